@@ -98,6 +98,14 @@
 #define configQUEUE_REGISTRY_SIZE		10
 #define configGENERATE_RUN_TIME_STATS	0
 
+/* Set to 1 to run the context switch, tick and queue paths of the kernel from
+RamLoc32. The functions are then copied from flash with the .data section at
+boot. Left at 0 until the TEST == EXAMPLE_2 build of statechart.c, which
+compares the two, has been measured on the board and the map file shows the
+copied code fits in RamLoc32. */
+#define configKERNEL_IN_RAM				0
+#define configKERNEL_RAM_SECTION		".ramfunc.$RamLoc32"
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 
@@ -109,6 +117,7 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil				1
 #define INCLUDE_vTaskDelay					1
 #define INCLUDE_uxTaskGetStackHighWaterMark	1
+#define INCLUDE_xTaskGetSchedulerState		1
 
 /* Use the system definition, if there is one */
 #ifdef __NVIC_PRIO_BITS
@@ -0,0 +1,80 @@
+/*
+ * @brief Configuration of the ROM USB device stack
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __APP_USB_CFG_H_
+#define __APP_USB_CFG_H_
+
+#include "lpc_types.h"
+#include "error.h"
+
+/** @ingroup RTOS_IO
+ * @{
+ */
+
+/* Sizes of the USB core tables allocated by the ROM stack */
+#define USB_MAX_IF_NUM          8
+#define USB_MAX_EP_NUM          6
+#define USB_MAX_PACKET0         64
+#define USB_FS_MAX_BULK_PACKET  64
+#define USB_HS_MAX_BULK_PACKET  512
+#define USB_DFU_XFER_SIZE       2048
+
+/* Memory given to the ROM stack for queue heads, transfer descriptors and
+   the CDC class driver, the queue heads need a 2 KB aligned base */
+#define USB_STACK_MEM_SIZE      0x2000
+#define USB_STACK_MEM_ALIGN     2048
+
+/* Interfaces and endpoints of the virtual COM port */
+#define USB_CDC_CIF_NUM         0
+#define USB_CDC_DIF_NUM         1
+#define USB_CDC_IN_EP           0x81
+#define USB_CDC_OUT_EP          0x01
+#define USB_CDC_INT_EP          0x82
+
+/* Interface and endpoints of the SD card export */
+#define USB_MSC_IF_NUM          2
+#define USB_MSC_IN_EP           0x83
+#define USB_MSC_OUT_EP          0x03
+
+/* Descriptors in usb_desc.c, the Msc configurations add the SD card export */
+extern const uint8_t USB_DeviceDescriptor[];
+extern uint8_t USB_HsConfigDescriptor[];
+extern uint8_t USB_FsConfigDescriptor[];
+extern uint8_t USB_HsMscConfigDescriptor[];
+extern uint8_t USB_FsMscConfigDescriptor[];
+extern const uint8_t USB_StringDescriptor[];
+extern const uint8_t USB_DeviceQualifier[];
+
+/**
+ * @}
+ */
+
+#endif /* __APP_USB_CFG_H_ */
@@ -0,0 +1,108 @@
+/*
+ * @brief Boot timeline
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __BOOT_TIME_H_
+#define __BOOT_TIME_H_
+
+#include "board.h"
+
+/** @defgroup BOOT_TIME Boot timeline
+ * @ingroup RTOS_IO
+ * Records when each boot phase ends, from the reset handler to the first
+ * task. The DWT cycle counter is started at the top of ResetISR(), which
+ * hands over the startup phases once the variables of this module have
+ * been initialized. The remaining phases are marked by the application.
+ * Each interval is converted with the core clock it started at. The core
+ * moves from 12MHz to the PLL inside Chip_SetupCoreClock() and runs its
+ * settling delays and the base clock setup at the PLL rate, but the whole
+ * of SystemInit() is counted at 12MHz. The "clocks" phase, and the times
+ * of the marks after it, are therefore upper bounds and are flagged as
+ * such. The cycle counts are exact.
+ * Marks are made in order from a single context and are not thread safe.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of marks kept, further marks are dropped
+ */
+#ifndef BOOT_TIME_MAX_MARKS
+#define BOOT_TIME_MAX_MARKS     16
+#endif
+
+/**
+ * @brief End of a boot phase
+ */
+typedef struct {
+	const char *name;			/**< Name of the phase that ended */
+	uint32_t cycles;			/**< Cycle counter at the end of the phase */
+	uint32_t us;				/**< Microseconds since ResetISR() */
+	bool upper;					/**< The phase changed core clock, its time is an upper bound */
+} BOOT_TIME_MARK_T;
+
+/**
+ * @brief	Mark the end of a boot phase at a given cycle count
+ * @param	name	: Name of the phase, the string is kept
+ * @param	cycles	: Cycle counter at the end of the phase
+ * @param	hz		: Core clock the phase started at, 0 for the current core clock
+ * @return	Nothing
+ * @note	Used by the startup code for the phases it runs before the
+ *			variables of this module are initialized. A rate below the
+ *			current core clock means the core was switched to a faster
+ *			clock during the phase, its time is flagged as an upper bound.
+ */
+void bootTime_markCycles(const char *name, uint32_t cycles, uint32_t hz);
+
+/**
+ * @brief	Mark the end of a boot phase now
+ * @param	name	: Name of the phase, the string is kept
+ * @return	Nothing
+ */
+void bootTime_mark(const char *name);
+
+/**
+ * @brief	Return the recorded marks
+ * @param	pMarks	: Set to the first mark
+ * @return	Number of marks
+ */
+uint32_t bootTime_getMarks(const BOOT_TIME_MARK_T **pMarks);
+
+/**
+ * @brief	Print the timeline on the debug output
+ * @return	Nothing
+ */
+void bootTime_print(void);
+
+/**
+ * @}
+ */
+
+#endif /* __BOOT_TIME_H_ */
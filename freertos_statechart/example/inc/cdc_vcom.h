@@ -0,0 +1,169 @@
+/*
+ * @brief Virtual COM port over the ROM USB CDC class driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __CDC_VCOM_H_
+#define __CDC_VCOM_H_
+
+#include "app_usbd_cfg.h"
+#include "usbd/usbd_rom_api.h"
+#include "ring_buffer.h"
+
+/** @defgroup CDC_VCOM Virtual COM port over USB CDC
+ * @ingroup RTOS_IO
+ * Bytes written to the port are copied straight into one of two transfer
+ * buffers while the other one is on the bulk IN endpoint, so the next
+ * transfer is armed as soon as the previous one completes. Writes that
+ * do not fit in the spare buffer queue on a transmit ring and are moved
+ * into the buffer that was just freed. Small writes that arrive while a
+ * transfer is in flight are therefore batched into one transfer.
+ * The bulk OUT endpoint also alternates between two buffers. Received
+ * data is copied to a receive ring, and the endpoint is NAKed while the
+ * ring cannot hold another full buffer.
+ * Writes never block, what does not fit is dropped and counted. They may
+ * be called from tasks and interrupt handlers, interrupts are masked
+ * while the data is copied. Reads must come from a single task.
+ * @{
+ */
+
+/**
+ * @brief Size of each of the two IN transfer buffers
+ */
+#ifndef VCOM_TX_BUF_SIZE
+#define VCOM_TX_BUF_SIZE        2048
+#endif
+
+/**
+ * @brief Size of each of the two OUT transfer buffers
+ */
+#define VCOM_RX_BUF_SIZE        USB_HS_MAX_BULK_PACKET
+
+/**
+ * @brief Port event callback, called from the USB interrupt
+ */
+typedef void (*VCOM_CALLBACK_T)(void);
+
+/**
+ * @brief Port configuration
+ */
+typedef struct {
+	uint8_t *txRing;			/**< Transmit ring storage */
+	uint32_t txRingSize;		/**< Transmit ring size, a power of 2 */
+	uint8_t *rxRing;			/**< Receive ring storage */
+	uint32_t rxRingSize;		/**< Receive ring size, a power of 2 */
+	uint8_t *txBuffers;			/**< 2 * VCOM_TX_BUF_SIZE bytes reachable by the USB DMA */
+	uint8_t *rxBuffers;			/**< 2 * VCOM_RX_BUF_SIZE bytes reachable by the USB DMA */
+	VCOM_CALLBACK_T txCb;		/**< An IN transfer completed, or NULL */
+	VCOM_CALLBACK_T rxCb;		/**< Data was added to the receive ring, or NULL */
+} VCOM_CFG_T;
+
+/**
+ * @brief Port statistics
+ */
+typedef struct {
+	uint32_t txBytes;			/**< Bytes sent to the host */
+	uint32_t txTransfers;		/**< IN transfers completed */
+	uint32_t txZlps;			/**< Zero length packets sent to end a transfer */
+	uint32_t txDropped;			/**< Bytes dropped because the port was full */
+	uint32_t rxBytes;			/**< Bytes received from the host */
+	uint32_t rxTransfers;		/**< OUT transfers completed */
+	uint32_t rxStalls;			/**< Times the OUT endpoint was NAKed for a full ring */
+} VCOM_STATS_T;
+
+/**
+ * @brief	Initialize the virtual COM port
+ * @param	hUsb		: Handle of the USB device stack
+ * @param	pDesc		: Descriptors given to the stack
+ * @param	pUsbParam	: Stack parameters, the memory used by the CDC driver
+ *						  is taken from them
+ * @param	pCfg		: Port configuration
+ * @return	LPC_OK or the error of the CDC class driver
+ * @note	Call after USBD_API->hw->Init() and before connecting. The stack
+ *			must have been initialized with vcom_reset_event() and
+ *			vcom_configure_event() as its reset and configure callbacks.
+ */
+ErrorCode_t vcom_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+					  const VCOM_CFG_T *pCfg);
+
+/**
+ * @brief	USB reset callback of the stack
+ * @param	hUsb	: Handle of the USB device stack
+ * @return	LPC_OK
+ * @note	Transfers in flight are dropped by the controller on reset, data
+ *			still waiting in the port is kept for the next configuration.
+ */
+ErrorCode_t vcom_reset_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @brief	USB configure callback of the stack
+ * @param	hUsb	: Handle of the USB device stack
+ * @return	LPC_OK
+ */
+ErrorCode_t vcom_configure_event(USBD_HANDLE_T hUsb);
+
+/**
+ * @brief	Queue data for the host without blocking
+ * @param	pBuf	: Data to send
+ * @param	len		: Number of bytes
+ * @return	Number of bytes accepted, the rest is dropped
+ */
+uint32_t vcom_write(const uint8_t *pBuf, uint32_t len);
+
+/**
+ * @brief	Read data received from the host
+ * @param	pBuf	: Buffer for the data
+ * @param	len		: Size of the buffer
+ * @return	Number of bytes read, 0 if none are available
+ */
+uint32_t vcom_bread(uint8_t *pBuf, uint32_t len);
+
+/**
+ * @brief	Return the number of bytes vcom_write() accepts now
+ * @return	Free space of the transmit ring and spare buffer
+ */
+uint32_t vcom_write_free(void);
+
+/**
+ * @brief	Return whether the host configured the device
+ * @return	true when configured
+ */
+bool vcom_connected(void);
+
+/**
+ * @brief	Return the port statistics
+ * @return	Pointer to the statistics
+ */
+const VCOM_STATS_T *vcom_stats(void);
+
+/**
+ * @}
+ */
+
+#endif /* __CDC_VCOM_H_ */
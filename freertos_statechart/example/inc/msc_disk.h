@@ -0,0 +1,140 @@
+/*
+ * @brief SD card export over the ROM USB mass storage class driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __MSC_DISK_H_
+#define __MSC_DISK_H_
+
+#include "app_usbd_cfg.h"
+#include "usbd/usbd_rom_api.h"
+#include "board.h"
+
+/** @defgroup MSC_DISK SD card export over USB mass storage
+ * @ingroup RTOS_IO
+ * The ROM class driver handles the SCSI commands and calls back for the
+ * data of READ and WRITE commands from the stack ISR. The callbacks
+ * queue requests on the asynchronous SD block driver using two run
+ * buffers of MSCDISK_RUN_BLOCKS blocks each.
+ * For reads, the USB endpoint sends straight from one run buffer while
+ * the card reads the following run into the other, so a sequential read
+ * only waits for the card on its first run.
+ * For writes, the host data is received straight into one run buffer.
+ * When it fills, it is queued for the card and the next run is received
+ * into the other buffer while the card programs the first.
+ * A partly filled write run is queued as soon as a read arrives, or when
+ * mscDisk_poll() finds the port idle.
+ * The callbacks wait for the card where the stack runs. Run the stack
+ * from a task and give a wait callback that blocks it, so that the other
+ * tasks run while the card is busy. Without one the wait spins on
+ * Chip_SDBLK_Poll(), and the SDIO interrupt must be able to preempt the
+ * stack. The card must not be used by anything else while it is exported.
+ * @{
+ */
+
+/**
+ * @brief Blocks in each of the two run buffers
+ */
+#ifndef MSCDISK_RUN_BLOCKS
+#define MSCDISK_RUN_BLOCKS      8
+#endif
+
+/**
+ * @brief Size of each run buffer in bytes
+ */
+#define MSCDISK_RUN_SIZE        (MSCDISK_RUN_BLOCKS * MMC_SECTOR_SIZE)
+
+/**
+ * @brief Card event callback
+ */
+typedef void (*MSCDISK_CALLBACK_T)(void);
+
+/**
+ * @brief Export configuration
+ */
+typedef struct {
+	uint8_t *buffers;			/**< 2 * MSCDISK_RUN_SIZE word aligned bytes reachable by the USB DMA */
+	uint32_t blockCount;		/**< Number of blocks on the card */
+	MSCDISK_CALLBACK_T doneCb;	/**< A card request finished, called from the SD driver, or NULL */
+	MSCDISK_CALLBACK_T waitCb;	/**< Blocks until doneCb is called, or NULL to poll the card */
+} MSCDISK_CFG_T;
+
+/**
+ * @brief Export statistics
+ */
+typedef struct {
+	uint32_t readBytes;			/**< Bytes sent to the host */
+	uint32_t writeBytes;		/**< Bytes received from the host */
+	uint32_t readRuns;			/**< Read requests queued on the card */
+	uint32_t readWaits;			/**< Host reads that waited for the card */
+	uint32_t writeRuns;			/**< Write requests queued on the card */
+	uint32_t writeWaits;		/**< Host writes that waited for a run buffer */
+	uint32_t errors;			/**< Failed card requests and rejected writes */
+} MSCDISK_STATS_T;
+
+/**
+ * @brief	Initialize the mass storage function
+ * @param	hUsb		: Handle of the USB device stack
+ * @param	pDesc		: Descriptors given to the stack, with a mass storage interface
+ * @param	pUsbParam	: Stack parameters, the memory used by the class driver
+ *						  is taken from them
+ * @param	pCfg		: Export configuration
+ * @return	LPC_OK or the error of the class driver
+ * @note	Call after USBD_API->hw->Init() and before connecting.
+ */
+ErrorCode_t mscDisk_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+						 const MSCDISK_CFG_T *pCfg);
+
+/**
+ * @brief	Queue buffered write data once the host is idle
+ * @return	Nothing
+ * @note	Call periodically, typically every 1ms from the task running
+ *			the stack.
+ */
+void mscDisk_poll(void);
+
+/**
+ * @brief	Write all buffered data and wait for the card
+ * @return	Nothing
+ * @note	Call once the stack no longer runs, before the card is used by
+ *			anything else.
+ */
+void mscDisk_flush(void);
+
+/**
+ * @brief	Return the export statistics
+ * @return	Pointer to the statistics
+ */
+const MSCDISK_STATS_T *mscDisk_stats(void);
+
+/**
+ * @}
+ */
+
+#endif /* __MSC_DISK_H_ */
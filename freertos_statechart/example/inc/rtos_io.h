@@ -0,0 +1,476 @@
+/*
+ * @brief FreeRTOS glue for the asynchronous chip drivers
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __RTOS_IO_H_
+#define __RTOS_IO_H_
+
+#include "board.h"
+
+/** @defgroup RTOS_IO FreeRTOS glue for the asynchronous chip drivers
+ * These functions wrap the callback based chip drivers so tasks can
+ * block on completion instead of polling. They also own the interrupt
+ * handlers of the peripherals used by the drivers.
+ * @{
+ */
+
+/**
+ * @brief	Initialize the asynchronous drivers and their interrupts
+ * @return	Nothing
+ * @note	Must be called before the scheduler is started.
+ */
+void RTOS_IO_Init(void);
+
+/**
+ * @brief	Advance the drivers that wait on timed conditions
+ * @return	Nothing
+ * @note	Called from the FreeRTOS tick hook.
+ */
+void RTOS_IO_Tick(void);
+
+/**
+ * @brief	Set the SDIO interrupt handler used until a card is attached
+ * @param	handler	: Handler, e.g. the one ending the wait_evt callback of
+ *					  Chip_SDMMC_Acquire(), or NULL
+ * @return	Nothing
+ * @note	The handler must disable or clear the interrupt. Without one, an
+ *			SDIO interrupt before RTOS_IO_SDAttach() disables itself.
+ */
+void RTOS_IO_SetSDIOHandler(void (*handler)(void));
+
+/**
+ * @brief	Hand an acquired SD card over to the asynchronous block driver
+ * @param	pSDMMC	: SDMMC peripheral selected
+ * @param	pCard	: Card acquired with Chip_SDMMC_Acquire()
+ * @return	SUCCESS, or ERROR if the card is not ready for transfers
+ * @note	The SDIO interrupt is owned by the block driver afterwards, and
+ *			the block cache is set up for RTOS_IO_SDRead() and RTOS_IO_SDWrite().
+ */
+Status RTOS_IO_SDAttach(LPC_SDMMC_T *pSDMMC, mci_card_struct *pCard);
+
+/**
+ * @brief	Run an SD block transfer, blocking the calling task until done
+ * @param	buffer	: Word aligned buffer of count * 512 bytes
+ * @param	block	: First block number
+ * @param	count	: Number of blocks, at most SDBLK_MAX_BLOCKS
+ * @param	write	: true to write, false to read
+ * @return	SUCCESS or ERROR
+ * @note	Bypasses the block cache. A write returns once the card has
+ *			finished programming the data.
+ */
+Status RTOS_IO_SDTransfer(void *buffer, uint32_t block, uint32_t count, bool write);
+
+/**
+ * @brief	Read blocks from the SD card through the block cache
+ * @param	buffer	: Buffer for count * 512 bytes
+ * @param	block	: First block number
+ * @param	count	: Number of blocks
+ * @return	SUCCESS or ERROR
+ */
+Status RTOS_IO_SDRead(void *buffer, uint32_t block, uint32_t count);
+
+/**
+ * @brief	Write blocks to the SD card through the block cache
+ * @param	buffer	: Buffer holding count * 512 bytes
+ * @param	block	: First block number
+ * @param	count	: Number of blocks
+ * @return	SUCCESS or ERROR
+ * @note	Short writes stay in the cache until RTOS_IO_SDFlush().
+ */
+Status RTOS_IO_SDWrite(const void *buffer, uint32_t block, uint32_t count);
+
+/**
+ * @brief	Write all cached SD blocks back to the card
+ * @return	SUCCESS or ERROR
+ * @note	Every write done before the call is on the card when it returns.
+ */
+Status RTOS_IO_SDFlush(void);
+
+/**
+ * @brief	Bring up the Ethernet MAC, PHY and descriptor rings
+ * @return	SUCCESS, or ERROR if the PHY did not respond
+ * @note	Must be called from a task. The link state is then tracked from
+ *			the tick hook with lpcPHYStsPoll().
+ */
+Status RTOS_IO_ENETInit(void);
+
+/**
+ * @brief	Wait for a received Ethernet frame
+ * @param	pFrame	: Filled with the frame, which refers to the receive buffer
+ * @param	waitMs	: Time to wait for a frame, in milliseconds
+ * @return	true if a frame was received, false on timeout
+ * @note	Only one task may receive. The frame must be given back with
+ *			Chip_ENETRING_Release() by that task once the stack is done with it.
+ *			While frames keep arriving they are picked up without interrupts.
+ */
+bool RTOS_IO_ENETReceive(ENETRING_RXFRAME_T *pFrame, uint32_t waitMs);
+
+/**
+ * @brief	Send an Ethernet frame, blocking the calling task until it is sent
+ * @param	pSegs	: Segments of the frame, sent in place without copying
+ * @param	numSegs	: Number of segments
+ * @return	SUCCESS, or ERROR if the link is down or the frame failed
+ * @note	A link down while the frame waits in the ring fails it, the task
+ *			is woken with ERROR.
+ */
+Status RTOS_IO_ENETSend(const ENETRING_SEG_T *pSegs, uint32_t numSegs);
+
+/**
+ * @brief	Start streaming the HSADC FIFO into blocks
+ * @return	SUCCESS or ERROR
+ * @note	The HSADC must be set up by the caller, conversions are started
+ *			with Chip_HSADC_SWTrigger() or an external trigger afterwards.
+ *			Each block holds 1024 packed samples.
+ */
+Status RTOS_IO_HSADCStart(void);
+
+/**
+ * @brief	Wait for the next full HSADC block
+ * @param	waitMs	: Time to wait for a block, in milliseconds
+ * @param	pSeq	: Where to store the block sequence number, or NULL
+ * @return	Pointer to the block, or NULL on timeout
+ * @note	Only one task may consume blocks. Each block must be given back
+ *			with Chip_HSADCDMA_ReleaseBlock(), two blocks may be held before
+ *			new ones are dropped. A sequence number that does not follow the
+ *			previous one means blocks were dropped in between.
+ */
+uint32_t *RTOS_IO_HSADCGetBlock(uint32_t waitMs, uint32_t *pSeq);
+
+/**
+ * @brief	Start full-duplex audio streaming through the WM8904 codec
+ * @return	SUCCESS or ERROR
+ * @note	Sets up I2S1 for 16-bit stereo at AUDCFG_SAMPLE_RATE with the
+ *			codec as clock master, and initializes the codec. Must be called
+ *			from a task. Each period holds 256 frames, one 32-bit word per
+ *			frame with the left sample in the low half.
+ */
+Status RTOS_IO_AudioStart(void);
+
+/**
+ * @brief	Wait for an empty audio period to fill
+ * @param	waitMs	: Time to wait for a period, in milliseconds
+ * @return	Pointer to the period, or NULL on timeout
+ * @note	Only one task may produce audio. The filled period is queued for
+ *			playback with Chip_I2SDMA_QueueTxPeriod(). Silence is played if
+ *			no period is queued when the one ahead of it starts.
+ */
+uint32_t *RTOS_IO_AudioGetTxPeriod(uint32_t waitMs);
+
+/**
+ * @brief	Wait for the next received audio period
+ * @param	waitMs	: Time to wait for a period, in milliseconds
+ * @return	Pointer to the period, or NULL on timeout
+ * @note	Only one task may consume audio. Each period must be given back
+ *			with Chip_I2SDMA_ReleaseRxPeriod(), two periods may be held before
+ *			received audio is discarded.
+ */
+uint32_t *RTOS_IO_AudioGetRxPeriod(uint32_t waitMs);
+
+/**
+ * @brief	Start the USB virtual COM port and connect to the host
+ * @return	SUCCESS, or ERROR if already started or the ROM USB stack failed
+ *			to initialize
+ * @note	The USB interrupt wakes a task of the highest priority that runs
+ *			the ROM stack, so the SD card export can block while it waits
+ *			for the card.
+ */
+Status RTOS_IO_USBStart(void);
+
+/**
+ * @brief	Export the SD card to the USB host as a mass storage device, or take it back
+ * @param	exportSD	: true to export the card, false to take it back
+ * @return	SUCCESS, or ERROR if no card is attached or USB is not started
+ * @note	The device disconnects and enumerates again with or without the
+ *			mass storage interface, data queued on the virtual COM port is
+ *			dropped. While the card is exported the RTOS_IO_SD* functions
+ *			return ERROR. The block cache is written back before the export
+ *			and emptied after it.
+ */
+Status RTOS_IO_USBExportSD(bool exportSD);
+
+/**
+ * @brief	Send data on the USB virtual COM port without blocking
+ * @param	data	: Data to send
+ * @param	len		: Number of bytes
+ * @return	Number of bytes queued, the rest is dropped
+ * @note	May be called from any task or interrupt handler. Data is kept
+ *			while no host has the device configured.
+ */
+uint32_t RTOS_IO_USBWrite(const void *data, uint32_t len);
+
+/**
+ * @brief	Read data from the USB virtual COM port
+ * @param	buffer	: Buffer for the data
+ * @param	len		: Size of the buffer
+ * @param	waitMs	: Time to wait for data
+ * @return	Number of bytes read, 0 on timeout
+ * @note	Only one task may read the port.
+ */
+uint32_t RTOS_IO_USBRead(void *buffer, uint32_t len, uint32_t waitMs);
+
+/**
+ * @brief	Start C_CAN0 with the interrupt driven driver
+ * @param	bitRate	: Bus bit rate in bits per second
+ * @return	SUCCESS, or ERROR if the bit rate cannot be set
+ * @note	No frame is received until a filter is added. The CAN pins
+ *			must be muxed by the application.
+ */
+Status RTOS_IO_CANStart(uint32_t bitRate);
+
+/**
+ * @brief	Accept frames matching a filter on C_CAN0
+ * @param	id		: Identifier to accept, or-ed with CCANQ_ID_EXT for extended frames
+ * @param	mask	: Identifier bits that must match @a id
+ * @param	depth	: Number of message objects buffering the filter
+ * @return	Number of the first message object of the filter, or 0 if out of message objects
+ */
+uint8_t RTOS_IO_CANAddFilter(uint32_t id, uint32_t mask, uint32_t depth);
+
+/**
+ * @brief	Queue a frame for transmission on C_CAN0 without blocking
+ * @param	pMsg	: Frame to send, copied
+ * @return	SUCCESS, or ERROR if the transmit queue is full
+ */
+Status RTOS_IO_CANSend(const CCAN_MSG_OBJ_T *pMsg);
+
+/**
+ * @brief	Wait for a frame received on C_CAN0
+ * @param	pMsg	: Pointer to store the frame
+ * @param	waitMs	: Maximum time to wait in milliseconds
+ * @return	true if a frame was received, false on timeout
+ * @note	Frames are returned from a single receive ring, one task
+ *			should read them.
+ */
+bool RTOS_IO_CANReceive(CCAN_MSG_OBJ_T *pMsg, uint32_t waitMs);
+
+/**
+ * @brief	Mount the key-value store on the EEPROM
+ * @return	SUCCESS, or ERROR if the store cannot be mounted
+ * @note	Updates are kept in RAM for up to a second before they are
+ *			programmed, RTOS_IO_KVFlush() programs them at once.
+ */
+Status RTOS_IO_KVStart(void);
+
+/**
+ * @brief	Set the value of a key
+ * @param	key		: Key
+ * @param	data	: Value
+ * @param	len		: Length of the value, 1 to EEKV_MAX_VALUE bytes
+ * @return	SUCCESS, or ERROR if the arguments are invalid or the store is full
+ */
+Status RTOS_IO_KVSet(uint16_t key, const void *data, uint32_t len);
+
+/**
+ * @brief	Read the value of a key
+ * @param	key		: Key
+ * @param	data	: Buffer for the value
+ * @param	maxLen	: Size of the buffer
+ * @return	Length of the value, or 0 if the key is not set
+ */
+uint32_t RTOS_IO_KVGet(uint16_t key, void *data, uint32_t maxLen);
+
+/**
+ * @brief	Delete a key
+ * @param	key		: Key
+ * @return	SUCCESS, or ERROR if the key is not set or the store is full
+ */
+Status RTOS_IO_KVDelete(uint16_t key);
+
+/**
+ * @brief	Program the buffered key-value updates now
+ * @return	Nothing
+ */
+void RTOS_IO_KVFlush(void);
+
+/**
+ * @brief	Start streaming a firmware image into the inactive flash bank
+ * @param	size	: Image size in bytes
+ * @param	crc		: CRC-32 (IEEE 802.3) of the image
+ * @return	SUCCESS, or ERROR if an update is running or the image does not fit
+ * @note	The image must be linked for the inactive bank. Its sectors are
+ *			erased and programmed from an idle priority task while the
+ *			application keeps running.
+ */
+Status RTOS_IO_FWUpdateBegin(uint32_t size, uint32_t crc);
+
+/**
+ * @brief	Add received data to the firmware image
+ * @param	data	: Next bytes of the image
+ * @param	len		: Number of bytes
+ * @return	SUCCESS, or ERROR if the update failed
+ * @note	Blocks the calling task while the page buffers are full.
+ */
+Status RTOS_IO_FWUpdateWrite(const void *data, uint32_t len);
+
+/**
+ * @brief	Wait for the firmware image to be verified and make it the boot image
+ * @return	SUCCESS if the new image runs after the next reset, ERROR otherwise
+ */
+Status RTOS_IO_FWUpdateFinish(void);
+
+/**
+ * @brief Address of the mailbox block shared with the M0APP core, the
+ * start of the AHB ETB SRAM. The M0 image attaches at the same address
+ * and neither image may link anything into this SRAM.
+ */
+#define RTOS_IO_IPC_SHARED_ADDR     0x2000C000
+
+/**
+ * @brief	Set up the mailbox and start the M0APP core
+ * @param	m0Image	: Address of the M0 image, 4KB aligned
+ * @return	SUCCESS, or ERROR if already started or the image is not aligned
+ * @note	The M0 image calls Chip_IPCMBX_Init() on RTOS_IO_IPC_SHARED_ADDR
+ *			and serves the messages, for example UART logging or button
+ *			scanning. Message identifiers are defined by the application.
+ */
+Status RTOS_IO_IPCStart(uint32_t m0Image);
+
+/**
+ * @brief	Send a message to the M0APP core
+ * @param	pMsg	: Message, copied
+ * @param	waitMs	: Maximum time to wait for space in milliseconds
+ * @return	true if the message was queued, false on timeout or a bad length
+ */
+bool RTOS_IO_IPCSend(const IPCMBX_MSG_T *pMsg, uint32_t waitMs);
+
+/**
+ * @brief	Wait for a message from the M0APP core
+ * @param	pMsg	: Pointer to store the message
+ * @param	waitMs	: Maximum time to wait in milliseconds
+ * @return	true if a message was received, false on timeout
+ */
+bool RTOS_IO_IPCReceive(IPCMBX_MSG_T *pMsg, uint32_t waitMs);
+
+/**
+ * @brief	Switch the debug UART from text to binary telemetry
+ * @param	baud	: New UART rate, for example TELEMETRY_BAUD
+ * @return	SUCCESS, or ERROR if already started
+ * @note	Waits for pending text to go out, then owns the UART interrupt.
+ *			DEBUGOUT and DEBUGSTR text is sent afterwards as TELEMETRY_TEXT
+ *			records of up to one line each. Text from interrupts is dropped.
+ */
+Status RTOS_IO_TelemStart(uint32_t baud);
+
+/**
+ * @brief	Send a telemetry record without blocking
+ * @param	type	: Record type, see telemetry.h
+ * @param	record	: Record payload, encoded straight into the UART ring buffer
+ * @param	len		: Payload size in bytes, up to TELEM_MAX_PAYLOAD
+ * @return	SUCCESS, or ERROR if not started, too long or the ring buffer is full
+ * @note	A record that does not fit is dropped and counted, the caller
+ *			is never held up by the UART.
+ */
+Status RTOS_IO_TelemSend(uint8_t type, const void *record, uint32_t len);
+
+/**
+ * @brief	Return the telemetry statistics
+ * @return	Pointer to the statistics
+ */
+const TELEM_STATS_T *RTOS_IO_TelemGetStats(void);
+
+/**
+ * @brief	Encrypt or decrypt a buffer, blocking the calling task until done
+ * @param	pCtx	: Stream context, advanced so the next call continues the stream
+ * @param	pOut	: Output buffer, may be the same as pIn
+ * @param	pIn		: Input buffer
+ * @param	len		: Length in bytes
+ * @return	SUCCESS, or ERROR on a bad length or engine failure
+ * @note	Runs on the AES engine with DMA when one is configured, other
+ *			tasks execute meanwhile. Otherwise the software AES runs in the
+ *			calling task.
+ */
+Status RTOS_IO_AESProcess(AESSTREAM_CTX_T *pCtx, uint8_t *pOut, const uint8_t *pIn, uint32_t len);
+
+/**
+ * @brief	Copy memory, blocking the calling task until done
+ * @param	dst	: Destination address
+ * @param	src	: Source address
+ * @param	len	: Number of bytes to copy
+ * @return	SUCCESS or ERROR
+ * @note	Large copies run on the GPDMA while other tasks execute.
+ */
+Status RTOS_IO_MemCopy(void *dst, const void *src, uint32_t len);
+
+/**
+ * @brief	Fill memory, blocking the calling task until done
+ * @param	dst	: Destination address
+ * @param	val	: Byte value to fill with
+ * @param	len	: Number of bytes to fill
+ * @return	SUCCESS or ERROR
+ */
+Status RTOS_IO_MemSet(void *dst, uint8_t val, uint32_t len);
+
+/**
+ * @brief	Return the DMA transaction queue of the LCD SSP
+ * @return	Pointer to the SSP DMA handle
+ * @note	Drivers may queue their own transactions on it with
+ *			Chip_SSPDMA_Submit(), they are serialized with the blocking calls.
+ */
+SSPDMA_HANDLE_T *RTOS_IO_GetLCDSSP(void);
+
+/**
+ * @brief	Initialize the LCD and start the task that refreshes it
+ * @param	maxFps	: Maximum number of refreshes per second
+ * @return	SUCCESS, or ERROR if already started or the task can't be created
+ * @note	The LCD is left in deferred mode: the LCD_* drawing functions only
+ *			update the frame buffer and mark dirty regions, the task sends the
+ *			changed columns as SSP DMA bursts once per frame period. Drawing
+ *			from several tasks must be serialized by the application.
+ */
+Status RTOS_IO_LCDStart(uint32_t maxFps);
+
+/**
+ * @brief	Run a full duplex transfer on the LCD SSP, blocking until done
+ * @param	tx	: Frames to send, or NULL to send 0xFF
+ * @param	rx	: Buffer for received frames, or NULL to discard them
+ * @param	len	: Number of frames
+ * @return	SUCCESS or ERROR
+ * @note	Frame size and clock are the ones currently set on the SSP.
+ */
+Status RTOS_IO_SSPTransfer(const void *tx, void *rx, uint32_t len);
+
+/**
+ * @brief	Run a batch of I2C transfers, blocking the calling task until done
+ * @param	id		: I2C peripheral ID (I2C0, I2C1)
+ * @param	pQXfer	: Array of transfers setup with Chip_I2C_MasterSetupQXfer()
+ * @param	count	: Number of transfers in the array
+ * @return	SUCCESS if all transfers completed, ERROR otherwise
+ * @note	The transfers are chained from the I2C interrupt, the task
+ *			sleeps until the last one completes. Before the scheduler
+ *			starts the I2C interrupt is masked, the call then polls the
+ *			bus until the transfers are done.
+ */
+Status RTOS_IO_I2CTransfer(I2C_ID_T id, I2C_QXFER_T *pQXfer, uint32_t count);
+
+/**
+ * @}
+ */
+
+#endif /* __RTOS_IO_H_ */
@@ -0,0 +1,104 @@
+/*
+ * @brief Telemetry record schema
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __TELEMETRY_H_
+#define __TELEMETRY_H_
+
+#include "board.h"
+
+/** @defgroup TELEMETRY Telemetry records
+ * @ingroup RTOS_IO
+ * Record types and payloads sent with RTOS_IO_TelemSend(). Payloads are
+ * little endian structures whose fields are naturally aligned, so they
+ * carry no padding and are sent as they are in memory. Strings are NUL
+ * padded and not terminated when they fill their field.<br>
+ * tools/telemetry_decode.py decodes the same records on the host. A new
+ * record type must be added there too, the decoder shows unknown types
+ * as raw bytes.
+ * @{
+ */
+
+/**
+ * @brief Debug UART rate once the telemetry is started
+ */
+#define TELEMETRY_BAUD          921600
+
+/**
+ * @brief Record types
+ */
+typedef enum {
+	TELEMETRY_TICK = 1,			/**< TELEMETRY_TICK_T */
+	TELEMETRY_BOOT_MARK,		/**< TELEMETRY_BOOT_MARK_T */
+	TELEMETRY_TASKS,			/**< TELEMETRY_TASKS_T */
+	TELEMETRY_LINK,				/**< TELEMETRY_LINK_T */
+	TELEMETRY_TEXT				/**< DEBUGOUT text, up to one line of characters with no terminator */
+} TELEMETRY_TYPE_T;
+
+/**
+ * @brief Periodic tick
+ */
+typedef struct {
+	uint32_t count;				/**< Ticks sent so far */
+	uint32_t ms;				/**< Milliseconds since the scheduler started */
+} TELEMETRY_TICK_T;
+
+/**
+ * @brief End of a boot phase, from the boot timeline
+ */
+typedef struct {
+	uint32_t us;				/**< Microseconds since ResetISR() */
+	uint32_t cycles;			/**< Cycle counter at the end of the phase */
+	char name[12];				/**< Name of the phase */
+} TELEMETRY_BOOT_MARK_T;
+
+/**
+ * @brief Task state
+ */
+typedef struct {
+	uint32_t tasks;				/**< Number of tasks */
+	uint32_t stackFree;			/**< Lowest free stack of the sending task in bytes */
+} TELEMETRY_TASKS_T;
+
+/**
+ * @brief Telemetry link statistics, see TELEM_STATS_T
+ */
+typedef struct {
+	uint32_t frames;			/**< Frames queued */
+	uint32_t bytes;				/**< Encoded bytes queued */
+	uint32_t dropped;			/**< Records dropped on a full ring buffer */
+} TELEMETRY_LINK_T;
+
+/**
+ * @}
+ */
+
+#endif /* __TELEMETRY_H_ */
@@ -0,0 +1,110 @@
+/*
+ * @brief Boot timeline
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "boot_time.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static BOOT_TIME_MARK_T bootMarks[BOOT_TIME_MAX_MARKS];
+static uint32_t bootCount;
+static uint32_t bootLastCycles;		/* Cycle counter at the previous mark */
+static uint32_t bootUs;				/* Microseconds at the previous mark */
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Mark the end of a boot phase at a given cycle count */
+void bootTime_markCycles(const char *name, uint32_t cycles, uint32_t hz)
+{
+	BOOT_TIME_MARK_T *pMark;
+	uint32_t coreHz;
+
+	if (bootCount >= BOOT_TIME_MAX_MARKS) {
+		return;
+	}
+	coreHz = Chip_Clock_GetRate(CLK_MX_MXCORE);
+	if (hz == 0) {
+		hz = coreHz;
+	}
+
+	bootUs += (uint32_t) (((uint64_t) (cycles - bootLastCycles) * 1000000) / hz);
+	bootLastCycles = cycles;
+
+	pMark = &bootMarks[bootCount++];
+	pMark->name = name;
+	pMark->cycles = cycles;
+	pMark->us = bootUs;
+	pMark->upper = (hz < coreHz);
+}
+
+/* Mark the end of a boot phase now */
+void bootTime_mark(const char *name)
+{
+	bootTime_markCycles(name, DWT->CYCCNT, 0);
+}
+
+/* Return the recorded marks */
+uint32_t bootTime_getMarks(const BOOT_TIME_MARK_T **pMarks)
+{
+	*pMarks = bootMarks;
+	return bootCount;
+}
+
+/* Print the timeline on the debug output */
+void bootTime_print(void)
+{
+	uint32_t i, prev = 0;
+	bool upper = false;
+
+	DEBUGOUT("Boot timeline:\r\n");
+	for (i = 0; i < bootCount; i++) {
+		upper |= bootMarks[i].upper;
+		DEBUGOUT("  %-10s %s%6lu us (%s%lu)\r\n", bootMarks[i].name, upper ? "<=" : "  ",
+				 (unsigned long) bootMarks[i].us, bootMarks[i].upper ? "<=" : "+",
+				 (unsigned long) (bootMarks[i].us - prev));
+		prev = bootMarks[i].us;
+	}
+	if (upper) {
+		DEBUGOUT("  <= upper bound, a phase changed core clock part way\r\n");
+	}
+}
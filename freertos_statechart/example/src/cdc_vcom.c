@@ -0,0 +1,357 @@
+/*
+ * @brief Virtual COM port over the ROM USB CDC class driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "board.h"
+#include "cdc_vcom.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Port state, shared by the USB interrupt and the callers */
+typedef struct {
+	USBD_HANDLE_T hUsb;
+	USBD_HANDLE_T hCdc;
+	RINGBUFF_T txRing;
+	RINGBUFF_T rxRing;
+	uint8_t *txBuf[2];
+	uint8_t *rxBuf[2];
+	uint32_t txLen[2];			/* Bytes in each IN buffer */
+	uint32_t txActive;			/* IN buffer last put on the endpoint, the other one is the spare */
+	uint32_t txXferLen;			/* Length of the IN transfer in flight */
+	uint32_t rxActive;			/* OUT buffer queued on the endpoint */
+	uint32_t maxPacket;			/* Bulk packet size of the current speed */
+	bool txBusy;
+	bool rxStalled;
+	bool configured;
+	VCOM_CALLBACK_T txCb;
+	VCOM_CALLBACK_T rxCb;
+	VCOM_STATS_T stats;
+} VCOM_DATA_T;
+
+static VCOM_DATA_T vcom;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t vcomEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void vcomExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Find the first interface descriptor of a class in a configuration descriptor */
+static USB_INTERFACE_DESCRIPTOR *vcomFindIntfDesc(uint8_t *pDesc, uint32_t intfClass)
+{
+	USB_COMMON_DESCRIPTOR *pD;
+	USB_INTERFACE_DESCRIPTOR *pIntfDesc;
+	uint32_t next = 0;
+
+	pD = (USB_COMMON_DESCRIPTOR *) pDesc;
+	while (pD->bLength) {
+		if (pD->bDescriptorType == USB_INTERFACE_DESCRIPTOR_TYPE) {
+			pIntfDesc = (USB_INTERFACE_DESCRIPTOR *) pD;
+			if (pIntfDesc->bInterfaceClass == intfClass) {
+				return pIntfDesc;
+			}
+		}
+		next = pD->bLength;
+		pD = (USB_COMMON_DESCRIPTOR *) ((uint8_t *) pD + next);
+	}
+	return NULL;
+}
+
+/* Move data queued on the transmit ring to the end of the spare buffer */
+static void vcomRefill(void)
+{
+	uint32_t spare = vcom.txActive ^ 1;
+
+	vcom.txLen[spare] += RingBuffer_PopMult(&vcom.txRing, vcom.txBuf[spare] + vcom.txLen[spare],
+											VCOM_TX_BUF_SIZE - vcom.txLen[spare]);
+}
+
+/* Put the spare buffer on the IN endpoint if it is free and refill the
+   buffer it completed with, so the next transfer is ready before this ends */
+static void vcomKick(void)
+{
+	uint32_t spare = vcom.txActive ^ 1;
+
+	if (vcom.txBusy || !vcom.configured || (vcom.txLen[spare] == 0)) {
+		return;
+	}
+
+	vcom.txActive = spare;
+	vcom.txXferLen = vcom.txLen[spare];
+	vcom.txBusy = true;
+	USBD_API->hw->WriteEP(vcom.hUsb, USB_CDC_IN_EP, vcom.txBuf[spare], vcom.txXferLen);
+	vcomRefill();
+}
+
+/* Queue the receive buffer on the OUT endpoint */
+static void vcomQueueRead(void)
+{
+	USBD_API->hw->ReadReqEP(vcom.hUsb, USB_CDC_OUT_EP, vcom.rxBuf[vcom.rxActive], VCOM_RX_BUF_SIZE);
+}
+
+/* Bulk IN endpoint handler */
+static ErrorCode_t vcomBulkIn(USBD_HANDLE_T hUsb, void *data, uint32_t event)
+{
+	if ((event != USB_EVT_IN) || !vcom.txBusy) {
+		return LPC_OK;
+	}
+
+	vcom.txBusy = false;
+	if (vcom.txXferLen > 0) {
+		vcom.stats.txBytes += vcom.txXferLen;
+		vcom.stats.txTransfers++;
+	}
+	vcom.txLen[vcom.txActive] = 0;
+
+	/* A transfer ending on a packet boundary is only seen as complete by
+	   the host after a short packet, send one if nothing else follows */
+	if ((vcom.txXferLen > 0) && ((vcom.txXferLen % vcom.maxPacket) == 0) &&
+		(vcom.txLen[vcom.txActive ^ 1] == 0)) {
+		vcom.txXferLen = 0;
+		vcom.txBusy = true;
+		vcom.stats.txZlps++;
+		USBD_API->hw->WriteEP(hUsb, USB_CDC_IN_EP, vcom.txBuf[vcom.txActive], 0);
+	}
+	else {
+		vcomKick();
+	}
+
+	if (vcom.txCb) {
+		vcom.txCb();
+	}
+	return LPC_OK;
+}
+
+/* Bulk OUT endpoint handler */
+static ErrorCode_t vcomBulkOut(USBD_HANDLE_T hUsb, void *data, uint32_t event)
+{
+	uint8_t *pBuf;
+	uint32_t len;
+
+	if (event != USB_EVT_OUT) {
+		return LPC_OK;
+	}
+
+	pBuf = vcom.rxBuf[vcom.rxActive];
+	len = USBD_API->hw->ReadEP(hUsb, USB_CDC_OUT_EP, pBuf);
+
+	/* Receive into the other buffer while this one is copied, unless the
+	   ring may not hold both. The endpoint is then NAKed until read */
+	if (RingBuffer_GetFree(&vcom.rxRing) >= (int) (len + VCOM_RX_BUF_SIZE)) {
+		vcom.rxActive ^= 1;
+		vcomQueueRead();
+	}
+	else {
+		vcom.rxStalled = true;
+		vcom.stats.rxStalls++;
+	}
+	RingBuffer_InsertMult(&vcom.rxRing, pBuf, len);
+	vcom.stats.rxBytes += len;
+	vcom.stats.rxTransfers++;
+
+	if (vcom.rxCb) {
+		vcom.rxCb();
+	}
+	return LPC_OK;
+}
+
+/* Line coding is accepted and ignored, the port has no baud rate */
+static ErrorCode_t vcomSetLineCode(USBD_HANDLE_T hCDC, CDC_LINE_CODING *line_coding)
+{
+	return LPC_OK;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the virtual COM port */
+ErrorCode_t vcom_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+					  const VCOM_CFG_T *pCfg)
+{
+	USBD_CDC_INIT_PARAM_T cdc_param;
+	ErrorCode_t ret;
+
+	if (pCfg->rxRingSize < (2 * VCOM_RX_BUF_SIZE)) {
+		return ERR_API_INVALID_PARAM1;
+	}
+
+	memset(&vcom, 0, sizeof(vcom));
+	vcom.hUsb = hUsb;
+	vcom.txBuf[0] = pCfg->txBuffers;
+	vcom.txBuf[1] = pCfg->txBuffers + VCOM_TX_BUF_SIZE;
+	vcom.rxBuf[0] = pCfg->rxBuffers;
+	vcom.rxBuf[1] = pCfg->rxBuffers + VCOM_RX_BUF_SIZE;
+	vcom.maxPacket = USB_FS_MAX_BULK_PACKET;
+	vcom.txCb = pCfg->txCb;
+	vcom.rxCb = pCfg->rxCb;
+	RingBuffer_Init(&vcom.txRing, pCfg->txRing, 1, pCfg->txRingSize);
+	RingBuffer_Init(&vcom.rxRing, pCfg->rxRing, 1, pCfg->rxRingSize);
+
+	memset(&cdc_param, 0, sizeof(cdc_param));
+	cdc_param.mem_base = pUsbParam->mem_base;
+	cdc_param.mem_size = pUsbParam->mem_size;
+	cdc_param.cif_intf_desc = (uint8_t *) vcomFindIntfDesc(pDesc->high_speed_desc,
+														   CDC_COMMUNICATION_INTERFACE_CLASS);
+	cdc_param.dif_intf_desc = (uint8_t *) vcomFindIntfDesc(pDesc->high_speed_desc, CDC_DATA_INTERFACE_CLASS);
+	cdc_param.SetLineCode = vcomSetLineCode;
+
+	ret = USBD_API->cdc->init(hUsb, &cdc_param, &vcom.hCdc);
+	if (ret != LPC_OK) {
+		return ret;
+	}
+
+	/* Replace the bulk handlers of the class driver */
+	ret = USBD_API->core->RegisterEpHandler(hUsb, ((USB_CDC_IN_EP & 0x0F) << 1) + 1, vcomBulkIn, &vcom);
+	if (ret == LPC_OK) {
+		ret = USBD_API->core->RegisterEpHandler(hUsb, (USB_CDC_OUT_EP & 0x0F) << 1, vcomBulkOut, &vcom);
+	}
+
+	/* Give the remaining memory back to the caller */
+	pUsbParam->mem_base = cdc_param.mem_base;
+	pUsbParam->mem_size = cdc_param.mem_size;
+	return ret;
+}
+
+/* USB reset callback */
+ErrorCode_t vcom_reset_event(USBD_HANDLE_T hUsb)
+{
+	if (vcom.txBusy) {
+		vcom.txLen[vcom.txActive] = 0;
+		vcom.txBusy = false;
+	}
+	vcom.rxStalled = false;
+	vcom.configured = false;
+	return LPC_OK;
+}
+
+/* USB configure callback */
+ErrorCode_t vcom_configure_event(USBD_HANDLE_T hUsb)
+{
+	USB_CORE_CTRL_T *pCtrl = (USB_CORE_CTRL_T *) hUsb;
+
+	vcom.configured = (pCtrl->config_value != 0);
+	if (vcom.configured) {
+		vcom.maxPacket = (pCtrl->device_speed == USB_HIGH_SPEED) ?
+						 USB_HS_MAX_BULK_PACKET : USB_FS_MAX_BULK_PACKET;
+		vcom.rxActive = 0;
+		vcom.rxStalled = false;
+		vcomQueueRead();
+		vcomKick();
+	}
+	return LPC_OK;
+}
+
+/* Queue data for the host */
+uint32_t vcom_write(const uint8_t *pBuf, uint32_t len)
+{
+	uint32_t primask, spare, count = 0;
+
+	primask = vcomEnterCritical();
+
+	/* Data goes straight to the spare buffer unless older data waits on the ring */
+	spare = vcom.txActive ^ 1;
+	if (RingBuffer_IsEmpty(&vcom.txRing)) {
+		count = MIN(len, VCOM_TX_BUF_SIZE - vcom.txLen[spare]);
+		memcpy(vcom.txBuf[spare] + vcom.txLen[spare], pBuf, count);
+		vcom.txLen[spare] += count;
+	}
+	if (count < len) {
+		count += RingBuffer_InsertMult(&vcom.txRing, pBuf + count, len - count);
+	}
+	vcom.stats.txDropped += len - count;
+	vcomKick();
+
+	vcomExitCritical(primask);
+	return count;
+}
+
+/* Read data received from the host */
+uint32_t vcom_bread(uint8_t *pBuf, uint32_t len)
+{
+	uint32_t primask, count;
+
+	count = RingBuffer_PopMult(&vcom.rxRing, pBuf, len);
+
+	/* Resume the OUT endpoint once a full buffer fits again */
+	if (vcom.rxStalled && (RingBuffer_GetFree(&vcom.rxRing) >= VCOM_RX_BUF_SIZE)) {
+		primask = vcomEnterCritical();
+		if (vcom.rxStalled && vcom.configured) {
+			vcom.rxStalled = false;
+			vcomQueueRead();
+		}
+		vcomExitCritical(primask);
+	}
+	return count;
+}
+
+/* Return the number of bytes vcom_write() accepts now */
+uint32_t vcom_write_free(void)
+{
+	uint32_t primask, count;
+
+	primask = vcomEnterCritical();
+	count = RingBuffer_GetFree(&vcom.txRing);
+	if (RingBuffer_IsEmpty(&vcom.txRing)) {
+		count += VCOM_TX_BUF_SIZE - vcom.txLen[vcom.txActive ^ 1];
+	}
+	vcomExitCritical(primask);
+	return count;
+}
+
+/* Return whether the host configured the device */
+bool vcom_connected(void)
+{
+	return vcom.configured;
+}
+
+/* Return the port statistics */
+const VCOM_STATS_T *vcom_stats(void)
+{
+	return &vcom.stats;
+}
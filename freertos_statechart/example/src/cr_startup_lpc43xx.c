@@ -44,6 +44,8 @@ extern "C" {
 #endif
 #endif
 
+#include "boot_time.h"
+
 #define WEAK __attribute__ ((weak))
 #define ALIAS(f) __attribute__ ((weak, alias (#f)))
 
@@ -58,6 +60,10 @@ extern "C" {
 extern void SystemInit(void);
 #endif
 
+// Boot timeline, declared in boot_time.h. Weak so that the startup code
+// still links without it.
+#pragma weak bootTime_markCycles
+
 //*****************************************************************************
 //
 // Forward declaration of the default handlers. These are aliased.
@@ -269,16 +275,42 @@ void (* const g_pfnVectors[])(void) = {
 void data_init(unsigned int romstart, unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
     unsigned int *pulSrc = (unsigned int*) romstart;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int *pulEnd = (unsigned int*) (start + (len & ~31U));
+
+    // Copy 8 words per iteration with LDM/STM bursts, then the
+    // remaining words one at a time
+    while (pulDest < pulEnd) {
+        __asm volatile ("ldmia %0!, {r3-r6}\n\t"
+                        "stmia %1!, {r3-r6}\n\t"
+                        "ldmia %0!, {r3-r6}\n\t"
+                        "stmia %1!, {r3-r6}"
+                        : "+r" (pulSrc), "+r" (pulDest)
+                        :
+                        : "r3", "r4", "r5", "r6", "memory");
+    }
+    for (len &= 31U; len != 0; len -= 4)
         *pulDest++ = *pulSrc++;
 }
 
 __attribute__ ((section(".after_vectors")))
 void bss_init(unsigned int start, unsigned int len) {
     unsigned int *pulDest = (unsigned int*) start;
-    unsigned int loop;
-    for (loop = 0; loop < len; loop = loop + 4)
+    unsigned int *pulEnd = (unsigned int*) (start + (len & ~31U));
+    register unsigned int zero0 __asm("r3") = 0;
+    register unsigned int zero1 __asm("r4") = 0;
+    register unsigned int zero2 __asm("r5") = 0;
+    register unsigned int zero3 __asm("r6") = 0;
+
+    // Clear 8 words per iteration with STM bursts, then the
+    // remaining words one at a time
+    while (pulDest < pulEnd) {
+        __asm volatile ("stmia %0!, {%1, %2, %3, %4}\n\t"
+                        "stmia %0!, {%1, %2, %3, %4}"
+                        : "+r" (pulDest)
+                        : "r" (zero0), "r" (zero1), "r" (zero2), "r" (zero3)
+                        : "memory");
+    }
+    for (len &= 31U; len != 0; len -= 4)
         *pulDest++ = 0;
 }
 
@@ -302,6 +334,21 @@ extern unsigned int __bss_section_table_end;
 //*****************************************************************************
 void ResetISR(void) {
 
+    // Start the DWT cycle counter, the boot timeline counts from here.
+    // CoreDebug->DEMCR @ 0xE000EDFC
+    // DWT->CTRL @ 0xE0001000
+    // DWT->CYCCNT @ 0xE0001004
+    volatile unsigned int *DEMCR = (unsigned int *) 0xE000EDFC;
+    volatile unsigned int *DWT_CTRL = (unsigned int *) 0xE0001000;
+    volatile unsigned int *DWT_CYCCNT = (unsigned int *) 0xE0001004;
+    unsigned int ClocksDone, DataDone, BssDone;
+
+    *DEMCR |= 0x01000000;
+    // TRCENA
+    *DWT_CYCCNT = 0;
+    *DWT_CTRL |= 0x00000001;
+    // CYCCNTENA
+
 // *************************************************************
 // The following conditional block of code manually resets as
 // much of the peripheral set of the LPC43 as possible. This is
@@ -355,6 +402,7 @@ void ResetISR(void) {
 #if defined (__USE_LPCOPEN)
     SystemInit();
 #endif
+    ClocksDone = *DWT_CYCCNT;
 
     //
     // Copy the data sections from flash to SRAM.
@@ -372,6 +420,7 @@ void ResetISR(void) {
         SectionLen = *SectionTableAddr++;
         data_init(LoadAddr, ExeAddr, SectionLen);
     }
+    DataDone = *DWT_CYCCNT;
     // At this point, SectionTableAddr = &__bss_section_table;
     // Zero fill the bss segment
     while (SectionTableAddr < &__bss_section_table_end) {
@@ -379,6 +428,18 @@ void ResetISR(void) {
         SectionLen = *SectionTableAddr++;
         bss_init(ExeAddr, SectionLen);
     }
+    BssDone = *DWT_CYCCNT;
+
+    // Hand the phases so far to the boot timeline, now that its
+    // variables are initialised. SystemInit() starts on the 12MHz IRC
+    // and switches to the PLL part way, so "clocks" is counted at 12MHz
+    // as an upper bound. The data and bss phases run at the final core
+    // clock.
+    if (bootTime_markCycles) {
+        bootTime_markCycles("clocks", ClocksDone, 12000000);
+        bootTime_markCycles("data", DataDone, 0);
+        bootTime_markCycles("bss", BssDone, 0);
+    }
 
 #if !defined (__USE_LPCOPEN)
 // LPCOpen init code deals with FP and VTOR initialisation
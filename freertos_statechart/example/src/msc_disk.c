@@ -0,0 +1,471 @@
+/*
+ * @brief SD card export over the ROM USB mass storage class driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "msc_disk.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Run buffer states */
+#define MSCDISK_EMPTY           0	/* Holds nothing */
+#define MSCDISK_READ            1	/* Read queued on the card, data valid once done */
+#define MSCDISK_FILL            2	/* Receiving write data from the host */
+#define MSCDISK_WRITE           3	/* Write queued on the card */
+
+/* Run buffer */
+typedef struct {
+	uint8_t *data;
+	SDBLK_REQ_T req;
+	uint32_t block;				/* First block of the run */
+	uint32_t count;				/* Blocks in the run */
+	uint32_t state;
+} MSCDISK_BUF_T;
+
+static MSCDISK_BUF_T mscBuf[2];
+static MSCDISK_BUF_T *mscCur;		/* Buffer the last read was served from */
+static MSCDISK_BUF_T *mscFill;		/* Buffer receiving write data, or NULL */
+static uint32_t mscFillBytes;		/* Bytes received into mscFill */
+static uint32_t mscNextFill;		/* Buffer to fill next, fills alternate */
+static uint32_t mscBlockCount;
+static MSCDISK_CALLBACK_T mscDoneCb;
+static MSCDISK_CALLBACK_T mscWaitCb;
+static volatile bool mscActive;		/* Host activity since the last poll */
+static MSCDISK_STATS_T mscStats;
+
+/* Vendor (8), product (16) and revision (4) reported to SCSI INQUIRY */
+static const uint8_t mscInquiry[28 + 1] = "NXP     LPC43xx SD Card 1.0 ";
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t mscEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void mscExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+STATIC INLINE MSCDISK_BUF_T *mscOther(MSCDISK_BUF_T *pBuf)
+{
+	return (pBuf == &mscBuf[0]) ? &mscBuf[1] : &mscBuf[0];
+}
+
+STATIC INLINE uint64_t mscPos(uint32_t offset, uint32_t high_offset)
+{
+	return ((uint64_t) high_offset << 32) | offset;
+}
+
+/* Find the first interface descriptor of a class in a configuration descriptor */
+static USB_INTERFACE_DESCRIPTOR *mscFindIntfDesc(uint8_t *pDesc, uint32_t intfClass)
+{
+	USB_COMMON_DESCRIPTOR *pD;
+	USB_INTERFACE_DESCRIPTOR *pIntfDesc;
+
+	pD = (USB_COMMON_DESCRIPTOR *) pDesc;
+	while (pD->bLength) {
+		if (pD->bDescriptorType == USB_INTERFACE_DESCRIPTOR_TYPE) {
+			pIntfDesc = (USB_INTERFACE_DESCRIPTOR *) pD;
+			if (pIntfDesc->bInterfaceClass == intfClass) {
+				return pIntfDesc;
+			}
+		}
+		pD = (USB_COMMON_DESCRIPTOR *) ((uint8_t *) pD + pD->bLength);
+	}
+	return NULL;
+}
+
+/* Check whether the card request of a buffer is still running */
+static bool mscBusy(MSCDISK_BUF_T *pBuf)
+{
+	if ((pBuf->state != MSCDISK_READ) && (pBuf->state != MSCDISK_WRITE)) {
+		return false;
+	}
+	if (!Chip_SDBLK_IsDone(&pBuf->req)) {
+		return true;
+	}
+
+	/* Written runs and failed reads are not kept */
+	if ((pBuf->state == MSCDISK_WRITE) || (pBuf->req.status != SUCCESS)) {
+		if (pBuf->req.status != SUCCESS) {
+			mscStats.errors++;
+		}
+		pBuf->state = MSCDISK_EMPTY;
+	}
+	return false;
+}
+
+/* Card request completion, from the SDIO interrupt or the busy line poll */
+static void mscReqDone(SDBLK_REQ_T *pReq)
+{
+	if (mscDoneCb != NULL) {
+		mscDoneCb();
+	}
+}
+
+/* Wait for the card request of a buffer. Without a wait callback the
+   busy line is polled here, write requests cannot finish otherwise when
+   the stack runs from the USB interrupt. */
+static void mscWait(MSCDISK_BUF_T *pBuf)
+{
+	while (mscBusy(pBuf)) {
+		if (mscWaitCb != NULL) {
+			mscWaitCb();
+		}
+		else {
+			Chip_SDBLK_Poll();
+		}
+	}
+}
+
+/* Queue a read of the run starting at a block */
+static void mscStartRead(MSCDISK_BUF_T *pBuf, uint32_t block)
+{
+	pBuf->block = block;
+	pBuf->count = MIN(MSCDISK_RUN_BLOCKS, mscBlockCount - block);
+	Chip_SDBLK_SetupReq(&pBuf->req, pBuf->data, block, pBuf->count, false, mscReqDone, NULL);
+	if (Chip_SDBLK_Submit(&pBuf->req) == SUCCESS) {
+		pBuf->state = MSCDISK_READ;
+		mscStats.readRuns++;
+	}
+	else {
+		pBuf->state = MSCDISK_EMPTY;
+		mscStats.errors++;
+	}
+}
+
+/* Queue the whole blocks received into the fill buffer */
+static void mscFlushFill(void)
+{
+	MSCDISK_BUF_T *pBuf = mscFill;
+
+	if (pBuf == NULL) {
+		return;
+	}
+	mscFill = NULL;
+
+	pBuf->count = mscFillBytes / MMC_SECTOR_SIZE;
+	pBuf->state = MSCDISK_EMPTY;
+	if (pBuf->count > 0) {
+		Chip_SDBLK_SetupReq(&pBuf->req, pBuf->data, pBuf->block, pBuf->count, true, mscReqDone, NULL);
+		if (Chip_SDBLK_Submit(&pBuf->req) == SUCCESS) {
+			pBuf->state = MSCDISK_WRITE;
+			mscStats.writeRuns++;
+		}
+		else {
+			mscStats.errors++;
+		}
+	}
+}
+
+/* Return the run buffer holding a block once its data is valid, reading
+   the run from the card if no buffer holds it */
+static MSCDISK_BUF_T *mscLoad(uint32_t block)
+{
+	MSCDISK_BUF_T *pBuf;
+	int i;
+
+	for (i = 0; i < 2; i++) {
+		pBuf = &mscBuf[i];
+		if ((pBuf->state == MSCDISK_READ) && (block >= pBuf->block) &&
+			(block < (pBuf->block + pBuf->count))) {
+			break;
+		}
+	}
+
+	if (i == 2) {
+		/* Keep the buffer the USB endpoint may still send from */
+		pBuf = (mscCur == &mscBuf[0]) ? &mscBuf[1] : &mscBuf[0];
+		mscWait(pBuf);
+		mscStartRead(pBuf, block);
+	}
+	if (mscBusy(pBuf)) {
+		mscStats.readWaits++;
+		mscWait(pBuf);
+	}
+
+	return (pBuf->state == MSCDISK_READ) ? pBuf : NULL;
+}
+
+/* Read the run following a buffer into the other one while the host
+   receives this one */
+static void mscReadAhead(MSCDISK_BUF_T *pBuf)
+{
+	MSCDISK_BUF_T *pNext = mscOther(pBuf);
+	uint32_t block = pBuf->block + pBuf->count;
+
+	if ((block >= mscBlockCount) || mscBusy(pNext) ||
+		((pNext->state == MSCDISK_READ) && (pNext->block == block))) {
+		return;
+	}
+	mscStartRead(pNext, block);
+}
+
+/* Return where a write chunk is received, starting a new run if it does
+   not continue the one being filled */
+static uint8_t *mscFillAddr(uint64_t pos, uint32_t length)
+{
+	MSCDISK_BUF_T *pBuf = mscFill;
+	uint32_t block;
+
+	if ((pBuf != NULL) && (pos == (((uint64_t) pBuf->block * MMC_SECTOR_SIZE) + mscFillBytes)) &&
+		((mscFillBytes + length) <= (pBuf->count * MMC_SECTOR_SIZE))) {
+		return pBuf->data + mscFillBytes;
+	}
+	mscFlushFill();
+
+	block = (uint32_t) (pos / MMC_SECTOR_SIZE);
+	if (((pos % MMC_SECTOR_SIZE) != 0) || (length > MSCDISK_RUN_SIZE) || (block >= mscBlockCount) ||
+		(((uint64_t) (mscBlockCount - block) * MMC_SECTOR_SIZE) < length)) {
+		return NULL;
+	}
+
+	/* Runs alternate so the card programs one while the other fills */
+	pBuf = &mscBuf[mscNextFill];
+	mscNextFill ^= 1;
+	if (mscBusy(pBuf)) {
+		mscStats.writeWaits++;
+		mscWait(pBuf);
+	}
+
+	/* Data read ahead may be stale once this run is written */
+	if (mscOther(pBuf)->state == MSCDISK_READ) {
+		mscWait(mscOther(pBuf));
+		mscOther(pBuf)->state = MSCDISK_EMPTY;
+	}
+
+	pBuf->state = MSCDISK_FILL;
+	pBuf->block = block;
+	pBuf->count = MIN(MSCDISK_RUN_BLOCKS, mscBlockCount - block);
+	mscFill = pBuf;
+	mscFillBytes = 0;
+	return pBuf->data;
+}
+
+/* Host read callback, points the stack to the data in a run buffer */
+static void mscRead(uint32_t offset, uint8_t * *dst, uint32_t length, uint32_t high_offset)
+{
+	uint64_t pos = mscPos(offset, high_offset);
+	uint8_t *out = *dst;
+	MSCDISK_BUF_T *pBuf = NULL;
+	uint32_t skip, count;
+
+	mscActive = true;
+	mscStats.readBytes += length;
+	mscFlushFill();
+
+	while (length > 0) {
+		pBuf = mscLoad((uint32_t) (pos / MMC_SECTOR_SIZE));
+		if (pBuf == NULL) {
+			memset(out, 0, length);
+			return;
+		}
+		skip = (uint32_t) (pos - ((uint64_t) pBuf->block * MMC_SECTOR_SIZE));
+		count = MIN(length, (pBuf->count * MMC_SECTOR_SIZE) - skip);
+		mscCur = pBuf;
+
+		if ((count == length) && (out == *dst)) {
+			/* Zero copy, the endpoint sends from the run buffer */
+			*dst = pBuf->data + skip;
+		}
+		else {
+			memcpy(out, pBuf->data + skip, count);
+		}
+		pos += count;
+		out += count;
+		length -= count;
+	}
+
+	mscReadAhead(pBuf);
+}
+
+/* Host write buffer callback, receives the chunk straight into a run buffer */
+static void mscGetWriteBuf(uint32_t offset, uint8_t * *buff_adr, uint32_t length, uint32_t high_offset)
+{
+	uint8_t *addr;
+
+	addr = mscFillAddr(mscPos(offset, high_offset), length);
+	if (addr != NULL) {
+		*buff_adr = addr;
+	}
+}
+
+/* Host write callback, the chunk is already in place unless it was too large */
+static void mscWrite(uint32_t offset, uint8_t * *src, uint32_t length, uint32_t high_offset)
+{
+	uint64_t pos = mscPos(offset, high_offset);
+	const uint8_t *in = *src;
+	uint8_t *addr;
+	uint32_t count;
+
+	mscActive = true;
+	mscStats.writeBytes += length;
+
+	while (length > 0) {
+		count = MIN(length, MSCDISK_RUN_SIZE);
+		if ((mscFill != NULL) && (pos == (((uint64_t) mscFill->block * MMC_SECTOR_SIZE) + mscFillBytes))) {
+			count = MIN(count, (mscFill->count * MMC_SECTOR_SIZE) - mscFillBytes);
+		}
+		addr = mscFillAddr(pos, count);
+		if (addr == NULL) {
+			mscStats.errors++;
+			return;
+		}
+		if (addr != in) {
+			memcpy(addr, in, count);
+		}
+		mscFillBytes += count;
+		if (mscFillBytes == (mscFill->count * MMC_SECTOR_SIZE)) {
+			mscFlushFill();
+		}
+		pos += count;
+		in += count;
+		length -= count;
+	}
+}
+
+/* Host verify callback */
+static ErrorCode_t mscVerify(uint32_t offset, uint8_t buf[], uint32_t length, uint32_t high_offset)
+{
+	uint64_t pos = mscPos(offset, high_offset);
+	MSCDISK_BUF_T *pBuf;
+	uint32_t skip, count;
+
+	mscActive = true;
+	mscFlushFill();
+
+	while (length > 0) {
+		pBuf = mscLoad((uint32_t) (pos / MMC_SECTOR_SIZE));
+		if (pBuf == NULL) {
+			return ERR_FAILED;
+		}
+		skip = (uint32_t) (pos - ((uint64_t) pBuf->block * MMC_SECTOR_SIZE));
+		count = MIN(length, (pBuf->count * MMC_SECTOR_SIZE) - skip);
+		mscCur = pBuf;
+		if (memcmp(buf, pBuf->data + skip, count) != 0) {
+			return ERR_FAILED;
+		}
+		pos += count;
+		buf += count;
+		length -= count;
+	}
+	return LPC_OK;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the mass storage function */
+ErrorCode_t mscDisk_init(USBD_HANDLE_T hUsb, USB_CORE_DESCS_T *pDesc, USBD_API_INIT_PARAM_T *pUsbParam,
+						 const MSCDISK_CFG_T *pCfg)
+{
+	USBD_MSC_INIT_PARAM_T msc_param;
+	ErrorCode_t ret;
+
+	memset(mscBuf, 0, sizeof(mscBuf));
+	mscBuf[0].data = pCfg->buffers;
+	mscBuf[1].data = pCfg->buffers + MSCDISK_RUN_SIZE;
+	mscCur = NULL;
+	mscFill = NULL;
+	mscNextFill = 0;
+	mscBlockCount = pCfg->blockCount;
+	mscDoneCb = pCfg->doneCb;
+	mscWaitCb = pCfg->waitCb;
+	memset(&mscStats, 0, sizeof(mscStats));
+
+	memset(&msc_param, 0, sizeof(msc_param));
+	msc_param.mem_base = pUsbParam->mem_base;
+	msc_param.mem_size = pUsbParam->mem_size;
+	msc_param.InquiryStr = (uint8_t *) mscInquiry;
+	msc_param.BlockCount = pCfg->blockCount;
+	msc_param.BlockSize = MMC_SECTOR_SIZE;
+	msc_param.MemorySize64 = (uint64_t) pCfg->blockCount * MMC_SECTOR_SIZE;
+	msc_param.MemorySize = (msc_param.MemorySize64 > 0xFFFFFFFF) ? 0xFFFFFFFF : (uint32_t) msc_param.MemorySize64;
+	msc_param.intf_desc = (uint8_t *) mscFindIntfDesc(pDesc->high_speed_desc, USB_DEVICE_CLASS_STORAGE);
+	msc_param.MSC_Write = mscWrite;
+	msc_param.MSC_Read = mscRead;
+	msc_param.MSC_Verify = mscVerify;
+	msc_param.MSC_GetWriteBuf = mscGetWriteBuf;
+
+	ret = USBD_API->msc->init(hUsb, &msc_param);
+
+	/* Give the remaining memory back to the caller */
+	pUsbParam->mem_base = msc_param.mem_base;
+	pUsbParam->mem_size = msc_param.mem_size;
+	return ret;
+}
+
+/* Queue buffered write data once the host is idle */
+void mscDisk_poll(void)
+{
+	uint32_t primask;
+
+	primask = mscEnterCritical();
+	if (!mscActive && (mscFill != NULL) && ((mscFillBytes % MMC_SECTOR_SIZE) == 0)) {
+		mscFlushFill();
+	}
+	mscActive = false;
+	mscExitCritical(primask);
+}
+
+/* Write all buffered data and wait for the card */
+void mscDisk_flush(void)
+{
+	uint32_t primask;
+
+	primask = mscEnterCritical();
+	mscFlushFill();
+	mscExitCritical(primask);
+
+	mscWait(&mscBuf[0]);
+	mscWait(&mscBuf[1]);
+	mscBuf[0].state = MSCDISK_EMPTY;
+	mscBuf[1].state = MSCDISK_EMPTY;
+}
+
+/* Return the export statistics */
+const MSCDISK_STATS_T *mscDisk_stats(void)
+{
+	return &mscStats;
+}
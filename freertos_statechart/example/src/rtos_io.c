@@ -0,0 +1,1408 @@
+/*
+ * @brief FreeRTOS glue for the asynchronous chip drivers
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "rtos_io.h"
+#include "lpc_phy.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "cdc_vcom.h"
+#include "msc_disk.h"
+#include "lcd_st7565s.h"
+#include "telemetry.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Interrupt priority of the drivers, must allow FreeRTOS ISR calls */
+#define RTOS_IO_IRQ_PRIORITY    (configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY + 1)
+
+/* First of the two GPDMA channels of the AES engine. The LPC4337 has no
+   engine, LPC43Sxx parts can set a channel here instead of the software AES */
+#define RTOS_IO_AES_CHANNEL     AESSTREAM_SOFTWARE
+
+/* GPDMA channels shared through the channel manager */
+#if (RTOS_IO_AES_CHANNEL == AESSTREAM_SOFTWARE)
+#define RTOS_IO_DMA_CHANNELS    0xFF
+#else
+#define RTOS_IO_DMA_CHANNELS    (0xFF & ~(3 << RTOS_IO_AES_CHANNEL))
+#endif
+
+/* Serializes blocking memory requests and signals their completion */
+static SemaphoreHandle_t memMutex;
+static SemaphoreHandle_t memDone;
+
+/* DMA transaction queue of the LCD SSP, chip select is driven by SSEL and
+   the LCD command line by the transaction chip select value */
+static SSPDMA_HANDLE_T lcdSSP;
+static SemaphoreHandle_t sspMutex;
+static SemaphoreHandle_t sspDone;
+
+/* Display task, flushes the deferred LCD frame buffer once per frame period */
+static TaskHandle_t lcdTaskHandle;
+static TickType_t lcdFramePeriod;
+static SemaphoreHandle_t lcdFlushDone;
+
+/* Serializes blocking AES requests and signals their completion */
+static SemaphoreHandle_t aesMutex;
+static SemaphoreHandle_t aesDone;
+
+/* Serializes blocking SD requests and signals their completion. Until a
+   card is attached the SDIO interrupt goes to the application's handler. */
+static SemaphoreHandle_t sdMutex;
+static SemaphoreHandle_t sdDone;
+static void (*sdPreAttachIRQ)(void);
+static volatile bool sdAttached;
+
+/* SD block cache, buffers in AHB RAM to keep them off the CPU local RAM */
+#define RTOS_IO_SD_CACHE_LINES  32
+#define RTOS_IO_SD_STAGE_BLOCKS 8
+
+static SDCACHE_LINE_T sdCacheLines[RTOS_IO_SD_CACHE_LINES];
+static uint32_t sdCacheData[RTOS_IO_SD_CACHE_LINES][MMC_SECTOR_SIZE / 4] __attribute__ ((section(".bss.$RamAHB32")));
+static uint32_t sdCacheStage[RTOS_IO_SD_STAGE_BLOCKS][MMC_SECTOR_SIZE / 4] __attribute__ ((section(".bss.$RamAHB32")));
+static SemaphoreHandle_t sdCacheMutex;
+static uint32_t sdBlocks;
+static bool sdExported;
+
+/* Serializes blocking I2C batches and signals their completion */
+static SemaphoreHandle_t i2cMutex[I2C_NUM_INTERFACE];
+static SemaphoreHandle_t i2cDone[I2C_NUM_INTERFACE];
+
+/* Ethernet rings in the 16K AHB RAM, the SD cache fills the 32K one */
+#define RTOS_IO_ENET_TX_DESCS   16
+#define RTOS_IO_ENET_RX_DESCS   8
+
+static ENET_ENHTXDESC_T enetTxDescs[RTOS_IO_ENET_TX_DESCS] __attribute__ ((section(".bss.$RamAHB16")));
+static ENET_ENHRXDESC_T enetRxDescs[RTOS_IO_ENET_RX_DESCS] __attribute__ ((section(".bss.$RamAHB16")));
+static uint32_t enetRxBuffers[RTOS_IO_ENET_RX_DESCS][ENETRING_RX_BUFSIZE / 4] __attribute__ ((section(".bss.$RamAHB16")));
+static volatile bool enetReady;
+static SemaphoreHandle_t enetRxEvent;
+static SemaphoreHandle_t enetMutex;
+static SemaphoreHandle_t enetTxDone;
+
+/* HSADC stream blocks, 1024 samples each in the second local RAM */
+#define RTOS_IO_HSADC_BLOCKS        4
+#define RTOS_IO_HSADC_BLOCK_WORDS   512
+
+static uint32_t hsadcBlocks[RTOS_IO_HSADC_BLOCKS][RTOS_IO_HSADC_BLOCK_WORDS] __attribute__ ((section(".bss.$RamLoc40")));
+static SemaphoreHandle_t hsadcReady;
+
+/* Audio periods of 256 16-bit stereo frames, 16 ms at 16 kHz, next to the
+   HSADC blocks. Two periods per direction are in flight, two are slack. */
+#define RTOS_IO_AUDIO_PERIODS       4
+#define RTOS_IO_AUDIO_PERIOD_WORDS  256
+
+static uint32_t audioTxPeriods[RTOS_IO_AUDIO_PERIODS][RTOS_IO_AUDIO_PERIOD_WORDS] __attribute__ ((section(".bss.$RamLoc40")));
+static uint32_t audioRxPeriods[RTOS_IO_AUDIO_PERIODS][RTOS_IO_AUDIO_PERIOD_WORDS] __attribute__ ((section(".bss.$RamLoc40")));
+static SemaphoreHandle_t audioTxReady;
+static SemaphoreHandle_t audioRxReady;
+
+/* USB virtual COM port and SD card export, the ROM stack and the transfer
+   buffers are reached by the USB DMA */
+#define RTOS_IO_USB_TX_RING     8192
+#define RTOS_IO_USB_RX_RING     2048
+
+/* The USB interrupt only wakes the USB task, which runs the ROM stack so
+   that the SD card export can block while it waits for the card */
+#define RTOS_IO_USB_TASK_PRIORITY   (configMAX_PRIORITIES - 1)
+
+const USBD_API_T *g_pUsbApi;
+static USBD_HANDLE_T usbHandle;
+static uint8_t usbStackMem[USB_STACK_MEM_SIZE] __attribute__ ((section(".bss.$RamLoc40"), aligned(USB_STACK_MEM_ALIGN)));
+static uint8_t usbTxBuffers[2 * VCOM_TX_BUF_SIZE] __attribute__ ((section(".bss.$RamLoc40"), aligned(4)));
+static uint8_t usbRxBuffers[2 * VCOM_RX_BUF_SIZE] __attribute__ ((section(".bss.$RamLoc40"), aligned(4)));
+static uint8_t usbMscBuffers[2 * MSCDISK_RUN_SIZE] __attribute__ ((section(".bss.$RamLoc40"), aligned(4)));
+static uint8_t usbTxRing[RTOS_IO_USB_TX_RING];
+static uint8_t usbRxRing[RTOS_IO_USB_RX_RING];
+static SemaphoreHandle_t usbRxReady;
+static SemaphoreHandle_t usbEvent;
+static SemaphoreHandle_t usbMscDone;
+static SemaphoreHandle_t usbMutex;
+static TaskHandle_t usbTaskHandle;
+
+/* C_CAN0 receive ring and transmit queue */
+#define RTOS_IO_CAN_RX_RING     64
+#define RTOS_IO_CAN_TX_QUEUE    32
+
+static CCANQ_HANDLE_T canHandle;
+static CCAN_MSG_OBJ_T canRxRing[RTOS_IO_CAN_RX_RING];
+static CCANQ_TXENTRY_T canTxQueue[RTOS_IO_CAN_TX_QUEUE];
+static SemaphoreHandle_t canRxReady;
+
+/* Key-value store on the EEPROM, updates are programmed at the latest
+   after RTOS_IO_KV_FLUSH_MS */
+#define RTOS_IO_KV_FIRST_PAGE   0
+#define RTOS_IO_KV_PAGES        32
+#define RTOS_IO_KV_KEYS         64
+#define RTOS_IO_KV_FLUSH_MS     1000
+
+static EEKV_HANDLE_T kvStore;
+static EEKV_INDEX_T kvIndex[RTOS_IO_KV_KEYS];
+static SemaphoreHandle_t kvMutex;
+static TaskHandle_t kvTaskHandle;
+
+/* Firmware updater, programs the inactive flash bank from an idle priority
+   task. fwBusy is set while that task has work, the idle hook does not sleep
+   then. fwStep is given after each page program or sector erase. */
+static FWUPD_HANDLE_T fwUpdate;
+static SemaphoreHandle_t fwWork;
+static SemaphoreHandle_t fwStep;
+static TaskHandle_t fwTaskHandle;
+static volatile bool fwBusy;
+
+/* Mailbox to the M0APP core, one sending and one receiving task at a time */
+static IPCMBX_HANDLE_T ipcHandle;
+static SemaphoreHandle_t ipcTxMutex;
+static SemaphoreHandle_t ipcRxMutex;
+static SemaphoreHandle_t ipcTxReady;
+static SemaphoreHandle_t ipcRxReady;
+static bool ipcStarted;
+
+/* Binary telemetry on the debug UART, received bytes are kept for later use */
+#define RTOS_IO_TELEM_TX_RING   2048
+#define RTOS_IO_TELEM_RX_RING   64
+#define RTOS_IO_TELEM_RX_TRIG   UART_FCR_TRG_LEV3
+#define RTOS_IO_TELEM_TEXT_LINE 80
+
+#if defined(BOARD_EDU_CIAA_NXP)
+#define RTOS_IO_TELEM_IRQn      USART2_IRQn
+#define RTOS_IO_TELEM_IRQHandler UART2_IRQHandler
+#else
+#define RTOS_IO_TELEM_IRQn      USART0_IRQn
+#define RTOS_IO_TELEM_IRQHandler UART0_IRQHandler
+#endif
+
+static TELEM_HANDLE_T telem;
+static RINGBUFF_T telemTxRing;
+static RINGBUFF_T telemRxRing;
+static uint8_t telemTxBuf[RTOS_IO_TELEM_TX_RING];
+static uint8_t telemRxBuf[RTOS_IO_TELEM_RX_RING];
+static SemaphoreHandle_t telemMutex;
+static bool telemStarted;
+
+/* DEBUGOUT text collected for the next TELEMETRY_TEXT record */
+static char telemText[RTOS_IO_TELEM_TEXT_LINE];
+static uint32_t telemTextLen;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Wake the task waiting on a request, from ISR or CPU completion */
+static void rtosIOGiveFromCallback(SemaphoreHandle_t sem)
+{
+	BaseType_t woken = pdFALSE;
+
+	/* The USB stack calls back from the USB task */
+	if (__get_IPSR() == 0) {
+		xSemaphoreGive(sem);
+		return;
+	}
+
+	xSemaphoreGiveFromISR(sem, &woken);
+	portEND_SWITCHING_ISR(woken);
+}
+
+static void memReqDone(GPDMAMEM_REQ_T *pReq)
+{
+	rtosIOGiveFromCallback((SemaphoreHandle_t) pReq->cbData);
+}
+
+static void sspXferDone(SSPDMA_XFER_T *pXfer)
+{
+	rtosIOGiveFromCallback((SemaphoreHandle_t) pXfer->cbData);
+}
+
+static void aesReqDone(AESSTREAM_REQ_T *pReq)
+{
+	rtosIOGiveFromCallback((SemaphoreHandle_t) pReq->cbData);
+}
+
+/* Wait handler of the queued I2C buses, Chip_I2C_MasterQueueWait() sleeps
+   here and the transfer completion wakes it from the interrupt */
+static void i2cQueueWait(I2C_ID_T id, I2C_EVENT_T event)
+{
+	/* Before the scheduler starts, creating the RTOS objects has left
+	   BASEPRI at configMAX_SYSCALL_INTERRUPT_PRIORITY, which masks the I2C
+	   interrupt. The wait then runs the state machine itself. */
+	if (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING) {
+		if (event == I2C_EVENT_WAIT) {
+			Chip_I2C_MasterQueuePoll(id);
+		}
+		return;
+	}
+
+	switch (event) {
+	case I2C_EVENT_LOCK:
+		xSemaphoreTake(i2cMutex[id], portMAX_DELAY);
+		break;
+
+	case I2C_EVENT_UNLOCK:
+		xSemaphoreGive(i2cMutex[id]);
+		break;
+
+	case I2C_EVENT_WAIT:
+		xSemaphoreTake(i2cDone[id], portMAX_DELAY);
+		break;
+
+	case I2C_EVENT_DONE:
+		rtosIOGiveFromCallback(i2cDone[id]);
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void sdReqDone(SDBLK_REQ_T *pReq)
+{
+	rtosIOGiveFromCallback((SemaphoreHandle_t) pReq->cbData);
+}
+
+static void enetRxReady(void)
+{
+	rtosIOGiveFromCallback(enetRxEvent);
+}
+
+static void enetFrameSent(void *cbData, Status status)
+{
+	*(Status *) cbData = status;
+	rtosIOGiveFromCallback(enetTxDone);
+}
+
+static void hsadcBlockReady(void)
+{
+	rtosIOGiveFromCallback(hsadcReady);
+}
+
+static void audioTxPeriodFree(void)
+{
+	rtosIOGiveFromCallback(audioTxReady);
+}
+
+static void audioRxPeriodFull(void)
+{
+	rtosIOGiveFromCallback(audioRxReady);
+}
+
+static void usbRxData(void)
+{
+	rtosIOGiveFromCallback(usbRxReady);
+}
+
+static void usbMscCardDone(void)
+{
+	rtosIOGiveFromCallback(usbMscDone);
+}
+
+/* The card request finishes from the SDIO interrupt, or from the busy line
+   poll in the tick */
+static void usbMscCardWait(void)
+{
+	xSemaphoreTake(usbMscDone, portMAX_DELAY);
+}
+
+static void canRxData(void)
+{
+	rtosIOGiveFromCallback(canRxReady);
+}
+
+/* Initialize the ROM USB stack and connect, with the SD card export when
+   exportSD is set */
+static Status usbStackInit(bool exportSD)
+{
+	USBD_API_INIT_PARAM_T usb_param;
+	USB_CORE_DESCS_T desc;
+	VCOM_CFG_T cfg;
+	MSCDISK_CFG_T mscCfg;
+
+	memset(&usb_param, 0, sizeof(usb_param));
+	usb_param.usb_reg_base = LPC_USB0_BASE;
+	usb_param.max_num_ep = 4;
+	usb_param.mem_base = (uint32_t) usbStackMem;
+	usb_param.mem_size = sizeof(usbStackMem);
+	usb_param.USB_Reset_Event = vcom_reset_event;
+	usb_param.USB_Configure_Event = vcom_configure_event;
+
+	desc.device_desc = (uint8_t *) USB_DeviceDescriptor;
+	desc.string_desc = (uint8_t *) USB_StringDescriptor;
+	desc.high_speed_desc = exportSD ? USB_HsMscConfigDescriptor : USB_HsConfigDescriptor;
+	desc.full_speed_desc = exportSD ? USB_FsMscConfigDescriptor : USB_FsConfigDescriptor;
+	desc.device_qualifier = (uint8_t *) USB_DeviceQualifier;
+	if (USBD_API->hw->Init(&usbHandle, &desc, &usb_param) != LPC_OK) {
+		return ERROR;
+	}
+
+	cfg.txRing = usbTxRing;
+	cfg.txRingSize = sizeof(usbTxRing);
+	cfg.rxRing = usbRxRing;
+	cfg.rxRingSize = sizeof(usbRxRing);
+	cfg.txBuffers = usbTxBuffers;
+	cfg.rxBuffers = usbRxBuffers;
+	cfg.txCb = NULL;
+	cfg.rxCb = usbRxData;
+	if (vcom_init(usbHandle, &desc, &usb_param, &cfg) != LPC_OK) {
+		return ERROR;
+	}
+
+	if (exportSD) {
+		mscCfg.buffers = usbMscBuffers;
+		mscCfg.blockCount = sdBlocks;
+		mscCfg.doneCb = usbMscCardDone;
+		mscCfg.waitCb = usbMscCardWait;
+		if (mscDisk_init(usbHandle, &desc, &usb_param, &mscCfg) != LPC_OK) {
+			return ERROR;
+		}
+	}
+
+	NVIC_SetPriority(USB0_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(USB0_IRQn);
+	USBD_API->hw->Connect(usbHandle, 1);
+	return SUCCESS;
+}
+
+/* Run the ROM device stack for the USB interrupt. While the SD card is
+   exported, also write the last run of a host write once the host goes idle. */
+static void usbTask(void *pvParameters)
+{
+	TickType_t pollTick = xTaskGetTickCount();
+
+	while (1) {
+		if (xSemaphoreTake(usbEvent, sdExported ? 1 : portMAX_DELAY) == pdTRUE) {
+			xSemaphoreTake(usbMutex, portMAX_DELAY);
+			USBD_API->hw->ISR(usbHandle);
+			NVIC_EnableIRQ(USB0_IRQn);
+			xSemaphoreGive(usbMutex);
+		}
+
+		if (sdExported && (xTaskGetTickCount() != pollTick)) {
+			pollTick = xTaskGetTickCount();
+			xSemaphoreTake(usbMutex, portMAX_DELAY);
+			mscDisk_poll();
+			xSemaphoreGive(usbMutex);
+		}
+	}
+}
+
+/* Send the frame buffer changes at most once per frame period */
+static void lcdTask(void *pvParameters)
+{
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t bytes;
+
+	while (1) {
+		vTaskDelayUntil(&wake, lcdFramePeriod);
+
+		/* Keep drawing tasks out while the changes are collected */
+		vTaskSuspendAll();
+		bytes = LCD_FlushAsync(&lcdSSP, sspXferDone, lcdFlushDone);
+		xTaskResumeAll();
+
+		if (bytes) {
+			xSemaphoreTake(lcdFlushDone, portMAX_DELAY);
+		}
+	}
+}
+
+/* Program the buffered key-value updates once they are old enough */
+static void kvTask(void *pvParameters)
+{
+	while (1) {
+		vTaskDelay((RTOS_IO_KV_FLUSH_MS / 4) / portTICK_PERIOD_MS);
+
+		xSemaphoreTake(kvMutex, portMAX_DELAY);
+		Chip_EEKV_Poll(&kvStore, xTaskGetTickCount() * portTICK_PERIOD_MS);
+		xSemaphoreGive(kvMutex);
+	}
+}
+
+/* Run the flash operations of the firmware update, sleeping when idle */
+static void fwTask(void *pvParameters)
+{
+	while (1) {
+		if (Chip_FWUPD_Poll(&fwUpdate)) {
+			/* A page buffer may be free or the update may have ended */
+			xSemaphoreGive(fwStep);
+		}
+		else {
+			fwBusy = false;
+			xSemaphoreTake(fwWork, portMAX_DELAY);
+			fwBusy = true;
+		}
+	}
+}
+
+/* Hand new work to the firmware task */
+static void fwKick(void)
+{
+	fwBusy = true;
+	xSemaphoreGive(fwWork);
+}
+
+/* Debug output once the telemetry owns the debug UART, each line goes out
+   as a text record between the other records. Text from an interrupt or
+   with the scheduler suspended cannot wait for the mutex and is dropped. */
+static void telemPutChar(char ch)
+{
+	if ((__get_IPSR() != 0) || (xTaskGetSchedulerState() != taskSCHEDULER_RUNNING)) {
+		return;
+	}
+
+	xSemaphoreTake(telemMutex, portMAX_DELAY);
+	telemText[telemTextLen++] = ch;
+	if ((ch == '\n') || (telemTextLen == RTOS_IO_TELEM_TEXT_LINE)) {
+		Chip_TELEM_Send(&telem, TELEMETRY_TEXT, telemText, telemTextLen);
+		telemTextLen = 0;
+	}
+	xSemaphoreGive(telemMutex);
+}
+
+static void enetDelayMs(uint32_t ms)
+{
+	vTaskDelay((ms + portTICK_PERIOD_MS - 1) / portTICK_PERIOD_MS);
+}
+
+static Status memSubmitAndWait(GPDMAMEM_REQ_T *pReq)
+{
+	Status status;
+
+	xSemaphoreTake(memMutex, portMAX_DELAY);
+	status = Chip_GPDMAMEM_Submit(pReq);
+	if (status == SUCCESS) {
+		/* The callback gives the semaphore exactly once per request */
+		xSemaphoreTake(memDone, portMAX_DELAY);
+		status = pReq->status;
+	}
+	xSemaphoreGive(memMutex);
+
+	return status;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* GPDMA interrupt handler, shared by all channels */
+void DMA_IRQHandler(void)
+{
+	Chip_GPDMAMGR_IRQHandler(LPC_GPDMA);
+	Chip_AESSTREAM_Poll();
+}
+
+/* I2C interrupt handlers, the queued master state machine runs here */
+void I2C0_IRQHandler(void)
+{
+	Chip_I2C_MasterStateHandler(I2C0);
+}
+
+void I2C1_IRQHandler(void)
+{
+	Chip_I2C_MasterStateHandler(I2C1);
+}
+
+/* SDIO interrupt handler, owned by the block driver once attached */
+void SDIO_IRQHandler(void)
+{
+	if (sdAttached) {
+		Chip_SDBLK_IRQHandler();
+	}
+	else if (sdPreAttachIRQ) {
+		sdPreAttachIRQ();
+	}
+	else {
+		/* Nobody waits for it, keep it from firing again */
+		NVIC_DisableIRQ(SDIO_IRQn);
+	}
+}
+
+/* Ethernet interrupt handler, owned by the descriptor ring driver */
+void ETH_IRQHandler(void)
+{
+	Chip_ENETRING_IRQHandler();
+}
+
+/* USB0 interrupt handler, the USB task runs the ROM device stack and
+   enables the interrupt again */
+void USB0_IRQHandler(void)
+{
+	NVIC_DisableIRQ(USB0_IRQn);
+	rtosIOGiveFromCallback(usbEvent);
+}
+
+/* C_CAN0 interrupt handler, owned by the interrupt driven C_CAN driver */
+void CAN0_IRQHandler(void)
+{
+	Chip_CCANQ_IRQHandler(&canHandle);
+}
+
+/* IPC interrupt from the M0APP core, raised by the mailbox doorbell */
+void M0APP_IRQHandler(void)
+{
+	uint32_t events = Chip_IPCMBX_IRQHandler(&ipcHandle);
+
+	if (events & IPCMBX_EVENT_RX) {
+		rtosIOGiveFromCallback(ipcRxReady);
+	}
+	if (events & IPCMBX_EVENT_TX) {
+		rtosIOGiveFromCallback(ipcTxReady);
+	}
+}
+
+/* Debug UART interrupt handler, owned by the telemetry once started */
+void RTOS_IO_TELEM_IRQHandler(void)
+{
+	Chip_UART_IRQRBFIFOHandler(DEBUG_UART, &telemRxRing, &telemTxRing, RTOS_IO_TELEM_RX_TRIG);
+}
+
+/* FreeRTOS idle hook, replaces the weak one that always sleeps. The idle
+   task runs the hook after yielding to the firmware task, sleeping there
+   would take every other time slice from a running update. */
+void vApplicationIdleHook(void)
+{
+	if (!fwBusy) {
+		__WFI();
+	}
+}
+
+/* Initialize the asynchronous drivers and their interrupts */
+void RTOS_IO_Init(void)
+{
+	I2C_ID_T id;
+
+	memMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(memDone);
+	xSemaphoreTake(memDone, 0);
+	sspMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(sspDone);
+	xSemaphoreTake(sspDone, 0);
+	vSemaphoreCreateBinary(lcdFlushDone);
+	xSemaphoreTake(lcdFlushDone, 0);
+	aesMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(aesDone);
+	xSemaphoreTake(aesDone, 0);
+	sdMutex = xSemaphoreCreateMutex();
+	sdCacheMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(sdDone);
+	xSemaphoreTake(sdDone, 0);
+	vSemaphoreCreateBinary(hsadcReady);
+	xSemaphoreTake(hsadcReady, 0);
+	vSemaphoreCreateBinary(audioTxReady);
+	xSemaphoreTake(audioTxReady, 0);
+	vSemaphoreCreateBinary(audioRxReady);
+	xSemaphoreTake(audioRxReady, 0);
+	vSemaphoreCreateBinary(usbRxReady);
+	xSemaphoreTake(usbRxReady, 0);
+	vSemaphoreCreateBinary(usbEvent);
+	xSemaphoreTake(usbEvent, 0);
+	vSemaphoreCreateBinary(usbMscDone);
+	xSemaphoreTake(usbMscDone, 0);
+	usbMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(canRxReady);
+	xSemaphoreTake(canRxReady, 0);
+	kvMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(fwWork);
+	xSemaphoreTake(fwWork, 0);
+	vSemaphoreCreateBinary(fwStep);
+	xSemaphoreTake(fwStep, 0);
+	ipcTxMutex = xSemaphoreCreateMutex();
+	ipcRxMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(ipcTxReady);
+	xSemaphoreTake(ipcTxReady, 0);
+	vSemaphoreCreateBinary(ipcRxReady);
+	xSemaphoreTake(ipcRxReady, 0);
+	telemMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(enetRxEvent);
+	xSemaphoreTake(enetRxEvent, 0);
+	enetMutex = xSemaphoreCreateMutex();
+	vSemaphoreCreateBinary(enetTxDone);
+	xSemaphoreTake(enetTxDone, 0);
+	for (id = I2C0; id < I2C_NUM_INTERFACE; id++) {
+		i2cMutex[id] = xSemaphoreCreateMutex();
+		vSemaphoreCreateBinary(i2cDone[id]);
+		xSemaphoreTake(i2cDone[id], 0);
+	}
+
+	Chip_GPDMA_Init(LPC_GPDMA);
+	Chip_GPDMAMGR_Init(LPC_GPDMA, RTOS_IO_DMA_CHANNELS);
+	Chip_GPDMAMEM_Init();
+	if (Chip_AESSTREAM_Init(RTOS_IO_AES_CHANNEL) != SUCCESS) {
+		Chip_AESSTREAM_Init(AESSTREAM_SOFTWARE);
+	}
+	Chip_SSPDMA_Init(&lcdSSP, LCD_SSP, GPDMAMGR_PRIO_NORMAL, Board_LCD_XferSelect);
+	NVIC_SetPriority(DMA_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(DMA_IRQn);
+
+	/* The I2C buses are queued, drivers call Chip_I2C_Init() when used */
+	Chip_I2C_MasterQueueInit(I2C0);
+	Chip_I2C_MasterQueueInit(I2C1);
+	Chip_I2C_SetQueueWaitHandler(I2C0, i2cQueueWait);
+	Chip_I2C_SetQueueWaitHandler(I2C1, i2cQueueWait);
+	NVIC_SetPriority(I2C0_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_SetPriority(I2C1_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(I2C0_IRQn);
+	NVIC_EnableIRQ(I2C1_IRQn);
+}
+
+/* Advance the drivers that wait on timed conditions, called every tick */
+void RTOS_IO_Tick(void)
+{
+	uint32_t physts;
+
+	/* The SD card busy line is checked here instead of spinning */
+	Chip_SDBLK_Poll();
+
+	/* Finishes AES chunks when the ROM runs its channels without interrupts */
+	Chip_AESSTREAM_Poll();
+
+	/* The PHY state machine runs one MII access per call */
+	if (enetReady) {
+		physts = lpcPHYStsPoll();
+		if (physts & PHY_LINK_CHANGED) {
+			Chip_ENETRING_SetLink((physts & PHY_LINK_CONNECTED) != 0,
+								  (physts & PHY_LINK_SPEED100) != 0,
+								  (physts & PHY_LINK_FULLDUPLX) != 0);
+		}
+	}
+}
+
+/* Bring up the Ethernet MAC, PHY and descriptor rings */
+Status RTOS_IO_ENETInit(void)
+{
+	ENETRING_CFG_T cfg;
+	uint8_t macAddr[6];
+
+	Chip_ENET_Init(LPC_ETHERNET, BOARD_ENET_PHY_ADDR);
+	Board_ENET_GetMacADDR(macAddr);
+	Chip_ENET_SetADDR(LPC_ETHERNET, macAddr);
+	if (lpc_phy_init(true, enetDelayMs) & PHY_LINK_ERROR) {
+		return ERROR;
+	}
+
+	cfg.txDescs = enetTxDescs;
+	cfg.numTx = RTOS_IO_ENET_TX_DESCS;
+	cfg.rxDescs = enetRxDescs;
+	cfg.rxBuffers = enetRxBuffers[0];
+	cfg.numRx = RTOS_IO_ENET_RX_DESCS;
+	cfg.rxEvent = enetRxReady;
+	if (Chip_ENETRING_Init(LPC_ETHERNET, &cfg) != SUCCESS) {
+		return ERROR;
+	}
+
+	NVIC_SetPriority(ETHERNET_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(ETHERNET_IRQn);
+	enetReady = true;
+	return SUCCESS;
+}
+
+/* Wait for a received Ethernet frame */
+bool RTOS_IO_ENETReceive(ENETRING_RXFRAME_T *pFrame, uint32_t waitMs)
+{
+	while (1) {
+		if (Chip_ENETRING_Receive(pFrame)) {
+			return true;
+		}
+
+		/* The ring is empty, sleep until the next receive interrupt */
+		if (Chip_ENETRING_EnableRXInt()) {
+			if (xSemaphoreTake(enetRxEvent, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+				return false;
+			}
+		}
+	}
+}
+
+/* Send an Ethernet frame, blocking the calling task until it is sent */
+Status RTOS_IO_ENETSend(const ENETRING_SEG_T *pSegs, uint32_t numSegs)
+{
+	Status status, sent = ERROR;
+
+	xSemaphoreTake(enetMutex, portMAX_DELAY);
+	status = Chip_ENETRING_Send(pSegs, numSegs, enetFrameSent, &sent);
+	if (status == SUCCESS) {
+		xSemaphoreTake(enetTxDone, portMAX_DELAY);
+		status = sent;
+	}
+	xSemaphoreGive(enetMutex);
+
+	return status;
+}
+
+/* Set the SDIO interrupt handler used until a card is attached */
+void RTOS_IO_SetSDIOHandler(void (*handler)(void))
+{
+	sdPreAttachIRQ = handler;
+}
+
+/* Hand an acquired SD card over to the asynchronous block driver */
+Status RTOS_IO_SDAttach(LPC_SDMMC_T *pSDMMC, mci_card_struct *pCard)
+{
+	if (Chip_SDBLK_Init(pSDMMC, pCard) != SUCCESS) {
+		return ERROR;
+	}
+
+	sdBlocks = Chip_SDMMC_GetDeviceBlocks(pSDMMC);
+	Chip_SDCACHE_Init(sdCacheLines, sdCacheData, RTOS_IO_SD_CACHE_LINES, sdCacheStage,
+					  RTOS_IO_SD_STAGE_BLOCKS, sdBlocks, RTOS_IO_SDTransfer);
+
+	sdAttached = true;
+	NVIC_SetPriority(SDIO_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(SDIO_IRQn);
+	return SUCCESS;
+}
+
+/* Run an SD block transfer, blocking the calling task until done */
+Status RTOS_IO_SDTransfer(void *buffer, uint32_t block, uint32_t count, bool write)
+{
+	SDBLK_REQ_T req;
+	Status status;
+
+	if (sdExported) {
+		return ERROR;
+	}
+	Chip_SDBLK_SetupReq(&req, buffer, block, count, write, sdReqDone, sdDone);
+
+	xSemaphoreTake(sdMutex, portMAX_DELAY);
+	status = Chip_SDBLK_Submit(&req);
+	if (status == SUCCESS) {
+		xSemaphoreTake(sdDone, portMAX_DELAY);
+		status = req.status;
+	}
+	xSemaphoreGive(sdMutex);
+
+	return status;
+}
+
+/* Read blocks from the SD card, blocking the calling task until done */
+Status RTOS_IO_SDRead(void *buffer, uint32_t block, uint32_t count)
+{
+	Status status;
+
+	xSemaphoreTake(sdCacheMutex, portMAX_DELAY);
+	status = sdExported ? ERROR : Chip_SDCACHE_Read(buffer, block, count);
+	xSemaphoreGive(sdCacheMutex);
+
+	return status;
+}
+
+/* Write blocks to the SD card through the cache */
+Status RTOS_IO_SDWrite(const void *buffer, uint32_t block, uint32_t count)
+{
+	Status status;
+
+	xSemaphoreTake(sdCacheMutex, portMAX_DELAY);
+	status = sdExported ? ERROR : Chip_SDCACHE_Write(buffer, block, count);
+	xSemaphoreGive(sdCacheMutex);
+
+	return status;
+}
+
+/* Write all cached SD blocks back to the card */
+Status RTOS_IO_SDFlush(void)
+{
+	Status status;
+
+	xSemaphoreTake(sdCacheMutex, portMAX_DELAY);
+	status = sdExported ? ERROR : Chip_SDCACHE_Flush();
+	xSemaphoreGive(sdCacheMutex);
+
+	return status;
+}
+
+/* Start streaming the HSADC FIFO into blocks */
+Status RTOS_IO_HSADCStart(void)
+{
+	if (Chip_HSADCDMA_Init(LPC_ADCHS, hsadcBlocks[0], RTOS_IO_HSADC_BLOCK_WORDS,
+						   RTOS_IO_HSADC_BLOCKS, hsadcBlockReady) != SUCCESS) {
+		return ERROR;
+	}
+	return Chip_HSADCDMA_Start();
+}
+
+/* Wait for the next full HSADC block */
+uint32_t *RTOS_IO_HSADCGetBlock(uint32_t waitMs, uint32_t *pSeq)
+{
+	uint32_t *block;
+
+	while ((block = Chip_HSADCDMA_GetBlock(pSeq)) == NULL) {
+		if (xSemaphoreTake(hsadcReady, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+			break;
+		}
+	}
+
+	return block;
+}
+
+/* Start full-duplex audio streaming through the WM8904 codec */
+Status RTOS_IO_AudioStart(void)
+{
+	I2S_AUDIO_FORMAT_T format;
+	I2SDMA_CFG_T cfg;
+
+	format.SampleRate = AUDCFG_SAMPLE_RATE;
+	format.ChannelNumber = 2;
+	format.WordWidth = 16;
+
+	/* The codec is the clock master, the receiver shares the transmit
+	   bit clock and word select pins */
+	Chip_I2S_Init(LPC_I2S1);
+	if ((Chip_I2S_TxConfig(LPC_I2S1, &format) != SUCCESS) ||
+		(Chip_I2S_RxConfig(LPC_I2S1, &format) != SUCCESS)) {
+		return ERROR;
+	}
+	Chip_I2S_RxModeConfig(LPC_I2S1, I2S_RXMODE_CLKSEL(0), I2S_RXMODE_4PIN_ENABLE, 0);
+	Chip_I2S_TxSlave(LPC_I2S1);
+	Chip_I2S_RxSlave(LPC_I2S1);
+	Chip_I2S_TxStop(LPC_I2S1);
+	Chip_I2S_RxStop(LPC_I2S1);
+	Board_Audio_Init(LPC_I2S1, CODEC_LINE_IN);
+
+	cfg.txBuffers = audioTxPeriods[0];
+	cfg.rxBuffers = audioRxPeriods[0];
+	cfg.periodWords = RTOS_IO_AUDIO_PERIOD_WORDS;
+	cfg.numPeriods = RTOS_IO_AUDIO_PERIODS;
+	cfg.txCb = audioTxPeriodFree;
+	cfg.rxCb = audioRxPeriodFull;
+	if (Chip_I2SDMA_Init(LPC_I2S1, &cfg) != SUCCESS) {
+		return ERROR;
+	}
+	return Chip_I2SDMA_Start();
+}
+
+/* Wait for an empty audio period to fill */
+uint32_t *RTOS_IO_AudioGetTxPeriod(uint32_t waitMs)
+{
+	uint32_t *period;
+
+	while ((period = Chip_I2SDMA_GetTxPeriod()) == NULL) {
+		if (xSemaphoreTake(audioTxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+			break;
+		}
+	}
+
+	return period;
+}
+
+/* Wait for the next received audio period */
+uint32_t *RTOS_IO_AudioGetRxPeriod(uint32_t waitMs)
+{
+	uint32_t *period;
+
+	while ((period = Chip_I2SDMA_GetRxPeriod()) == NULL) {
+		if (xSemaphoreTake(audioRxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+			break;
+		}
+	}
+
+	return period;
+}
+
+/* Start the USB virtual COM port and connect to the host */
+Status RTOS_IO_USBStart(void)
+{
+	if (usbTaskHandle) {
+		return ERROR;
+	}
+
+	Chip_USB0_Init();
+	g_pUsbApi = (const USBD_API_T *) LPC_ROM_API->usbdApiBase;
+
+	if (xTaskCreate(usbTask, "vTaskUSB", configMINIMAL_STACK_SIZE * 2, NULL,
+					RTOS_IO_USB_TASK_PRIORITY, &usbTaskHandle) != pdPASS) {
+		return ERROR;
+	}
+
+	return usbStackInit(false);
+}
+
+/* Export the SD card to the USB host or take it back */
+Status RTOS_IO_USBExportSD(bool exportSD)
+{
+	Status status;
+
+	if (g_pUsbApi == NULL) {
+		return ERROR;
+	}
+
+	xSemaphoreTake(sdCacheMutex, portMAX_DELAY);
+	if (exportSD == sdExported) {
+		xSemaphoreGive(sdCacheMutex);
+		return SUCCESS;
+	}
+
+	if (exportSD) {
+		/* The host sees the card as written by the tasks so far */
+		if ((sdBlocks == 0) || (Chip_SDCACHE_Flush() != SUCCESS)) {
+			xSemaphoreGive(sdCacheMutex);
+			return ERROR;
+		}
+		Chip_SDCACHE_Invalidate();
+		sdExported = true;
+	}
+
+	/* The device enumerates again with or without the mass storage interface */
+	xSemaphoreTake(usbMutex, portMAX_DELAY);
+	USBD_API->hw->Connect(usbHandle, 0);
+	NVIC_DisableIRQ(USB0_IRQn);
+	if (!exportSD) {
+		mscDisk_flush();
+		Chip_SDCACHE_Invalidate();
+		sdExported = false;
+	}
+	status = usbStackInit(exportSD);
+	xSemaphoreGive(usbMutex);
+
+	xSemaphoreGive(sdCacheMutex);
+	return status;
+}
+
+/* Send data on the USB virtual COM port without blocking */
+uint32_t RTOS_IO_USBWrite(const void *data, uint32_t len)
+{
+	return vcom_write((const uint8_t *) data, len);
+}
+
+/* Read data from the USB virtual COM port, waiting for some to arrive */
+uint32_t RTOS_IO_USBRead(void *buffer, uint32_t len, uint32_t waitMs)
+{
+	uint32_t count;
+
+	while ((count = vcom_bread((uint8_t *) buffer, len)) == 0) {
+		if (xSemaphoreTake(usbRxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+			break;
+		}
+	}
+
+	return count;
+}
+
+/* Start C_CAN0 with the interrupt driven driver */
+Status RTOS_IO_CANStart(uint32_t bitRate)
+{
+	CCANQ_CFG_T cfg;
+
+	Chip_CCAN_Init(LPC_C_CAN0);
+	if (Chip_CCAN_SetBitRate(LPC_C_CAN0, bitRate) != SUCCESS) {
+		return ERROR;
+	}
+
+	cfg.rxRing = canRxRing;
+	cfg.rxRingSize = RTOS_IO_CAN_RX_RING;
+	cfg.txQueue = canTxQueue;
+	cfg.txQueueSize = RTOS_IO_CAN_TX_QUEUE;
+	cfg.rxEvent = canRxData;
+	if (Chip_CCANQ_Init(&canHandle, LPC_C_CAN0, &cfg) != SUCCESS) {
+		return ERROR;
+	}
+
+	NVIC_SetPriority(C_CAN0_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(C_CAN0_IRQn);
+	return SUCCESS;
+}
+
+/* Accept frames matching a filter on C_CAN0 */
+uint8_t RTOS_IO_CANAddFilter(uint32_t id, uint32_t mask, uint32_t depth)
+{
+	return Chip_CCANQ_AddFilter(&canHandle, id, mask, depth);
+}
+
+/* Queue a frame for transmission on C_CAN0 */
+Status RTOS_IO_CANSend(const CCAN_MSG_OBJ_T *pMsg)
+{
+	return Chip_CCANQ_Send(&canHandle, pMsg);
+}
+
+/* Wait for a frame received on C_CAN0 */
+bool RTOS_IO_CANReceive(CCAN_MSG_OBJ_T *pMsg, uint32_t waitMs)
+{
+	while (!Chip_CCANQ_Receive(&canHandle, pMsg)) {
+		if (xSemaphoreTake(canRxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* Mount the key-value store on the EEPROM */
+Status RTOS_IO_KVStart(void)
+{
+	EEKV_CFG_T cfg;
+
+	if (kvTaskHandle) {
+		return ERROR;
+	}
+
+	cfg.firstPage = RTOS_IO_KV_FIRST_PAGE;
+	cfg.numPages = RTOS_IO_KV_PAGES;
+	cfg.index = kvIndex;
+	cfg.indexSize = RTOS_IO_KV_KEYS;
+	cfg.flushMs = RTOS_IO_KV_FLUSH_MS;
+
+	Chip_EEPROM_Init(LPC_EEPROM);
+	if (Chip_EEKV_Init(&kvStore, LPC_EEPROM, &cfg) != SUCCESS) {
+		return ERROR;
+	}
+
+	if (xTaskCreate(kvTask, "vTaskKV", configMINIMAL_STACK_SIZE, NULL,
+					tskIDLE_PRIORITY + 1UL, &kvTaskHandle) != pdPASS) {
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/* Set the value of a key */
+Status RTOS_IO_KVSet(uint16_t key, const void *data, uint32_t len)
+{
+	Status status;
+
+	xSemaphoreTake(kvMutex, portMAX_DELAY);
+	status = Chip_EEKV_Set(&kvStore, key, data, len);
+	xSemaphoreGive(kvMutex);
+
+	return status;
+}
+
+/* Read the value of a key */
+uint32_t RTOS_IO_KVGet(uint16_t key, void *data, uint32_t maxLen)
+{
+	uint32_t len;
+
+	xSemaphoreTake(kvMutex, portMAX_DELAY);
+	len = Chip_EEKV_Get(&kvStore, key, data, maxLen);
+	xSemaphoreGive(kvMutex);
+
+	return len;
+}
+
+/* Delete a key */
+Status RTOS_IO_KVDelete(uint16_t key)
+{
+	Status status;
+
+	xSemaphoreTake(kvMutex, portMAX_DELAY);
+	status = Chip_EEKV_Delete(&kvStore, key);
+	xSemaphoreGive(kvMutex);
+
+	return status;
+}
+
+/* Program the buffered key-value updates now */
+void RTOS_IO_KVFlush(void)
+{
+	xSemaphoreTake(kvMutex, portMAX_DELAY);
+	Chip_EEKV_Flush(&kvStore);
+	xSemaphoreGive(kvMutex);
+}
+
+/* Start streaming a firmware image into the inactive flash bank */
+Status RTOS_IO_FWUpdateBegin(uint32_t size, uint32_t crc)
+{
+	if (Chip_FWUPD_Begin(&fwUpdate, size, crc) != SUCCESS) {
+		return ERROR;
+	}
+
+	if (!fwTaskHandle &&
+		(xTaskCreate(fwTask, "vTaskFW", configMINIMAL_STACK_SIZE, NULL,
+					 tskIDLE_PRIORITY, &fwTaskHandle) != pdPASS)) {
+		Chip_FWUPD_Abort(&fwUpdate);
+		return ERROR;
+	}
+
+	/* Starts erasing ahead of the data */
+	fwKick();
+	return SUCCESS;
+}
+
+/* Add received data to the firmware image */
+Status RTOS_IO_FWUpdateWrite(const void *data, uint32_t len)
+{
+	const uint8_t *p = (const uint8_t *) data;
+	uint32_t n;
+
+	while (len > 0) {
+		if (Chip_FWUPD_GetState(&fwUpdate) != FWUPD_RECEIVING) {
+			return ERROR;
+		}
+		n = Chip_FWUPD_Write(&fwUpdate, p, len);
+		fwKick();
+		if (n == 0) {
+			/* Page buffers full, wait for the flash task to program one */
+			xSemaphoreTake(fwStep, portMAX_DELAY);
+		}
+		p += n;
+		len -= n;
+	}
+
+	return SUCCESS;
+}
+
+/* Wait for the image to be verified and make it the boot image */
+Status RTOS_IO_FWUpdateFinish(void)
+{
+	while (Chip_FWUPD_GetState(&fwUpdate) == FWUPD_RECEIVING) {
+		fwKick();
+		xSemaphoreTake(fwStep, portMAX_DELAY);
+	}
+
+	return Chip_FWUPD_Activate(&fwUpdate);
+}
+
+/* Set up the mailbox and start the M0APP core */
+Status RTOS_IO_IPCStart(uint32_t m0Image)
+{
+	if (ipcStarted) {
+		return ERROR;
+	}
+
+	Chip_IPCMBX_Init(&ipcHandle, (IPCMBX_SHARED_T *) RTOS_IO_IPC_SHARED_ADDR);
+	NVIC_SetPriority(M0APP_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_ClearPendingIRQ(M0APP_IRQn);
+	NVIC_EnableIRQ(M0APP_IRQn);
+	if (Chip_IPCMBX_StartM0(m0Image) != SUCCESS) {
+		NVIC_DisableIRQ(M0APP_IRQn);
+		return ERROR;
+	}
+
+	ipcStarted = true;
+	return SUCCESS;
+}
+
+/* Send a message to the M0APP core */
+bool RTOS_IO_IPCSend(const IPCMBX_MSG_T *pMsg, uint32_t waitMs)
+{
+	bool sent = true;
+
+	if (!ipcStarted || (pMsg->len > IPCMBX_MSG_DATA)) {
+		return false;
+	}
+
+	xSemaphoreTake(ipcTxMutex, portMAX_DELAY);
+	while (Chip_IPCMBX_Send(&ipcHandle, pMsg) != SUCCESS) {
+		if (Chip_IPCMBX_WaitTx(&ipcHandle) &&
+			(xSemaphoreTake(ipcTxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE)) {
+			sent = false;
+			break;
+		}
+	}
+	xSemaphoreGive(ipcTxMutex);
+
+	return sent;
+}
+
+/* Wait for a message from the M0APP core */
+bool RTOS_IO_IPCReceive(IPCMBX_MSG_T *pMsg, uint32_t waitMs)
+{
+	bool received = true;
+
+	if (!ipcStarted) {
+		return false;
+	}
+
+	xSemaphoreTake(ipcRxMutex, portMAX_DELAY);
+	while (!Chip_IPCMBX_Receive(&ipcHandle, pMsg)) {
+		if (Chip_IPCMBX_WaitRx(&ipcHandle) &&
+			(xSemaphoreTake(ipcRxReady, waitMs / portTICK_PERIOD_MS) != pdTRUE)) {
+			received = false;
+			break;
+		}
+	}
+	xSemaphoreGive(ipcRxMutex);
+
+	return received;
+}
+
+/* Switch the debug UART from text to binary telemetry */
+Status RTOS_IO_TelemStart(uint32_t baud)
+{
+	static const uint8_t delimiter = 0;
+
+	if (telemStarted) {
+		return ERROR;
+	}
+
+	RingBuffer_Init(&telemTxRing, telemTxBuf, 1, RTOS_IO_TELEM_TX_RING);
+	RingBuffer_Init(&telemRxRing, telemRxBuf, 1, RTOS_IO_TELEM_RX_RING);
+	Chip_TELEM_Init(&telem, DEBUG_UART, &telemTxRing);
+
+	/* Board_Init() has set up the UART, let the last text out before the
+	   rate changes */
+	while (Chip_UART_CheckBusy(DEBUG_UART) == SET) {}
+	Chip_UART_SetBaudFDR(DEBUG_UART, baud);
+	Chip_UART_SetupFIFOS(DEBUG_UART, (UART_FCR_FIFO_EN | RTOS_IO_TELEM_RX_TRIG));
+	Chip_UART_IntEnable(DEBUG_UART, (UART_IER_RBRINT | UART_IER_RLSINT));
+	NVIC_SetPriority(RTOS_IO_TELEM_IRQn, RTOS_IO_IRQ_PRIORITY);
+	NVIC_EnableIRQ(RTOS_IO_TELEM_IRQn);
+	telemStarted = true;
+
+	/* End whatever the host received before, so the first frame decodes */
+	Chip_UART_SendRB(DEBUG_UART, &telemTxRing, &delimiter, 1);
+
+	/* DEBUGOUT would write the UART directly, in the middle of the frames */
+	Board_UARTSetPutChar(telemPutChar);
+
+	return SUCCESS;
+}
+
+/* Send a telemetry record without blocking */
+Status RTOS_IO_TelemSend(uint8_t type, const void *record, uint32_t len)
+{
+	Status ret;
+
+	if (!telemStarted) {
+		return ERROR;
+	}
+
+	xSemaphoreTake(telemMutex, portMAX_DELAY);
+	ret = Chip_TELEM_Send(&telem, type, record, len);
+	xSemaphoreGive(telemMutex);
+
+	return ret;
+}
+
+/* Return the telemetry statistics */
+const TELEM_STATS_T *RTOS_IO_TelemGetStats(void)
+{
+	return Chip_TELEM_GetStats(&telem);
+}
+
+/* Encrypt or decrypt a buffer, blocking the calling task until done */
+Status RTOS_IO_AESProcess(AESSTREAM_CTX_T *pCtx, uint8_t *pOut, const uint8_t *pIn, uint32_t len)
+{
+	AESSTREAM_REQ_T req;
+	Status status;
+
+	Chip_AESSTREAM_SetupReq(&req, pCtx, pOut, pIn, len, aesReqDone, aesDone);
+	xSemaphoreTake(aesMutex, portMAX_DELAY);
+	status = Chip_AESSTREAM_Submit(&req);
+	if (status == SUCCESS) {
+		xSemaphoreTake(aesDone, portMAX_DELAY);
+		status = req.status;
+	}
+	xSemaphoreGive(aesMutex);
+
+	return status;
+}
+
+/* Copy memory, blocking the calling task until done */
+Status RTOS_IO_MemCopy(void *dst, const void *src, uint32_t len)
+{
+	GPDMAMEM_REQ_T req;
+
+	Chip_GPDMAMEM_SetupCopy(&req, dst, src, len, memReqDone, memDone);
+	return memSubmitAndWait(&req);
+}
+
+/* Fill memory, blocking the calling task until done */
+Status RTOS_IO_MemSet(void *dst, uint8_t val, uint32_t len)
+{
+	GPDMAMEM_REQ_T req;
+
+	Chip_GPDMAMEM_SetupFill(&req, dst, val, len, memReqDone, memDone);
+	return memSubmitAndWait(&req);
+}
+
+/* Return the DMA handle of the LCD SSP */
+SSPDMA_HANDLE_T *RTOS_IO_GetLCDSSP(void)
+{
+	return &lcdSSP;
+}
+
+/* Initialize the LCD and start the task that refreshes it */
+Status RTOS_IO_LCDStart(uint32_t maxFps)
+{
+	if ((maxFps == 0) || (maxFps > configTICK_RATE_HZ) || lcdTaskHandle) {
+		return ERROR;
+	}
+	lcdFramePeriod = configTICK_RATE_HZ / maxFps;
+
+	/* The init sequence uses blocking writes, keep the blocking transfers off the SSP */
+	xSemaphoreTake(sspMutex, portMAX_DELAY);
+	Board_LCD_Init();
+	LCD_Init();
+	LCD_SetDeferred(true);
+	xSemaphoreGive(sspMutex);
+
+	if (xTaskCreate(lcdTask, "vTaskLCD", configMINIMAL_STACK_SIZE, NULL,
+					tskIDLE_PRIORITY + 1UL, &lcdTaskHandle) != pdPASS) {
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/* Run a transfer on the LCD SSP, blocking the calling task until done */
+Status RTOS_IO_SSPTransfer(const void *tx, void *rx, uint32_t len)
+{
+	SSPDMA_XFER_T xfer;
+	Status status;
+
+	Chip_SSPDMA_SetupXfer(&xfer, 0, tx, rx, len, sspXferDone, sspDone);
+
+	xSemaphoreTake(sspMutex, portMAX_DELAY);
+	status = Chip_SSPDMA_Submit(&lcdSSP, &xfer);
+	if (status == SUCCESS) {
+		xSemaphoreTake(sspDone, portMAX_DELAY);
+		status = xfer.status;
+	}
+	xSemaphoreGive(sspMutex);
+
+	return status;
+}
+
+/* Run a batch of I2C transfers, blocking the calling task until done */
+Status RTOS_IO_I2CTransfer(I2C_ID_T id, I2C_QXFER_T *pQXfer, uint32_t count)
+{
+	Status status = SUCCESS;
+	uint32_t i;
+
+	if (count == 0) {
+		return SUCCESS;
+	}
+
+	/* Transfers complete in order, the last one ends the batch */
+	Chip_I2C_MasterSubmit(id, pQXfer, count);
+	Chip_I2C_MasterQueueWait(id, &pQXfer[count - 1]);
+
+	for (i = 0; i < count; i++) {
+		if (pQXfer[i].xfer.status != I2C_STATUS_DONE) {
+			status = ERROR;
+		}
+	}
+	return status;
+}
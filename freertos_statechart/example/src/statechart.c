@@ -32,6 +32,11 @@
 #include "board.h"
 #include "FreeRTOS.h"
 #include "task.h"
+#include "queue.h"
+#include "rtos_io.h"
+#include "boot_time.h"
+#include "telemetry.h"
+#include <string.h>
 
 #include "src-gen/Prefix.h"
 
@@ -39,8 +44,8 @@
  * Private types/enumerations/variables
  ****************************************************************************/
 #define EXAMPLE_1 (1)		/* Blink LED3 */
-#define EXAMPLE_2 (2)		/* */
-#define EXAMPLE_3 (3)		/* */
+#define EXAMPLE_2 (2)		/* Kernel timing */
+#define EXAMPLE_3 (3)		/* Binary telemetry */
 #define EXAMPLE_4 (4)		/* */
 #define EXAMPLE_5 (5)		/* */
 #define EXAMPLE_6 (6)		/* */
@@ -66,20 +71,26 @@ static void prvSetupHardware(void)
 {
 	SystemCoreClockUpdate();
 	Board_Init();
+	bootTime_mark("board");
+	RTOS_IO_Init();
+	bootTime_mark("rtos_io");
+}
+
+/* LED operation of the statechart, src-gen/Prefix.c is built whichever
+   example runs */
+void prefixIface_opLED(Prefix* handle, sc_integer LEDNumber, sc_boolean State)
+{
+	Board_LED_Set((uint8_t) LEDNumber, State);
 }
 
 #if (TEST == EXAMPLE_1)
 
 void vApplicationTickHook()
 {
+	RTOS_IO_Tick();
 	SysTick_Time_Flag = true;
 }
 
-void prefixIface_opLED(Prefix* handle, sc_integer LEDNumber, sc_boolean State)
-{
-	Board_LED_Set((uint8_t) LEDNumber, State);
-}
-
 const char *pcTextForMain = "\r\nExample 1 - Blink LED3\r\n";
 
 
@@ -109,6 +120,16 @@ static void vLED3Task(void *pvParameters) {
 static void vUARTTask(void *pvParameters) {
 	int tickCnt = 0;
 
+	/* Created last at the same priority as the LED thread, so the
+	   scheduler starts with this one */
+	bootTime_mark("first task");
+
+	/* Print out the name of this example and the boot timeline. This is
+	   done here rather than in main() as the polled debug UART would hold
+	   off the scheduler for the length of the text. */
+	DEBUGOUT(pcTextForMain);
+	bootTime_print();
+
 	while (1) {
 		DEBUGOUT("Tick: %d \r\n", tickCnt);
 		tickCnt++;
@@ -129,12 +150,11 @@ static void vUARTTask(void *pvParameters) {
  */
 int main(void)
 {
+	bootTime_mark("main");
+
 	/* Sets up system hardware */
 	prvSetupHardware();
 
-	/* Print out the name of this example. */
-	DEBUGOUT(pcTextForMain);
-
 	/* Blink LED3 thread */
 	xTaskCreate((TaskFunction_t) vLED3Task,					/* Pointer to the function thats implement the task. */
 				(const char * const) "LED3Task",			/* Text name for the task. This is to facilitate debugging only. */
@@ -148,6 +168,7 @@ int main(void)
 				(void *) NULL, (UBaseType_t) (tskIDLE_PRIORITY + 1UL), (TaskHandle_t *) NULL);
 
 	/* Start the scheduler so our tasks start executing. */
+	bootTime_mark("tasks");
 	vTaskStartScheduler();
 
 	/* If all is well we will never reach here as the scheduler will now be
@@ -158,4 +179,181 @@ int main(void)
 	/* Should never arrive here */
 	return ((int) NULL);
 }
+
+#elif (TEST == EXAMPLE_2)
+
+/* Iterations per measurement */
+#define TIMING_LOOPS (1000)
+
+const char *pcTextForMain = "\r\nExample 2 - Kernel timing\r\n";
+
+static QueueHandle_t xPingQueue, xPongQueue;
+static TaskHandle_t xYieldTask;
+
+/* Yield thread, switches straight back to the timing thread */
+static void vYieldTask(void *pvParameters) {
+	while (1) {
+		taskYIELD();
+	}
+}
+
+/* Pong thread, answers each ping from the timing thread */
+static void vPongTask(void *pvParameters) {
+	uint32_t value;
+
+	while (1) {
+		xQueueReceive(xPingQueue, &value, portMAX_DELAY);
+		xQueueSend(xPongQueue, &value, portMAX_DELAY);
+	}
+}
+
+/* Timing thread, measures with the cycle counter started by the startup code */
+static void vTimingTask(void *pvParameters) {
+	uint32_t i, start, value = 0;
+	uint32_t switchCycles, queueCycles;
+
+	DEBUGOUT(pcTextForMain);
+	DEBUGOUT("Kernel hot paths in %s\r\n", (configKERNEL_IN_RAM == 1) ? "RAM" : "flash");
+
+	while (1) {
+		/* Each yield switches to the yield thread and back */
+		vTaskResume(xYieldTask);
+		start = DWT->CYCCNT;
+		for (i = 0; i < TIMING_LOOPS; i++) {
+			taskYIELD();
+		}
+		switchCycles = (DWT->CYCCNT - start) / (2 * TIMING_LOOPS);
+		vTaskSuspend(xYieldTask);
+
+		/* Each round trip is two sends, two receives and two switches, the
+		   pong thread preempts as soon as the ping is sent */
+		start = DWT->CYCCNT;
+		for (i = 0; i < TIMING_LOOPS; i++) {
+			xQueueSend(xPingQueue, &value, portMAX_DELAY);
+			xQueueReceive(xPongQueue, &value, portMAX_DELAY);
+		}
+		queueCycles = (DWT->CYCCNT - start) / TIMING_LOOPS;
+
+		DEBUGOUT("Context switch: %lu cycles, queue round trip: %lu cycles\r\n",
+				 (unsigned long) switchCycles, (unsigned long) queueCycles);
+		vTaskDelay(configTICK_RATE_HZ);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/**
+ * @brief	main routine for the kernel timing example
+ * @return	Nothing, function should not exit
+ */
+int main(void)
+{
+	/* Sets up system hardware */
+	prvSetupHardware();
+
+	xPingQueue = xQueueCreate(1, sizeof(uint32_t));
+	xPongQueue = xQueueCreate(1, sizeof(uint32_t));
+
+	/* Timing thread and its yield partner at the same priority, the partner
+	   only runs while context switches are measured */
+	xTaskCreate((TaskFunction_t) vTimingTask, (const char * const) "vTaskTiming", (uint16_t) (configMINIMAL_STACK_SIZE * 2),
+				(void *) NULL, (UBaseType_t) (tskIDLE_PRIORITY + 1UL), (TaskHandle_t *) NULL);
+	xTaskCreate((TaskFunction_t) vYieldTask, (const char * const) "vTaskYield", (uint16_t) configMINIMAL_STACK_SIZE,
+				(void *) NULL, (UBaseType_t) (tskIDLE_PRIORITY + 1UL), &xYieldTask);
+	vTaskSuspend(xYieldTask);
+
+	/* Pong thread above the timing thread */
+	xTaskCreate((TaskFunction_t) vPongTask, (const char * const) "vTaskPong", (uint16_t) configMINIMAL_STACK_SIZE,
+				(void *) NULL, (UBaseType_t) (tskIDLE_PRIORITY + 2UL), (TaskHandle_t *) NULL);
+
+	/* Start the scheduler so our tasks start executing. */
+	vTaskStartScheduler();
+
+	/* Should only get here if there was insufficient heap for the idle task */
+	while (1);
+
+	/* Should never arrive here */
+	return ((int) NULL);
+}
+
+#elif (TEST == EXAMPLE_3)
+
+const char *pcTextForMain = "\r\nExample 3 - Binary telemetry\r\n";
+
+/* Telemetry thread, sends the boot timeline once, then a tick, task and
+   link record each second. Decode with tools/telemetry_decode.py */
+static void vTelemetryTask(void *pvParameters) {
+	const BOOT_TIME_MARK_T *pMarks;
+	const TELEM_STATS_T *pStats;
+	TELEMETRY_BOOT_MARK_T mark;
+	TELEMETRY_TICK_T tick;
+	TELEMETRY_TASKS_T tasks;
+	TELEMETRY_LINK_T link;
+	uint32_t i, count;
+
+	bootTime_mark("first task");
+
+	/* Last text on the debug UART */
+	DEBUGOUT(pcTextForMain);
+	RTOS_IO_TelemStart(TELEMETRY_BAUD);
+
+	count = bootTime_getMarks(&pMarks);
+	for (i = 0; i < count; i++) {
+		mark.us = pMarks[i].us;
+		mark.cycles = pMarks[i].cycles;
+		strncpy(mark.name, pMarks[i].name, sizeof(mark.name));
+		RTOS_IO_TelemSend(TELEMETRY_BOOT_MARK, &mark, sizeof(mark));
+	}
+
+	tick.count = 0;
+	while (1) {
+		tick.ms = xTaskGetTickCount() * portTICK_PERIOD_MS;
+		RTOS_IO_TelemSend(TELEMETRY_TICK, &tick, sizeof(tick));
+		tick.count++;
+
+		tasks.tasks = uxTaskGetNumberOfTasks();
+		tasks.stackFree = uxTaskGetStackHighWaterMark(NULL) * sizeof(StackType_t);
+		RTOS_IO_TelemSend(TELEMETRY_TASKS, &tasks, sizeof(tasks));
+
+		pStats = RTOS_IO_TelemGetStats();
+		link.frames = pStats->frames;
+		link.bytes = pStats->bytes;
+		link.dropped = pStats->dropped;
+		RTOS_IO_TelemSend(TELEMETRY_LINK, &link, sizeof(link));
+
+		/* About a 1s delay here */
+		vTaskDelay(configTICK_RATE_HZ);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/**
+ * @brief	main routine for the binary telemetry example
+ * @return	Nothing, function should not exit
+ */
+int main(void)
+{
+	bootTime_mark("main");
+
+	/* Sets up system hardware */
+	prvSetupHardware();
+
+	xTaskCreate((TaskFunction_t) vTelemetryTask, (const char * const) "vTaskTelem", (uint16_t) configMINIMAL_STACK_SIZE,
+				(void *) NULL, (UBaseType_t) (tskIDLE_PRIORITY + 1UL), (TaskHandle_t *) NULL);
+
+	/* Start the scheduler so our tasks start executing. */
+	bootTime_mark("tasks");
+	vTaskStartScheduler();
+
+	/* Should only get here if there was insufficient heap for the idle task */
+	while (1);
+
+	/* Should never arrive here */
+	return ((int) NULL);
+}
 #endif
@@ -0,0 +1,279 @@
+/*
+ * @brief USB descriptors of the virtual COM port and SD card export
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "board.h"
+#include "app_usbd_cfg.h"
+#include "usbd/usbd_rom_api.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Length of the virtual COM port function, association to last endpoint */
+#define CDC_FUNCTION_DESC_LEN   (USB_INTERFACE_ASSOC_DESC_SIZE + 2 * USB_INTERFACE_DESC_SIZE + \
+								 0x0013 + 3 * USB_ENDPOINT_DESC_SIZE)
+
+/* Length of the mass storage function */
+#define MSC_FUNCTION_DESC_LEN   (USB_INTERFACE_DESC_SIZE + 2 * USB_ENDPOINT_DESC_SIZE)
+
+/* Configuration descriptor header */
+#define CONFIG_DESC(totalLength, numInterfaces) \
+	USB_CONFIGURATION_DESC_SIZE,		/* bLength */ \
+	USB_CONFIGURATION_DESCRIPTOR_TYPE,	/* bDescriptorType */ \
+	WBVAL(totalLength),					/* wTotalLength */ \
+	(numInterfaces),					/* bNumInterfaces */ \
+	0x01,								/* bConfigurationValue */ \
+	0x00,								/* iConfiguration */ \
+	USB_CONFIG_SELF_POWERED,			/* bmAttributes */ \
+	USB_CONFIG_POWER_MA(100)			/* bMaxPower */
+
+/* Virtual COM port function, bulk packet size and interrupt interval differ by speed */
+#define CDC_FUNCTION_DESC(bulkPacket, intInterval) \
+	/* Interface association */ \
+	USB_INTERFACE_ASSOC_DESC_SIZE,		/* bLength */ \
+	USB_INTERFACE_ASSOCIATION_DESCRIPTOR_TYPE,	/* bDescriptorType */ \
+	USB_CDC_CIF_NUM,					/* bFirstInterface */ \
+	0x02,								/* bInterfaceCount */ \
+	CDC_COMMUNICATION_INTERFACE_CLASS,	/* bFunctionClass */ \
+	CDC_ABSTRACT_CONTROL_MODEL,			/* bFunctionSubClass */ \
+	0x00,								/* bFunctionProtocol */ \
+	0x04,								/* iFunction */ \
+	/* Communication class interface */ \
+	USB_INTERFACE_DESC_SIZE,			/* bLength */ \
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_CDC_CIF_NUM,					/* bInterfaceNumber */ \
+	0x00,								/* bAlternateSetting */ \
+	0x01,								/* bNumEndpoints */ \
+	CDC_COMMUNICATION_INTERFACE_CLASS,	/* bInterfaceClass */ \
+	CDC_ABSTRACT_CONTROL_MODEL,			/* bInterfaceSubClass */ \
+	0x00,								/* bInterfaceProtocol */ \
+	0x04,								/* iInterface */ \
+	/* Header functional descriptor */ \
+	0x05,								/* bFunctionLength */ \
+	CDC_CS_INTERFACE,					/* bDescriptorType */ \
+	CDC_HEADER,							/* bDescriptorSubtype */ \
+	WBVAL(CDC_V1_10),					/* bcdCDC */ \
+	/* Call management functional descriptor */ \
+	0x05,								/* bFunctionLength */ \
+	CDC_CS_INTERFACE,					/* bDescriptorType */ \
+	CDC_CALL_MANAGEMENT,				/* bDescriptorSubtype */ \
+	0x01,								/* bmCapabilities, handled by the device */ \
+	USB_CDC_DIF_NUM,					/* bDataInterface */ \
+	/* Abstract control management functional descriptor */ \
+	0x04,								/* bFunctionLength */ \
+	CDC_CS_INTERFACE,					/* bDescriptorType */ \
+	CDC_ABSTRACT_CONTROL_MANAGEMENT,	/* bDescriptorSubtype */ \
+	0x02,								/* bmCapabilities, line coding and state */ \
+	/* Union functional descriptor */ \
+	0x05,								/* bFunctionLength */ \
+	CDC_CS_INTERFACE,					/* bDescriptorType */ \
+	CDC_UNION,							/* bDescriptorSubtype */ \
+	USB_CDC_CIF_NUM,					/* bMasterInterface */ \
+	USB_CDC_DIF_NUM,					/* bSlaveInterface0 */ \
+	/* Notification endpoint */ \
+	USB_ENDPOINT_DESC_SIZE,				/* bLength */ \
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_CDC_INT_EP,						/* bEndpointAddress */ \
+	USB_ENDPOINT_TYPE_INTERRUPT,		/* bmAttributes */ \
+	WBVAL(0x0010),						/* wMaxPacketSize */ \
+	(intInterval),						/* bInterval */ \
+	/* Data class interface */ \
+	USB_INTERFACE_DESC_SIZE,			/* bLength */ \
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_CDC_DIF_NUM,					/* bInterfaceNumber */ \
+	0x00,								/* bAlternateSetting */ \
+	0x02,								/* bNumEndpoints */ \
+	CDC_DATA_INTERFACE_CLASS,			/* bInterfaceClass */ \
+	0x00,								/* bInterfaceSubClass */ \
+	0x00,								/* bInterfaceProtocol */ \
+	0x04,								/* iInterface */ \
+	/* Bulk OUT endpoint */ \
+	USB_ENDPOINT_DESC_SIZE,				/* bLength */ \
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_CDC_OUT_EP,						/* bEndpointAddress */ \
+	USB_ENDPOINT_TYPE_BULK,				/* bmAttributes */ \
+	WBVAL(bulkPacket),					/* wMaxPacketSize */ \
+	0x00,								/* bInterval */ \
+	/* Bulk IN endpoint */ \
+	USB_ENDPOINT_DESC_SIZE,				/* bLength */ \
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_CDC_IN_EP,						/* bEndpointAddress */ \
+	USB_ENDPOINT_TYPE_BULK,				/* bmAttributes */ \
+	WBVAL(bulkPacket),					/* wMaxPacketSize */ \
+	0x00								/* bInterval */
+
+/* Mass storage function */
+#define MSC_FUNCTION_DESC(bulkPacket) \
+	/* Mass storage interface */ \
+	USB_INTERFACE_DESC_SIZE,			/* bLength */ \
+	USB_INTERFACE_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_MSC_IF_NUM,						/* bInterfaceNumber */ \
+	0x00,								/* bAlternateSetting */ \
+	0x02,								/* bNumEndpoints */ \
+	USB_DEVICE_CLASS_STORAGE,			/* bInterfaceClass */ \
+	MSC_SUBCLASS_SCSI,					/* bInterfaceSubClass */ \
+	MSC_PROTOCOL_BULK_ONLY,				/* bInterfaceProtocol */ \
+	0x05,								/* iInterface */ \
+	/* Bulk IN endpoint */ \
+	USB_ENDPOINT_DESC_SIZE,				/* bLength */ \
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_MSC_IN_EP,						/* bEndpointAddress */ \
+	USB_ENDPOINT_TYPE_BULK,				/* bmAttributes */ \
+	WBVAL(bulkPacket),					/* wMaxPacketSize */ \
+	0x00,								/* bInterval */ \
+	/* Bulk OUT endpoint */ \
+	USB_ENDPOINT_DESC_SIZE,				/* bLength */ \
+	USB_ENDPOINT_DESCRIPTOR_TYPE,		/* bDescriptorType */ \
+	USB_MSC_OUT_EP,						/* bEndpointAddress */ \
+	USB_ENDPOINT_TYPE_BULK,				/* bmAttributes */ \
+	WBVAL(bulkPacket),					/* wMaxPacketSize */ \
+	0x00								/* bInterval */
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/* Device descriptor, the functions are grouped by interface associations */
+ALIGNED(4) const uint8_t USB_DeviceDescriptor[] = {
+	USB_DEVICE_DESC_SIZE,				/* bLength */
+	USB_DEVICE_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	WBVAL(0x0200),						/* bcdUSB 2.0 */
+	USB_DEVICE_CLASS_MISCELLANEOUS,		/* bDeviceClass */
+	0x02,								/* bDeviceSubClass, common class */
+	0x01,								/* bDeviceProtocol, interface association */
+	USB_MAX_PACKET0,					/* bMaxPacketSize0 */
+	WBVAL(0x1FC9),						/* idVendor */
+	WBVAL(0x0083),						/* idProduct */
+	WBVAL(0x0100),						/* bcdDevice */
+	0x01,								/* iManufacturer */
+	0x02,								/* iProduct */
+	0x03,								/* iSerialNumber */
+	0x01								/* bNumConfigurations */
+};
+
+/* Device qualifier, describes the device at the other speed */
+ALIGNED(4) const uint8_t USB_DeviceQualifier[] = {
+	0x0A,								/* bLength */
+	USB_DEVICE_QUALIFIER_DESCRIPTOR_TYPE,	/* bDescriptorType */
+	WBVAL(0x0200),						/* bcdUSB */
+	USB_DEVICE_CLASS_MISCELLANEOUS,		/* bDeviceClass */
+	0x02,								/* bDeviceSubClass */
+	0x01,								/* bDeviceProtocol */
+	USB_MAX_PACKET0,					/* bMaxPacketSize0 */
+	0x01,								/* bNumOtherSpeedConfigurations */
+	0x00								/* bReserved */
+};
+
+/* Configuration descriptors, the ROM stack patches them so they are not const.
+   Each ends with a zero byte */
+ALIGNED(4) uint8_t USB_HsConfigDescriptor[] = {
+	CONFIG_DESC(USB_CONFIGURATION_DESC_SIZE + CDC_FUNCTION_DESC_LEN, 0x02),
+	CDC_FUNCTION_DESC(USB_HS_MAX_BULK_PACKET, 0x08),
+	0
+};
+
+ALIGNED(4) uint8_t USB_FsConfigDescriptor[] = {
+	CONFIG_DESC(USB_CONFIGURATION_DESC_SIZE + CDC_FUNCTION_DESC_LEN, 0x02),
+	CDC_FUNCTION_DESC(USB_FS_MAX_BULK_PACKET, 0x02),
+	0
+};
+
+ALIGNED(4) uint8_t USB_HsMscConfigDescriptor[] = {
+	CONFIG_DESC(USB_CONFIGURATION_DESC_SIZE + CDC_FUNCTION_DESC_LEN + MSC_FUNCTION_DESC_LEN, 0x03),
+	CDC_FUNCTION_DESC(USB_HS_MAX_BULK_PACKET, 0x08),
+	MSC_FUNCTION_DESC(USB_HS_MAX_BULK_PACKET),
+	0
+};
+
+ALIGNED(4) uint8_t USB_FsMscConfigDescriptor[] = {
+	CONFIG_DESC(USB_CONFIGURATION_DESC_SIZE + CDC_FUNCTION_DESC_LEN + MSC_FUNCTION_DESC_LEN, 0x03),
+	CDC_FUNCTION_DESC(USB_FS_MAX_BULK_PACKET, 0x02),
+	MSC_FUNCTION_DESC(USB_FS_MAX_BULK_PACKET),
+	0
+};
+
+/* String descriptors */
+ALIGNED(4) const uint8_t USB_StringDescriptor[] = {
+	/* Index 0x00: LANGID codes */
+	0x04,								/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	WBVAL(0x0409),						/* wLANGID, US English */
+	/* Index 0x01: Manufacturer */
+	(3 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'N', 0,
+	'X', 0,
+	'P', 0,
+	/* Index 0x02: Product */
+	(9 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'V', 0,
+	'C', 0,
+	'O', 0,
+	'M', 0,
+	' ', 0,
+	'P', 0,
+	'o', 0,
+	'r', 0,
+	't', 0,
+	/* Index 0x03: Serial Number */
+	(4 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'4', 0,
+	'3', 0,
+	'3', 0,
+	'7', 0,
+	/* Index 0x04: Virtual COM port interfaces */
+	(4 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'V', 0,
+	'C', 0,
+	'O', 0,
+	'M', 0,
+	/* Index 0x05: Mass storage interface */
+	(7 * 2 + 2),						/* bLength */
+	USB_STRING_DESCRIPTOR_TYPE,			/* bDescriptorType */
+	'S', 0,
+	'D', 0,
+	' ', 0,
+	'C', 0,
+	'a', 0,
+	'r', 0,
+	'd', 0,
+};
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
@@ -717,6 +717,26 @@ is included as it is used by the port layer. */
 	#define mtCOVERAGE_TEST_MARKER()
 #endif
 
+#ifndef configKERNEL_IN_RAM
+	#define configKERNEL_IN_RAM 0
+#endif
+
+#ifndef configKERNEL_RAM_SECTION
+	#define configKERNEL_RAM_SECTION ".ramfunc.$RamLoc32"
+#endif
+
+/* Placement of the kernel functions run on every context switch, tick and
+queue operation.  With configKERNEL_IN_RAM set to 1 they are linked into
+configKERNEL_RAM_SECTION, which the managed linker script loads into RAM with
+the initialised data, so they execute without flash wait states. */
+#ifndef portKERNEL_RAMFUNC
+	#if configKERNEL_IN_RAM == 1
+		#define portKERNEL_RAMFUNC __attribute__(( section( configKERNEL_RAM_SECTION ) ))
+	#else
+		#define portKERNEL_RAMFUNC
+	#endif
+#endif
+
 /* Definitions to allow backward compatibility with FreeRTOS versions prior to
 V8 if desired. */
 #ifndef configENABLE_BACKWARD_COMPATIBILITY
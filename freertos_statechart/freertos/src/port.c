@@ -392,7 +392,7 @@ void vPortYield( void )
 }
 /*-----------------------------------------------------------*/
 
-void vPortEnterCritical( void )
+portKERNEL_RAMFUNC void vPortEnterCritical( void )
 {
 	portDISABLE_INTERRUPTS();
 	uxCriticalNesting++;
@@ -401,7 +401,7 @@ void vPortEnterCritical( void )
 }
 /*-----------------------------------------------------------*/
 
-void vPortExitCritical( void )
+portKERNEL_RAMFUNC void vPortExitCritical( void )
 {
 	configASSERT( uxCriticalNesting );
 	uxCriticalNesting--;
@@ -412,7 +412,7 @@ void vPortExitCritical( void )
 }
 /*-----------------------------------------------------------*/
 
-__attribute__(( naked )) uint32_t ulPortSetInterruptMask( void )
+portKERNEL_RAMFUNC __attribute__(( naked )) uint32_t ulPortSetInterruptMask( void )
 {
 	__asm volatile														\
 	(																	\
@@ -429,7 +429,7 @@ __attribute__(( naked )) uint32_t ulPortSetInterruptMask( void )
 }
 /*-----------------------------------------------------------*/
 
-__attribute__(( naked )) void vPortClearInterruptMask( uint32_t ulNewMaskValue )
+portKERNEL_RAMFUNC __attribute__(( naked )) void vPortClearInterruptMask( uint32_t ulNewMaskValue )
 {
 	__asm volatile													\
 	(																\
@@ -443,7 +443,7 @@ __attribute__(( naked )) void vPortClearInterruptMask( uint32_t ulNewMaskValue )
 }
 /*-----------------------------------------------------------*/
 
-void xPortPendSVHandler( void )
+portKERNEL_RAMFUNC void xPortPendSVHandler( void )
 {
 	/* This is a naked function. */
 
@@ -499,7 +499,7 @@ void xPortPendSVHandler( void )
 }
 /*-----------------------------------------------------------*/
 
-void xPortSysTickHandler( void )
+portKERNEL_RAMFUNC void xPortSysTickHandler( void )
 {
 	/* The SysTick runs at the lowest interrupt priority, so when this interrupt
 	executes all interrupts must be unmasked.  There is therefore no need to
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Decode the binary telemetry sent by RTOS_IO_TelemSend().
+
+Frames are COBS encoded and end with a zero byte. Decoded, a frame is a
+type byte, a sequence byte, the payload and a CRC-16/CCITT (0x1021,
+initial 0xFFFF, LSB first) over the first three, see telem_18xx_43xx.h.
+The record payloads follow example/inc/telemetry.h, keep RECORDS in step
+with it.
+
+Reads a serial port (needs pyserial), a capture file or stdin:
+
+    telemetry_decode.py /dev/ttyUSB1
+    telemetry_decode.py capture.bin
+    telemetry_decode.py - < capture.bin
+"""
+
+import argparse
+import struct
+import sys
+
+TELEMETRY_BAUD = 921600
+
+# type: (name, struct format, field names), little endian and unpadded
+RECORDS = {
+    1: ("tick", "<II", ("count", "ms")),
+    2: ("boot_mark", "<II12s", ("us", "cycles", "name")),
+    3: ("tasks", "<II", ("tasks", "stackFree")),
+    4: ("link", "<III", ("frames", "bytes", "dropped")),
+}
+
+# DEBUGOUT text sent once the telemetry has started, any length
+TEXT_RECORD = 5
+
+
+def _crc16_table():
+    table = []
+    for i in range(256):
+        crc = i << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+        table.append(crc & 0xFFFF)
+    return table
+
+
+CRC16_TABLE = _crc16_table()
+
+
+def crc16(data, crc=0xFFFF):
+    for b in data:
+        crc = ((crc << 8) & 0xFFFF) ^ CRC16_TABLE[(crc >> 8) ^ b]
+    return crc
+
+
+def cobs_decode(data):
+    """Decode one COBS block sequence without its delimiter, None if malformed."""
+    out = bytearray()
+    i = 0
+    while i < len(data):
+        code = data[i]
+        if code == 0 or i + code > len(data):
+            return None
+        out += data[i + 1:i + code]
+        i += code
+        if code != 0xFF and i < len(data):
+            out.append(0)
+    return bytes(out)
+
+
+def decode_record(rtype, payload):
+    """Return (name, fields) for a record, fields is a dict or the raw bytes."""
+    if rtype == TEXT_RECORD:
+        return "text", payload.decode("ascii", "replace")
+    if rtype not in RECORDS:
+        return "type%d" % rtype, payload.hex()
+    name, fmt, fields = RECORDS[rtype]
+    if len(payload) != struct.calcsize(fmt):
+        return name, "bad length %d: %s" % (len(payload), payload.hex())
+    values = []
+    for v in struct.unpack(fmt, payload):
+        if isinstance(v, bytes):
+            v = v.rstrip(b"\0").decode("ascii", "replace")
+        values.append(v)
+    return name, dict(zip(fields, values))
+
+
+class Decoder:
+    """Splits a byte stream into frames and checks them."""
+
+    def __init__(self):
+        self.buf = bytearray()
+        self.frames = 0
+        self.bad = 0
+        self.lost = 0
+        self.seq = None
+
+    def feed(self, data):
+        """Add received bytes, yields (kind, seq, name, fields) per frame.
+
+        kind is "record", or "text" for bytes that are not a valid frame
+        but look like text, such as the DEBUGOUT output before the start.
+        DEBUGOUT text sent later comes as "record" frames named "text",
+        one line or part of a line each.
+        """
+        self.buf += data
+        while True:
+            end = self.buf.find(0)
+            if end < 0:
+                return
+            chunk = bytes(self.buf[:end])
+            del self.buf[:end + 1]
+            if not chunk:
+                continue
+            raw = cobs_decode(chunk)
+            if raw is None or len(raw) < 4 or crc16(raw[:-2]) != struct.unpack("<H", raw[-2:])[0]:
+                text = chunk.decode("ascii", "replace").strip()
+                if text and all(32 <= b < 127 or b in (9, 10, 13) for b in chunk):
+                    yield "text", None, None, text
+                else:
+                    self.bad += 1
+                continue
+            rtype, seq = raw[0], raw[1]
+            if self.seq is not None:
+                self.lost += (seq - self.seq - 1) & 0xFF
+            self.seq = seq
+            self.frames += 1
+            name, fields = decode_record(rtype, raw[2:-2])
+            yield "record", seq, name, fields
+
+
+def open_input(path, baud):
+    if path == "-":
+        return sys.stdin.buffer
+    if path.startswith("/dev/") or path.upper().startswith("COM"):
+        import serial
+        return serial.Serial(path, baud, timeout=0.1)
+    return open(path, "rb")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("input", help="serial port, capture file or - for stdin")
+    parser.add_argument("-b", "--baud", type=int, default=TELEMETRY_BAUD,
+                        help="serial port rate (default %(default)s)")
+    args = parser.parse_args()
+
+    stream = open_input(args.input, args.baud)
+    dec = Decoder()
+    try:
+        while True:
+            data = stream.read(4096)
+            if not data:
+                if hasattr(stream, "in_waiting"):
+                    continue
+                break
+            for kind, seq, name, fields in dec.feed(data):
+                if kind == "text":
+                    print("text: %s" % fields)
+                elif name == "text":
+                    print("%3d text: %s" % (seq, fields.rstrip("\r\n")))
+                else:
+                    print("%3d %-10s %s" % (seq, name, fields))
+            sys.stdout.flush()
+    except KeyboardInterrupt:
+        pass
+    print("%d frames, %d bad, %d lost" % (dec.frames, dec.bad, dec.lost), file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -108,6 +108,10 @@ extern "C" {
 #define LCD_CMD_GPIO_PIN     4
 #define LCD_BIT_RATE         1000000 /* 1 MHz */
 
+/* Chip select values of LCD DMA transactions, they select the command line level */
+#define LCD_XFER_DATA        0
+#define LCD_XFER_CMD         1
+
 /* Audio Codec defines */
 #define I2CDEV_WM8904_ADDR     (0x34 >> 1)
 #define WM8904_I2C_BUS         I2C1
@@ -328,6 +332,31 @@ void Board_LCD_Init(void);
  */
 void Board_LCD_WriteData(const uint8_t *data, uint16_t size);
 
+/**
+ * @brief	Prepare a DMA transaction to the LCD module
+ * @param	pXfer	: Pointer to transaction to setup
+ * @param	cmd		: true to send commands, false to send display data
+ * @param	data	: Bytes to send, must remain valid until the transaction completes
+ * @param	size	: Number of bytes
+ * @param	cb		: Completion callback, can be NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ * @note	The transaction uses the LCD SSP format, the SSP DMA handle
+ * must be initialized with Board_LCD_XferSelect() as chip select callback.
+ */
+void Board_LCD_SetupXfer(SSPDMA_XFER_T *pXfer, bool cmd, const uint8_t *data, uint16_t size,
+						 SSPDMA_CALLBACK_T cb, void *cbData);
+
+/**
+ * @brief	Chip select callback for SSP DMA transactions on the LCD SSP
+ * @param	cs		: LCD_XFER_CMD or LCD_XFER_DATA
+ * @param	assert	: true at the start of the transaction, false at its end
+ * @return	Nothing
+ * @note	Drives the LCD command line, it is left high between transactions
+ * as with Board_LCD_WriteData().
+ */
+void Board_LCD_XferSelect(uint32_t cs, bool assert);
+
 /**
  * @}
  */
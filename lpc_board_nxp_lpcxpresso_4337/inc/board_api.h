@@ -100,6 +100,20 @@ void Board_Debug_Init(void);
  */
 void Board_UARTPutChar(char ch);
 
+/**
+ * @brief Function taking the debug output in place of the UART
+ */
+typedef void (*BOARD_PUTCHAR_T)(char ch);
+
+/**
+ * @brief	Redirects the characters of Board_UARTPutChar()
+ * @param	putChar	: Function taking each character, or NULL for the debug UART
+ * @return	None
+ * @note	For a driver that takes over the debug UART, so that the
+ *			DEBUGOUT and DEBUGSTR text does not mix with its own output.
+ */
+void Board_UARTSetPutChar(BOARD_PUTCHAR_T putChar);
+
 /**
  * @brief	Get a single character from the UART, required for scanf input
  * @return	EOF if not character was received, or character value
@@ -60,6 +60,15 @@ typedef struct {
 extern "C" {
 #endif
 
+/**
+ * Deferred refresh statistics
+ */
+typedef struct {
+	uint32_t flushes;	/*!< LCD_FlushAsync() calls that queued data */
+	uint32_t bursts;	/*!< RAM address and data burst pairs queued */
+	uint32_t bytes;		/*!< Command and data bytes queued */
+} LCD_FLUSH_STATS_T;
+
 /**
  * @brief	Initialize the LCD turns it ON
  * @return	Nothing
@@ -79,6 +88,38 @@ void LCD_Init(void);
  */
 void LCD_Refresh(int left, int top, int right, int bottom);
 
+/**
+ * @brief	Enable or disable deferred refresh
+ * @param	enable	: true to defer, false to refresh immediately
+ * @return	Nothing
+ * @note	In deferred mode LCD_Refresh() and the drawing functions only
+ * mark the region dirty, nothing is sent until LCD_FlushAsync() is called.
+ * Disabling it waits for a running LCD_FlushAsync() to complete, then
+ * sends the regions still dirty with blocking writes. The SSP DMA
+ * interrupt must be able to run while it waits.
+ */
+void LCD_SetDeferred(bool enable);
+
+/**
+ * @brief	Queue the changes made since the last flush as SSP DMA transactions
+ * @param	pHandle	: SSP DMA handle of the LCD SSP
+ * @param	cb		: Callback of the last transaction, can be NULL
+ * @param	cbData	: User data for the callback
+ * @return	Number of bytes queued, 0 if nothing changed or the previous
+ * flush is still running, in which case @a cb is not called
+ * @note	Only the columns that differ from the panel RAM are sent, as at
+ * most LCD_FLUSH_SPANS bursts per page. The frame buffer can be drawn into
+ * as soon as this function returns. The handle must use Board_LCD_XferSelect()
+ * as chip select callback.
+ */
+uint32_t LCD_FlushAsync(SSPDMA_HANDLE_T *pHandle, SSPDMA_CALLBACK_T cb, void *cbData);
+
+/**
+ * @brief	Return the deferred refresh statistics
+ * @return	Pointer to the statistics
+ */
+const LCD_FLUSH_STATS_T *LCD_GetFlushStats(void);
+
 /**
  * @brief	Turns On/Off a pixel at (@a x,@a y) in Display device
  * @param	x	: X coordinate of the pixel
@@ -99,6 +140,21 @@ void LCD_PutPixel(int x, int y, int col);
  */
 void LCD_SetPixel(int x, int y, int col);
 
+/**
+ * @brief	Clears or sets all pixels of the display
+ * @param	col	: Color of the pixels (0 - OFF[WHITE]; 1 - ON[BLACK])
+ * @return	Nothing
+ */
+void LCD_Clear(int col);
+
+/**
+ * @brief	Scrolls the display content up
+ * @param	lines	: Number of pixel rows to scroll by
+ * @param	col		: Color of the rows uncovered at the bottom
+ * @return	Nothing
+ */
+void LCD_ScrollUp(int lines, int col);
+
 /**
  * @brief	Draws a rectangle from (top,right) to (bottom,left)
  * @param	left	: Left coordinate [X coordinate]
@@ -71,6 +71,9 @@ static const io_port_t gpioButtonBits[] = {{BUTTONS_TEC1_GPIO_PORT_NUM, BUTTONS_
 
 static uint32_t lcd_cfg_val;
 
+/* Takes the debug output instead of the UART when set */
+static BOARD_PUTCHAR_T debugPutChar;
+
 void Board_UART_Init(LPC_USART_T *pUART)
 {
 #if defined(BOARD_NXP_LPCXPRESSO_4337)
@@ -102,6 +105,10 @@ void Board_Debug_Init(void)
 /* Sends a character on the UART */
 void Board_UARTPutChar(char ch)
 {
+	if (debugPutChar) {
+		debugPutChar(ch);
+		return;
+	}
 #if defined(DEBUG_UART)
 	/* Wait for space in FIFO */
 	while ((Chip_UART_ReadLineStatus(DEBUG_UART) & UART_LSR_THRE) == 0) {}
@@ -109,6 +116,12 @@ void Board_UARTPutChar(char ch)
 #endif
 }
 
+/* Redirects the debug output, NULL sends it to the UART again */
+void Board_UARTSetPutChar(BOARD_PUTCHAR_T putChar)
+{
+	debugPutChar = putChar;
+}
+
 /* Gets a character from the UART, returns EOF if no character is ready */
 int Board_UARTGetChar(void)
 {
@@ -346,6 +359,25 @@ void Board_LCD_WriteData(const uint8_t *data, uint16_t size)
 	LCD_SSP->CR0 = val;
 }
 
+/* Prepare a DMA transaction to the LCD module */
+void Board_LCD_SetupXfer(SSPDMA_XFER_T *pXfer, bool cmd, const uint8_t *data, uint16_t size,
+						 SSPDMA_CALLBACK_T cb, void *cbData)
+{
+	Chip_SSPDMA_SetupXfer(pXfer, cmd ? LCD_XFER_CMD : LCD_XFER_DATA, data, NULL, size, cb, cbData);
+	pXfer->cr0 = lcd_cfg_val;
+}
+
+/* Drive the LCD command line around DMA transactions */
+void Board_LCD_XferSelect(uint32_t cs, bool assert)
+{
+	if (assert && (cs == LCD_XFER_CMD)) {
+		Chip_GPIO_SetPinOutLow(LPC_GPIO_PORT, LCD_CMD_GPIO_PORT, LCD_CMD_GPIO_PIN);
+	}
+	else {
+		Chip_GPIO_SetPinOutHigh(LPC_GPIO_PORT, LCD_CMD_GPIO_PORT, LCD_CMD_GPIO_PIN);
+	}
+}
+
 /**
  * @}
  */
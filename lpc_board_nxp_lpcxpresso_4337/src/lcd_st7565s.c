@@ -30,6 +30,7 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 #include "board.h"
 #include "lcd_st7565s.h"
 
@@ -67,12 +68,48 @@ static const uint8_t lcd_init_cmd[] = {
 	0x04,
 };
 
+/* Page rows are word aligned so spans can be written a word at a time */
 #ifdef LCD_ORIENT_PORTRAIT
-static uint8_t fbuffer[LCD_X_RES >> 3][LCD_Y_RES];
+static uint8_t fbuffer[LCD_X_RES >> 3][LCD_Y_RES] __attribute__ ((aligned(4)));
 #else
-static uint8_t fbuffer[LCD_Y_RES >> 3][LCD_X_RES];
+static uint8_t fbuffer[LCD_Y_RES >> 3][LCD_X_RES] __attribute__ ((aligned(4)));
 #endif
 
+/* Panel RAM geometry, the frame buffer is always stored in panel order */
+#define LCD_PG_NUM   (sizeof(fbuffer) / sizeof(fbuffer[0]))
+#define LCD_COL_NUM  (sizeof(fbuffer[0]))
+
+/* Maximum number of DMA bursts sent per page by LCD_FlushAsync() */
+#ifndef LCD_FLUSH_SPANS
+#define LCD_FLUSH_SPANS  2
+#endif
+
+/* Unchanged columns that are cheaper to resend than a new RAM address */
+#define LCD_FLUSH_GAP    4
+
+/* Deferred mode: drawing only widens the dirty column span of each page */
+static bool deferred;
+static uint8_t dirtyLo[LCD_PG_NUM], dirtyHi[LCD_PG_NUM];
+
+/* Content of the panel RAM, also the source of the flush DMA bursts */
+static uint8_t shadow[LCD_PG_NUM][LCD_COL_NUM];
+static uint8_t flushCmd[LCD_PG_NUM][LCD_FLUSH_SPANS][3];
+static SSPDMA_XFER_T flushXfer[LCD_PG_NUM * LCD_FLUSH_SPANS * 2];
+static int flushXferNum;
+static LCD_FLUSH_STATS_T flushStats;
+
+/* Glyphs of the current font rotated to panel columns (bit 0 at the top),
+   built on first use. Only fonts of up to 16 rows are cached. */
+#ifndef LCD_GLYPH_CACHE_CHARS
+#define LCD_GLYPH_CACHE_CHARS  96
+#endif
+
+static uint16_t glyphCache[LCD_GLYPH_CACHE_CHARS][16];
+static uint32_t glyphValid[(LCD_GLYPH_CACHE_CHARS + 31) / 32];
+
+/* Replicate a page byte in the four bytes of a word */
+#define LCD_WORD(b)  ((uint32_t) (uint8_t) (b) * 0x01010101UL)
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -99,6 +136,132 @@ static void LCD_SetRAMAddr(uint8_t pgAddr, uint8_t colAddr)
 	LCD_WriteCmd(cmd, sizeof(cmd));
 }
 
+/* Mark all pages clean */
+static void LCD_ClearDirty(void)
+{
+	memset(dirtyLo, LCD_COL_NUM, sizeof(dirtyLo));
+	memset(dirtyHi, 0, sizeof(dirtyHi));
+}
+
+/* Sets a pixel in display RAM, the coordinates must be on the display */
+STATIC INLINE void LCD_PlotPixel(int x, int y, int col)
+{
+#ifdef LCD_ORIENT_PORTRAIT
+	if (1) {
+		int t = x;
+		x = y;
+		y = LCD_X_RES - t - 1;
+	}
+#endif
+	if (col)
+		fbuffer[y/8][x] |= 1 << (y & 7);
+	else
+		fbuffer[y/8][x] &= ~(1 << (y & 7));
+}
+
+/* Set (col != 0) or clear the @a mask bits of @a n consecutive page bytes */
+static void LCD_SpanOp(uint8_t *p, int n, uint8_t mask, int col)
+{
+	uint32_t *w, m = LCD_WORD(mask);
+
+	for (; (n > 0) && ((uint32_t) p & 3); n--, p++) {
+		*p = col ? (*p | mask) : (*p & ~mask);
+	}
+	for (w = (uint32_t *) p; n >= 4; n -= 4, w++) {
+		*w = col ? (*w | m) : (*w & ~m);
+	}
+	for (p = (uint8_t *) w; n > 0; n--, p++) {
+		*p = col ? (*p | mask) : (*p & ~mask);
+	}
+}
+
+/* Fill panel columns @a c0 to @a c1 of panel rows @a r0 to @a r1 */
+static void LCD_FillPanel(int c0, int c1, int r0, int r1, int col)
+{
+	int pg;
+	uint8_t mask;
+
+	for (pg = r0 >> 3; pg <= (r1 >> 3); pg++) {
+		mask = 0xFF;
+		if (pg == (r0 >> 3)) {
+			mask &= 0xFF << (r0 & 7);
+		}
+		if (pg == (r1 >> 3)) {
+			mask &= 0xFF >> (7 - (r1 & 7));
+		}
+		LCD_SpanOp(&fbuffer[pg][c0], c1 - c0 + 1, mask, col);
+	}
+}
+
+/* Fill a rectangle of the frame buffer, clipped to the display */
+static void LCD_FillArea(int left, int top, int right, int bottom, int col)
+{
+	if (left < 0) {
+		left = 0;
+	}
+	if (top < 0) {
+		top = 0;
+	}
+	if (right >= LCD_X_RES) {
+		right = LCD_X_RES - 1;
+	}
+	if (bottom >= LCD_Y_RES) {
+		bottom = LCD_Y_RES - 1;
+	}
+	if ((left > right) || (top > bottom)) {
+		return;
+	}
+
+#ifdef LCD_ORIENT_PORTRAIT
+	LCD_FillPanel(top, bottom, LCD_X_RES - right - 1, LCD_X_RES - left - 1, col);
+#else
+	LCD_FillPanel(left, right, top, bottom, col);
+#endif
+}
+
+/* Write @a n pixels of a panel column from panel row @a row, bit 0 of
+   @a bits is the top pixel, set bits take the font color and clear bits
+   the background color */
+static void LCD_WriteStrip(int pc, int row, int n, uint32_t bits)
+{
+	uint32_t m, v;
+	uint8_t *p = &fbuffer[row >> 3][pc];
+
+	v = (cf->fcolor ? bits : 0) | (cf->bgcolor ? ~bits : 0);
+	m = ((1UL << n) - 1) << (row & 7);
+	v = (v << (row & 7)) & m;
+	for (; m; m >>= 8, v >>= 8, p += LCD_COL_NUM) {
+		*p = (*p & ~m) | v;
+	}
+}
+
+/* Return the columns of a glyph as vertical bits, bit 0 at the top */
+static const uint16_t *LCD_GetGlyph(int index, uint16_t *tmp)
+{
+	const uint16_t *fp = cf->font->font_table + (index * cf->font->font_height);
+	uint16_t *cols = tmp;
+	int r, c;
+
+	if (index < LCD_GLYPH_CACHE_CHARS) {
+		cols = glyphCache[index];
+		if (glyphValid[index >> 5] & (1UL << (index & 31))) {
+			return cols;
+		}
+		glyphValid[index >> 5] |= 1UL << (index & 31);
+	}
+
+	memset(cols, 0, 16 * sizeof(uint16_t));
+	for (r = 0; r < cf->font->font_height; r++) {
+		for (c = 0; c < 16; c++) {
+			if (fp[r] & (0x8000 >> c)) {
+				cols[c] |= 1 << r;
+			}
+		}
+	}
+
+	return cols;
+}
+
 /* Get the width of a given char index (in pixels) */
 static int LCD_GetCharWidth(int index)
 {
@@ -119,6 +282,8 @@ void LCD_Init(void)
 {
 	int i;
 
+	deferred = false;
+
 	/* Initialize LCD and turn it On */
 	for (i = 0; i < sizeof(lcd_init_cmd); i++) {
 		LCD_WriteCmd(&lcd_init_cmd[i], 1);
@@ -135,15 +300,6 @@ void LCD_Refresh(int left, int top, int right, int bottom)
 {
 	int pg;
 
-	/* Sanity check boundaries */
-	if (right >= LCD_X_RES) {
-		right = LCD_X_RES - 1;
-	}
-
-	if (bottom >= LCD_Y_RES) {
-		bottom = LCD_Y_RES - 1;
-	}
-
 #ifdef LCD_ORIENT_PORTRAIT
 	pg = left;
 	left = top;
@@ -151,28 +307,200 @@ void LCD_Refresh(int left, int top, int right, int bottom)
 	right = bottom;
 	bottom = LCD_X_RES - pg - 1;
 #endif
+
+	/* Sanity check boundaries, in panel coordinates */
+	if (right >= (int) LCD_COL_NUM) {
+		right = LCD_COL_NUM - 1;
+	}
+	if (bottom >= (int) (LCD_PG_NUM * 8)) {
+		bottom = LCD_PG_NUM * 8 - 1;
+	}
+	if (left < 0) {
+		left = 0;
+	}
+	if (top < 0) {
+		top = 0;
+	}
+	if ((left > right) || (top > bottom)) {
+		return;
+	}
+
+	if (deferred) {
+		for (pg = top / 8; pg <= bottom / 8; pg ++) {
+			if (left < dirtyLo[pg]) {
+				dirtyLo[pg] = left;
+			}
+			if (right > dirtyHi[pg]) {
+				dirtyHi[pg] = right;
+			}
+		}
+		return;
+	}
+
 	for (pg = top / 8; pg <= bottom / 8; pg ++) {
 		LCD_SetRAMAddr(pg, left);
 		Board_LCD_WriteData(&fbuffer[pg][left], right - left + 1);
+		memcpy(&shadow[pg][left], &fbuffer[pg][left], right - left + 1);
 	}
 }
 
+/* Enable or disable deferred refresh */
+void LCD_SetDeferred(bool enable)
+{
+	int pg;
+
+	if (enable == deferred) {
+		return;
+	}
+
+	if (enable) {
+		LCD_ClearDirty();
+		deferred = true;
+		return;
+	}
+
+	/* The blocking writes must not cut into the bursts of a running flush */
+	if (flushXferNum > 0) {
+		while (!Chip_SSPDMA_IsDone(&flushXfer[flushXferNum - 1])) {}
+	}
+
+	/* Send what is still dirty the blocking way */
+	deferred = false;
+	for (pg = 0; pg < LCD_PG_NUM; pg++) {
+		if (dirtyLo[pg] <= dirtyHi[pg]) {
+			LCD_SetRAMAddr(pg, dirtyLo[pg]);
+			Board_LCD_WriteData(&fbuffer[pg][dirtyLo[pg]], dirtyHi[pg] - dirtyLo[pg] + 1);
+			memcpy(&shadow[pg][dirtyLo[pg]], &fbuffer[pg][dirtyLo[pg]], dirtyHi[pg] - dirtyLo[pg] + 1);
+		}
+	}
+}
+
+/* Queue the changed parts of the dirty regions on the LCD SSP DMA */
+uint32_t LCD_FlushAsync(SSPDMA_HANDLE_T *pHandle, SSPDMA_CALLBACK_T cb, void *cbData)
+{
+	uint8_t start[LCD_FLUSH_SPANS], end[LCD_FLUSH_SPANS];
+	int pg, col, i, spans, num = 0;
+	uint32_t bytes = 0;
+
+	/* The bursts of the previous flush are sent from the shadow buffer */
+	if ((flushXferNum > 0) && !Chip_SSPDMA_IsDone(&flushXfer[flushXferNum - 1])) {
+		return 0;
+	}
+
+	for (pg = 0; pg < LCD_PG_NUM; pg++) {
+		/* Dirty regions are bounding boxes, only send the columns that changed */
+		spans = 0;
+		for (col = dirtyLo[pg]; col <= dirtyHi[pg]; col++) {
+			if (fbuffer[pg][col] == shadow[pg][col]) {
+				continue;
+			}
+			if ((spans > 0) && ((col - end[spans - 1] <= LCD_FLUSH_GAP) || (spans == LCD_FLUSH_SPANS))) {
+				end[spans - 1] = col + 1;
+			}
+			else {
+				start[spans] = col;
+				end[spans] = col + 1;
+				spans++;
+			}
+			shadow[pg][col] = fbuffer[pg][col];
+		}
+
+		for (i = 0; i < spans; i++) {
+			flushCmd[pg][i][0] = 0xB0 | pg;
+			flushCmd[pg][i][1] = start[i] & 0x0F;
+			flushCmd[pg][i][2] = 0x10 | (start[i] >> 4);
+			Board_LCD_SetupXfer(&flushXfer[num++], true, flushCmd[pg][i], 3, NULL, NULL);
+			Board_LCD_SetupXfer(&flushXfer[num++], false, &shadow[pg][start[i]], end[i] - start[i], NULL, NULL);
+			bytes += 3 + end[i] - start[i];
+		}
+		flushStats.bursts += spans;
+	}
+	LCD_ClearDirty();
+
+	flushXferNum = num;
+	if (num == 0) {
+		return 0;
+	}
+
+	flushXfer[num - 1].cb = cb;
+	flushXfer[num - 1].cbData = cbData;
+	for (i = 0; i < num; i++) {
+		Chip_SSPDMA_Submit(pHandle, &flushXfer[i]);
+	}
+
+	flushStats.flushes++;
+	flushStats.bytes += bytes;
+	return bytes;
+}
+
+/* Return the deferred refresh statistics */
+const LCD_FLUSH_STATS_T *LCD_GetFlushStats(void)
+{
+	return &flushStats;
+}
+
 /* Sets a pixel in display RAM */
 void LCD_SetPixel(int x, int y, int col)
 {
-	if (x > LCD_X_RES || y > LCD_Y_RES)
+	if (x < 0 || y < 0 || x >= LCD_X_RES || y >= LCD_Y_RES)
 		return;
+	LCD_PlotPixel(x, y, col);
+}
+
+/* Clears or sets the whole display */
+void LCD_Clear(int col)
+{
+	memset(fbuffer, col ? 0xFF : 0, sizeof(fbuffer));
+	LCD_Refresh(0, 0, LCD_X_RES - 1, LCD_Y_RES - 1);
+}
+
+/* Scrolls the display content up */
+void LCD_ScrollUp(int lines, int col)
+{
+	if (lines <= 0) {
+		return;
+	}
+	if (lines >= LCD_Y_RES) {
+		LCD_Clear(col);
+		return;
+	}
+
 #ifdef LCD_ORIENT_PORTRAIT
+	/* Display rows are panel columns */
 	if (1) {
-		int t = x;
-		x = y;
-		y = LCD_X_RES - t - 1;
+		int pg;
+
+		for (pg = 0; pg < LCD_PG_NUM; pg++) {
+			memmove(&fbuffer[pg][0], &fbuffer[pg][lines], LCD_COL_NUM - lines);
+			memset(&fbuffer[pg][LCD_COL_NUM - lines], col ? 0xFF : 0, lines);
+		}
+	}
+#else
+	/* Display rows are panel rows, each byte moves up by whole pages and
+	   takes the low bits of the byte below, four columns at a time */
+	if (1) {
+		uint32_t fill = col ? 0xFFFFFFFF : 0, lo, hi;
+		uint32_t loMask = LCD_WORD(0xFF >> (lines & 7));
+		int pg, i, q = lines >> 3, s = lines & 7;
+
+		for (pg = 0; pg < LCD_PG_NUM; pg++) {
+			uint32_t *dst = (uint32_t *) fbuffer[pg];
+			const uint32_t *src1 = (pg + q < LCD_PG_NUM) ? (const uint32_t *) fbuffer[pg + q] : NULL;
+			const uint32_t *src2 = (pg + q + 1 < LCD_PG_NUM) ? (const uint32_t *) fbuffer[pg + q + 1] : NULL;
+
+			for (i = 0; i < LCD_COL_NUM / 4; i++) {
+				lo = src1 ? src1[i] : fill;
+				if (s == 0) {
+					dst[i] = lo;
+					continue;
+				}
+				hi = src2 ? src2[i] : fill;
+				dst[i] = ((lo >> s) & loMask) | ((hi << (8 - s)) & ~loMask);
+			}
+		}
 	}
 #endif
-	if (col)
-		fbuffer[y/8][x] |= 1 << (y & 7);
-	else
-		fbuffer[y/8][x] &= ~(1 << (y & 7));
+	LCD_Refresh(0, 0, LCD_X_RES - 1, LCD_Y_RES - 1);
 }
 
 /* Sets a pixel in the Display device */
@@ -185,29 +513,17 @@ void LCD_PutPixel(int x, int y, int col)
 /* Draw a rectangle with given coordinates and color */
 void LCD_DrawRect(int left, int top, int right, int bottom, int col)
 {
-	int i;
-
-	for (i = left; i <= right; i++) {
-		LCD_SetPixel(i, top, col);
-		LCD_SetPixel(i, bottom, col);
-	}
-	for (i = top + 1; i < bottom; i++) {
-		LCD_SetPixel(left, i, col);
-		LCD_SetPixel(right, i, col);
-	}
+	LCD_FillArea(left, top, right, top, col);
+	LCD_FillArea(left, bottom, right, bottom, col);
+	LCD_FillArea(left, top + 1, left, bottom - 1, col);
+	LCD_FillArea(right, top + 1, right, bottom - 1, col);
 	LCD_Refresh(left, top, right, bottom);
 }
 
 /* Draw a rectangle filled with given color */
 void LCD_FillRect(int left, int top, int right, int bottom, int col)
 {
-	int i, j;
-	/* TODO: improve this algorithm */
-	for (i = top; i <= bottom; i++) {
-		for (j = left; j <= right; j ++) {
-			LCD_SetPixel(j, i, col);
-		}
-	}
+	LCD_FillArea(left, top, right, bottom, col);
 	LCD_Refresh(left, top, right, bottom);
 }
 
@@ -217,14 +533,25 @@ void LCD_DrawLine(int x0, int y0, int x1, int y1, int col)
 	int dx = abs(x1-x0), sx = x0<x1 ? 1 : -1;
 	int dy = abs(y1-y0), sy = y0<y1 ? 1 : -1;
 	int err = (dx>dy ? dx : -dy)/2, e2;
+	int left = x0 < x1 ? x0 : x1, right = x0 < x1 ? x1 : x0;
+	int top = y0 < y1 ? y0 : y1, bottom = y0 < y1 ? y1 : y0;
 
-	LCD_PutPixel(x0, y0, col);
+	/* Horizontal and vertical lines are spans */
+	if (dx == 0 || dy == 0) {
+		LCD_FillArea(left, top, right, bottom, col);
+		LCD_Refresh(left, top, right, bottom);
+		return;
+	}
+
+	LCD_SetPixel(x0, y0, col);
 	while(x0 != x1 || y0 != y1){
 		e2 = err;
 		if (e2 >-dx) { err -= dy; x0 += sx; }
 		if (e2 < dy) { err += dx; y0 += sy; }
-		LCD_PutPixel(x0, y0, col);
+		if ((unsigned) x0 < LCD_X_RES && (unsigned) y0 < LCD_Y_RES)
+			LCD_PlotPixel(x0, y0, col);
 	}
+	LCD_Refresh(left, top, right, bottom);
 }
 
 
@@ -250,6 +577,7 @@ void LCD_SetFontWidth(int width)
 void LCD_SetFont(const FONT_T *font)
 {
 	cf->font = font;
+	memset(glyphValid, 0, sizeof(glyphValid));
 }
 
 /* Sets the space between two characters */
@@ -274,6 +602,32 @@ uint32_t LCD_PutCharXY(int xPos, int yPos, int ch)
 	w = LCD_GetCharWidth(ch) + cf->spacing;
 	h = cf->font->font_height;
 	fp = cf->font->font_table + (ch * h);
+
+	/* Cells on the display are written a panel column at a time */
+	if ((xPos >= 0) && (yPos >= 0) && (xPos + w <= LCD_X_RES) && (yPos + h <= LCD_Y_RES)) {
+#ifdef LCD_ORIENT_PORTRAIT
+		/* Font rows are panel columns, the leftmost pixel is the lowest row */
+		if (w <= 16) {
+			for (r = 0; r < h; r++) {
+				LCD_WriteStrip(yPos + r, LCD_X_RES - xPos - w, w, fp[r] >> (16 - w));
+			}
+			LCD_Refresh(xPos, yPos, xPos + w - 1, yPos +  h - 1);
+			return (xPos + w) | ((yPos + h) << 16);
+		}
+#else
+		if (h <= 16) {
+			uint16_t tmp[16];
+			const uint16_t *cols = LCD_GetGlyph(ch, tmp);
+
+			for (c = 0; c < w; c++) {
+				LCD_WriteStrip(xPos + c, yPos, h, (c < 16) ? cols[c] : 0);
+			}
+			LCD_Refresh(xPos, yPos, xPos + w - 1, yPos +  h - 1);
+			return (xPos + w) | ((yPos + h) << 16);
+		}
+#endif
+	}
+
 	for (r = 0; r < h; r++, fp++) {
 		uint16_t t = 0x8000;
 		for (c = 0; c < w; c ++, t >>= 1) {
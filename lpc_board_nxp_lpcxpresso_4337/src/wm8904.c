@@ -41,6 +41,13 @@
 
 #define WM8904_LOCK_TIMEOUT         10
 
+/* Largest number of register writes queued as one I2C batch */
+#define WM8904_BATCH_MAX            32
+
+/* Register write batch, transfers and their reg/MSB/LSB bytes */
+static I2C_QXFER_T wm8904Batch[WM8904_BATCH_MAX];
+static uint8_t wm8904BatchData[WM8904_BATCH_MAX][3];
+
 typedef struct __WM8904_Init_Seq {
     uint16_t reg_adr;
     uint16_t reg_val;
@@ -212,14 +219,13 @@ int WM8904_REG_VerifyMult(uint8_t reg, const uint8_t *value, uint8_t *buff, int
 /* WM8904 initialize function */
 int WM8904_Init(int input)
 {
-	I2C_EVENTHANDLER_T old = Chip_I2C_GetMasterEventHandler(WM8904_I2C_BUS);
 	int ret;
 
-	/* Initialize I2C */
+	/* Initialize I2C, transfers are queued so register writes can be batched */
 	Board_I2C_Init(WM8904_I2C_BUS);
 	Chip_I2C_Init(WM8904_I2C_BUS);
 	Chip_I2C_SetClockRate(WM8904_I2C_BUS, 100000);
-	Chip_I2C_SetMasterEventHandler(WM8904_I2C_BUS, Chip_I2C_EventHandlerPolling);
+	Chip_I2C_MasterQueueInit(WM8904_I2C_BUS);
 
 	/* Initialize the default values */
 	ret = Audio_Codec_SetDefaultValues((void *)&g_wm8904[0], sizeof(g_wm8904)/sizeof(WM8904_Init_Seq_t));
@@ -244,8 +250,7 @@ int WM8904_Init(int input)
 										  UDA1380_REG_ADC_DEFAULT_VALUE | input);
 		}
 	}
-#endif	
-	Chip_I2C_SetMasterEventHandler(WM8904_I2C_BUS, old);
+#endif
 
 	return ret;
 }
@@ -254,26 +259,56 @@ static void delay(uint32_t i) {
 	while (i--) {}
 }
 
+/* Queue a run of register writes as one batch and wait for it */
+static int WM8904_BatchWrite(const WM8904_Init_Seq_t *seq, uint32_t cnt)
+{
+	uint32_t i;
+
+	for (i = 0; i < cnt; i++) {
+		wm8904BatchData[i][0] = seq[i].reg_adr;
+		wm8904BatchData[i][1] = seq[i].reg_val >> 8;
+		wm8904BatchData[i][2] = seq[i].reg_val & 0xFF;
+		Chip_I2C_MasterSetupQXfer(&wm8904Batch[i], I2CDEV_WM8904_ADDR, wm8904BatchData[i], 3,
+								  NULL, 0, NULL, NULL);
+	}
+	Chip_I2C_MasterSubmit(WM8904_I2C_BUS, wm8904Batch, cnt);
+
+	/* Transfers complete in order, the last one ends the batch. Its completion
+	   wakes the wait handler of the bus, an RTOS blocks the task there. */
+	Chip_I2C_MasterQueueWait(WM8904_I2C_BUS, &wm8904Batch[cnt - 1]);
+	for (i = 0; i < cnt; i++) {
+		if (wm8904Batch[i].xfer.status != I2C_STATUS_DONE) {
+			return ERROR;
+		}
+	}
+	return SUCCESS;
+}
+
 /* Write multiple registers in one go */
 int WM8904_MultiRegWrite(const WM8904_Init_Seq_t* seq, uint32_t cnt)
 {
-    uint16_t rd_val = 1;
-    uint32_t i;
-    
-    for (i = 0; i < cnt; i++) {
-        /* check if it is delay register */
-        if (seq[i].reg_adr == 0xFF) {
-            
-            delay(seq[i].reg_val * 1000);
-						do { 
-				       rd_val = WM8904_REG_Read(0x70);
-            } while (rd_val & 1);
-        } else {
-            WM8904_REG_Write(seq[i].reg_adr, seq[i].reg_val);
-						rd_val = WM8904_REG_Read(seq[i].reg_adr);
-        }
-    }
-    return (SUCCESS);
+	uint16_t rd_val = 1;
+	uint32_t i, run;
+	int ret = SUCCESS;
+
+	for (i = 0; i < cnt; i += run) {
+		/* check if it is delay register */
+		if (seq[i].reg_adr == 0xFF) {
+			delay(seq[i].reg_val * 1000);
+			do {
+				rd_val = WM8904_REG_Read(0x70);
+			} while (rd_val & 1);
+			run = 1;
+			continue;
+		}
+
+		/* Writes up to the next delay entry go out back to back */
+		for (run = 0; (i + run < cnt) && (run < WM8904_BATCH_MAX) && (seq[i + run].reg_adr != 0xFF); run++) {}
+		if (WM8904_BatchWrite(&seq[i], run) != SUCCESS) {
+			ret = ERROR;
+		}
+	}
+	return ret;
 }
 
 /**
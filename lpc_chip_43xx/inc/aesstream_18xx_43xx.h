@@ -0,0 +1,213 @@
+/*
+ * @brief LPC18xx/43xx streaming AES-CBC/CTR service
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __AESSTREAM_18XX_43XX_H_
+#define __AESSTREAM_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup AESSTREAM_18XX_43XX CHIP: LPC18xx/43xx streaming AES service
+ * @ingroup AES_18XX_43XX
+ * Encryption requests are queued and run through the AES engine with the
+ * ROM DMA path, so the CPU keeps running while data moves. Requests are
+ * cut into chunks of up to AESSTREAM_CHUNK_BYTES. A stream context
+ * carries the CBC chaining value or the CTR counter from chunk to chunk
+ * and from one request to the next, so a long stream can be submitted
+ * piece by piece.<br>
+ * The engine only offers ECB and CBC. CTR runs the counter blocks through
+ * ECB in a scratch buffer and XORs the keystream into the output.<br>
+ * The service can also run on a software AES-128 instead of the engine,
+ * for parts and hosts without one. Chip_AESSTREAM_ProcessSW() runs the
+ * same code directly, to check results of the hardware path.<br>
+ * The ROM programs two GPDMA channels starting at the given one. They must
+ * not be given to the GPDMA channel manager. Completion is detected by
+ * Chip_AESSTREAM_Poll(), called from the DMA interrupt and periodically.
+ * @{
+ */
+
+/**
+ * @brief AES block size in bytes
+ */
+#define AESSTREAM_BLOCK_SIZE        16
+
+/**
+ * @brief Largest chunk run through the engine in one DMA operation
+ */
+#define AESSTREAM_CHUNK_BYTES       1024
+
+/**
+ * @brief Channel number selecting the software AES backend
+ */
+#define AESSTREAM_SOFTWARE          (-1)
+
+/**
+ * @brief Stream cipher modes
+ */
+typedef enum {
+	AESSTREAM_CBC_ENCRYPT,		/*!< CBC encryption */
+	AESSTREAM_CBC_DECRYPT,		/*!< CBC decryption */
+	AESSTREAM_CTR,				/*!< Counter mode, encryption and decryption */
+} AESSTREAM_MODE_T;
+
+/**
+ * @brief Stream context, one per key and direction
+ */
+typedef struct {
+	uint8_t key[AESSTREAM_BLOCK_SIZE];	/*!< AES-128 key */
+	uint8_t iv[AESSTREAM_BLOCK_SIZE];	/*!< CBC chaining value or CTR counter block, advanced by the stream */
+	AESSTREAM_MODE_T mode;				/*!< Cipher mode */
+} AESSTREAM_CTX_T;
+
+struct AESSTREAM_REQ;
+
+/**
+ * @brief Request completion callback
+ * @note	Called from the context that finished the request: the DMA
+ *			interrupt, the periodic poll, or the submitting function with the
+ *			software backend.
+ */
+typedef void (*AESSTREAM_CALLBACK_T)(struct AESSTREAM_REQ *pReq);
+
+/**
+ * @brief Stream request
+ * This structure and its buffers are owned by the caller and must remain
+ * valid until the request completes.
+ */
+typedef struct AESSTREAM_REQ {
+	AESSTREAM_CTX_T *pCtx;				/*!< Stream context */
+	const uint8_t *pIn;					/*!< Input data */
+	uint8_t *pOut;						/*!< Output data, may be the same as pIn */
+	uint32_t len;						/*!< Length in bytes */
+	AESSTREAM_CALLBACK_T cb;			/*!< Completion callback, can be NULL */
+	void *cbData;						/*!< User data for the callback */
+	volatile Status status;				/*!< Request status, valid once done is set */
+	volatile uint8_t done;				/*!< Set to 1 when the request completes */
+	uint32_t offset;					/*!< Internal: bytes processed */
+	struct AESSTREAM_REQ *next;			/*!< Internal: next queued request */
+} AESSTREAM_REQ_T;
+
+/**
+ * @brief	Initialize the stream service
+ * @param	channel	: First of the two GPDMA channels for the engine, or AESSTREAM_SOFTWARE
+ * @return	SUCCESS, or ERROR if the ROM rejects the DMA setup
+ * @note	The GPDMA must be initialized with Chip_GPDMA_Init() first. The
+ *			engine is initialized with Chip_AES_Init().
+ */
+Status Chip_AESSTREAM_Init(int32_t channel);
+
+/**
+ * @brief	Initialize a stream context
+ * @param	pCtx	: Pointer to context
+ * @param	mode	: Cipher mode
+ * @param	key		: 16 byte key
+ * @param	iv		: 16 byte initialization vector or initial counter block
+ * @return	Nothing
+ * @note	The CTR counter block is incremented as a 128-bit big endian number.
+ */
+void Chip_AESSTREAM_InitCtx(AESSTREAM_CTX_T *pCtx, AESSTREAM_MODE_T mode, const uint8_t *key, const uint8_t *iv);
+
+/**
+ * @brief	Prepare a stream request
+ * @param	pReq	: Pointer to request
+ * @param	pCtx	: Stream context
+ * @param	pOut	: Output buffer, may be the same as pIn
+ * @param	pIn		: Input buffer
+ * @param	len		: Length in bytes
+ * @param	cb		: Completion callback, or NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ * @note	With the engine both buffers must be 32-bit aligned.
+ */
+STATIC INLINE void Chip_AESSTREAM_SetupReq(AESSTREAM_REQ_T *pReq, AESSTREAM_CTX_T *pCtx, uint8_t *pOut,
+										   const uint8_t *pIn, uint32_t len, AESSTREAM_CALLBACK_T cb,
+										   void *cbData)
+{
+	pReq->pCtx = pCtx;
+	pReq->pOut = pOut;
+	pReq->pIn = pIn;
+	pReq->len = len;
+	pReq->cb = cb;
+	pReq->cbData = cbData;
+}
+
+/**
+ * @brief	Queue a stream request
+ * @param	pReq	: Pointer to request setup with Chip_AESSTREAM_SetupReq()
+ * @return	SUCCESS if the request was queued, ERROR on bad parameters
+ * @note	Requests run in submission order. CBC lengths must be a multiple
+ *			of AESSTREAM_BLOCK_SIZE. A CTR length may end in a partial block
+ *			only on the last request of a stream. With the software backend
+ *			the request is processed before this function returns.
+ */
+Status Chip_AESSTREAM_Submit(AESSTREAM_REQ_T *pReq);
+
+/**
+ * @brief	Return completion state of a stream request
+ * @param	pReq	: Pointer to submitted request
+ * @return	true if the request has completed, false if it is still pending
+ */
+STATIC INLINE bool Chip_AESSTREAM_IsDone(const AESSTREAM_REQ_T *pReq)
+{
+	return pReq->done != 0;
+}
+
+/**
+ * @brief	Check the engine and continue the queued requests
+ * @return	Nothing
+ * @note	Call this function from DMA_IRQHandler() and from a periodic
+ *			tick. The DMA interrupt finishes chunks promptly, the tick covers
+ *			ROM versions that run the AES channels without terminal count
+ *			interrupts.
+ */
+void Chip_AESSTREAM_Poll(void);
+
+/**
+ * @brief	Run data through the software AES, updating the context
+ * @param	pCtx	: Stream context
+ * @param	pOut	: Output buffer, may be the same as pIn
+ * @param	pIn		: Input buffer
+ * @param	len		: Length in bytes, same rules as Chip_AESSTREAM_Submit()
+ * @return	SUCCESS, or ERROR on a bad length
+ */
+Status Chip_AESSTREAM_ProcessSW(AESSTREAM_CTX_T *pCtx, uint8_t *pOut, const uint8_t *pIn, uint32_t len);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __AESSTREAM_18XX_43XX_H_ */
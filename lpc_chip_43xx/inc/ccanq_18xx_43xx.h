@@ -0,0 +1,216 @@
+/*
+ * @brief LPC18xx/43xx interrupt driven C_CAN driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __CCANQ_18XX_43XX_H_
+#define __CCANQ_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup CCANQ_18XX_43XX CHIP: LPC18xx/43xx interrupt driven C_CAN driver
+ * @ingroup CCAN_18XX_43XX
+ * The 32 message objects are handed out by a bitmap allocator. Receive
+ * filters get runs of consecutive objects chained as hardware FIFOs from
+ * the low end, so they also win the interrupt priority, and the transmit
+ * objects are taken from the high end.<br>
+ * The interrupt handler drains the receive FIFOs into a single producer,
+ * single consumer ring that tasks read with Chip_CCANQ_Receive() without
+ * locking. Frames to send are kept in a priority queue ordered by CAN
+ * arbitration (lowest identifier first, frames of equal identifier in
+ * submission order). Whenever all transmit objects are idle the next
+ * batch is loaded into them in that order, so a frame never waits behind
+ * more than CCANQ_TX_OBJS frames of lower priority.<br>
+ * Chip_CCAN_Init() and Chip_CCAN_SetBitRate() must be called first, and
+ * the C_CAN interrupt handler must call Chip_CCANQ_IRQHandler(). The
+ * message interface IF1 is used by the interrupt handler and IF2 inside
+ * critical sections, the blocking Chip_CCAN_* message functions must not
+ * be used once the driver runs.
+ * @{
+ */
+
+/**
+ * @brief Number of message objects used for transmission
+ */
+#ifndef CCANQ_TX_OBJS
+#define CCANQ_TX_OBJS               4
+#endif
+
+/**
+ * @brief Extended frame flag in identifiers, as in CCAN_MSG_OBJ_T
+ */
+#define CCANQ_ID_EXT                (1UL << 30)
+
+/**
+ * @brief Receive event callback, called from interrupt context after
+ * frames were added to the receive ring
+ */
+typedef void (*CCANQ_EVENT_T)(void);
+
+/**
+ * @brief Transmit queue entry, used by the driver
+ */
+typedef struct {
+	uint32_t prio;				/**< Arbitration field value, lowest is sent first */
+	uint32_t seq;				/**< Submission order among equal priorities */
+	CCAN_MSG_OBJ_T msg;			/**< Frame */
+} CCANQ_TXENTRY_T;
+
+/**
+ * @brief Driver setup
+ */
+typedef struct {
+	CCAN_MSG_OBJ_T *rxRing;		/**< Receive ring */
+	uint32_t rxRingSize;		/**< Number of frames in the ring, a power of 2 */
+	CCANQ_TXENTRY_T *txQueue;	/**< Transmit queue storage */
+	uint32_t txQueueSize;		/**< Number of frames in the transmit queue */
+	CCANQ_EVENT_T rxEvent;		/**< Receive event callback, can be NULL */
+} CCANQ_CFG_T;
+
+/**
+ * @brief Driver statistics
+ */
+typedef struct {
+	uint32_t rxFrames;			/**< Frames added to the receive ring */
+	uint32_t rxDropped;			/**< Frames dropped because the receive ring was full */
+	uint32_t rxOverruns;		/**< Frames lost by a full hardware FIFO */
+	uint32_t txFrames;			/**< Frames sent */
+	uint32_t txFull;			/**< Frames refused because the transmit queue was full */
+	uint32_t txBatches;			/**< Loads of the transmit objects */
+	uint32_t busErrors;			/**< Error warning or passive state changes */
+	uint32_t busOff;			/**< Bus off events, recovery is started by the driver */
+	uint32_t irqs;				/**< Interrupts handled */
+} CCANQ_STATS_T;
+
+/**
+ * @brief Driver handle, one per C_CAN controller
+ */
+typedef struct {
+	LPC_CCAN_T *pCCAN;			/**< C_CAN peripheral */
+	CCANQ_CFG_T cfg;			/**< Setup */
+	uint32_t freeObjs;			/**< Internal: free message objects, bit n for object n + 1 */
+	uint32_t rxObjs;			/**< Internal: receive objects */
+	uint32_t fifoEnds;			/**< Internal: last object of each receive FIFO */
+	uint8_t txFirst;			/**< Internal: first transmit object */
+	uint32_t txBusy;			/**< Internal: transmit objects holding a frame */
+	volatile uint32_t rxHead;	/**< Internal: receive ring write index */
+	volatile uint32_t rxTail;	/**< Internal: receive ring read index */
+	uint32_t txCount;			/**< Internal: frames in the transmit queue */
+	uint32_t txSeq;				/**< Internal: next submission number */
+	CCANQ_STATS_T stats;		/**< Statistics */
+} CCANQ_HANDLE_T;
+
+/**
+ * @brief	Start the driver on a C_CAN controller
+ * @param	pHandle	: Pointer to handle to initialize
+ * @param	pCCAN	: The base of C_CAN peripheral on the chip
+ * @param	pCfg	: Setup, copied by the driver
+ * @return	SUCCESS, or ERROR if the setup is invalid
+ * @note	All message objects are invalidated and the controller
+ * interrupts are enabled, the NVIC interrupt is left to the caller.
+ */
+Status Chip_CCANQ_Init(CCANQ_HANDLE_T *pHandle, LPC_CCAN_T *pCCAN, const CCANQ_CFG_T *pCfg);
+
+/**
+ * @brief	Add a receive filter backed by a hardware FIFO
+ * @param	pHandle	: Pointer to driver handle
+ * @param	id		: Identifier to accept, or-ed with CCANQ_ID_EXT for extended frames
+ * @param	mask	: Identifier bits that must match @a id, 0 accepts all identifiers
+ * @param	depth	: Number of message objects in the FIFO
+ * @return	Number of the first message object of the FIFO, to be passed to
+ * Chip_CCANQ_RemoveFilter(), or 0 if not enough consecutive objects are free
+ * @note	A frame is stored by the first filter it matches. Deeper FIFOs
+ * absorb longer bursts between two interrupts.
+ */
+uint8_t Chip_CCANQ_AddFilter(CCANQ_HANDLE_T *pHandle, uint32_t id, uint32_t mask, uint32_t depth);
+
+/**
+ * @brief	Remove a receive filter
+ * @param	pHandle	: Pointer to driver handle
+ * @param	first	: Value returned by Chip_CCANQ_AddFilter()
+ * @return	Nothing
+ */
+void Chip_CCANQ_RemoveFilter(CCANQ_HANDLE_T *pHandle, uint8_t first);
+
+/**
+ * @brief	Queue a frame for transmission
+ * @param	pHandle	: Pointer to driver handle
+ * @param	pMsg	: Frame, copied by the driver
+ * @return	SUCCESS, or ERROR if the transmit queue is full
+ * @note	This function can be called from an interrupt.
+ */
+Status Chip_CCANQ_Send(CCANQ_HANDLE_T *pHandle, const CCAN_MSG_OBJ_T *pMsg);
+
+/**
+ * @brief	Take the oldest frame from the receive ring
+ * @param	pHandle	: Pointer to driver handle
+ * @param	pMsg	: Pointer to store the frame
+ * @return	true if a frame was returned, false if the ring is empty
+ * @note	Must be called from a single context.
+ */
+bool Chip_CCANQ_Receive(CCANQ_HANDLE_T *pHandle, CCAN_MSG_OBJ_T *pMsg);
+
+/**
+ * @brief	Return the number of frames waiting in the transmit queue
+ * @param	pHandle	: Pointer to driver handle
+ * @return	Frames queued and not yet loaded in a transmit object
+ */
+STATIC INLINE uint32_t Chip_CCANQ_GetTxPending(const CCANQ_HANDLE_T *pHandle)
+{
+	return pHandle->txCount;
+}
+
+/**
+ * @brief	Return the driver statistics
+ * @param	pHandle	: Pointer to driver handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE const CCANQ_STATS_T *Chip_CCANQ_GetStats(const CCANQ_HANDLE_T *pHandle)
+{
+	return &pHandle->stats;
+}
+
+/**
+ * @brief	C_CAN interrupt handler
+ * @param	pHandle	: Pointer to driver handle
+ * @return	Nothing
+ */
+void Chip_CCANQ_IRQHandler(CCANQ_HANDLE_T *pHandle);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CCANQ_18XX_43XX_H_ */
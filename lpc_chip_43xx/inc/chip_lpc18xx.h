@@ -173,16 +173,23 @@ extern "C" {
 #include "adc_18xx_43xx.h"
 #include "atimer_18xx_43xx.h"
 #include "aes_18xx_43xx.h"
+#include "aesstream_18xx_43xx.h"
 #include "ccan_18xx_43xx.h"
+#include "ccanq_18xx_43xx.h"
 #include "dac_18xx_43xx.h"
 #include "eeprom_18xx_43xx.h"
+#include "eekv_18xx_43xx.h"
 #include "emc_18xx_43xx.h"
 #include "enet_18xx_43xx.h"
+#include "enetring_18xx_43xx.h"
 #include "fmc_18xx_43xx.h"
 #include "i2c_18xx_43xx.h"
 #include "i2s_18xx_43xx.h"
+#include "i2sdma_18xx_43xx.h"
 #include "gima_18xx_43xx.h"
 #include "gpdma_18xx_43xx.h"
+#include "gpdmamgr_18xx_43xx.h"
+#include "gpdmamem_18xx_43xx.h"
 #include "gpio_18xx_43xx.h"
 #include "pinint_18xx_43xx.h"
 #include "gpiogroup_18xx_43xx.h"
@@ -195,12 +202,18 @@ extern "C" {
 #include "sct_18xx_43xx.h"
 #include "sct_pwm_18xx_43xx.h"
 #include "sdmmc_18xx_43xx.h"
+#include "sdblk_18xx_43xx.h"
+#include "sdcache_18xx_43xx.h"
+#include "sdlog_18xx_43xx.h"
 #include "ssp_18xx_43xx.h"
+#include "sspdma_18xx_43xx.h"
 #include "timer_18xx_43xx.h"
 #include "uart_18xx_43xx.h"
+#include "telem_18xx_43xx.h"
 #include "usbhs_18xx_43xx.h"
 #include "wwdt_18xx_43xx.h"
 #include "romapi_18xx_43xx.h"
+#include "fwupd_18xx_43xx.h"
 #include "i2cm_18xx_43xx.h"
 
 #ifdef __cplusplus
@@ -175,18 +175,26 @@ extern "C" {
 #include "sdif_18xx_43xx.h"
 #include "adc_18xx_43xx.h"
 #include "hsadc_18xx_43xx.h"
+#include "hsadcdma_18xx_43xx.h"
 #include "atimer_18xx_43xx.h"
 #include "aes_18xx_43xx.h"
+#include "aesstream_18xx_43xx.h"
 #include "ccan_18xx_43xx.h"
+#include "ccanq_18xx_43xx.h"
 #include "dac_18xx_43xx.h"
 #include "eeprom_18xx_43xx.h"
+#include "eekv_18xx_43xx.h"
 #include "emc_18xx_43xx.h"
 #include "enet_18xx_43xx.h"
+#include "enetring_18xx_43xx.h"
 #include "fmc_18xx_43xx.h"
 #include "i2c_18xx_43xx.h"
 #include "i2s_18xx_43xx.h"
+#include "i2sdma_18xx_43xx.h"
 #include "gima_18xx_43xx.h"
 #include "gpdma_18xx_43xx.h"
+#include "gpdmamgr_18xx_43xx.h"
+#include "gpdmamem_18xx_43xx.h"
 #include "gpio_18xx_43xx.h"
 #include "pinint_18xx_43xx.h"
 #include "gpiogroup_18xx_43xx.h"
@@ -199,16 +207,23 @@ extern "C" {
 #include "sct_18xx_43xx.h"
 #include "sct_pwm_18xx_43xx.h"
 #include "sdmmc_18xx_43xx.h"
+#include "sdblk_18xx_43xx.h"
+#include "sdcache_18xx_43xx.h"
+#include "sdlog_18xx_43xx.h"
 #include "sdio_18xx_43xx.h"
 #include "sgpio_18xx_43xx.h"
 #include "spi_18xx_43xx.h"
 #include "ssp_18xx_43xx.h"
+#include "sspdma_18xx_43xx.h"
 #include "timer_18xx_43xx.h"
 #include "uart_18xx_43xx.h"
+#include "telem_18xx_43xx.h"
 #include "usbhs_18xx_43xx.h"
 #include "wwdt_18xx_43xx.h"
 #include "romapi_18xx_43xx.h"
+#include "fwupd_18xx_43xx.h"
 #include "i2cm_18xx_43xx.h"
+#include "ipcmbx_18xx_43xx.h"
 
 #if defined(CORE_M4)
 #include "fpu_init.h"
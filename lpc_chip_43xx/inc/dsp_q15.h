@@ -0,0 +1,249 @@
+/*
+ * @brief Fixed-point (q15) signal processing kernels
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __DSP_Q15_H_
+#define __DSP_Q15_H_
+
+#include "lpc_types.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup DSP_Q15 CHIP: Fixed-point q15 DSP kernels
+ * @ingroup CHIP_Common
+ * Filters, decimators, level metering and an FFT for 16-bit q15 sample
+ * data. On Cortex-M4 builds the kernels use the dual 16-bit SIMD
+ * instructions from core_cm4_simd.h; elsewhere the same instructions
+ * are emulated in C so the kernels can be built and checked on a host.
+ * Every kernel has a plain scalar *_Ref version that produces
+ * bit-identical output and can be used to verify the optimized one.
+ *
+ * Sample, coefficient, state and FFT buffers are read two samples at a
+ * time and must be 32-bit aligned.
+ * @{
+ */
+
+/** Largest transform size supported by DSP_FFT_Q15() */
+#define DSP_FFT_MAX_LEN         1024
+
+/**
+ * @brief FIR filter instance
+ */
+typedef struct {
+	const int16_t *pCoeffs;	/*!< numTaps coefficients, in time-reversed order */
+	int16_t *pState;		/*!< numTaps - 1 + blockSize samples of state */
+	uint16_t numTaps;		/*!< Number of taps, must be even */
+} DSP_FIR_Q15_T;
+
+/**
+ * @brief FIR decimator instance
+ */
+typedef struct {
+	DSP_FIR_Q15_T fir;		/*!< Anti-alias filter */
+	uint8_t factor;			/*!< Decimation factor */
+} DSP_DECIM_Q15_T;
+
+/**
+ * @brief Biquad cascade instance (direct form I)
+ */
+typedef struct {
+	const int16_t *pCoeffs;	/*!< 6 coefficients per stage: {b0, 0, b1, b2, a1, a2} */
+	int16_t *pState;		/*!< 4 samples of state per stage: {x[n-1], x[n-2], y[n-1], y[n-2]} */
+	uint8_t numStages;		/*!< Number of second order stages */
+	uint8_t postShift;		/*!< Coefficients are scaled down by 2^postShift */
+} DSP_BIQUAD_Q15_T;
+
+/**
+ * @brief Signal level of a block
+ */
+typedef struct {
+	int16_t rms;			/*!< Root mean square value */
+	int16_t peak;			/*!< Largest absolute sample value */
+} DSP_LEVEL_T;
+
+/**
+ * @brief	Initialize a FIR filter
+ * @param	pFIR		: Pointer to FIR instance
+ * @param	numTaps		: Number of taps, must be even (pad with a zero tap)
+ * @param	pCoeffs		: Coefficients b[numTaps - 1] ... b[0]
+ * @param	pState		: State buffer of numTaps - 1 + blockSize samples
+ * @return	Nothing
+ * @note	blockSize is the largest block that will be passed to
+ *			DSP_FIR_Q15(). The state is cleared.
+ */
+void DSP_FIR_Q15_Init(DSP_FIR_Q15_T *pFIR, uint16_t numTaps, const int16_t *pCoeffs, int16_t *pState);
+
+/**
+ * @brief	Run a block of samples through a FIR filter
+ * @param	pFIR		: Pointer to FIR instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, may be the same as pSrc
+ * @param	blockSize	: Number of samples
+ * @return	Nothing
+ * @note	The products are summed in 64 bits. The result is shifted
+ *			right by 15 and saturated to 16 bits.
+ */
+void DSP_FIR_Q15(DSP_FIR_Q15_T *pFIR, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Scalar reference version of DSP_FIR_Q15()
+ * @param	pFIR		: Pointer to FIR instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, may be the same as pSrc
+ * @param	blockSize	: Number of samples
+ * @return	Nothing
+ */
+void DSP_FIR_Q15_Ref(DSP_FIR_Q15_T *pFIR, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Initialize a FIR decimator
+ * @param	pDecim		: Pointer to decimator instance
+ * @param	factor		: Decimation factor
+ * @param	numTaps		: Number of taps, must be even
+ * @param	pCoeffs		: Coefficients b[numTaps - 1] ... b[0]
+ * @param	pState		: State buffer of numTaps - 1 + blockSize samples
+ * @return	Nothing
+ */
+void DSP_Decimate_Q15_Init(DSP_DECIM_Q15_T *pDecim, uint8_t factor, uint16_t numTaps,
+						   const int16_t *pCoeffs, int16_t *pState);
+
+/**
+ * @brief	Filter and decimate a block of samples
+ * @param	pDecim		: Pointer to decimator instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, blockSize / factor of them
+ * @param	blockSize	: Number of input samples, a multiple of factor
+ * @return	Nothing
+ * @note	Only the outputs that are kept are computed.
+ */
+void DSP_Decimate_Q15(DSP_DECIM_Q15_T *pDecim, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Scalar reference version of DSP_Decimate_Q15()
+ * @param	pDecim		: Pointer to decimator instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, blockSize / factor of them
+ * @param	blockSize	: Number of input samples, a multiple of factor
+ * @return	Nothing
+ */
+void DSP_Decimate_Q15_Ref(DSP_DECIM_Q15_T *pDecim, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Initialize a biquad cascade
+ * @param	pBQ			: Pointer to biquad instance
+ * @param	numStages	: Number of second order stages
+ * @param	pCoeffs		: 6 * numStages coefficients
+ * @param	pState		: 4 * numStages samples of state
+ * @param	postShift	: Coefficients are scaled down by 2^postShift (0 to 15)
+ * @return	Nothing
+ * @note	Each stage computes y = b0*x + b1*x[n-1] + b2*x[n-2] +
+ *			a1*y[n-1] + a2*y[n-2], so the feedback coefficients are
+ *			negated compared with the usual transfer function. The state
+ *			is cleared.
+ */
+void DSP_Biquad_Q15_Init(DSP_BIQUAD_Q15_T *pBQ, uint8_t numStages, const int16_t *pCoeffs,
+						 int16_t *pState, uint8_t postShift);
+
+/**
+ * @brief	Run a block of samples through a biquad cascade
+ * @param	pBQ			: Pointer to biquad instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, may be the same as pSrc
+ * @param	blockSize	: Number of samples
+ * @return	Nothing
+ * @note	Each stage sums in 64 bits, shifts right by 15 - postShift
+ *			and saturates to 16 bits.
+ */
+void DSP_Biquad_Q15(DSP_BIQUAD_Q15_T *pBQ, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Scalar reference version of DSP_Biquad_Q15()
+ * @param	pBQ			: Pointer to biquad instance
+ * @param	pSrc		: Input samples
+ * @param	pDst		: Output samples, may be the same as pSrc
+ * @param	blockSize	: Number of samples
+ * @return	Nothing
+ */
+void DSP_Biquad_Q15_Ref(DSP_BIQUAD_Q15_T *pBQ, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize);
+
+/**
+ * @brief	Measure the RMS and peak level of a block of samples
+ * @param	pSrc		: Samples
+ * @param	len			: Number of samples, must be even
+ * @param	pLevel		: Pointer to where to return the levels
+ * @return	Nothing
+ * @note	A full scale negative sample reads as a peak of 0x7FFF.
+ */
+void DSP_Level_Q15(const int16_t *pSrc, uint32_t len, DSP_LEVEL_T *pLevel);
+
+/**
+ * @brief	Scalar reference version of DSP_Level_Q15()
+ * @param	pSrc		: Samples
+ * @param	len			: Number of samples, must be even
+ * @param	pLevel		: Pointer to where to return the levels
+ * @return	Nothing
+ */
+void DSP_Level_Q15_Ref(const int16_t *pSrc, uint32_t len, DSP_LEVEL_T *pLevel);
+
+/**
+ * @brief	In-place complex radix-2 FFT
+ * @param	pData		: n complex samples, interleaved as {re, im}
+ * @param	n			: Transform size, a power of 2 from 4 to DSP_FFT_MAX_LEN
+ * @param	inverse		: true for the inverse transform
+ * @return	Nothing
+ * @note	Every stage halves its outputs, so the forward transform is
+ *			scaled by 1/n and cannot overflow for inputs with a complex
+ *			magnitude below 1. The inverse transform is the usual one,
+ *			including its 1/n, so a round trip returns the input / n.
+ *			The output is in natural order.
+ */
+void DSP_FFT_Q15(int16_t *pData, uint32_t n, bool inverse);
+
+/**
+ * @brief	Scalar reference version of DSP_FFT_Q15()
+ * @param	pData		: n complex samples, interleaved as {re, im}
+ * @param	n			: Transform size, a power of 2 from 4 to DSP_FFT_MAX_LEN
+ * @param	inverse		: true for the inverse transform
+ * @return	Nothing
+ */
+void DSP_FFT_Q15_Ref(int16_t *pData, uint32_t n, bool inverse);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_Q15_H_ */
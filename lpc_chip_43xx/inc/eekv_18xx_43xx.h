@@ -0,0 +1,191 @@
+/*
+ * @brief LPC18xx/43xx EEPROM key-value store
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __EEKV_18XX_43XX_H_
+#define __EEKV_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup EEKV_18XX_43XX CHIP: LPC18xx/43xx EEPROM key-value store
+ * @ingroup EEPROM_18XX_43XX
+ * Stores small values by 16-bit key in a range of EEPROM pages used as a
+ * circular log. Updates are appended as records to a page image in RAM
+ * that is programmed to the next page of the log once it is full, once
+ * the oldest buffered update is older than the flush delay, or on
+ * Chip_EEKV_Flush(). An update of a buffered value of the same length
+ * replaces it in place, so a burst of parameter changes costs a single
+ * page program.<br>
+ * Each page is programmed once per turn of the log, which spreads wear
+ * evenly over the range. The values still current in the page following
+ * the one being written are copied into the page image first, so a page
+ * never holds the only copy of a value when it is erased, and a power
+ * loss during a program only loses the updates of that page.<br>
+ * A RAM index sorted by key, rebuilt by Chip_EEKV_Init() from the pages,
+ * locates every value without scanning the EEPROM.
+ * @{
+ */
+
+/**
+ * @brief Largest value, in bytes
+ */
+#define EEKV_MAX_VALUE              32
+
+/**
+ * @brief Key reserved by the store
+ */
+#define EEKV_KEY_INVALID            0xFFFF
+
+/**
+ * @brief Index entry, located value of a key
+ */
+typedef struct {
+	uint16_t key;				/**< Key */
+	uint8_t page;				/**< Page of the log, or 0xFF for the page image */
+	uint8_t word;				/**< Word offset of the record in the page */
+} EEKV_INDEX_T;
+
+/**
+ * @brief Store setup
+ */
+typedef struct {
+	uint32_t firstPage;			/**< First EEPROM page of the log */
+	uint32_t numPages;			/**< Number of pages of the log, at least 3 */
+	EEKV_INDEX_T *index;		/**< Index storage */
+	uint32_t indexSize;			/**< Maximum number of keys */
+	uint32_t flushMs;			/**< Longest time an update stays in RAM */
+} EEKV_CFG_T;
+
+/**
+ * @brief Store statistics
+ */
+typedef struct {
+	uint32_t updates;			/**< Values set or deleted */
+	uint32_t coalesced;			/**< Updates replacing a buffered value */
+	uint32_t programs;			/**< Page programs */
+	uint32_t carriedBytes;		/**< Bytes copied forward from the oldest page */
+	uint32_t lookups;			/**< Values read */
+} EEKV_STATS_T;
+
+/**
+ * @brief Store handle
+ */
+typedef struct {
+	LPC_EEPROM_T *pEEPROM;		/**< EEPROM peripheral */
+	EEKV_CFG_T cfg;				/**< Setup */
+	uint32_t buf[EEPROM_PAGE_SIZE / 4];	/**< Internal: image of the next page */
+	uint32_t bufWords;			/**< Internal: words used in the page image */
+	uint32_t head;				/**< Internal: page the image is programmed to */
+	uint32_t seq;				/**< Internal: sequence number of the page image */
+	uint32_t numKeys;			/**< Internal: keys in the index */
+	uint32_t liveWords;			/**< Internal: words of the current records */
+	bool dirty;					/**< Internal: the page image holds updates */
+	uint32_t now;				/**< Internal: time of the last poll */
+	uint32_t dirtySince;		/**< Internal: time of the oldest buffered update */
+	EEKV_STATS_T stats;			/**< Statistics */
+} EEKV_HANDLE_T;
+
+/**
+ * @brief	Mount the store, building the index from the EEPROM pages
+ * @param	pHandle	: Pointer to handle to initialize
+ * @param	pEEPROM	: Pointer to EEPROM peripheral block structure
+ * @param	pCfg	: Setup, copied by the store
+ * @return	SUCCESS, or ERROR if the setup is invalid or the index is too small
+ * @note	Chip_EEPROM_Init() must be called first. A range without valid
+ * pages is an empty store, no formatting is needed.
+ */
+Status Chip_EEKV_Init(EEKV_HANDLE_T *pHandle, LPC_EEPROM_T *pEEPROM, const EEKV_CFG_T *pCfg);
+
+/**
+ * @brief	Set the value of a key
+ * @param	pHandle	: Pointer to store handle
+ * @param	key		: Key, any value but EEKV_KEY_INVALID
+ * @param	data	: Value
+ * @param	len		: Length of the value, 1 to EEKV_MAX_VALUE bytes
+ * @return	SUCCESS, or ERROR if the arguments are invalid or the store is full
+ * @note	This function may program pages, blocking for a few milliseconds each.
+ */
+Status Chip_EEKV_Set(EEKV_HANDLE_T *pHandle, uint16_t key, const void *data, uint32_t len);
+
+/**
+ * @brief	Read the value of a key
+ * @param	pHandle	: Pointer to store handle
+ * @param	key		: Key
+ * @param	data	: Buffer for the value
+ * @param	maxLen	: Size of the buffer, a longer value is truncated
+ * @return	Length of the value, or 0 if the key is not set
+ */
+uint32_t Chip_EEKV_Get(EEKV_HANDLE_T *pHandle, uint16_t key, void *data, uint32_t maxLen);
+
+/**
+ * @brief	Delete a key
+ * @param	pHandle	: Pointer to store handle
+ * @param	key		: Key
+ * @return	SUCCESS, or ERROR if the key is not set or the store is full
+ */
+Status Chip_EEKV_Delete(EEKV_HANDLE_T *pHandle, uint16_t key);
+
+/**
+ * @brief	Program the buffered updates now
+ * @param	pHandle	: Pointer to store handle
+ * @return	Nothing
+ */
+void Chip_EEKV_Flush(EEKV_HANDLE_T *pHandle);
+
+/**
+ * @brief	Program the buffered updates once the flush delay expired
+ * @param	pHandle	: Pointer to store handle
+ * @param	nowMs	: Current time in milliseconds
+ * @return	Nothing
+ * @note	Call periodically from a context that can block while a page is programmed.
+ */
+void Chip_EEKV_Poll(EEKV_HANDLE_T *pHandle, uint32_t nowMs);
+
+/**
+ * @brief	Return the store statistics
+ * @param	pHandle	: Pointer to store handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE const EEKV_STATS_T *Chip_EEKV_GetStats(const EEKV_HANDLE_T *pHandle)
+{
+	return &pHandle->stats;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EEKV_18XX_43XX_H_ */
@@ -0,0 +1,232 @@
+/*
+ * @brief LPC18xx/43xx zero-copy Ethernet descriptor ring driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __ENETRING_18XX_43XX_H_
+#define __ENETRING_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup ENETRING_18XX_43XX CHIP: LPC18xx/43xx zero-copy Ethernet descriptor ring driver
+ * @ingroup ENET_18XX_43XX
+ * Runs the ENET DMA with rings of enhanced descriptors. Each receive
+ * descriptor owns one preallocated buffer large enough for a full frame.
+ * A received frame is handed out by reference and its descriptor is only
+ * given back to the DMA by Chip_ENETRING_Release(), so frames may be held
+ * and released in any order. Frames are sent from application buffers,
+ * one descriptor per segment, and the buffers must stay valid until the
+ * frame callback runs.<br>
+ * Receive interrupts are mitigated: the first receive interrupt masks
+ * further ones and calls the event callback, the receiving task then
+ * pulls frames with Chip_ENETRING_Receive() until the ring is empty and
+ * re-arms the interrupt with Chip_ENETRING_EnableRXInt(). Under load the
+ * task keeps finding frames and runs without receive interrupts.<br>
+ * Chip_ENET_Init() must be called first. Chip_ENETRING_Receive(),
+ * Chip_ENETRING_Release() and Chip_ENETRING_EnableRXInt() must be called
+ * from a single context.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of descriptors in each ring
+ */
+#define ENETRING_MAX_DESCS          32
+
+/**
+ * @brief Receive buffer size, one full frame rounded up to a word
+ */
+#define ENETRING_RX_BUFSIZE         ((EMAC_ETH_MAX_FLEN + 3) & ~3)
+
+/**
+ * @brief Maximum size of one transmit segment
+ */
+#define ENETRING_MAX_SEGSIZE        0xFFF
+
+/**
+ * @brief Transmit segment, any alignment
+ */
+typedef struct {
+	const void *data;			/**< Segment data */
+	uint32_t len;				/**< Segment length, 1 to ENETRING_MAX_SEGSIZE */
+} ENETRING_SEG_T;
+
+/**
+ * @brief Received frame, valid until passed to Chip_ENETRING_Release()
+ */
+typedef struct {
+	uint8_t *data;				/**< Frame data in the receive buffer */
+	uint32_t len;				/**< Frame length without FCS */
+	uint32_t index;				/**< Descriptor index, used by the driver */
+} ENETRING_RXFRAME_T;
+
+/**
+ * @brief Frame sent callback, called from interrupt context
+ * The segments of the frame may be reused once it is called.
+ */
+typedef void (*ENETRING_TXCALLBACK_T)(void *cbData, Status status);
+
+/**
+ * @brief Receive event callback, called from interrupt context
+ * Called when frames arrived while the receive interrupt was enabled.
+ * The interrupt is masked until Chip_ENETRING_EnableRXInt() is called.
+ */
+typedef void (*ENETRING_EVENT_T)(void);
+
+/**
+ * @brief Descriptor ring setup
+ */
+typedef struct {
+	ENET_ENHTXDESC_T *txDescs;	/**< Transmit descriptors, word aligned */
+	uint32_t numTx;				/**< Number of transmit descriptors, 2 to ENETRING_MAX_DESCS */
+	ENET_ENHRXDESC_T *rxDescs;	/**< Receive descriptors, word aligned */
+	uint32_t *rxBuffers;		/**< numRx * ENETRING_RX_BUFSIZE bytes of receive buffers */
+	uint32_t numRx;				/**< Number of receive descriptors, 2 to ENETRING_MAX_DESCS */
+	ENETRING_EVENT_T rxEvent;	/**< Receive event callback */
+} ENETRING_CFG_T;
+
+/**
+ * @brief Descriptor ring statistics
+ */
+typedef struct {
+	uint32_t rxFrames;			/**< Frames handed out */
+	uint32_t rxBytes;			/**< Bytes handed out */
+	uint32_t rxErrors;			/**< Frames dropped with an error */
+	uint32_t rxNoBuffer;		/**< Times the receive DMA ran out of descriptors */
+	uint32_t rxInts;			/**< Receive interrupts taken, each starts a polling run */
+	uint32_t txFrames;			/**< Frames sent */
+	uint32_t txBytes;			/**< Bytes queued for sending */
+	uint32_t txErrors;			/**< Frames completed with an error */
+	uint32_t txAborted;			/**< Frames failed unsent because the link went down */
+	uint32_t txFull;			/**< Frames refused for lack of descriptors */
+	uint32_t linkChanges;		/**< Link state changes */
+	uint32_t busErrors;			/**< Fatal bus errors */
+} ENETRING_STATS_T;
+
+/**
+ * @brief	Initialize the descriptor rings and start the DMA
+ * @param	pENET	: The base of ENET peripheral on the chip
+ * @param	pCfg	: Ring setup, copied by the driver
+ * @return	SUCCESS, or ERROR if the setup is invalid
+ * @note	The MAC stays disabled until Chip_ENETRING_SetLink() reports
+ * the link up. The ETH interrupt handler must call
+ * Chip_ENETRING_IRQHandler() from now on.
+ */
+Status Chip_ENETRING_Init(LPC_ENET_T *pENET, const ENETRING_CFG_T *pCfg);
+
+/**
+ * @brief	Apply a PHY link state to the MAC
+ * @param	up			: true if the link is up
+ * @param	speed100	: true for 100Mbps, false for 10Mbps
+ * @param	full		: true for full duplex
+ * @return	Nothing
+ * @note	Sending and receiving are enabled only while the link is up.
+ * When the link goes down, frames not sent yet complete at once with
+ * ERROR through their callbacks.
+ */
+void Chip_ENETRING_SetLink(bool up, bool speed100, bool full);
+
+/**
+ * @brief	Return the link state set by Chip_ENETRING_SetLink()
+ * @return	true if the link is up
+ */
+bool Chip_ENETRING_IsLinkUp(void);
+
+/**
+ * @brief	Queue a frame made of one or more segments
+ * @param	pSegs	: Array of segments, copied by the driver
+ * @param	numSegs	: Number of segments
+ * @param	cb		: Callback when the frame is sent, or NULL
+ * @param	cbData	: User data for the callback
+ * @return	SUCCESS if queued, ERROR if the link is down or the ring is full
+ * @note	The segment data is sent in place. Can be called from an interrupt.
+ */
+Status Chip_ENETRING_Send(const ENETRING_SEG_T *pSegs, uint32_t numSegs,
+						  ENETRING_TXCALLBACK_T cb, void *cbData);
+
+/**
+ * @brief	Return the number of free transmit descriptors
+ * @return	Number of segments that can be queued
+ */
+uint32_t Chip_ENETRING_TXFree(void);
+
+/**
+ * @brief	Complete the frames the DMA has sent
+ * @return	Number of frames completed
+ * @note	Called from the interrupt handler, may also be called to reclaim
+ * descriptors early.
+ */
+uint32_t Chip_ENETRING_ReclaimTX(void);
+
+/**
+ * @brief	Get the next received frame
+ * @param	pFrame	: Filled with the frame
+ * @return	true if a frame was returned, false if the ring is empty
+ * @note	Frames with errors are dropped and their descriptors re-armed.
+ */
+bool Chip_ENETRING_Receive(ENETRING_RXFRAME_T *pFrame);
+
+/**
+ * @brief	Give the buffer of a received frame back to the DMA
+ * @param	pFrame	: Frame returned by Chip_ENETRING_Receive()
+ * @return	Nothing
+ */
+void Chip_ENETRING_Release(const ENETRING_RXFRAME_T *pFrame);
+
+/**
+ * @brief	Re-enable the receive interrupt once the ring is empty
+ * @return	true if the interrupt is enabled, false if a frame arrived
+ * meanwhile and Chip_ENETRING_Receive() must be called again
+ */
+bool Chip_ENETRING_EnableRXInt(void);
+
+/**
+ * @brief	ETH interrupt handler for the ring driver
+ * @return	Nothing
+ */
+void Chip_ENETRING_IRQHandler(void);
+
+/**
+ * @brief	Return the ring statistics
+ * @return	Pointer to the statistics, cleared by Chip_ENETRING_Init()
+ */
+ENETRING_STATS_T *Chip_ENETRING_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ENETRING_18XX_43XX_H_ */
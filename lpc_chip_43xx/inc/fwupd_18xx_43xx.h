@@ -0,0 +1,219 @@
+/*
+ * @brief LPC18xx/43xx dual bank firmware updater
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __FWUPD_18XX_43XX_H_
+#define __FWUPD_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup FWUPD_18XX_43XX CHIP: LPC18xx/43xx dual bank firmware updater
+ * @ingroup IAP_18XX_43XX
+ * Streams a new firmware image into the flash bank the application does
+ * not run from, while it keeps running from the other one.<br>
+ * Chip_FWUPD_Write() only copies the received data into a few page
+ * buffers and can be called from the receiving interrupt or task.
+ * Chip_FWUPD_Poll(), called from a low priority task, does one flash
+ * operation per call: it programs and compares the oldest full page, or
+ * when no page is waiting, erases the next sector of the image ahead of
+ * the data. Sector erases therefore overlap the transfer instead of
+ * delaying it. Once the last page is programmed, the CRC-32 of the
+ * image and the vector table checksum are checked, and
+ * Chip_FWUPD_Activate() makes the new bank the boot bank in a single
+ * IAP command.<br>
+ * The image must be linked for the address returned by
+ * Chip_FWUPD_GetTargetBase().
+ * @{
+ */
+
+/**
+ * @brief Flash program page size, in bytes
+ */
+#define FWUPD_PAGE_SIZE             512
+
+/**
+ * @brief Number of page buffers between Chip_FWUPD_Write() and Chip_FWUPD_Poll(),
+ * they should hold the data received during a sector erase (100 ms)
+ */
+#ifndef FWUPD_BUF_PAGES
+#define FWUPD_BUF_PAGES             16
+#endif
+
+/**
+ * @brief Size of a flash bank
+ */
+#ifndef FWUPD_BANK_SIZE
+#define FWUPD_BANK_SIZE             0x80000
+#endif
+
+/**
+ * @brief Flash bank addresses
+ */
+#define FWUPD_BANK_A_BASE           0x1A000000
+#define FWUPD_BANK_B_BASE           0x1B000000
+
+/**
+ * @brief Update states
+ */
+typedef enum {
+	FWUPD_IDLE,					/**< No update running */
+	FWUPD_RECEIVING,			/**< Image being received and programmed */
+	FWUPD_VERIFIED,				/**< Image programmed and checked, ready to activate */
+	FWUPD_FAILED,				/**< Flash error or image check failed */
+} FWUPD_STATE_T;
+
+/**
+ * @brief Updater statistics
+ */
+typedef struct {
+	uint32_t pages;				/**< Pages programmed */
+	uint32_t eraseAhead;		/**< Sectors erased before data waited for them */
+	uint32_t eraseStalls;		/**< Sectors erased while a page waited for them */
+	uint32_t writeFull;			/**< Writes cut short by full page buffers */
+} FWUPD_STATS_T;
+
+/**
+ * @brief Updater handle
+ */
+typedef struct {
+	uint32_t buf[FWUPD_BUF_PAGES][FWUPD_PAGE_SIZE / 4];	/**< Internal: received pages, word aligned for the IAP */
+	FWUPD_STATE_T state;		/**< Internal: update state */
+	uint8_t bank;				/**< Internal: IAP number of the bank being written */
+	uint8_t status;				/**< Last IAP status code */
+	uint32_t base;				/**< Internal: address of the bank being written */
+	uint32_t size;				/**< Internal: image size */
+	uint32_t crc;				/**< Internal: expected image CRC-32 */
+	uint32_t runCRC;			/**< Internal: CRC-32 of the programmed bytes */
+	volatile uint32_t received;	/**< Internal: bytes received, padding included */
+	volatile uint32_t programmed;	/**< Internal: bytes programmed */
+	uint32_t erased;			/**< Internal: bytes erased from the start of the bank */
+	FWUPD_STATS_T stats;		/**< Statistics */
+} FWUPD_HANDLE_T;
+
+/**
+ * @brief	Start an update
+ * @param	pHandle	: Pointer to updater handle
+ * @param	size	: Image size in bytes
+ * @param	crc		: CRC-32 (IEEE 802.3) of the image
+ * @return	SUCCESS, or ERROR if an update is running or the image does not fit
+ */
+Status Chip_FWUPD_Begin(FWUPD_HANDLE_T *pHandle, uint32_t size, uint32_t crc);
+
+/**
+ * @brief	Hand received image data to the updater
+ * @param	pHandle	: Pointer to updater handle
+ * @param	data	: Next bytes of the image
+ * @param	len		: Number of bytes
+ * @return	Number of bytes taken, less than @a len when the page buffers are full
+ * @note	Does not access the flash and can be called from an interrupt,
+ * from a single context.
+ */
+uint32_t Chip_FWUPD_Write(FWUPD_HANDLE_T *pHandle, const void *data, uint32_t len);
+
+/**
+ * @brief	Run the next flash operation of the update
+ * @param	pHandle	: Pointer to updater handle
+ * @return	true if a flash operation was run, false if there was nothing to do
+ * @note	Blocks the calling task during the operation: about 1 ms to
+ * program a page, up to 100 ms to erase a sector. The application must
+ * not run from the bank being written.
+ */
+bool Chip_FWUPD_Poll(FWUPD_HANDLE_T *pHandle);
+
+/**
+ * @brief	Make the verified image the boot image
+ * @param	pHandle	: Pointer to updater handle
+ * @return	SUCCESS, or ERROR if no verified image is waiting or the IAP fails
+ * @note	The new image runs after the next reset.
+ */
+Status Chip_FWUPD_Activate(FWUPD_HANDLE_T *pHandle);
+
+/**
+ * @brief	Stop the running update
+ * @param	pHandle	: Pointer to updater handle
+ * @return	Nothing
+ * @note	The boot bank is left unchanged.
+ */
+STATIC INLINE void Chip_FWUPD_Abort(FWUPD_HANDLE_T *pHandle)
+{
+	pHandle->state = FWUPD_IDLE;
+}
+
+/**
+ * @brief	Return the state of the update
+ * @param	pHandle	: Pointer to updater handle
+ * @return	Update state
+ */
+STATIC INLINE FWUPD_STATE_T Chip_FWUPD_GetState(const FWUPD_HANDLE_T *pHandle)
+{
+	return pHandle->state;
+}
+
+/**
+ * @brief	Return the address the image must be linked for
+ * @param	pHandle	: Pointer to updater handle
+ * @return	Base address of the bank being written
+ */
+STATIC INLINE uint32_t Chip_FWUPD_GetTargetBase(const FWUPD_HANDLE_T *pHandle)
+{
+	return pHandle->base;
+}
+
+/**
+ * @brief	Return the number of image bytes programmed
+ * @param	pHandle	: Pointer to updater handle
+ * @return	Bytes programmed
+ */
+STATIC INLINE uint32_t Chip_FWUPD_GetProgress(const FWUPD_HANDLE_T *pHandle)
+{
+	return pHandle->programmed;
+}
+
+/**
+ * @brief	Return the updater statistics
+ * @param	pHandle	: Pointer to updater handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE const FWUPD_STATS_T *Chip_FWUPD_GetStats(const FWUPD_HANDLE_T *pHandle)
+{
+	return &pHandle->stats;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __FWUPD_18XX_43XX_H_ */
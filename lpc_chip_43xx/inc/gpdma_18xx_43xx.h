@@ -207,6 +207,9 @@ typedef struct {
 #define GPDMA_CONN_DAC              ((27UL))		/**< DAC                */
 #define GPDMA_CONN_I2S1_Tx_Channel_0 ((28UL))		/**< I2S1 Tx on channel 0 */
 #define GPDMA_CONN_I2S1_Rx_Channel_1 ((29UL))		/**< I2S1 Rx on channel 0 */
+#if defined(CHIP_LPC43XX)
+#define GPDMA_CONN_ADCHS            ((30UL))		/**< HSADC FIFO read    */
+#endif
 
 /**
  * @brief GPDMA Burst size in Source and Destination definitions
@@ -386,6 +389,26 @@ Status Chip_GPDMA_SGTransfer(LPC_GPDMA_T *pGPDMA,
 							 const DMA_TransferDescriptor_t *DMADescriptor,
 							 GPDMA_FLOW_CONTROL_T TransferType);
 
+/**
+ * @brief	Do a DMA transfer using linked list of descriptors and explicit connections
+ * @param	pGPDMA			: The base of GPDMA on the chip
+ * @param	ChannelNum		: Channel used for transfer
+ * @param	DMADescriptor	: First node in the linked list of descriptors, prepared
+ *							  with Chip_GPDMA_PrepareDescriptor() or by hand
+ * @param	TransferType	: Select the transfer controller and the type of transfer. (See, #GPDMA_FLOW_CONTROL_T)
+ * @param	SrcConn			: Source PeripheralConnection_ID, or GPDMA_CONN_MEMORY
+ * @param	DstConn			: Destination PeripheralConnection_ID, or GPDMA_CONN_MEMORY
+ * @return	ERROR on error, SUCCESS on success
+ * @note	Unlike Chip_GPDMA_SGTransfer(), the descriptor addresses are used as is
+ *			and the DMA request lines are selected from @a SrcConn and @a DstConn.
+ */
+Status Chip_GPDMA_SGTransferConn(LPC_GPDMA_T *pGPDMA,
+								 uint8_t ChannelNum,
+								 const DMA_TransferDescriptor_t *DMADescriptor,
+								 GPDMA_FLOW_CONTROL_T TransferType,
+								 uint32_t SrcConn,
+								 uint32_t DstConn);
+
 /**
  * @brief	Prepare a single DMA descriptor
  * @param	pGPDMA			: The base of GPDMA on the chip
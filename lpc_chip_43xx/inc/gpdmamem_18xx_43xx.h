@@ -0,0 +1,236 @@
+/*
+ * @brief LPC18xx/43xx GPDMA asynchronous memory copy/fill engine
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __GPDMAMEM_18XX_43XX_H_
+#define __GPDMAMEM_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup GPDMAMEM_18XX_43XX CHIP: LPC18xx/43xx GPDMA memory copy/fill engine
+ * @ingroup GPDMA_18XX_43XX
+ * This engine runs memory to memory copy and fill requests through the GPDMA
+ * channel manager, one request at a time at GPDMAMGR_PRIO_LOW. Requests are
+ * queued and completed from the DMA interrupt, large transfers are split into
+ * linked list descriptors automatically and requests smaller than the CPU
+ * threshold are done with memcpy()/memset() directly.
+ * @{
+ */
+
+/**
+ * @brief Default size (in bytes) below which requests are done by the CPU
+ * This value can be overridden at run time using Chip_GPDMAMEM_SetThreshold()
+ * or measured on the target using Chip_GPDMAMEM_Calibrate().
+ */
+#ifndef GPDMAMEM_CPU_THRESHOLD
+#define GPDMAMEM_CPU_THRESHOLD      64
+#endif
+
+/**
+ * @brief Number of linked list descriptors built per DMA segment
+ * Longer requests are continued from the interrupt once a segment completes.
+ */
+#ifndef GPDMAMEM_MAX_DESC
+#define GPDMAMEM_MAX_DESC           8
+#endif
+
+/**
+ * @brief Maximum number of transfers a single GPDMA descriptor can move
+ */
+#define GPDMAMEM_MAX_XFER           0xFFF
+
+/**
+ * @brief GPDMA memory request operation
+ */
+typedef enum {
+	GPDMAMEM_OP_COPY,		/*!< Copy memory from source to destination */
+	GPDMAMEM_OP_FILL		/*!< Fill destination with a byte value */
+} GPDMAMEM_OP_T;
+
+struct GPDMAMEM_REQ;
+
+/**
+ * @brief GPDMA memory request completion callback
+ * @note	This callback is called from the DMA interrupt for requests done
+ *			by DMA and from Chip_GPDMAMEM_Submit() for requests done by CPU
+ *			or refused by the channel manager.
+ */
+typedef void (*GPDMAMEM_CALLBACK_T)(struct GPDMAMEM_REQ *pReq);
+
+/**
+ * @brief GPDMA memory request structure
+ * This structure is owned by the caller and must remain valid until
+ * the request completes.
+ */
+typedef struct GPDMAMEM_REQ {
+	uint8_t *dst;					/*!< Destination address */
+	const uint8_t *src;				/*!< Source address (GPDMAMEM_OP_COPY only) */
+	uint32_t len;					/*!< Number of bytes to copy or fill */
+	uint32_t fill;					/*!< Fill byte replicated to a word (GPDMAMEM_OP_FILL only) */
+	GPDMAMEM_OP_T op;				/*!< Request operation */
+	GPDMAMEM_CALLBACK_T cb;			/*!< Completion callback, can be NULL */
+	void *cbData;					/*!< User data for the callback */
+	volatile Status status;			/*!< Request status, valid once done is set */
+	volatile uint8_t done;			/*!< Set to 1 when the request completes */
+	uint8_t width;					/*!< Internal: GPDMA transfer width */
+	uint32_t pos;					/*!< Internal: next byte offset handled by DMA */
+	uint32_t end;					/*!< Internal: end of the DMA handled region */
+	struct GPDMAMEM_REQ *next;		/*!< Internal: next queued request */
+} GPDMAMEM_REQ_T;
+
+/**
+ * @brief GPDMA memory engine statistics
+ */
+typedef struct {
+	uint32_t cpuReqs;				/*!< Requests done by the CPU */
+	uint32_t dmaReqs;				/*!< Requests done by DMA */
+	uint32_t dmaBytes;				/*!< Bytes moved by DMA */
+	uint32_t segments;				/*!< Linked list segments started */
+	uint32_t errors;				/*!< Requests that ended with a DMA error */
+} GPDMAMEM_STATS_T;
+
+/**
+ * @brief	Initialize the GPDMA memory engine
+ * @return	Nothing
+ * @note	The GPDMA channel manager must be initialized with
+ *			Chip_GPDMAMGR_Init() first.
+ */
+void Chip_GPDMAMEM_Init(void);
+
+/**
+ * @brief	Prepare a memory copy request
+ * @param	pReq	: Pointer to request to setup
+ * @param	dst		: Destination address
+ * @param	src		: Source address
+ * @param	len		: Number of bytes to copy
+ * @param	cb		: Completion callback, can be NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ * @note	Source and destination regions must not overlap.
+ */
+STATIC INLINE void Chip_GPDMAMEM_SetupCopy(GPDMAMEM_REQ_T *pReq, void *dst, const void *src, uint32_t len,
+										   GPDMAMEM_CALLBACK_T cb, void *cbData)
+{
+	pReq->op = GPDMAMEM_OP_COPY;
+	pReq->dst = (uint8_t *) dst;
+	pReq->src = (const uint8_t *) src;
+	pReq->len = len;
+	pReq->cb = cb;
+	pReq->cbData = cbData;
+}
+
+/**
+ * @brief	Prepare a memory fill request
+ * @param	pReq	: Pointer to request to setup
+ * @param	dst		: Destination address
+ * @param	val		: Byte value to fill with
+ * @param	len		: Number of bytes to fill
+ * @param	cb		: Completion callback, can be NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_GPDMAMEM_SetupFill(GPDMAMEM_REQ_T *pReq, void *dst, uint8_t val, uint32_t len,
+										   GPDMAMEM_CALLBACK_T cb, void *cbData)
+{
+	pReq->op = GPDMAMEM_OP_FILL;
+	pReq->dst = (uint8_t *) dst;
+	pReq->src = NULL;
+	pReq->fill = val * 0x01010101UL;
+	pReq->len = len;
+	pReq->cb = cb;
+	pReq->cbData = cbData;
+}
+
+/**
+ * @brief	Submit a memory request
+ * @param	pReq	: Pointer to request setup with Chip_GPDMAMEM_SetupCopy()
+ *					  or Chip_GPDMAMEM_SetupFill()
+ * @return	SUCCESS if the request was queued or completed, ERROR if the
+ *			engine is not initialized
+ * @note	Requests smaller than the CPU threshold are completed before this
+ *			function returns. So is a request the channel manager refuses
+ *			to start, with status ERROR. This function can be called from
+ *			an interrupt.
+ */
+Status Chip_GPDMAMEM_Submit(GPDMAMEM_REQ_T *pReq);
+
+/**
+ * @brief	Return completion state of a memory request
+ * @param	pReq	: Pointer to submitted request
+ * @return	true if the request has completed, false if it is still pending
+ */
+STATIC INLINE bool Chip_GPDMAMEM_IsDone(const GPDMAMEM_REQ_T *pReq)
+{
+	return pReq->done != 0;
+}
+
+/**
+ * @brief	Set the size below which requests are done by the CPU
+ * @param	bytes	: Threshold in bytes
+ * @return	Nothing
+ */
+void Chip_GPDMAMEM_SetThreshold(uint32_t bytes);
+
+/**
+ * @brief	Return the size below which requests are done by the CPU
+ * @return	Threshold in bytes
+ */
+uint32_t Chip_GPDMAMEM_GetThreshold(void);
+
+/**
+ * @brief	Measure the memcpy() vs DMA crossover and set the CPU threshold
+ * @param	pBuf1	: Pointer to a scratch buffer of at least maxLen bytes
+ * @param	pBuf2	: Pointer to a second scratch buffer of at least maxLen bytes
+ * @param	maxLen	: Largest copy size to try (power of 2)
+ * @return	The new CPU threshold in bytes
+ * @note	Copies of 16 bytes up to maxLen are timed with the DWT cycle counter
+ *			both with memcpy() and with the DMA engine (submit to completion).
+ *			The DMA interrupt must be enabled and routed to the channel manager
+ *			before calling this function, and the engine must be idle.
+ */
+uint32_t Chip_GPDMAMEM_Calibrate(void *pBuf1, void *pBuf2, uint32_t maxLen);
+
+/**
+ * @brief	Return the GPDMA memory engine statistics
+ * @return	Pointer to the statistics structure
+ */
+const GPDMAMEM_STATS_T *Chip_GPDMAMEM_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GPDMAMEM_18XX_43XX_H_ */
@@ -0,0 +1,250 @@
+/*
+ * @brief LPC18xx/43xx GPDMA channel manager
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __GPDMAMGR_18XX_43XX_H_
+#define __GPDMAMGR_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup GPDMAMGR_18XX_43XX CHIP: LPC18xx/43xx GPDMA channel manager
+ * @ingroup GPDMA_18XX_43XX
+ * The channel manager owns a set of GPDMA channels and shares them between
+ * drivers. Transfer requests are queued per peripheral connection (only one
+ * transfer per connection runs at a time) and free channels are given to the
+ * highest priority queued request, oldest first. When a transfer completes,
+ * the next queued request is started from the DMA interrupt before the
+ * completion callback runs. The application must call
+ * Chip_GPDMAMGR_IRQHandler() from DMA_IRQHandler().
+ * @{
+ */
+
+/**
+ * @brief Number of peripheral connections (queues) handled by the manager
+ */
+#if defined(GPDMA_CONN_ADCHS)
+#define GPDMAMGR_NUM_CONN           (GPDMA_CONN_ADCHS + 1)
+#else
+#define GPDMAMGR_NUM_CONN           (GPDMA_CONN_I2S1_Rx_Channel_1 + 1)
+#endif
+
+/**
+ * @brief GPDMA manager request priorities
+ */
+#define GPDMAMGR_PRIO_HIGHEST       0	/*!< Highest priority, e.g. audio streams */
+#define GPDMAMGR_PRIO_HIGH          1	/*!< High priority, e.g. serial receive */
+#define GPDMAMGR_PRIO_NORMAL        2	/*!< Normal priority, e.g. serial transmit */
+#define GPDMAMGR_PRIO_LOW           3	/*!< Low priority, e.g. memory copies */
+
+struct GPDMAMGR_REQ;
+
+/**
+ * @brief GPDMA manager completion callback
+ * @note	This callback is called from the DMA interrupt. It may submit new
+ *			requests.
+ */
+typedef void (*GPDMAMGR_CALLBACK_T)(struct GPDMAMGR_REQ *pReq);
+
+/**
+ * @brief GPDMA manager transfer request
+ * This structure, and the descriptors it points to, are owned by the caller
+ * and must remain valid until the request completes.
+ */
+typedef struct GPDMAMGR_REQ {
+	const DMA_TransferDescriptor_t *pDesc;	/*!< First descriptor of the transfer, linked through lli */
+	GPDMA_FLOW_CONTROL_T type;				/*!< Transfer type and flow controller */
+	uint8_t srcConn;						/*!< Source connection ID, GPDMA_CONN_MEMORY for memory */
+	uint8_t dstConn;						/*!< Destination connection ID, GPDMA_CONN_MEMORY for memory */
+	uint8_t priority;						/*!< Request priority, GPDMAMGR_PRIO_* */
+	GPDMAMGR_CALLBACK_T cb;					/*!< Completion callback, can be NULL */
+	GPDMAMGR_CALLBACK_T progressCb;			/*!< Descriptor interrupt callback while running, can be NULL */
+	void *cbData;							/*!< User data for the callbacks */
+	volatile Status status;					/*!< Request status, valid once done is set */
+	volatile uint8_t done;					/*!< Set to 1 when the request completes */
+	uint8_t channel;						/*!< Internal: channel running the request */
+	uint32_t seq;							/*!< Internal: submission order */
+	struct GPDMAMGR_REQ *next;				/*!< Internal: next request in queue */
+} GPDMAMGR_REQ_T;
+
+/**
+ * @brief GPDMA manager per channel statistics
+ */
+typedef struct {
+	uint32_t transfers;			/*!< Completed transfers */
+	uint32_t errors;			/*!< Transfers that ended with a DMA error */
+	uint32_t busyTicks;			/*!< Core clock cycles the channel was busy */
+	uint32_t startTick;			/*!< Internal: cycle count at transfer start */
+} GPDMAMGR_CH_STATS_T;
+
+/**
+ * @brief	Initialize the GPDMA channel manager
+ * @param	pGPDMA		: The base of GPDMA on the chip
+ * @param	chanMask	: Bit mask of GPDMA channels given to the manager
+ * @return	Nothing
+ * @note	The GPDMA must be initialized with Chip_GPDMA_Init() first. Channels
+ *			in @a chanMask must not be used directly by other drivers. Lower
+ *			channel numbers have a higher hardware priority and are given to
+ *			higher priority requests first.
+ */
+void Chip_GPDMAMGR_Init(LPC_GPDMA_T *pGPDMA, uint8_t chanMask);
+
+/**
+ * @brief	Prepare a transfer request
+ * @param	pReq		: Pointer to request to setup
+ * @param	pDesc		: First descriptor of the transfer
+ * @param	type		: Transfer type and flow controller
+ * @param	srcConn		: Source connection ID, or GPDMA_CONN_MEMORY
+ * @param	dstConn		: Destination connection ID, or GPDMA_CONN_MEMORY
+ * @param	priority	: Request priority, GPDMAMGR_PRIO_*
+ * @param	cb			: Completion callback, can be NULL
+ * @param	cbData		: User data for the callback
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_GPDMAMGR_SetupReq(GPDMAMGR_REQ_T *pReq, const DMA_TransferDescriptor_t *pDesc,
+										  GPDMA_FLOW_CONTROL_T type, uint8_t srcConn, uint8_t dstConn,
+										  uint8_t priority, GPDMAMGR_CALLBACK_T cb, void *cbData)
+{
+	pReq->pDesc = pDesc;
+	pReq->type = type;
+	pReq->srcConn = srcConn;
+	pReq->dstConn = dstConn;
+	pReq->priority = priority;
+	pReq->cb = cb;
+	pReq->progressCb = NULL;
+	pReq->cbData = cbData;
+}
+
+/**
+ * @brief	Set the progress callback of a transfer request
+ * @param	pReq	: Pointer to request setup with Chip_GPDMAMGR_SetupReq()
+ * @param	cb		: Callback for descriptor interrupts, or NULL
+ * @return	Nothing
+ * @note	The callback is called from the DMA interrupt for every terminal
+ *			count interrupt of a descriptor that is not the last one. This lets
+ *			a circular descriptor chain, which never completes, stream data.
+ *			Interrupts of back to back descriptors may be merged into one call.
+ */
+STATIC INLINE void Chip_GPDMAMGR_SetProgressCb(GPDMAMGR_REQ_T *pReq, GPDMAMGR_CALLBACK_T cb)
+{
+	pReq->progressCb = cb;
+}
+
+/**
+ * @brief	Queue a transfer request
+ * @param	pReq	: Pointer to request setup with Chip_GPDMAMGR_SetupReq()
+ * @return	SUCCESS if the request was queued, ERROR on bad parameters
+ * @note	The transfer starts as soon as its connection is idle and a channel
+ *			is free. This function can be called from an interrupt.
+ */
+Status Chip_GPDMAMGR_Submit(GPDMAMGR_REQ_T *pReq);
+
+/**
+ * @brief	Cancel a queued or running transfer request
+ * @param	pReq	: Pointer to submitted request
+ * @return	SUCCESS if the request was cancelled, ERROR if it already completed
+ * @note	A cancelled request completes with status ERROR and its callback
+ *			is called before this function returns.
+ */
+Status Chip_GPDMAMGR_Cancel(GPDMAMGR_REQ_T *pReq);
+
+/**
+ * @brief	Return completion state of a transfer request
+ * @param	pReq	: Pointer to submitted request
+ * @return	true if the request has completed, false if it is still pending
+ */
+STATIC INLINE bool Chip_GPDMAMGR_IsDone(const GPDMAMGR_REQ_T *pReq)
+{
+	return pReq->done != 0;
+}
+
+/**
+ * @brief	Return the descriptor a running request will load next
+ * @param	pReq	: Pointer to a running request
+ * @return	Address of the next descriptor, or NULL if the request is not running
+ * @note	Lets a progress callback of a circular chain find out how many
+ *			descriptors ended since the last call.
+ */
+const DMA_TransferDescriptor_t *Chip_GPDMAMGR_GetNextDesc(const GPDMAMGR_REQ_T *pReq);
+
+/**
+ * @brief	GPDMA channel manager interrupt handler
+ * @param	pGPDMA	: The base of GPDMA on the chip
+ * @return	true if a managed channel had a pending interrupt, otherwise false
+ * @note	Call this function from DMA_IRQHandler().
+ */
+bool Chip_GPDMAMGR_IRQHandler(LPC_GPDMA_T *pGPDMA);
+
+/**
+ * @brief	Return the number of requests waiting on a connection
+ * @param	conn	: Connection ID (GPDMA_CONN_MEMORY for memory to memory)
+ * @return	Number of queued requests, not counting the running one
+ */
+uint32_t Chip_GPDMAMGR_GetQueueDepth(uint8_t conn);
+
+/**
+ * @brief	Return the highest queue depth seen on a connection
+ * @param	conn	: Connection ID (GPDMA_CONN_MEMORY for memory to memory)
+ * @return	Highest number of queued requests since the last statistics reset
+ */
+uint32_t Chip_GPDMAMGR_GetMaxQueueDepth(uint8_t conn);
+
+/**
+ * @brief	Return the statistics of a channel
+ * @param	channel	: GPDMA channel number
+ * @return	Pointer to the channel statistics
+ */
+const GPDMAMGR_CH_STATS_T *Chip_GPDMAMGR_GetChannelStats(uint8_t channel);
+
+/**
+ * @brief	Return the utilization of a channel
+ * @param	channel	: GPDMA channel number
+ * @return	Busy time in 1/1000 of the time since the last statistics reset
+ * @note	Busy time is measured with the DWT cycle counter, the window between
+ *			two resets must be shorter than 2^32 core clock cycles.
+ */
+uint32_t Chip_GPDMAMGR_GetUtilization(uint8_t channel);
+
+/**
+ * @brief	Reset channel and queue statistics
+ * @return	Nothing
+ */
+void Chip_GPDMAMGR_ResetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __GPDMAMGR_18XX_43XX_H_ */
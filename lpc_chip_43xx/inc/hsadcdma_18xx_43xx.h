@@ -0,0 +1,152 @@
+/*
+ * @brief LPC43xx HSADC streaming acquisition over GPDMA
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __HSADCDMA_18XX_43XX_H_
+#define __HSADCDMA_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup HSADCDMA_18XX_43XX CHIP: LPC43xx HSADC streaming acquisition over GPDMA
+ * @ingroup HSADC_18XX_43XX
+ * A circular chain of GPDMA descriptors, one per block buffer, moves packed
+ * FIFO words, two samples per word, into a pool of block buffers without CPU
+ * copies. Each full block is queued for the consumer, which gets it by
+ * reference with Chip_HSADCDMA_GetBlock() and gives it back with
+ * Chip_HSADCDMA_ReleaseBlock(). A descriptor whose block the consumer still
+ * holds when the DMA is about to reach it is pointed at a discard word, so
+ * held blocks are never overwritten. Its data is counted as dropped and
+ * leaves a gap in the block sequence numbers.<br>
+ * The HSADC conversion descriptors, clock and inputs are set up by the
+ * application with the Chip_HSADC_* functions. The DMA interrupt must run
+ * within numBlocks - 2 block times of each block end. The stream holds a
+ * GPDMA channel of the channel manager for as long as it runs.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of block buffers
+ */
+#define HSADCDMA_MAX_BLOCKS         32
+
+/**
+ * @brief Maximum block size in 32-bit FIFO words, limited by the DMA transfer size
+ */
+#define HSADCDMA_MAX_BLOCK_WORDS    0xFFF
+
+/**
+ * @brief FIFO trip level used for DMA requests
+ */
+#define HSADCDMA_FIFO_TRIP          8
+
+/**
+ * @brief Block ready callback, called from the DMA interrupt
+ */
+typedef void (*HSADCDMA_CALLBACK_T)(void);
+
+/**
+ * @brief HSADC stream statistics
+ */
+typedef struct {
+	uint32_t blocks;			/**< Blocks queued for the consumer */
+	uint32_t dropped;			/**< Blocks discarded for lack of a free buffer */
+	uint32_t overruns;			/**< Times the stream started discarding */
+	uint32_t lateIrqs;			/**< Block interrupts served after the next block had ended, harmless */
+	uint32_t fifoOverflows;		/**< Blocks during which the HSADC FIFO overflowed */
+	uint32_t maxQueued;			/**< Highest number of blocks waiting for the consumer */
+} HSADCDMA_STATS_T;
+
+/**
+ * @brief	Initialize the HSADC stream
+ * @param	pHSADC		: The base of HSADC peripheral on the chip
+ * @param	buffers		: numBlocks * blockWords words of block buffers
+ * @param	blockWords	: Words per block, 4 to HSADCDMA_MAX_BLOCK_WORDS, a multiple of 4
+ * @param	numBlocks	: Number of blocks, 3 to HSADCDMA_MAX_BLOCKS
+ * @param	cb			: Block ready callback, or NULL
+ * @return	SUCCESS, or ERROR on bad parameters
+ * @note	Sets the FIFO to packed mode with a trip level of
+ * HSADCDMA_FIFO_TRIP. The consumer has numBlocks - 2 blocks of slack
+ * before blocks are dropped. The GPDMA channel manager must be initialized.
+ */
+Status Chip_HSADCDMA_Init(LPC_HSADC_T *pHSADC, uint32_t *buffers, uint32_t blockWords,
+						  uint32_t numBlocks, HSADCDMA_CALLBACK_T cb);
+
+/**
+ * @brief	Start streaming the HSADC FIFO
+ * @return	SUCCESS, or ERROR if the DMA request could not be queued
+ * @note	The FIFO is flushed and all blocks are returned to the pool.
+ * Conversions are then started by the application, with
+ * Chip_HSADC_SWTrigger() or an external trigger.
+ */
+Status Chip_HSADCDMA_Start(void);
+
+/**
+ * @brief	Stop streaming
+ * @return	Nothing
+ * @note	Blocks already queued stay available to the consumer.
+ */
+void Chip_HSADCDMA_Stop(void);
+
+/**
+ * @brief	Get the oldest full block
+ * @param	pSeq	: Where to store the block sequence number, or NULL
+ * @return	Pointer to the block words, or NULL if none is ready
+ * @note	The block stays owned by the caller until released. Sequence
+ * numbers count every block since Chip_HSADCDMA_Start(), dropped ones
+ * included, so a block that does not follow the previous one continues
+ * the signal after a gap.
+ */
+uint32_t *Chip_HSADCDMA_GetBlock(uint32_t *pSeq);
+
+/**
+ * @brief	Give a block back to the stream
+ * @param	block	: Block returned by Chip_HSADCDMA_GetBlock()
+ * @return	Nothing
+ */
+void Chip_HSADCDMA_ReleaseBlock(uint32_t *block);
+
+/**
+ * @brief	Return the stream statistics
+ * @return	Pointer to the statistics, cleared by Chip_HSADCDMA_Start()
+ */
+HSADCDMA_STATS_T *Chip_HSADCDMA_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HSADCDMA_18XX_43XX_H_ */
@@ -161,6 +161,38 @@ typedef enum {
  */
 typedef void (*I2C_EVENTHANDLER_T)(I2C_ID_T, I2C_EVENT_T);
 
+struct I2C_QXFER;
+
+/**
+ * @brief	Queued transfer completion callback, called from the I2C interrupt
+ */
+typedef void (*I2C_QCALLBACK_T)(struct I2C_QXFER *pQXfer);
+
+/**
+ * @brief Queued master transfer
+ * The structure and its buffers are owned by the caller and must remain
+ * valid until @a done is set.
+ */
+typedef struct I2C_QXFER {
+	I2C_XFER_T xfer;		/**< Transfer, its status is final once done is set */
+	I2C_QCALLBACK_T cb;		/**< Completion callback or NULL */
+	void *cbData;			/**< User data for the callback */
+	volatile uint8_t done;	/**< Set to 1 when the transfer has completed */
+	struct I2C_QXFER *next;	/**< Queue link, used by the driver */
+} I2C_QXFER_T;
+
+/**
+ * @brief Queued master transfer statistics, times in CPU cycles
+ */
+typedef struct {
+	uint32_t xfers;			/**< Transfers completed with I2C_STATUS_DONE */
+	uint32_t errors;		/**< Transfers completed with any other status */
+	uint32_t busyTicks;		/**< Time from start to stop of all transfers */
+	uint32_t chained;		/**< Transfers started straight from the previous completion */
+	uint32_t gapTicks;		/**< Stop request to next start condition, chained transfers */
+	uint32_t maxGapTicks;	/**< Longest bus idle time before a chained transfer */
+} I2C_QSTATS_T;
+
 /**
  * @brief	Initializes the LPC_I2C peripheral with specified parameter.
  * @param	id			: I2C peripheral ID (I2C0, I2C1 ... etc)
@@ -389,6 +421,111 @@ void Chip_I2C_SlaveStateHandler(I2C_ID_T id);
  */
 int Chip_I2C_IsStateChanged(I2C_ID_T id);
 
+/**
+ * @brief	Switch the master side of an I2C bus to queued operation
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	1 when successful, 0 when a transfer is on going
+ * @note
+ * Transfers are then queued with Chip_I2C_MasterSubmit() and the next
+ * one is started from the completion of the previous one. The interrupt
+ * handler of the bus must call Chip_I2C_MasterStateHandler(), or the
+ * application must call Chip_I2C_MasterQueuePoll() when the interrupt is
+ * not enabled. Chip_I2C_MasterTransfer() and the functions built on it
+ * keep working, they queue the transfer and wait for it with
+ * Chip_I2C_MasterQueueWait(). Slave operation is not supported on a
+ * queued bus.
+ */
+int Chip_I2C_MasterQueueInit(I2C_ID_T id);
+
+/**
+ * @brief	Set the handler that blocks tasks waiting for queued transfers
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	event	: Wait handler, or NULL to busy wait
+ * @return	Nothing
+ * @note
+ * Chip_I2C_MasterQueueWait() calls the handler with #I2C_EVENT_LOCK and
+ * #I2C_EVENT_UNLOCK around the wait, and with #I2C_EVENT_WAIT until the
+ * transfer is done. The completion of the transfer calls it from the I2C
+ * interrupt with #I2C_EVENT_DONE, e.g. to give the semaphore taken on
+ * #I2C_EVENT_WAIT. The handler is kept by Chip_I2C_MasterQueueInit().
+ * While the I2C interrupt cannot be taken, the handler can call
+ * Chip_I2C_MasterQueuePoll() on #I2C_EVENT_WAIT instead of sleeping.
+ */
+void Chip_I2C_SetQueueWaitHandler(I2C_ID_T id, I2C_EVENTHANDLER_T event);
+
+/**
+ * @brief	Setup a queued master transfer
+ * @param	pQXfer		: Pointer to queued transfer to setup
+ * @param	slaveAddr	: 7-bit slave address
+ * @param	txBuff		: Bytes to send, or NULL
+ * @param	txSz		: Number of bytes to send
+ * @param	rxBuff		: Buffer for received bytes, or NULL
+ * @param	rxSz		: Number of bytes to receive after a repeated start
+ * @param	cb			: Completion callback or NULL
+ * @param	cbData		: User data for the callback
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_I2C_MasterSetupQXfer(I2C_QXFER_T *pQXfer, uint8_t slaveAddr,
+											 const uint8_t *txBuff, int txSz, uint8_t *rxBuff, int rxSz,
+											 I2C_QCALLBACK_T cb, void *cbData)
+{
+	pQXfer->xfer.slaveAddr = slaveAddr;
+	pQXfer->xfer.txBuff = txBuff;
+	pQXfer->xfer.txSz = txSz;
+	pQXfer->xfer.rxBuff = rxBuff;
+	pQXfer->xfer.rxSz = rxSz;
+	pQXfer->cb = cb;
+	pQXfer->cbData = cbData;
+}
+
+/**
+ * @brief	Queue a batch of master transfers
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	pQXfer	: Pointer to an array of transfers
+ * @param	count	: Number of transfers in the array
+ * @return	Nothing
+ * @note	The transfers run back to back in array order, each ending
+ * with a stop condition. The batch is queued atomically so no other
+ * transfer can be interleaved with it. Can be called from an interrupt.
+ */
+void Chip_I2C_MasterSubmit(I2C_ID_T id, I2C_QXFER_T *pQXfer, uint32_t count);
+
+/**
+ * @brief	Run the queued master state machine without interrupts
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	Nothing
+ * @note	Safe to call while the I2C interrupt is enabled.
+ */
+void Chip_I2C_MasterQueuePoll(I2C_ID_T id);
+
+/**
+ * @brief	Wait for a queued transfer to complete
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @param	pQXfer	: Pointer to a submitted transfer
+ * @return	Final status of the transfer
+ * @note	The transfer is completed by the I2C interrupt, the caller sleeps
+ * in the handler set with Chip_I2C_SetQueueWaitHandler() or, without one,
+ * spins on the done flag with interrupts enabled.
+ */
+I2C_STATUS_T Chip_I2C_MasterQueueWait(I2C_ID_T id, I2C_QXFER_T *pQXfer);
+
+/**
+ * @brief	Check whether a queued transfer has completed
+ * @param	pQXfer	: Pointer to a submitted transfer
+ * @return	true if the transfer has completed
+ */
+STATIC INLINE bool Chip_I2C_MasterIsDone(I2C_QXFER_T *pQXfer)
+{
+	return pQXfer->done != 0;
+}
+
+/**
+ * @brief	Return the queued transfer statistics of a bus
+ * @param	id		: I2C peripheral ID (I2C0, I2C1 ... etc)
+ * @return	Pointer to the statistics, cleared by Chip_I2C_MasterQueueInit()
+ */
+I2C_QSTATS_T *Chip_I2C_MasterGetQueueStats(I2C_ID_T id);
+
 /**
  * @}
  */
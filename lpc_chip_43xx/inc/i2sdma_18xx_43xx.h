@@ -0,0 +1,176 @@
+/*
+ * @brief LPC18xx/43xx full-duplex I2S audio streaming over GPDMA
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __I2SDMA_18XX_43XX_H_
+#define __I2SDMA_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup I2SDMA_18XX_43XX CHIP: LPC18xx/43xx I2S audio streaming over GPDMA
+ * @ingroup I2S_18XX_43XX
+ * Each direction runs a circular chain of GPDMA descriptors between the
+ * I2S FIFO and a pool of period buffers, so audio moves without CPU
+ * copies or FIFO interrupts. Every period end raises one DMA interrupt:
+ * - Transmit periods are filled by the application, which gets an empty
+ * one with Chip_I2SDMA_GetTxPeriod() and queues it with
+ * Chip_I2SDMA_QueueTxPeriod(). When no queued period is left for the
+ * next-but-one slot, silence is played instead and an underrun is
+ * counted.
+ * - Received periods are queued for the application, which gets them
+ * with Chip_I2SDMA_GetRxPeriod() and gives them back with
+ * Chip_I2SDMA_ReleaseRxPeriod(). When no free period is left, the
+ * samples are discarded and an overrun is counted.
+ *
+ * The period size sets the trade-off between latency and interrupt load:
+ * a period is handed over once per periodWords frames, and the stream
+ * keeps two periods of each direction in flight.<br>
+ * The I2S format, clocking and master/slave mode are set up by the
+ * application with the Chip_I2S_* functions. The streams hold one GPDMA
+ * channel of the channel manager per direction while they run.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of period buffers per direction
+ */
+#define I2SDMA_MAX_PERIODS          32
+
+/**
+ * @brief Maximum period size in 32-bit FIFO words, limited by the DMA transfer size
+ */
+#define I2SDMA_MAX_PERIOD_WORDS     0xFFF
+
+/**
+ * @brief FIFO level used for DMA requests, and the DMA burst size
+ */
+#define I2SDMA_FIFO_DEPTH           4
+
+/**
+ * @brief Period callback, called from the DMA interrupt
+ */
+typedef void (*I2SDMA_CALLBACK_T)(void);
+
+/**
+ * @brief Audio stream configuration
+ */
+typedef struct {
+	uint32_t *txBuffers;		/**< numPeriods * periodWords words for transmit, or NULL */
+	uint32_t *rxBuffers;		/**< numPeriods * periodWords words for receive, or NULL */
+	uint32_t periodWords;		/**< FIFO words per period, 4 to I2SDMA_MAX_PERIOD_WORDS, a multiple of 4 */
+	uint32_t numPeriods;		/**< Periods per direction, 3 to I2SDMA_MAX_PERIODS */
+	I2SDMA_CALLBACK_T txCb;		/**< Called when a transmit period is free again, or NULL */
+	I2SDMA_CALLBACK_T rxCb;		/**< Called when a receive period is full, or NULL */
+} I2SDMA_CFG_T;
+
+/**
+ * @brief Audio stream statistics
+ */
+typedef struct {
+	uint32_t txPeriods;			/**< Queued periods played */
+	uint32_t rxPeriods;			/**< Periods received and queued */
+	uint32_t underruns;			/**< Periods of silence played for lack of queued data */
+	uint32_t overruns;			/**< Periods discarded for lack of a free buffer */
+	uint32_t lateIrqs;			/**< Period interrupts served after the next period had ended */
+} I2SDMA_STATS_T;
+
+/**
+ * @brief	Initialize the audio streams
+ * @param	pI2S	: The base of I2S peripheral on the chip
+ * @param	pCfg	: Pointer to stream configuration, copied
+ * @return	SUCCESS, or ERROR on bad parameters
+ * @note	Either direction can be left out with a NULL buffer pointer.
+ * The GPDMA channel manager must be initialized.
+ */
+Status Chip_I2SDMA_Init(LPC_I2S_T *pI2S, const I2SDMA_CFG_T *pCfg);
+
+/**
+ * @brief	Start streaming
+ * @return	SUCCESS, or ERROR if already running or a DMA request could not be queued
+ * @note	Transmit periods queued before the start are played first, the
+ * remaining periods are returned to the pools. The I2S transmitter and
+ * receiver are started.
+ */
+Status Chip_I2SDMA_Start(void);
+
+/**
+ * @brief	Stop streaming
+ * @return	Nothing
+ * @note	The I2S transmitter and receiver are paused. Received periods
+ * already queued stay available to the application.
+ */
+void Chip_I2SDMA_Stop(void);
+
+/**
+ * @brief	Get an empty transmit period to fill
+ * @return	Pointer to the period words, or NULL if none is free
+ */
+uint32_t *Chip_I2SDMA_GetTxPeriod(void);
+
+/**
+ * @brief	Queue a filled transmit period
+ * @param	period	: Period returned by Chip_I2SDMA_GetTxPeriod()
+ * @return	Nothing
+ * @note	Periods are played in the order they are queued. A period must
+ * be queued before the one ahead of it starts playing.
+ */
+void Chip_I2SDMA_QueueTxPeriod(uint32_t *period);
+
+/**
+ * @brief	Get the oldest full receive period
+ * @return	Pointer to the period words, or NULL if none is ready
+ */
+uint32_t *Chip_I2SDMA_GetRxPeriod(void);
+
+/**
+ * @brief	Give a receive period back to the stream
+ * @param	period	: Period returned by Chip_I2SDMA_GetRxPeriod()
+ * @return	Nothing
+ */
+void Chip_I2SDMA_ReleaseRxPeriod(uint32_t *period);
+
+/**
+ * @brief	Return the stream statistics
+ * @return	Pointer to the statistics, cleared by Chip_I2SDMA_Start()
+ */
+I2SDMA_STATS_T *Chip_I2SDMA_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __I2SDMA_18XX_43XX_H_ */
@@ -42,6 +42,7 @@ extern "C" {
  */
 
 /* IAP command definitions */
+#define IAP_INIT_CMD                49	/*!< Initialize the IAP functions */
 #define IAP_PREWRRITE_CMD           50	/*!< Prepare sector for write operation command */
 #define IAP_WRISECTOR_CMD           51	/*!< Write Sector command */
 #define IAP_ERSSECTOR_CMD           52	/*!< Erase Sector command */
@@ -81,6 +82,13 @@ extern "C" {
 /* IAP_ENTRY API function type */
 typedef void (*IAP_ENTRY_T)(unsigned int[5], unsigned int[4]);
 
+/**
+ * @brief	Initialize the IAP functions
+ * @return	Status code to indicate the command is executed successfully or not
+ * @note	This command must be executed once before the other IAP commands.
+ */
+uint8_t Chip_IAP_Init(void);
+
 /**
  * @brief	Prepare sector for write operation
  * @param	strSector	: Start sector number
@@ -0,0 +1,236 @@
+/*
+ * @brief LPC43xx inter-core mailbox
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __IPCMBX_18XX_43XX_H_
+#define __IPCMBX_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup IPCMBX_18XX_43XX CHIP: LPC43xx M4/M0 inter-core mailbox
+ * @ingroup CHIP_18XX_43XX_Drivers
+ * Messages between the Cortex-M4 and the Cortex-M0APP core go through two
+ * single producer, single consumer rings in a shared IPCMBX_SHARED_T block,
+ * one per direction. The block is placed at the same address in both
+ * images, normally in AHB SRAM that neither image links anything into.<br>
+ * Each ring index and wait flag is written by one core only and read by
+ * the other, so no lock or exclusive access is needed. This matters
+ * because the M0 has no LDREX/STREX. Memory barriers order the message
+ * against its index.<br>
+ * A core that finds its receive ring empty, or its send ring full, calls
+ * Chip_IPCMBX_WaitRx() or Chip_IPCMBX_WaitTx() before it sleeps. The
+ * other core rings the doorbell (SEV, which raises the IPC interrupt of
+ * the other core) only while such a wait flag is set, so a busy ring
+ * costs no interrupts. The IPC interrupt handler of each core must call
+ * Chip_IPCMBX_IRQHandler().<br>
+ * This driver is built for both cores. Chip_IPCMBX_Init() must be called
+ * by the M4 before it starts the M0, and by the M0 once it runs. Each ring
+ * must be used by a single sender and a single receiver per core, so a
+ * caller with several senders or receivers must serialize them.
+ * @{
+ */
+
+/**
+ * @brief Size of a message slot in bytes
+ */
+#ifndef IPCMBX_MSG_SIZE
+#define IPCMBX_MSG_SIZE             32
+#endif
+
+/**
+ * @brief Messages in each ring, a power of 2. Must match in both images
+ */
+#ifndef IPCMBX_RING_MSGS
+#define IPCMBX_RING_MSGS            16
+#endif
+
+/**
+ * @brief Payload bytes in a message
+ */
+#define IPCMBX_MSG_DATA             (IPCMBX_MSG_SIZE - 4)
+
+/**
+ * @brief Value of IPCMBX_SHARED_T::magic once the M4 has set up the block
+ */
+#define IPCMBX_MAGIC                0x4D42584FUL
+
+/**
+ * @brief Events returned by Chip_IPCMBX_IRQHandler()
+ */
+#define IPCMBX_EVENT_RX             (1 << 0)	/*!< A message is waiting to be received */
+#define IPCMBX_EVENT_TX             (1 << 1)	/*!< A waiting sender has space again */
+
+/**
+ * @brief Message
+ */
+typedef struct {
+	uint16_t id;				/**< Service or command, defined by the application */
+	uint16_t len;				/**< Bytes used in data */
+	uint8_t data[IPCMBX_MSG_DATA];	/**< Payload */
+} IPCMBX_MSG_T;
+
+/**
+ * @brief One direction of the mailbox, in shared memory
+ */
+typedef struct {
+	volatile uint32_t head;		/**< Messages written, advanced by the sender only */
+	volatile uint32_t tail;		/**< Messages read, advanced by the receiver only */
+	volatile uint32_t rxWait;	/**< Set by the receiver while it waits for a message */
+	volatile uint32_t txWait;	/**< Set by the sender while it waits for space */
+	IPCMBX_MSG_T msg[IPCMBX_RING_MSGS];	/**< Message slots */
+} IPCMBX_RING_T;
+
+/**
+ * @brief Shared mailbox block
+ */
+typedef struct {
+	volatile uint32_t magic;	/**< IPCMBX_MAGIC once set up */
+	IPCMBX_RING_T toM0;			/**< Messages from the M4 to the M0 */
+	IPCMBX_RING_T toM4;			/**< Messages from the M0 to the M4 */
+} IPCMBX_SHARED_T;
+
+/**
+ * @brief Mailbox statistics, kept by each core for its own side
+ */
+typedef struct {
+	uint32_t sent;				/**< Messages sent */
+	uint32_t received;			/**< Messages received */
+	uint32_t txFull;			/**< Sends refused because the ring was full */
+	uint32_t doorbells;			/**< Doorbells rung to the other core */
+	uint32_t irqs;				/**< IPC interrupts handled */
+} IPCMBX_STATS_T;
+
+/**
+ * @brief Mailbox handle, one per core
+ */
+typedef struct {
+	IPCMBX_SHARED_T *pShared;	/**< Shared block */
+	IPCMBX_RING_T *pTx;			/**< Internal: ring this core sends on */
+	IPCMBX_RING_T *pRx;			/**< Internal: ring this core receives from */
+	IPCMBX_STATS_T stats;		/**< Statistics */
+} IPCMBX_HANDLE_T;
+
+/**
+ * @brief	Attach to the shared mailbox block
+ * @param	pHandle	: Pointer to handle to initialize
+ * @param	pShared	: Shared block, at the same address in both images
+ * @return	SUCCESS, or ERROR on the M0 if the M4 has not set up the block
+ * @note	On the M4 the block is cleared, this must be done before the M0
+ * is started. On the M0 the block is only checked.
+ */
+Status Chip_IPCMBX_Init(IPCMBX_HANDLE_T *pHandle, IPCMBX_SHARED_T *pShared);
+
+/**
+ * @brief	Send a message to the other core without blocking
+ * @param	pHandle	: Pointer to mailbox handle
+ * @param	pMsg	: Message, the header and len bytes of data are copied
+ * @return	SUCCESS, or ERROR if the ring is full or len is too long
+ */
+Status Chip_IPCMBX_Send(IPCMBX_HANDLE_T *pHandle, const IPCMBX_MSG_T *pMsg);
+
+/**
+ * @brief	Take the oldest message from the other core
+ * @param	pHandle	: Pointer to mailbox handle
+ * @param	pMsg	: Pointer to store the message
+ * @return	true if a message was returned, false if the ring is empty
+ */
+bool Chip_IPCMBX_Receive(IPCMBX_HANDLE_T *pHandle, IPCMBX_MSG_T *pMsg);
+
+/**
+ * @brief	Ask for a doorbell when the next message arrives
+ * @param	pHandle	: Pointer to mailbox handle
+ * @return	true if the ring is still empty and the caller may sleep until
+ * the IPC interrupt, false if a message arrived meanwhile
+ * @note	The request is cleared by the next successful receive.
+ */
+bool Chip_IPCMBX_WaitRx(IPCMBX_HANDLE_T *pHandle);
+
+/**
+ * @brief	Ask for a doorbell when the other core frees a slot
+ * @param	pHandle	: Pointer to mailbox handle
+ * @return	true if the ring is still full and the caller may sleep until
+ * the IPC interrupt, false if a slot was freed meanwhile
+ * @note	The request is cleared by the next successful send.
+ */
+bool Chip_IPCMBX_WaitTx(IPCMBX_HANDLE_T *pHandle);
+
+/**
+ * @brief	Handle the IPC interrupt from the other core
+ * @param	pHandle	: Pointer to mailbox handle
+ * @return	IPCMBX_EVENT_* flags of the waits that can proceed
+ * @note	Call from M0APP_IRQHandler() on the M4 and from the M4 core
+ * interrupt handler on the M0.
+ */
+uint32_t Chip_IPCMBX_IRQHandler(IPCMBX_HANDLE_T *pHandle);
+
+#if defined(CORE_M4)
+/**
+ * @brief	Start the M0APP core on an image
+ * @param	imageAddr	: Address of the M0 vector table, 4KB aligned
+ * @return	SUCCESS, or ERROR if the address is not aligned
+ * @note	The core is held in reset while its memory map is changed.
+ * Call Chip_IPCMBX_Init() first.
+ */
+Status Chip_IPCMBX_StartM0(uint32_t imageAddr);
+
+#endif /* defined(CORE_M4) */
+
+/**
+ * @brief	Return the number of messages waiting to be received
+ * @param	pHandle	: Pointer to mailbox handle
+ * @return	Messages in the receive ring
+ */
+STATIC INLINE uint32_t Chip_IPCMBX_GetRxCount(const IPCMBX_HANDLE_T *pHandle)
+{
+	return pHandle->pRx->head - pHandle->pRx->tail;
+}
+
+/**
+ * @brief	Return the mailbox statistics
+ * @param	pHandle	: Pointer to mailbox handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE const IPCMBX_STATS_T *Chip_IPCMBX_GetStats(const IPCMBX_HANDLE_T *pHandle)
+{
+	return &pHandle->stats;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __IPCMBX_18XX_43XX_H_ */
@@ -0,0 +1,172 @@
+/*
+ * @brief LPC18xx/43xx asynchronous SD/MMC block I/O driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __SDBLK_18XX_43XX_H_
+#define __SDBLK_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup SDBLK_18XX_43XX CHIP: LPC18xx/43xx asynchronous SD/MMC block I/O driver
+ * @ingroup SDMMC_18XX_43XX
+ * Block read and write requests are queued and run by the SDIO interrupt.
+ * A request completes from the interrupt on DATA_OVER for reads. For writes
+ * and before issuing a command to a busy card, the card busy line is checked
+ * by Chip_SDBLK_Poll(), which is meant to be called from a periodic timer, so
+ * no code spins while the card programs its flash. The card must have been
+ * acquired with Chip_SDMMC_Acquire(), and the blocking Chip_SDMMC_* functions
+ * must not be used while requests are queued.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of blocks in one request, limited by the IDMAC descriptors
+ */
+#define SDBLK_MAX_BLOCKS            (0x10000 / MMC_SECTOR_SIZE)
+
+struct SDBLK_REQ;
+
+/**
+ * @brief SD block request completion callback, called from interrupt context
+ */
+typedef void (*SDBLK_CALLBACK_T)(struct SDBLK_REQ *pReq);
+
+/**
+ * @brief SD block request
+ * The structure and its buffer are owned by the caller and must remain valid
+ * until the request completes. The buffer must be word aligned.
+ */
+typedef struct SDBLK_REQ {
+	void *buffer;				/**< Data buffer, count * 512 bytes */
+	uint32_t block;				/**< First block number */
+	uint32_t count;				/**< Number of blocks, 1 to SDBLK_MAX_BLOCKS */
+	bool write;					/**< true to write to the card, false to read */
+	SDBLK_CALLBACK_T cb;		/**< Completion callback or NULL */
+	void *cbData;				/**< User data for the callback */
+	Status status;				/**< SUCCESS or ERROR, valid once done is set */
+	volatile uint8_t done;		/**< Set to 1 when the request has completed */
+	struct SDBLK_REQ *next;		/**< Queue link, used by the driver */
+} SDBLK_REQ_T;
+
+/**
+ * @brief SD block driver statistics
+ */
+typedef struct {
+	uint32_t reads;				/**< Read requests completed */
+	uint32_t writes;			/**< Write requests completed */
+	uint32_t blocks;			/**< Blocks transferred */
+	uint32_t errors;			/**< Requests completed with an error */
+	uint32_t busyPolls;			/**< Polls that found the card busy */
+} SDBLK_STATS_T;
+
+/**
+ * @brief	Initialize the asynchronous block driver
+ * @param	pSDMMC	: SDMMC peripheral selected
+ * @param	pCard	: Card acquired with Chip_SDMMC_Acquire()
+ * @return	SUCCESS, or ERROR if the card is not in transfer state
+ * @note	The SDIO interrupt handler must call Chip_SDBLK_IRQHandler()
+ * from now on.
+ */
+Status Chip_SDBLK_Init(LPC_SDMMC_T *pSDMMC, mci_card_struct *pCard);
+
+/**
+ * @brief	Setup a block request
+ * @param	pReq	: Pointer to request to setup
+ * @param	buffer	: Word aligned data buffer
+ * @param	block	: First block number
+ * @param	count	: Number of blocks
+ * @param	write	: true to write, false to read
+ * @param	cb		: Completion callback or NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_SDBLK_SetupReq(SDBLK_REQ_T *pReq, void *buffer, uint32_t block, uint32_t count,
+									   bool write, SDBLK_CALLBACK_T cb, void *cbData)
+{
+	pReq->buffer = buffer;
+	pReq->block = block;
+	pReq->count = count;
+	pReq->write = write;
+	pReq->cb = cb;
+	pReq->cbData = cbData;
+}
+
+/**
+ * @brief	Queue a block request
+ * @param	pReq	: Pointer to request setup with Chip_SDBLK_SetupReq()
+ * @return	SUCCESS if queued, ERROR if the block range is invalid or the driver
+ *			is not initialized
+ * @note	Requests run in submission order. Can be called from an interrupt.
+ */
+Status Chip_SDBLK_Submit(SDBLK_REQ_T *pReq);
+
+/**
+ * @brief	Check whether a request has completed
+ * @param	pReq	: Pointer to a submitted request
+ * @return	true if the request has completed
+ */
+STATIC INLINE bool Chip_SDBLK_IsDone(SDBLK_REQ_T *pReq)
+{
+	return pReq->done != 0;
+}
+
+/**
+ * @brief	Check the card busy line and advance waiting requests
+ * @return	Nothing
+ * @note	Call periodically, typically from a 1ms timer or tick hook.
+ * A write request completes from here once the card has programmed it.
+ */
+void Chip_SDBLK_Poll(void);
+
+/**
+ * @brief	SDIO interrupt handler for the block driver
+ * @return	Nothing
+ * @note	Does nothing before Chip_SDBLK_Init(), the interrupt is then
+ *			still the card acquire code's to handle.
+ */
+void Chip_SDBLK_IRQHandler(void);
+
+/**
+ * @brief	Return the block driver statistics
+ * @return	Pointer to the statistics, cleared by Chip_SDBLK_Init()
+ */
+SDBLK_STATS_T *Chip_SDBLK_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SDBLK_18XX_43XX_H_ */
@@ -0,0 +1,151 @@
+/*
+ * @brief LPC18xx/43xx SD/MMC block cache
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __SDCACHE_18XX_43XX_H_
+#define __SDCACHE_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup SDCACHE_18XX_43XX CHIP: LPC18xx/43xx SD/MMC block cache
+ * @ingroup SDMMC_18XX_43XX
+ * Write-back LRU cache of 512 byte blocks above the asynchronous block
+ * driver. Reads that continue the previous read are extended with
+ * read-ahead, and dirty blocks with adjacent numbers are written back
+ * with a single multiple block write. Line and staging buffers are
+ * provided by the application so they can be placed in AHB RAM. The cache
+ * is not reentrant, callers must serialize their accesses.
+ * @{
+ */
+
+/**
+ * @brief Blocks read ahead when a read continues the previous one
+ */
+#ifndef SDCACHE_READAHEAD
+#define SDCACHE_READAHEAD           4
+#endif
+
+/**
+ * @brief Block I/O function used by the cache
+ * Must run the transfer to completion before returning.
+ */
+typedef Status (*SDCACHE_IO_T)(void *buffer, uint32_t block, uint32_t count, bool write);
+
+/**
+ * @brief Cache line, one block
+ */
+typedef struct {
+	uint32_t block;				/**< Cached block number */
+	uint32_t lastUse;			/**< Access stamp for LRU replacement */
+	uint8_t valid;				/**< Line holds a block */
+	uint8_t dirty;				/**< Line differs from the card */
+	uint8_t *data;				/**< Block data, set by Chip_SDCACHE_Init() */
+} SDCACHE_LINE_T;
+
+/**
+ * @brief Cache statistics
+ */
+typedef struct {
+	uint32_t hits;				/**< Blocks served from the cache */
+	uint32_t misses;			/**< Blocks read from the card on request */
+	uint32_t readAhead;			/**< Blocks read from the card ahead of request */
+	uint32_t readCmds;			/**< Read commands sent to the card */
+	uint32_t writeCmds;			/**< Write commands sent to the card */
+	uint32_t blocksWritten;		/**< Blocks written to the card */
+} SDCACHE_STATS_T;
+
+/**
+ * @brief	Initialize the block cache
+ * @param	lines		: Array of numLines cache lines
+ * @param	lineData	: Word aligned buffer of numLines * 512 bytes
+ * @param	numLines	: Number of cache lines
+ * @param	stage		: Word aligned staging buffer of stageBlocks * 512 bytes
+ * @param	stageBlocks	: Longest run moved by one command, 1 to SDBLK_MAX_BLOCKS
+ * @param	numBlocks	: Number of blocks on the card, read-ahead stops there
+ * @param	io			: Block I/O function, NULL to use Chip_SDBLK_* with polling
+ * @return	Nothing
+ */
+void Chip_SDCACHE_Init(SDCACHE_LINE_T *lines, void *lineData, uint32_t numLines,
+					   void *stage, uint32_t stageBlocks, uint32_t numBlocks, SDCACHE_IO_T io);
+
+/**
+ * @brief	Read blocks through the cache
+ * @param	buffer	: Buffer for count * 512 bytes
+ * @param	block	: First block number
+ * @param	count	: Number of blocks
+ * @return	SUCCESS or ERROR
+ */
+Status Chip_SDCACHE_Read(void *buffer, uint32_t block, uint32_t count);
+
+/**
+ * @brief	Write blocks into the cache
+ * @param	buffer	: Buffer holding count * 512 bytes
+ * @param	block	: First block number
+ * @param	count	: Number of blocks
+ * @return	SUCCESS or ERROR
+ * @note	The blocks reach the card when they are evicted or on
+ * Chip_SDCACHE_Flush(). Writes of stageBlocks or more go to the card at once,
+ * in commands of at most SDBLK_MAX_BLOCKS. Such a buffer should be word
+ * aligned, otherwise it is copied through the staging buffer.
+ */
+Status Chip_SDCACHE_Write(const void *buffer, uint32_t block, uint32_t count);
+
+/**
+ * @brief	Write all dirty blocks back to the card
+ * @return	SUCCESS or ERROR
+ * @note	Acts as a barrier, every write done before the call has been
+ * programmed into the card when it returns SUCCESS.
+ */
+Status Chip_SDCACHE_Flush(void);
+
+/**
+ * @brief	Drop all cached blocks without writing them back
+ * @return	Nothing
+ * @note	Use after the card has been changed or written around the cache.
+ */
+void Chip_SDCACHE_Invalidate(void);
+
+/**
+ * @brief	Return the cache statistics
+ * @return	Pointer to the statistics, cleared by Chip_SDCACHE_Init()
+ */
+SDCACHE_STATS_T *Chip_SDCACHE_GetStats(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SDCACHE_18XX_43XX_H_ */
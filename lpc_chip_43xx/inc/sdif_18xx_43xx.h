@@ -196,6 +196,7 @@ typedef struct {				/*!< SDMMC Structure        */
 /** @brief SDIO status register definess
  */
 #define MCI_STS_GET_FCNT(x)     (((x) >> 17) & 0x1FF)
+#define MCI_STS_DATA_BUSY       (1 << 9)		/*!< Card holds DAT0 low (busy) */
 
 /** @brief SDIO FIFO threshold defines
  */
@@ -0,0 +1,193 @@
+/*
+ * @brief LPC18xx/43xx append-only record log on SD/MMC
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __SDLOG_18XX_43XX_H_
+#define __SDLOG_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup SDLOG_18XX_43XX CHIP: LPC18xx/43xx append-only record log on SD/MMC
+ * @ingroup SDMMC_18XX_43XX
+ * Time-stamped records are packed into 512 byte pages that are written
+ * sequentially over a circular range of card blocks, so an append never
+ * rewrites anything but the page being filled. The range is split into
+ * SDLOG_MAX_SEGMENTS segments and a RAM index keeps the first sequence
+ * number and time stamp of each one for range reads. A checkpoint holding
+ * the write position is stored at the start of every segment, so after a
+ * power loss only the pages written since the last checkpoint are scanned.
+ * A page is written to its own block once, when full. Syncs of the page being
+ * filled alternate between two tail blocks, so a write torn by a power loss
+ * never takes records synced before it.
+ * Time stamps must not decrease. The log is not reentrant.
+ * @{
+ */
+
+/**
+ * @brief Number of segments the log range is split into
+ */
+#ifndef SDLOG_MAX_SEGMENTS
+#define SDLOG_MAX_SEGMENTS          32
+#endif
+
+/**
+ * @brief Size of the page header and of the header of each record
+ */
+#define SDLOG_PAGE_HDR_SIZE         32
+#define SDLOG_REC_HDR_SIZE          6
+
+/**
+ * @brief Largest record payload, a record never spans two pages
+ */
+#define SDLOG_MAX_RECORD            (MMC_SECTOR_SIZE - SDLOG_PAGE_HDR_SIZE - SDLOG_REC_HDR_SIZE)
+
+/**
+ * @brief Block I/O function used by the log, must complete before returning
+ */
+typedef Status (*SDLOG_IO_T)(void *buffer, uint32_t block, uint32_t count, bool write);
+
+/**
+ * @brief Record callback of Chip_SDLOG_ReadRange()
+ */
+typedef void (*SDLOG_RECORD_CB_T)(uint32_t ts, const void *data, uint32_t len, void *arg);
+
+/**
+ * @brief Log statistics
+ * Write amplification is blocksWritten * 512 / recordBytes.
+ */
+typedef struct {
+	uint32_t records;			/**< Records appended */
+	uint32_t recordBytes;		/**< Payload bytes appended */
+	uint32_t blocksWritten;		/**< Page and checkpoint blocks written */
+	uint32_t blocksRead;		/**< Blocks read by mount and range reads */
+	uint32_t scanned;			/**< Pages scanned by the last mount */
+} SDLOG_STATS_T;
+
+/**
+ * @brief Segment index entry
+ */
+typedef struct {
+	uint32_t firstSeq;			/**< Sequence number of the first page */
+	uint32_t firstTs;			/**< Time stamp of the first record */
+	uint32_t valid;				/**< Segment holds pages of the current log */
+} SDLOG_SEG_T;
+
+/**
+ * @brief Log handle
+ */
+typedef struct {
+	uint32_t page[MMC_SECTOR_SIZE / 4];		/**< Page being filled */
+	uint32_t scratch[MMC_SECTOR_SIZE / 4];	/**< Buffer for reads */
+	SDLOG_SEG_T seg[SDLOG_MAX_SEGMENTS];	/**< Segment index */
+	SDLOG_IO_T io;				/**< Block I/O function */
+	uint32_t base;				/**< First block of the log range */
+	uint32_t segPages;			/**< Pages per segment */
+	uint32_t epoch;				/**< Format generation, tags every page */
+	uint32_t cpGen;				/**< Generation of the last checkpoint */
+	uint32_t headPage;			/**< Index of the page being filled */
+	uint32_t headSeq;			/**< Sequence number of the page being filled */
+	uint32_t lastTs;			/**< Time stamp of the last record */
+	SDLOG_STATS_T stats;		/**< Statistics */
+} SDLOG_T;
+
+/**
+ * @brief	Create an empty log over a range of blocks
+ * @param	pLog		: Log handle
+ * @param	firstBlock	: First block of the range
+ * @param	numBlocks	: Number of blocks, at least 4 + SDLOG_MAX_SEGMENTS
+ * @param	io			: Block I/O function
+ * @return	SUCCESS or ERROR
+ */
+Status Chip_SDLOG_Format(SDLOG_T *pLog, uint32_t firstBlock, uint32_t numBlocks, SDLOG_IO_T io);
+
+/**
+ * @brief	Open an existing log and recover its write position
+ * @param	pLog		: Log handle
+ * @param	firstBlock	: First block of the range
+ * @param	numBlocks	: Number of blocks, as given to Chip_SDLOG_Format()
+ * @param	io			: Block I/O function
+ * @return	SUCCESS, or ERROR if the range holds no log
+ * @note	Records appended after the last Chip_SDLOG_Sync() before a power
+ * loss are lost, all others are recovered.
+ */
+Status Chip_SDLOG_Mount(SDLOG_T *pLog, uint32_t firstBlock, uint32_t numBlocks, SDLOG_IO_T io);
+
+/**
+ * @brief	Append a record
+ * @param	pLog	: Log handle
+ * @param	ts		: Time stamp, not lower than the previous one
+ * @param	data	: Record payload
+ * @param	len		: Payload length, at most SDLOG_MAX_RECORD
+ * @return	SUCCESS or ERROR
+ * @note	The record is in RAM until its page fills or Chip_SDLOG_Sync()
+ * is called.
+ */
+Status Chip_SDLOG_Append(SDLOG_T *pLog, uint32_t ts, const void *data, uint32_t len);
+
+/**
+ * @brief	Write the page being filled to the card
+ * @param	pLog	: Log handle
+ * @return	SUCCESS or ERROR
+ * @note	The page goes to the tail block not holding its previous copy.
+ */
+Status Chip_SDLOG_Sync(SDLOG_T *pLog);
+
+/**
+ * @brief	Read the records of a time range, oldest first
+ * @param	pLog	: Log handle
+ * @param	tsFrom	: First time stamp of the range
+ * @param	tsTo	: Last time stamp of the range
+ * @param	cb		: Function called for every record in the range
+ * @param	arg		: User argument for the callback
+ * @return	SUCCESS or ERROR
+ */
+Status Chip_SDLOG_ReadRange(SDLOG_T *pLog, uint32_t tsFrom, uint32_t tsTo, SDLOG_RECORD_CB_T cb, void *arg);
+
+/**
+ * @brief	Return the log statistics
+ * @param	pLog	: Log handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE SDLOG_STATS_T *Chip_SDLOG_GetStats(SDLOG_T *pLog)
+{
+	return &pLog->stats;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SDLOG_18XX_43XX_H_ */
@@ -0,0 +1,201 @@
+/*
+ * @brief LPC18xx/43xx SSP DMA transaction queue driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __SSPDMA_18XX_43XX_H_
+#define __SSPDMA_18XX_43XX_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup SSPDMA_18XX_43XX CHIP: LPC18xx/43xx SSP DMA transaction queue driver
+ * @ingroup SSP_18XX_43XX
+ * Transactions (chip select, transmit buffer, receive buffer, length) are
+ * queued on an SSP handle and moved by the GPDMA channel manager. The next
+ * queued transaction is started from the DMA interrupt as soon as the current
+ * one completes, so back-to-back transactions run without CPU gaps. The SSP
+ * must be initialized and enabled as a master before use, and the blocking
+ * Chip_SSP_* functions must not be used on the same SSP while transactions
+ * are queued.
+ * @{
+ */
+
+/**
+ * @brief Maximum number of descriptors per direction in a transaction
+ * A transaction can move up to SSPDMA_MAX_DESC * 4095 frames.
+ */
+#ifndef SSPDMA_MAX_DESC
+#define SSPDMA_MAX_DESC             4
+#endif
+
+/**
+ * @brief Maximum number of frames in a transaction
+ */
+#define SSPDMA_MAX_FRAMES           (SSPDMA_MAX_DESC * 0xFFF)
+
+struct SSPDMA_XFER;
+
+/**
+ * @brief SSP DMA transaction completion callback, called from the DMA interrupt
+ */
+typedef void (*SSPDMA_CALLBACK_T)(struct SSPDMA_XFER *pXfer);
+
+/**
+ * @brief SSP DMA chip select callback, called with assert true before the first
+ * frame of a transaction and with assert false after its last frame
+ */
+typedef void (*SSPDMA_CS_CALLBACK_T)(uint32_t cs, bool assert);
+
+/**
+ * @brief SSP DMA transaction
+ * This structure and its buffers are owned by the caller and must remain
+ * valid until the transaction completes. Buffers hold one byte per frame for
+ * frames of 8 bits or less, and one halfword per frame otherwise.
+ */
+typedef struct SSPDMA_XFER {
+	uint32_t cs;					/*!< Chip select passed to the chip select callback */
+	const void *tx;					/*!< Data to send, NULL to send 0xFF frames */
+	void *rx;						/*!< Buffer for received data, NULL to discard */
+	uint32_t len;					/*!< Number of frames */
+	uint32_t cr0;					/*!< CR0 value for this transaction, 0 to keep the current format */
+	SSPDMA_CALLBACK_T cb;			/*!< Completion callback, can be NULL */
+	void *cbData;					/*!< User data for the callback */
+	volatile Status status;			/*!< Transaction status, valid once done is set */
+	volatile uint8_t done;			/*!< Set to 1 when the transaction completes */
+	struct SSPDMA_XFER *next;		/*!< Internal: next queued transaction */
+} SSPDMA_XFER_T;
+
+/**
+ * @brief SSP DMA statistics
+ */
+typedef struct {
+	uint32_t xfers;					/*!< Completed transactions */
+	uint32_t frames;				/*!< Frames moved by completed transactions */
+	uint32_t errors;				/*!< Transactions that ended with an error */
+	uint32_t busyTicks;				/*!< Core clock cycles spent moving frames */
+	uint32_t startTick;				/*!< Internal: cycle count at transaction start */
+} SSPDMA_STATS_T;
+
+/**
+ * @brief SSP DMA handle, one per SSP peripheral
+ */
+typedef struct {
+	LPC_SSP_T *pSSP;							/*!< SSP peripheral */
+	uint8_t txConn;								/*!< GPDMA connection for transmit */
+	uint8_t rxConn;								/*!< GPDMA connection for receive */
+	uint8_t priority;							/*!< GPDMA manager priority */
+	uint8_t pending;							/*!< Internal: DMA directions still running */
+	SSPDMA_CS_CALLBACK_T csCb;					/*!< Chip select callback, can be NULL */
+	SSPDMA_XFER_T *pHead;						/*!< Internal: running transaction */
+	SSPDMA_XFER_T *pTail;						/*!< Internal: last queued transaction */
+	uint32_t savedCR0;							/*!< Internal: CR0 before the transaction */
+	uint16_t dummyTx;							/*!< Internal: frame sent when tx is NULL */
+	uint16_t dummyRx;							/*!< Internal: sink when rx is NULL */
+	Status dmaStatus;							/*!< Internal: status of the DMA directions */
+	DMA_TransferDescriptor_t txDesc[SSPDMA_MAX_DESC];	/*!< Internal: transmit descriptors */
+	DMA_TransferDescriptor_t rxDesc[SSPDMA_MAX_DESC];	/*!< Internal: receive descriptors */
+	GPDMAMGR_REQ_T txReq;						/*!< Internal: transmit DMA request */
+	GPDMAMGR_REQ_T rxReq;						/*!< Internal: receive DMA request */
+	SSPDMA_STATS_T stats;						/*!< Transfer statistics */
+} SSPDMA_HANDLE_T;
+
+/**
+ * @brief	Initialize an SSP DMA handle
+ * @param	pHandle		: Pointer to handle to initialize
+ * @param	pSSP		: The base of SSP peripheral on the chip (LPC_SSP0 or LPC_SSP1)
+ * @param	priority	: GPDMA manager priority for the transfers, GPDMAMGR_PRIO_*
+ * @param	csCb		: Chip select callback, NULL when the SSP drives SSEL
+ * @return	Nothing
+ * @note	The GPDMA channel manager must be initialized first.
+ */
+void Chip_SSPDMA_Init(SSPDMA_HANDLE_T *pHandle, LPC_SSP_T *pSSP, uint8_t priority, SSPDMA_CS_CALLBACK_T csCb);
+
+/**
+ * @brief	Prepare a transaction
+ * @param	pXfer	: Pointer to transaction to setup
+ * @param	cs		: Chip select passed to the chip select callback
+ * @param	tx		: Data to send, NULL to send 0xFF frames
+ * @param	rx		: Buffer for received data, NULL to discard
+ * @param	len		: Number of frames
+ * @param	cb		: Completion callback, can be NULL
+ * @param	cbData	: User data for the callback
+ * @return	Nothing
+ */
+STATIC INLINE void Chip_SSPDMA_SetupXfer(SSPDMA_XFER_T *pXfer, uint32_t cs, const void *tx, void *rx,
+										 uint32_t len, SSPDMA_CALLBACK_T cb, void *cbData)
+{
+	pXfer->cs = cs;
+	pXfer->tx = tx;
+	pXfer->rx = rx;
+	pXfer->len = len;
+	pXfer->cr0 = 0;
+	pXfer->cb = cb;
+	pXfer->cbData = cbData;
+}
+
+/**
+ * @brief	Queue a transaction
+ * @param	pHandle	: Pointer to SSP DMA handle
+ * @param	pXfer	: Pointer to transaction setup with Chip_SSPDMA_SetupXfer()
+ * @return	SUCCESS if queued, ERROR if the length is 0 or above SSPDMA_MAX_FRAMES
+ * @note	This function can be called from an interrupt.
+ */
+Status Chip_SSPDMA_Submit(SSPDMA_HANDLE_T *pHandle, SSPDMA_XFER_T *pXfer);
+
+/**
+ * @brief	Return completion state of a transaction
+ * @param	pXfer	: Pointer to submitted transaction
+ * @return	true if the transaction has completed, false if it is still pending
+ */
+STATIC INLINE bool Chip_SSPDMA_IsDone(const SSPDMA_XFER_T *pXfer)
+{
+	return pXfer->done != 0;
+}
+
+/**
+ * @brief	Return true if the handle has no running or queued transaction
+ * @param	pHandle	: Pointer to SSP DMA handle
+ * @return	true if idle
+ */
+STATIC INLINE bool Chip_SSPDMA_IsIdle(const SSPDMA_HANDLE_T *pHandle)
+{
+	return pHandle->pHead == NULL;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SSPDMA_18XX_43XX_H_ */
@@ -0,0 +1,141 @@
+/*
+ * @brief LPC18xx/43xx framed binary telemetry over UART
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#ifndef __TELEM_18XX_43XX_H_
+#define __TELEM_18XX_43XX_H_
+
+#include "ring_buffer.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/** @defgroup TELEM_18XX_43XX CHIP: LPC18xx/43xx framed binary telemetry over UART
+ * @ingroup CHIP_18XX_43XX_Drivers
+ * Sends typed binary records on a UART instead of formatted text. Each
+ * record is a type byte, a sequence byte, the payload and a CRC-16/CCITT
+ * (polynomial 0x1021, initial value 0xFFFF, sent LSB first) over the
+ * first three. The record is COBS encoded, so it holds no zero byte, and
+ * a zero byte ends the frame. A receiver resynchronizes on the next zero
+ * after an error, and a gap in the sequence numbers shows lost frames.<br>
+ * The encoder writes the frame straight into the UART transmit ring
+ * buffer, the same one used by Chip_UART_SendRB(), computing the CRC in
+ * the same pass. The frame is only made visible to the UART interrupt
+ * once complete. The ring buffer must have 1 byte items, and the UART
+ * interrupt must call Chip_UART_IRQRBHandler() or
+ * Chip_UART_IRQRBFIFOHandler() with it.<br>
+ * A handle must be used by one sender at a time, a caller with several
+ * senders must serialize them.
+ * @{
+ */
+
+/**
+ * @brief Largest record payload in bytes, keeps a COBS block in one frame
+ */
+#define TELEM_MAX_PAYLOAD           249
+
+/**
+ * @brief Frame bytes added to the payload: COBS code, type, sequence,
+ * CRC and delimiter
+ */
+#define TELEM_FRAME_OVERHEAD        6
+
+/**
+ * @brief Telemetry statistics
+ */
+typedef struct {
+	uint32_t frames;			/**< Frames queued */
+	uint32_t bytes;				/**< Encoded bytes queued, delimiters included */
+	uint32_t dropped;			/**< Records dropped because the ring buffer was full */
+} TELEM_STATS_T;
+
+/**
+ * @brief Telemetry handle
+ */
+typedef struct {
+	LPC_USART_T *pUART;			/**< UART the frames are sent on */
+	RINGBUFF_T *pRB;			/**< Transmit ring buffer of the UART */
+	uint8_t seq;				/**< Internal: sequence number of the next record */
+	TELEM_STATS_T stats;		/**< Statistics */
+} TELEM_HANDLE_T;
+
+/**
+ * @brief	Initialize a telemetry handle
+ * @param	pTelem	: Pointer to handle to initialize
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pRB		: Transmit ring buffer of the UART, 1 byte items
+ * @return	Nothing
+ */
+void Chip_TELEM_Init(TELEM_HANDLE_T *pTelem, LPC_USART_T *pUART, RINGBUFF_T *pRB);
+
+/**
+ * @brief	Encode a record into the transmit ring buffer and start the UART
+ * @param	pTelem	: Pointer to telemetry handle
+ * @param	type	: Record type, defined by the application
+ * @param	payload	: Record payload
+ * @param	len		: Payload size in bytes, up to TELEM_MAX_PAYLOAD
+ * @return	SUCCESS, or ERROR if the record is too long or the ring
+ * buffer has less than len + TELEM_FRAME_OVERHEAD bytes free
+ * @note	Does not block. A record is queued whole or not at all, a
+ * dropped record still uses up its sequence number.
+ */
+Status Chip_TELEM_Send(TELEM_HANDLE_T *pTelem, uint8_t type, const void *payload, uint32_t len);
+
+/**
+ * @brief	Compute a CRC-16/CCITT
+ * @param	crc		: 0xFFFF to start, or the result of the previous block
+ * @param	data	: Data to add
+ * @param	len		: Size of data in bytes
+ * @return	Updated CRC
+ * @note	Table driven, one lookup per byte.
+ */
+uint16_t Chip_TELEM_CRC16(uint16_t crc, const void *data, uint32_t len);
+
+/**
+ * @brief	Return the telemetry statistics
+ * @param	pTelem	: Pointer to telemetry handle
+ * @return	Pointer to the statistics
+ */
+STATIC INLINE const TELEM_STATS_T *Chip_TELEM_GetStats(const TELEM_HANDLE_T *pTelem)
+{
+	return &pTelem->stats;
+}
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TELEM_18XX_43XX_H_ */
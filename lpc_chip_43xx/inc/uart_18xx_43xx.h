@@ -150,6 +150,7 @@ typedef struct {					/*!< USARTn Structure       */
 #define UART_FCR_BITMASK        (0xCF)		/*!< UART FIFO control bit mask */
 
 #define UART_TX_FIFO_SIZE       (16)
+#define UART_RX_FIFO_SIZE       (16)
 
 /* FIFO trigger level bit definitions */
 #define UART_FCR_TRG_LEV0       (0)			/*!< UART FIFO trigger level 0: 1 character */
@@ -677,6 +678,9 @@ FlagStatus Chip_UART_CheckBusy(LPC_USART_T *pUART);
  *			all the data is in the FIFO or the FIFO is full. This function
  *			will not block in the FIFO is full. The actual number of bytes
  *			placed into the FIFO is returned. This function ignores errors.
+ *			THRE only reports an empty FIFO, so up to UART_TX_FIFO_SIZE
+ *			bytes are written for each THRE check. The FIFOs must be
+ *			enabled, which Chip_UART_Init() does by default.
  */
 int Chip_UART_Send(LPC_USART_T *pUART, const void *data, int numBytes);
 
@@ -743,7 +747,9 @@ int Chip_UART_ReadBlocking(LPC_USART_T *pUART, void *data, int numBytes);
  * @return	Nothing
  * @note	If ring buffer support is desired for the receive side
  *			of data transfer, the UART interrupt should call this
- *			function for a receive based interrupt status.
+ *			function for a receive based interrupt status. Received
+ *			bytes are gathered and moved into the ring buffer in
+ *			chunks of up to UART_RX_FIFO_SIZE bytes.
  */
 void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
 
@@ -754,7 +760,9 @@ void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
  * @return	Nothing
  * @note	If ring buffer support is desired for the transmit side
  *			of data transfer, the UART interrupt should call this
- *			function for a transmit based interrupt status.
+ *			function for a transmit based interrupt status. When the
+ *			transmit FIFO is empty, up to UART_TX_FIFO_SIZE bytes are
+ *			moved from the ring buffer into it in one pass.
  */
 void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB);
 
@@ -796,6 +804,26 @@ int Chip_UART_ReadRB(LPC_USART_T *pUART, RINGBUFF_T *pRB, void *data, int bytes)
  */
 void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB);
 
+/**
+ * @brief	UART FIFO interrupt handler for ring buffers
+ * @param	pUART	: Pointer to selected UART peripheral
+ * @param	pRXRB	: Pointer to receive ring buffer
+ * @param	pTXRB	: Pointer to transmit ring buffer
+ * @param	rxTrig	: Receive FIFO trigger level in use, UART_FCR_TRG_LEV0 to
+ *					  UART_FCR_TRG_LEV3
+ * @return	Nothing
+ * @note	Alternative to Chip_UART_IRQRBHandler() for high baud rates.
+ *			The pending interrupts are taken from the IIR register: a
+ *			receive data available interrupt reads the whole trigger
+ *			level without polling LSR, a character time-out interrupt
+ *			drains the rest of the receive FIFO, and a THRE interrupt
+ *			refills the whole transmit FIFO. Setup the FIFOs with the
+ *			same trigger level, for example (UART_FCR_FIFO_EN |
+ *			UART_FCR_TRG_LEV3), and enable UART_IER_RBRINT and
+ *			UART_IER_RLSINT. Chip_UART_SendRB() handles UART_IER_THREINT.
+ */
+void Chip_UART_IRQRBFIFOHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB, uint32_t rxTrig);
+
 /**
  * @brief	Returns the Auto Baud status
  * @param	pUART	: Pointer to selected UART peripheral
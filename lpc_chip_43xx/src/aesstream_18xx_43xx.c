@@ -0,0 +1,568 @@
+/*
+ * @brief LPC18xx/43xx streaming AES-CBC/CTR service
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* AES-128 round count and expanded key size */
+#define AES_ROUNDS          10
+#define AES_RK_BYTES        (AESSTREAM_BLOCK_SIZE * (AES_ROUNDS + 1))
+
+static int32_t aesChannel = AESSTREAM_SOFTWARE;
+static uint32_t aesChanMask;
+
+/* Request queue, the head request is the one running */
+static AESSTREAM_REQ_T *aesHead, *aesTail;
+
+/* A chunk is being processed, and for the engine, is still in the DMA */
+static bool aesActive;
+static volatile bool aesHwRunning;
+static uint32_t aesChunkLen;
+static uint32_t aesErrors;
+
+/* CBC decryption chaining value saved before an in-place chunk, and the
+   CTR keystream buffer */
+static uint8_t aesNextIV[AESSTREAM_BLOCK_SIZE];
+static uint32_t aesScratch[AESSTREAM_CHUNK_BYTES / 4];
+
+static const uint8_t aesSbox[256] = {
+	0x63, 0x7C, 0x77, 0x7B, 0xF2, 0x6B, 0x6F, 0xC5, 0x30, 0x01, 0x67, 0x2B, 0xFE, 0xD7, 0xAB, 0x76,
+	0xCA, 0x82, 0xC9, 0x7D, 0xFA, 0x59, 0x47, 0xF0, 0xAD, 0xD4, 0xA2, 0xAF, 0x9C, 0xA4, 0x72, 0xC0,
+	0xB7, 0xFD, 0x93, 0x26, 0x36, 0x3F, 0xF7, 0xCC, 0x34, 0xA5, 0xE5, 0xF1, 0x71, 0xD8, 0x31, 0x15,
+	0x04, 0xC7, 0x23, 0xC3, 0x18, 0x96, 0x05, 0x9A, 0x07, 0x12, 0x80, 0xE2, 0xEB, 0x27, 0xB2, 0x75,
+	0x09, 0x83, 0x2C, 0x1A, 0x1B, 0x6E, 0x5A, 0xA0, 0x52, 0x3B, 0xD6, 0xB3, 0x29, 0xE3, 0x2F, 0x84,
+	0x53, 0xD1, 0x00, 0xED, 0x20, 0xFC, 0xB1, 0x5B, 0x6A, 0xCB, 0xBE, 0x39, 0x4A, 0x4C, 0x58, 0xCF,
+	0xD0, 0xEF, 0xAA, 0xFB, 0x43, 0x4D, 0x33, 0x85, 0x45, 0xF9, 0x02, 0x7F, 0x50, 0x3C, 0x9F, 0xA8,
+	0x51, 0xA3, 0x40, 0x8F, 0x92, 0x9D, 0x38, 0xF5, 0xBC, 0xB6, 0xDA, 0x21, 0x10, 0xFF, 0xF3, 0xD2,
+	0xCD, 0x0C, 0x13, 0xEC, 0x5F, 0x97, 0x44, 0x17, 0xC4, 0xA7, 0x7E, 0x3D, 0x64, 0x5D, 0x19, 0x73,
+	0x60, 0x81, 0x4F, 0xDC, 0x22, 0x2A, 0x90, 0x88, 0x46, 0xEE, 0xB8, 0x14, 0xDE, 0x5E, 0x0B, 0xDB,
+	0xE0, 0x32, 0x3A, 0x0A, 0x49, 0x06, 0x24, 0x5C, 0xC2, 0xD3, 0xAC, 0x62, 0x91, 0x95, 0xE4, 0x79,
+	0xE7, 0xC8, 0x37, 0x6D, 0x8D, 0xD5, 0x4E, 0xA9, 0x6C, 0x56, 0xF4, 0xEA, 0x65, 0x7A, 0xAE, 0x08,
+	0xBA, 0x78, 0x25, 0x2E, 0x1C, 0xA6, 0xB4, 0xC6, 0xE8, 0xDD, 0x74, 0x1F, 0x4B, 0xBD, 0x8B, 0x8A,
+	0x70, 0x3E, 0xB5, 0x66, 0x48, 0x03, 0xF6, 0x0E, 0x61, 0x35, 0x57, 0xB9, 0x86, 0xC1, 0x1D, 0x9E,
+	0xE1, 0xF8, 0x98, 0x11, 0x69, 0xD9, 0x8E, 0x94, 0x9B, 0x1E, 0x87, 0xE9, 0xCE, 0x55, 0x28, 0xDF,
+	0x8C, 0xA1, 0x89, 0x0D, 0xBF, 0xE6, 0x42, 0x68, 0x41, 0x99, 0x2D, 0x0F, 0xB0, 0x54, 0xBB, 0x16
+};
+
+static const uint8_t aesInvSbox[256] = {
+	0x52, 0x09, 0x6A, 0xD5, 0x30, 0x36, 0xA5, 0x38, 0xBF, 0x40, 0xA3, 0x9E, 0x81, 0xF3, 0xD7, 0xFB,
+	0x7C, 0xE3, 0x39, 0x82, 0x9B, 0x2F, 0xFF, 0x87, 0x34, 0x8E, 0x43, 0x44, 0xC4, 0xDE, 0xE9, 0xCB,
+	0x54, 0x7B, 0x94, 0x32, 0xA6, 0xC2, 0x23, 0x3D, 0xEE, 0x4C, 0x95, 0x0B, 0x42, 0xFA, 0xC3, 0x4E,
+	0x08, 0x2E, 0xA1, 0x66, 0x28, 0xD9, 0x24, 0xB2, 0x76, 0x5B, 0xA2, 0x49, 0x6D, 0x8B, 0xD1, 0x25,
+	0x72, 0xF8, 0xF6, 0x64, 0x86, 0x68, 0x98, 0x16, 0xD4, 0xA4, 0x5C, 0xCC, 0x5D, 0x65, 0xB6, 0x92,
+	0x6C, 0x70, 0x48, 0x50, 0xFD, 0xED, 0xB9, 0xDA, 0x5E, 0x15, 0x46, 0x57, 0xA7, 0x8D, 0x9D, 0x84,
+	0x90, 0xD8, 0xAB, 0x00, 0x8C, 0xBC, 0xD3, 0x0A, 0xF7, 0xE4, 0x58, 0x05, 0xB8, 0xB3, 0x45, 0x06,
+	0xD0, 0x2C, 0x1E, 0x8F, 0xCA, 0x3F, 0x0F, 0x02, 0xC1, 0xAF, 0xBD, 0x03, 0x01, 0x13, 0x8A, 0x6B,
+	0x3A, 0x91, 0x11, 0x41, 0x4F, 0x67, 0xDC, 0xEA, 0x97, 0xF2, 0xCF, 0xCE, 0xF0, 0xB4, 0xE6, 0x73,
+	0x96, 0xAC, 0x74, 0x22, 0xE7, 0xAD, 0x35, 0x85, 0xE2, 0xF9, 0x37, 0xE8, 0x1C, 0x75, 0xDF, 0x6E,
+	0x47, 0xF1, 0x1A, 0x71, 0x1D, 0x29, 0xC5, 0x89, 0x6F, 0xB7, 0x62, 0x0E, 0xAA, 0x18, 0xBE, 0x1B,
+	0xFC, 0x56, 0x3E, 0x4B, 0xC6, 0xD2, 0x79, 0x20, 0x9A, 0xDB, 0xC0, 0xFE, 0x78, 0xCD, 0x5A, 0xF4,
+	0x1F, 0xDD, 0xA8, 0x33, 0x88, 0x07, 0xC7, 0x31, 0xB1, 0x12, 0x10, 0x59, 0x27, 0x80, 0xEC, 0x5F,
+	0x60, 0x51, 0x7F, 0xA9, 0x19, 0xB5, 0x4A, 0x0D, 0x2D, 0xE5, 0x7A, 0x9F, 0x93, 0xC9, 0x9C, 0xEF,
+	0xA0, 0xE0, 0x3B, 0x4D, 0xAE, 0x2A, 0xF5, 0xB0, 0xC8, 0xEB, 0xBB, 0x3C, 0x83, 0x53, 0x99, 0x61,
+	0x17, 0x2B, 0x04, 0x7E, 0xBA, 0x77, 0xD6, 0x26, 0xE1, 0x69, 0x14, 0x63, 0x55, 0x21, 0x0C, 0x7D
+};
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t aesEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void aesExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Multiply by x in GF(2^8) */
+STATIC INLINE uint8_t aesXtime(uint8_t x)
+{
+	return (uint8_t) ((x << 1) ^ ((x & 0x80) ? 0x1B : 0));
+}
+
+/* Multiply in GF(2^8) */
+static uint8_t aesMul(uint8_t a, uint8_t b)
+{
+	uint8_t p = 0;
+
+	while (b) {
+		if (b & 1) {
+			p ^= a;
+		}
+		a = aesXtime(a);
+		b >>= 1;
+	}
+	return p;
+}
+
+/* AES-128 key expansion */
+static void aesExpandKey(const uint8_t *key, uint8_t *rk)
+{
+	uint8_t rcon = 1, t[4];
+	uint32_t i;
+
+	memcpy(rk, key, AESSTREAM_BLOCK_SIZE);
+	for (i = AESSTREAM_BLOCK_SIZE; i < AES_RK_BYTES; i += 4) {
+		memcpy(t, &rk[i - 4], 4);
+		if ((i % AESSTREAM_BLOCK_SIZE) == 0) {
+			uint8_t t0 = t[0];
+
+			t[0] = aesSbox[t[1]] ^ rcon;
+			t[1] = aesSbox[t[2]];
+			t[2] = aesSbox[t[3]];
+			t[3] = aesSbox[t0];
+			rcon = aesXtime(rcon);
+		}
+		rk[i] = rk[i - 16] ^ t[0];
+		rk[i + 1] = rk[i - 15] ^ t[1];
+		rk[i + 2] = rk[i - 14] ^ t[2];
+		rk[i + 3] = rk[i - 13] ^ t[3];
+	}
+}
+
+static void aesAddRoundKey(uint8_t *s, const uint8_t *rk)
+{
+	uint32_t i;
+
+	for (i = 0; i < AESSTREAM_BLOCK_SIZE; i++) {
+		s[i] ^= rk[i];
+	}
+}
+
+/* SubBytes and ShiftRows of a column major state */
+static void aesSubShift(uint8_t *s, const uint8_t *box, bool inverse)
+{
+	uint8_t t[AESSTREAM_BLOCK_SIZE];
+	uint32_t r, c, from;
+
+	for (c = 0; c < 4; c++) {
+		for (r = 0; r < 4; r++) {
+			from = inverse ? ((c + 4 - r) % 4) : ((c + r) % 4);
+			t[(c * 4) + r] = box[s[(from * 4) + r]];
+		}
+	}
+	memcpy(s, t, AESSTREAM_BLOCK_SIZE);
+}
+
+static void aesMixColumns(uint8_t *s)
+{
+	uint8_t a0, a1, a2, a3, all;
+	uint32_t c;
+
+	for (c = 0; c < AESSTREAM_BLOCK_SIZE; c += 4) {
+		a0 = s[c];
+		a1 = s[c + 1];
+		a2 = s[c + 2];
+		a3 = s[c + 3];
+		all = a0 ^ a1 ^ a2 ^ a3;
+		s[c] ^= all ^ aesXtime(a0 ^ a1);
+		s[c + 1] ^= all ^ aesXtime(a1 ^ a2);
+		s[c + 2] ^= all ^ aesXtime(a2 ^ a3);
+		s[c + 3] ^= all ^ aesXtime(a3 ^ a0);
+	}
+}
+
+static void aesInvMixColumns(uint8_t *s)
+{
+	uint8_t a0, a1, a2, a3;
+	uint32_t c;
+
+	for (c = 0; c < AESSTREAM_BLOCK_SIZE; c += 4) {
+		a0 = s[c];
+		a1 = s[c + 1];
+		a2 = s[c + 2];
+		a3 = s[c + 3];
+		s[c] = aesMul(a0, 14) ^ aesMul(a1, 11) ^ aesMul(a2, 13) ^ aesMul(a3, 9);
+		s[c + 1] = aesMul(a0, 9) ^ aesMul(a1, 14) ^ aesMul(a2, 11) ^ aesMul(a3, 13);
+		s[c + 2] = aesMul(a0, 13) ^ aesMul(a1, 9) ^ aesMul(a2, 14) ^ aesMul(a3, 11);
+		s[c + 3] = aesMul(a0, 11) ^ aesMul(a1, 13) ^ aesMul(a2, 9) ^ aesMul(a3, 14);
+	}
+}
+
+/* Encrypt one block in place */
+static void aesEncryptBlock(const uint8_t *rk, uint8_t *s)
+{
+	uint32_t round;
+
+	aesAddRoundKey(s, rk);
+	for (round = 1; round <= AES_ROUNDS; round++) {
+		aesSubShift(s, aesSbox, false);
+		if (round != AES_ROUNDS) {
+			aesMixColumns(s);
+		}
+		aesAddRoundKey(s, &rk[round * AESSTREAM_BLOCK_SIZE]);
+	}
+}
+
+/* Decrypt one block in place */
+static void aesDecryptBlock(const uint8_t *rk, uint8_t *s)
+{
+	uint32_t round;
+
+	aesAddRoundKey(s, &rk[AES_ROUNDS * AESSTREAM_BLOCK_SIZE]);
+	for (round = AES_ROUNDS; round >= 1; round--) {
+		aesSubShift(s, aesInvSbox, true);
+		aesAddRoundKey(s, &rk[(round - 1) * AESSTREAM_BLOCK_SIZE]);
+		if (round != 1) {
+			aesInvMixColumns(s);
+		}
+	}
+}
+
+/* Increment a 128-bit big endian counter block */
+static void aesIncCounter(uint8_t *ctr)
+{
+	int i;
+
+	for (i = AESSTREAM_BLOCK_SIZE - 1; i >= 0; i--) {
+		if (++ctr[i] != 0) {
+			break;
+		}
+	}
+}
+
+static void aesXor(uint8_t *pOut, const uint8_t *pA, const uint8_t *pB, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		pOut[i] = pA[i] ^ pB[i];
+	}
+}
+
+/* Check a request length against the mode rules */
+STATIC INLINE bool aesLengthValid(const AESSTREAM_CTX_T *pCtx, uint32_t len)
+{
+	return (pCtx->mode == AESSTREAM_CTR) || ((len % AESSTREAM_BLOCK_SIZE) == 0);
+}
+
+/* Run data through the software AES */
+static void aesSoftware(AESSTREAM_CTX_T *pCtx, uint8_t *pOut, const uint8_t *pIn, uint32_t len)
+{
+	uint8_t rk[AES_RK_BYTES], blk[AESSTREAM_BLOCK_SIZE];
+	uint32_t n;
+
+	aesExpandKey(pCtx->key, rk);
+	while (len > 0) {
+		n = (len < AESSTREAM_BLOCK_SIZE) ? len : AESSTREAM_BLOCK_SIZE;
+		switch (pCtx->mode) {
+		case AESSTREAM_CBC_ENCRYPT:
+			aesXor(blk, pIn, pCtx->iv, AESSTREAM_BLOCK_SIZE);
+			aesEncryptBlock(rk, blk);
+			memcpy(pCtx->iv, blk, AESSTREAM_BLOCK_SIZE);
+			break;
+
+		case AESSTREAM_CBC_DECRYPT:
+			memcpy(blk, pIn, AESSTREAM_BLOCK_SIZE);
+			aesDecryptBlock(rk, blk);
+			aesXor(blk, blk, pCtx->iv, AESSTREAM_BLOCK_SIZE);
+			memcpy(pCtx->iv, pIn, AESSTREAM_BLOCK_SIZE);
+			break;
+
+		default:
+			memcpy(blk, pCtx->iv, AESSTREAM_BLOCK_SIZE);
+			aesEncryptBlock(rk, blk);
+			aesIncCounter(pCtx->iv);
+			aesXor(blk, blk, pIn, n);
+			break;
+		}
+		memcpy(pOut, blk, n);
+		pIn += n;
+		pOut += n;
+		len -= n;
+	}
+}
+
+/* Start the next chunk of a request on the engine */
+static Status aesHwStart(AESSTREAM_REQ_T *pReq)
+{
+	AESSTREAM_CTX_T *pCtx = pReq->pCtx;
+	uint8_t *pIn = (uint8_t *) &pReq->pIn[pReq->offset];
+	uint8_t *pOut = &pReq->pOut[pReq->offset];
+	uint8_t *pCtr = (uint8_t *) aesScratch;
+	uint32_t blocks = (aesChunkLen + AESSTREAM_BLOCK_SIZE - 1) / AESSTREAM_BLOCK_SIZE;
+	uint32_t i, status;
+
+	switch (pCtx->mode) {
+	case AESSTREAM_CBC_ENCRYPT:
+		status = Chip_AES_SetMode(CHIP_AES_API_CMD_ENCODE_CBC);
+		break;
+
+	case AESSTREAM_CBC_DECRYPT:
+		/* The last input block is the next chaining value, keep it before
+		   an in-place chunk overwrites it */
+		memcpy(aesNextIV, &pIn[aesChunkLen - AESSTREAM_BLOCK_SIZE], AESSTREAM_BLOCK_SIZE);
+		status = Chip_AES_SetMode(CHIP_AES_API_CMD_DECODE_CBC);
+		break;
+
+	default:
+		/* Counter blocks are encrypted in place into the keystream */
+		for (i = 0; i < blocks; i++) {
+			memcpy(&pCtr[i * AESSTREAM_BLOCK_SIZE], pCtx->iv, AESSTREAM_BLOCK_SIZE);
+			aesIncCounter(pCtx->iv);
+		}
+		pIn = pOut = pCtr;
+		status = Chip_AES_SetMode(CHIP_AES_API_CMD_ENCODE_ECB);
+		break;
+	}
+	if (status != LPC_OK) {
+		return ERROR;
+	}
+
+	Chip_AES_LoadKeySW(pCtx->key);
+	if (pCtx->mode != AESSTREAM_CTR) {
+		Chip_AES_LoadIV_SW(pCtx->iv);
+	}
+
+	aesErrors = 0;
+	aesHwRunning = true;
+	if (Chip_AES_OperateDMA(aesChannel, pOut, pIn, blocks) != LPC_OK) {
+		aesHwRunning = false;
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/* Post-process a chunk the engine has finished */
+static void aesHwFinish(AESSTREAM_REQ_T *pReq)
+{
+	AESSTREAM_CTX_T *pCtx = pReq->pCtx;
+	uint8_t *pOut = &pReq->pOut[pReq->offset];
+
+	switch (pCtx->mode) {
+	case AESSTREAM_CBC_ENCRYPT:
+		memcpy(pCtx->iv, &pOut[aesChunkLen - AESSTREAM_BLOCK_SIZE], AESSTREAM_BLOCK_SIZE);
+		break;
+
+	case AESSTREAM_CBC_DECRYPT:
+		memcpy(pCtx->iv, aesNextIV, AESSTREAM_BLOCK_SIZE);
+		break;
+
+	default:
+		aesXor(pOut, &pReq->pIn[pReq->offset], (uint8_t *) aesScratch, aesChunkLen);
+		break;
+	}
+}
+
+/* Account for a finished chunk and complete the request when it is all done */
+static void aesChunkDone(AESSTREAM_REQ_T *pReq, Status status)
+{
+	uint32_t primask;
+
+	pReq->offset += aesChunkLen;
+	if ((status == SUCCESS) && (pReq->offset < pReq->len)) {
+		aesActive = false;
+		return;
+	}
+
+	primask = aesEnterCritical();
+	aesHead = pReq->next;
+	if (aesHead == NULL) {
+		aesTail = NULL;
+	}
+	aesActive = false;
+	aesExitCritical(primask);
+
+	pReq->status = status;
+	pReq->done = 1;
+	if (pReq->cb) {
+		pReq->cb(pReq);
+	}
+}
+
+/* Run queued chunks until the engine is busy or the queue is empty */
+static void aesPump(void)
+{
+	AESSTREAM_REQ_T *pReq;
+	uint32_t primask;
+
+	for (;; ) {
+		primask = aesEnterCritical();
+		pReq = aesHead;
+		if ((aesActive) || (pReq == NULL)) {
+			aesExitCritical(primask);
+			return;
+		}
+		aesActive = true;
+		aesExitCritical(primask);
+
+		aesChunkLen = pReq->len - pReq->offset;
+		if (aesChunkLen > AESSTREAM_CHUNK_BYTES) {
+			aesChunkLen = AESSTREAM_CHUNK_BYTES;
+		}
+
+		if (aesChannel == AESSTREAM_SOFTWARE) {
+			aesSoftware(pReq->pCtx, &pReq->pOut[pReq->offset], &pReq->pIn[pReq->offset], aesChunkLen);
+			aesChunkDone(pReq, SUCCESS);
+		}
+		else if (aesHwStart(pReq) == SUCCESS) {
+			/* Chip_AESSTREAM_Poll() takes over */
+			return;
+		}
+		else {
+			aesChunkDone(pReq, ERROR);
+		}
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the stream service */
+Status Chip_AESSTREAM_Init(int32_t channel)
+{
+	aesHead = aesTail = NULL;
+	aesActive = false;
+	aesHwRunning = false;
+	aesChannel = channel;
+	if (channel == AESSTREAM_SOFTWARE) {
+		return SUCCESS;
+	}
+
+	if ((channel < 0) || (channel > (GPDMA_NUMBER_CHANNELS - 2))) {
+		return ERROR;
+	}
+	aesChanMask = 3UL << channel;
+	Chip_AES_Init();
+	if (Chip_AES_Config_DMA(channel) != LPC_OK) {
+		aesChannel = AESSTREAM_SOFTWARE;
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/* Initialize a stream context */
+void Chip_AESSTREAM_InitCtx(AESSTREAM_CTX_T *pCtx, AESSTREAM_MODE_T mode, const uint8_t *key, const uint8_t *iv)
+{
+	pCtx->mode = mode;
+	memcpy(pCtx->key, key, AESSTREAM_BLOCK_SIZE);
+	memcpy(pCtx->iv, iv, AESSTREAM_BLOCK_SIZE);
+}
+
+/* Queue a stream request */
+Status Chip_AESSTREAM_Submit(AESSTREAM_REQ_T *pReq)
+{
+	uint32_t primask;
+
+	if (!aesLengthValid(pReq->pCtx, pReq->len)) {
+		return ERROR;
+	}
+
+	pReq->offset = 0;
+	pReq->done = 0;
+	pReq->status = ERROR;
+	pReq->next = NULL;
+	if (pReq->len == 0) {
+		pReq->status = SUCCESS;
+		pReq->done = 1;
+		if (pReq->cb) {
+			pReq->cb(pReq);
+		}
+		return SUCCESS;
+	}
+
+	primask = aesEnterCritical();
+	if (aesTail) {
+		aesTail->next = pReq;
+	}
+	else {
+		aesHead = pReq;
+	}
+	aesTail = pReq;
+	aesExitCritical(primask);
+
+	aesPump();
+
+	return SUCCESS;
+}
+
+/* Check the engine and continue the queued requests */
+void Chip_AESSTREAM_Poll(void)
+{
+	uint32_t primask;
+	bool finished;
+
+	if (aesChannel == AESSTREAM_SOFTWARE) {
+		return;
+	}
+
+	/* The channels disable themselves at the end of the transfer. Their
+	   interrupt flags are only cleared, the manager does not own them. */
+	primask = aesEnterCritical();
+	aesErrors |= LPC_GPDMA->RAWINTERRSTAT & aesChanMask;
+	LPC_GPDMA->INTTCCLEAR = aesChanMask;
+	LPC_GPDMA->INTERRCLR = aesChanMask;
+	finished = aesHwRunning && ((LPC_GPDMA->ENBLDCHNS & aesChanMask) == 0);
+	if (finished) {
+		aesHwRunning = false;
+	}
+	aesExitCritical(primask);
+
+	if (finished) {
+		if (aesErrors == 0) {
+			aesHwFinish(aesHead);
+			aesChunkDone(aesHead, SUCCESS);
+		}
+		else {
+			aesChunkDone(aesHead, ERROR);
+		}
+		aesPump();
+	}
+}
+
+/* Run data through the software AES, updating the context */
+Status Chip_AESSTREAM_ProcessSW(AESSTREAM_CTX_T *pCtx, uint8_t *pOut, const uint8_t *pIn, uint32_t len)
+{
+	if (!aesLengthValid(pCtx, len)) {
+		return ERROR;
+	}
+
+	aesSoftware(pCtx, pOut, pIn, len);
+	return SUCCESS;
+}
@@ -0,0 +1,491 @@
+/*
+ * @brief LPC18xx/43xx interrupt driven C_CAN driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Command masks of the message object transfers */
+#define CCANQ_CMD_READ_RX   (CCAN_IF_CMDMSK_RD | CCAN_IF_CMDMSK_ARB | CCAN_IF_CMDMSK_CTRL | \
+							 CCAN_IF_CMDMSK_DATAA | CCAN_IF_CMDMSK_DATAB | \
+							 CCAN_IF_CMDMSK_R_CLRINTPND | CCAN_IF_CMDMSK_R_NEWDAT)
+#define CCANQ_CMD_WRITE_TX  (CCAN_IF_CMDMSK_WR | CCAN_IF_CMDMSK_ARB | CCAN_IF_CMDMSK_CTRL | \
+							 CCAN_IF_CMDMSK_DATAA | CCAN_IF_CMDMSK_DATAB)
+#define CCANQ_CMD_WRITE_RX  (CCAN_IF_CMDMSK_WR | CCAN_IF_CMDMSK_MASK | CCAN_IF_CMDMSK_ARB | \
+							 CCAN_IF_CMDMSK_CTRL)
+#define CCANQ_CMD_CLRINTPND (CCAN_IF_CMDMSK_RD | CCAN_IF_CMDMSK_R_CLRINTPND)
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t ccanqEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void ccanqExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Index of the lowest set bit */
+STATIC INLINE uint32_t ccanqLowestBit(uint32_t bits)
+{
+	return __CLZ(__RBIT(bits));
+}
+
+/* Mask of @a n bits from bit @a first */
+STATIC INLINE uint32_t ccanqBits(uint32_t first, uint32_t n)
+{
+	return ((n >= 32) ? 0xFFFFFFFF : ((1UL << n) - 1)) << first;
+}
+
+/* Allocate @a n consecutive message objects from the top or the bottom of
+   the message RAM, returns the first object number or 0 */
+STATIC uint8_t ccanqAlloc(CCANQ_HANDLE_T *pHandle, uint32_t n, bool top)
+{
+	uint32_t starts = pHandle->freeObjs;
+	uint32_t i;
+
+	if ((n == 0) || (n > CCAN_MSG_MAX_NUM)) {
+		return 0;
+	}
+
+	/* Bit i stays set when objects i + 1 to i + n are all free */
+	for (i = 1; i < n; i++) {
+		starts &= starts >> 1;
+	}
+	if (starts == 0) {
+		return 0;
+	}
+
+	i = top ? (uint32_t) (31 - __CLZ(starts)) : (uint32_t) ccanqLowestBit(starts);
+	pHandle->freeObjs &= ~ccanqBits(i, n);
+	return i + 1;
+}
+
+/* Invalidate a message object, through IF2 */
+STATIC void ccanqInvalidate(LPC_CCAN_T *pCCAN, uint32_t msgNum)
+{
+	pCCAN->IF[CCAN_MSG_IF2].ARB1 = 0;
+	pCCAN->IF[CCAN_MSG_IF2].ARB2 = 0;
+	pCCAN->IF[CCAN_MSG_IF2].MCTRL = 0;
+	Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF2, CCAN_IF_CMDMSK_WR | CCAN_IF_CMDMSK_ARB | CCAN_IF_CMDMSK_CTRL,
+								msgNum);
+}
+
+/* Arbitration field of an identifier: base identifier, then IDE so that
+   standard frames win over extended frames of the same base identifier */
+STATIC uint32_t ccanqPrio(uint32_t id)
+{
+	if (id & CCANQ_ID_EXT) {
+		id &= CCAN_MSG_ID_EXT_MASK;
+		return ((id >> 18) << 19) | (1UL << 18) | (id & 0x3FFFF);
+	}
+
+	return (id & CCAN_MSG_ID_STD_MASK) << 19;
+}
+
+/* Transmit queue order: arbitration priority, then submission order */
+STATIC INLINE bool ccanqBefore(const CCANQ_TXENTRY_T *a, const CCANQ_TXENTRY_T *b)
+{
+	return (a->prio < b->prio) || ((a->prio == b->prio) && ((int32_t) (a->seq - b->seq) < 0));
+}
+
+/* Add a frame to the transmit queue heap */
+STATIC void ccanqPush(CCANQ_HANDLE_T *pHandle, const CCAN_MSG_OBJ_T *pMsg)
+{
+	CCANQ_TXENTRY_T *q = pHandle->cfg.txQueue;
+	CCANQ_TXENTRY_T e;
+	uint32_t i, parent;
+
+	e.prio = ccanqPrio(pMsg->id);
+	e.seq = pHandle->txSeq++;
+	e.msg = *pMsg;
+
+	for (i = pHandle->txCount++; i > 0; i = parent) {
+		parent = (i - 1) >> 1;
+		if (!ccanqBefore(&e, &q[parent])) {
+			break;
+		}
+		q[i] = q[parent];
+	}
+	q[i] = e;
+}
+
+/* Remove the first frame from the transmit queue heap */
+STATIC void ccanqPop(CCANQ_HANDLE_T *pHandle, CCAN_MSG_OBJ_T *pMsg)
+{
+	CCANQ_TXENTRY_T *q = pHandle->cfg.txQueue;
+	CCANQ_TXENTRY_T *last;
+	uint32_t i, child, n;
+
+	*pMsg = q[0].msg;
+	n = --pHandle->txCount;
+	last = &q[n];
+
+	for (i = 0; (child = (i << 1) + 1) < n; i = child) {
+		if ((child + 1 < n) && ccanqBefore(&q[child + 1], &q[child])) {
+			child++;
+		}
+		if (!ccanqBefore(&q[child], last)) {
+			break;
+		}
+		q[i] = q[child];
+	}
+	q[i] = *last;
+}
+
+/* Load a frame in a transmit object and request its transmission */
+STATIC void ccanqWriteTx(LPC_CCAN_T *pCCAN, uint32_t msgNum, const CCAN_MSG_OBJ_T *pMsg)
+{
+	CCAN_IF_T *pIF = &pCCAN->IF[CCAN_MSG_IF2];
+	const uint8_t *d = pMsg->data;
+
+	pIF->MCTRL = CCAN_IF_MCTRL_TXIE | CCAN_IF_MCTRL_TXRQ | CCAN_IF_MCTRL_EOB | (pMsg->dlc & CCAN_IF_MCTRL_DLC_MSK);
+	pIF->DA1 = d[0] | (d[1] << 8);
+	pIF->DA2 = d[2] | (d[3] << 8);
+	pIF->DB1 = d[4] | (d[5] << 8);
+	pIF->DB2 = d[6] | (d[7] << 8);
+	if (pMsg->id & CCANQ_ID_EXT) {
+		pIF->ARB1 = pMsg->id & 0xFFFF;
+		pIF->ARB2 = CCAN_IF_ARB2_MSGVAL | CCAN_IF_ARB2_XTD | CCAN_IF_ARB2_DIR(CCAN_TX_DIR) |
+					((pMsg->id >> 16) & (CCAN_MSG_ID_EXT_MASK >> 16));
+	}
+	else {
+		pIF->ARB1 = 0;
+		pIF->ARB2 = CCAN_IF_ARB2_MSGVAL | CCAN_IF_ARB2_DIR(CCAN_TX_DIR) | ((pMsg->id & CCAN_MSG_ID_STD_MASK) << 2);
+	}
+	Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF2, CCANQ_CMD_WRITE_TX, msgNum);
+}
+
+/* Load the next batch of queued frames once all transmit objects are idle.
+   The hardware sends the lowest numbered object first, so the frames are
+   loaded in queue order from the first transmit object. Called with
+   interrupts disabled. */
+STATIC void ccanqLoadTx(CCANQ_HANDLE_T *pHandle)
+{
+	CCAN_MSG_OBJ_T msg;
+	uint32_t i;
+
+	if ((pHandle->txBusy != 0) || (pHandle->txCount == 0)) {
+		return;
+	}
+
+	for (i = 0; (i < CCANQ_TX_OBJS) && (pHandle->txCount > 0); i++) {
+		ccanqPop(pHandle, &msg);
+		ccanqWriteTx(pHandle->pCCAN, pHandle->txFirst + i, &msg);
+		pHandle->txBusy |= 1UL << (pHandle->txFirst + i - 1);
+	}
+	pHandle->stats.txBatches++;
+}
+
+/* Read a receive object into the receive ring, through IF1 */
+STATIC void ccanqReadRx(CCANQ_HANDLE_T *pHandle, uint32_t msgNum)
+{
+	LPC_CCAN_T *pCCAN = pHandle->pCCAN;
+	CCAN_IF_T *pIF = &pCCAN->IF[CCAN_MSG_IF1];
+	CCAN_MSG_OBJ_T *pMsg;
+	uint32_t mctrl, arb2, head, v;
+
+	/* Reading clears NEWDAT, the object takes the next frame right away */
+	Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF1, CCANQ_CMD_READ_RX, msgNum);
+	mctrl = pIF->MCTRL;
+
+	/* The last object of a full FIFO was overwritten. Clearing the flag
+	   can drop a frame stored in the meantime, the FIFO is overflowing. */
+	if (mctrl & CCAN_IF_MCTRL_MLST) {
+		pHandle->stats.rxOverruns++;
+		pIF->MCTRL = mctrl & ~(CCAN_IF_MCTRL_MLST | CCAN_IF_MCTRL_NEWD | CCAN_IF_MCTRL_INTP);
+		Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF1, CCAN_IF_CMDMSK_WR | CCAN_IF_CMDMSK_CTRL, msgNum);
+	}
+	if (!(mctrl & CCAN_IF_MCTRL_NEWD)) {
+		return;
+	}
+
+	head = pHandle->rxHead;
+	if ((head - pHandle->rxTail) >= pHandle->cfg.rxRingSize) {
+		pHandle->stats.rxDropped++;
+		return;
+	}
+
+	pMsg = &pHandle->cfg.rxRing[head & (pHandle->cfg.rxRingSize - 1)];
+	arb2 = pIF->ARB2;
+	if (arb2 & CCAN_IF_ARB2_XTD) {
+		pMsg->id = (((arb2 & (CCAN_MSG_ID_EXT_MASK >> 16)) << 16) | (pIF->ARB1 & 0xFFFF)) | CCANQ_ID_EXT;
+	}
+	else {
+		pMsg->id = (arb2 >> 2) & CCAN_MSG_ID_STD_MASK;
+	}
+	pMsg->dlc = mctrl & CCAN_IF_MCTRL_DLC_MSK;
+	v = pIF->DA1;
+	pMsg->data[0] = v;
+	pMsg->data[1] = v >> 8;
+	v = pIF->DA2;
+	pMsg->data[2] = v;
+	pMsg->data[3] = v >> 8;
+	v = pIF->DB1;
+	pMsg->data[4] = v;
+	pMsg->data[5] = v >> 8;
+	v = pIF->DB2;
+	pMsg->data[6] = v;
+	pMsg->data[7] = v >> 8;
+
+	pHandle->rxHead = head + 1;
+	pHandle->stats.rxFrames++;
+}
+
+/* Objects of a FIFO holding frames, oldest first. The hardware stores
+   into the lowest free object, so objects freed while the upper part of
+   the FIFO was still full get newer frames: when the pending objects
+   have a gap, the run above the highest gap is the oldest. */
+STATIC uint32_t ccanqOldest(uint32_t pend)
+{
+	uint32_t b = 31 - __CLZ(pend);
+
+	while ((b > 0) && (pend & (1UL << (b - 1)))) {
+		b--;
+	}
+	return pend & ~ccanqBits(0, b);
+}
+
+/* Move the frames of the receive FIFO holding object @a msgNum to the ring */
+STATIC void ccanqDrainFifo(CCANQ_HANDLE_T *pHandle, uint32_t msgNum)
+{
+	LPC_CCAN_T *pCCAN = pHandle->pCCAN;
+	uint32_t idx = msgNum - 1;
+	uint32_t below, first, last, fifo, pend, toread, count = 0;
+
+	/* A FIFO starts after the end of another FIFO or a non receive object */
+	below = (pHandle->fifoEnds | ~pHandle->rxObjs) & ccanqBits(0, idx);
+	first = below ? (32 - __CLZ(below)) : 0;
+	last = ccanqLowestBit(pHandle->fifoEnds & ~ccanqBits(0, first));
+	fifo = ccanqBits(first, last - first + 1);
+
+	while ((pend = ((pCCAN->ND1 & 0xFFFF) | (pCCAN->ND2 << 16)) & fifo) != 0) {
+		toread = ccanqOldest(pend >> first) << first;
+		while (toread) {
+			ccanqReadRx(pHandle, ccanqLowestBit(toread) + 1);
+			toread &= toread - 1;
+			count++;
+		}
+	}
+
+	/* Nothing left to read, do not report the object again */
+	if (count == 0) {
+		Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF1, CCANQ_CMD_CLRINTPND, msgNum);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Start the driver on a C_CAN controller */
+Status Chip_CCANQ_Init(CCANQ_HANDLE_T *pHandle, LPC_CCAN_T *pCCAN, const CCANQ_CFG_T *pCfg)
+{
+	uint32_t i;
+
+	if ((pCfg->rxRing == NULL) || (pCfg->rxRingSize == 0) || (pCfg->rxRingSize & (pCfg->rxRingSize - 1)) ||
+		(pCfg->txQueue == NULL) || (pCfg->txQueueSize == 0)) {
+		return ERROR;
+	}
+
+	pHandle->pCCAN = pCCAN;
+	pHandle->cfg = *pCfg;
+	pHandle->rxObjs = 0;
+	pHandle->fifoEnds = 0;
+	pHandle->txBusy = 0;
+	pHandle->rxHead = pHandle->rxTail = 0;
+	pHandle->txCount = 0;
+	pHandle->txSeq = 0;
+	memset(&pHandle->stats, 0, sizeof(pHandle->stats));
+
+	for (i = 1; i <= CCAN_MSG_MAX_NUM; i++) {
+		ccanqInvalidate(pCCAN, i);
+	}
+	pHandle->freeObjs = 0xFFFFFFFF;
+	pHandle->txFirst = ccanqAlloc(pHandle, CCANQ_TX_OBJS, true);
+
+	/* Status interrupts would come with every frame, only take errors */
+	Chip_CCAN_DisableInt(pCCAN, CCAN_CTRL_SIE);
+	Chip_CCAN_EnableInt(pCCAN, CCAN_CTRL_IE | CCAN_CTRL_EIE);
+
+	return SUCCESS;
+}
+
+/* Add a receive filter backed by a hardware FIFO */
+uint8_t Chip_CCANQ_AddFilter(CCANQ_HANDLE_T *pHandle, uint32_t id, uint32_t mask, uint32_t depth)
+{
+	LPC_CCAN_T *pCCAN = pHandle->pCCAN;
+	CCAN_IF_T *pIF = &pCCAN->IF[CCAN_MSG_IF2];
+	uint32_t primask, i;
+	uint8_t first;
+
+	primask = ccanqEnterCritical();
+	first = ccanqAlloc(pHandle, depth, false);
+	if (first == 0) {
+		ccanqExitCritical(primask);
+		return 0;
+	}
+
+	/* Same filter in every object, only the last one ends the FIFO */
+	if (id & CCANQ_ID_EXT) {
+		pIF->MSK1 = mask & 0xFFFF;
+		pIF->MSK2 = CCAN_IF_MASK2_MXTD | CCAN_IF_MASK2_MDIR(1) | ((mask >> 16) & (CCAN_MSG_ID_EXT_MASK >> 16));
+		pIF->ARB1 = id & 0xFFFF;
+		pIF->ARB2 = CCAN_IF_ARB2_MSGVAL | CCAN_IF_ARB2_XTD | ((id >> 16) & (CCAN_MSG_ID_EXT_MASK >> 16));
+	}
+	else {
+		pIF->MSK1 = 0;
+		pIF->MSK2 = CCAN_IF_MASK2_MXTD | CCAN_IF_MASK2_MDIR(1) | ((mask & CCAN_MSG_ID_STD_MASK) << 2);
+		pIF->ARB1 = 0;
+		pIF->ARB2 = CCAN_IF_ARB2_MSGVAL | ((id & CCAN_MSG_ID_STD_MASK) << 2);
+	}
+	for (i = first; i < first + depth; i++) {
+		pIF->MCTRL = CCAN_IF_MCTRL_UMSK | CCAN_IF_MCTRL_RXIE | ((i == first + depth - 1) ? CCAN_IF_MCTRL_EOB : 0);
+		Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF2, CCANQ_CMD_WRITE_RX, i);
+	}
+
+	pHandle->rxObjs |= ccanqBits(first - 1, depth);
+	pHandle->fifoEnds |= 1UL << (first + depth - 2);
+	ccanqExitCritical(primask);
+
+	return first;
+}
+
+/* Remove a receive filter */
+void Chip_CCANQ_RemoveFilter(CCANQ_HANDLE_T *pHandle, uint8_t first)
+{
+	uint32_t primask, last, objs, i;
+
+	if ((first == 0) || (first > CCAN_MSG_MAX_NUM) || !(pHandle->rxObjs & (1UL << (first - 1)))) {
+		return;
+	}
+
+	primask = ccanqEnterCritical();
+	last = ccanqLowestBit(pHandle->fifoEnds & ~ccanqBits(0, first - 1));
+	objs = ccanqBits(first - 1, last - first + 2);
+	for (i = first; i <= last + 1; i++) {
+		ccanqInvalidate(pHandle->pCCAN, i);
+	}
+	pHandle->rxObjs &= ~objs;
+	pHandle->fifoEnds &= ~objs;
+	pHandle->freeObjs |= objs;
+	ccanqExitCritical(primask);
+}
+
+/* Queue a frame for transmission */
+Status Chip_CCANQ_Send(CCANQ_HANDLE_T *pHandle, const CCAN_MSG_OBJ_T *pMsg)
+{
+	uint32_t primask;
+
+	primask = ccanqEnterCritical();
+	if (pHandle->txCount >= pHandle->cfg.txQueueSize) {
+		pHandle->stats.txFull++;
+		ccanqExitCritical(primask);
+		return ERROR;
+	}
+	ccanqPush(pHandle, pMsg);
+	ccanqLoadTx(pHandle);
+	ccanqExitCritical(primask);
+
+	return SUCCESS;
+}
+
+/* Take the oldest frame from the receive ring */
+bool Chip_CCANQ_Receive(CCANQ_HANDLE_T *pHandle, CCAN_MSG_OBJ_T *pMsg)
+{
+	uint32_t tail = pHandle->rxTail;
+
+	if (tail == pHandle->rxHead) {
+		return false;
+	}
+
+	*pMsg = pHandle->cfg.rxRing[tail & (pHandle->cfg.rxRingSize - 1)];
+	pHandle->rxTail = tail + 1;
+	return true;
+}
+
+/* C_CAN interrupt handler */
+void Chip_CCANQ_IRQHandler(CCANQ_HANDLE_T *pHandle)
+{
+	LPC_CCAN_T *pCCAN = pHandle->pCCAN;
+	uint32_t intId, stat, bit, primask;
+	uint32_t rxFrames = pHandle->stats.rxFrames;
+
+	pHandle->stats.irqs++;
+	while ((intId = (Chip_CCAN_GetIntID(pCCAN) & 0xFFFF)) != CCAN_INT_NO_PENDING) {
+		if (intId == CCAN_INT_STATUS) {
+			/* Reading the status clears the interrupt */
+			stat = Chip_CCAN_GetStatus(pCCAN);
+			if (stat & CCAN_STAT_BOFF) {
+				/* The controller stopped, clearing INIT starts the recovery */
+				pHandle->stats.busOff++;
+				pCCAN->CNTL &= ~CCAN_CTRL_INIT;
+			}
+			else {
+				pHandle->stats.busErrors++;
+			}
+			continue;
+		}
+
+		bit = 1UL << ((intId - 1) & 0x1F);
+		if (pHandle->rxObjs & bit) {
+			ccanqDrainFifo(pHandle, intId);
+		}
+		else {
+			Chip_CCAN_TransferMsgObject(pCCAN, CCAN_MSG_IF1, CCANQ_CMD_CLRINTPND, intId);
+			if (pHandle->txBusy & bit) {
+				pHandle->stats.txFrames++;
+				primask = ccanqEnterCritical();
+				pHandle->txBusy &= ~bit;
+				ccanqLoadTx(pHandle);
+				ccanqExitCritical(primask);
+			}
+		}
+	}
+
+	if ((pHandle->stats.rxFrames != rxFrames) && pHandle->cfg.rxEvent) {
+		pHandle->cfg.rxEvent();
+	}
+}
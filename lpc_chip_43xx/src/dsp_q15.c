@@ -0,0 +1,664 @@
+/*
+ * @brief Fixed-point (q15) signal processing kernels
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include <string.h>
+#include "dsp_q15.h"
+
+#if defined(__ARM_FEATURE_DSP) || defined(__TARGET_FEATURE_DSPMUL)
+#include "chip.h"
+#endif
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#if !(defined(__ARM_FEATURE_DSP) || defined(__TARGET_FEATURE_DSPMUL))
+/* C equivalents of the Cortex-M4 SIMD instructions used by the kernels, so
+   that they can be built and checked on cores and hosts without them */
+static int32_t simdSat16(int32_t v)
+{
+	return (v > 32767) ? 32767 : ((v < -32768) ? -32768 : v);
+}
+
+#define SIMD_LO(x)      ((int32_t) (int16_t) ((x) & 0xFFFF))
+#define SIMD_HI(x)      ((int32_t) (int16_t) ((x) >> 16))
+#define SIMD_PACK(l, h) (((uint32_t) (l) & 0xFFFF) | ((uint32_t) (h) << 16))
+
+STATIC INLINE uint32_t __QADD16(uint32_t a, uint32_t b)
+{
+	return SIMD_PACK(simdSat16(SIMD_LO(a) + SIMD_LO(b)), simdSat16(SIMD_HI(a) + SIMD_HI(b)));
+}
+
+STATIC INLINE uint32_t __QSUB16(uint32_t a, uint32_t b)
+{
+	return SIMD_PACK(simdSat16(SIMD_LO(a) - SIMD_LO(b)), simdSat16(SIMD_HI(a) - SIMD_HI(b)));
+}
+
+STATIC INLINE uint32_t __SHADD16(uint32_t a, uint32_t b)
+{
+	return SIMD_PACK((SIMD_LO(a) + SIMD_LO(b)) >> 1, (SIMD_HI(a) + SIMD_HI(b)) >> 1);
+}
+
+STATIC INLINE uint32_t __SMUSD(uint32_t a, uint32_t b)
+{
+	return (uint32_t) (SIMD_LO(a) * SIMD_LO(b) - SIMD_HI(a) * SIMD_HI(b));
+}
+
+STATIC INLINE uint32_t __SMUADX(uint32_t a, uint32_t b)
+{
+	return (uint32_t) (SIMD_LO(a) * SIMD_HI(b) + SIMD_HI(a) * SIMD_LO(b));
+}
+
+STATIC INLINE uint64_t __SMLALD(uint32_t a, uint32_t b, uint64_t acc)
+{
+	return acc + (uint64_t) ((int64_t) SIMD_LO(a) * SIMD_LO(b) + (int64_t) SIMD_HI(a) * SIMD_HI(b));
+}
+
+STATIC INLINE uint64_t __SMLALDX(uint32_t a, uint32_t b, uint64_t acc)
+{
+	return acc + (uint64_t) ((int64_t) SIMD_LO(a) * SIMD_HI(b) + (int64_t) SIMD_HI(a) * SIMD_LO(b));
+}
+
+STATIC INLINE uint32_t __PKHBT(uint32_t a, uint32_t b, uint32_t shift)
+{
+	return (a & 0xFFFF) | ((b << shift) & 0xFFFF0000);
+}
+
+STATIC INLINE uint32_t __RBIT(uint32_t v)
+{
+	uint32_t r = 0;
+	int i;
+
+	for (i = 0; i < 32; i++) {
+		r = (r << 1) | (v & 1);
+		v >>= 1;
+	}
+	return r;
+}
+
+STATIC INLINE uint8_t __CLZ(uint32_t v)
+{
+	uint8_t n = 0;
+
+	while ((n < 32) && ((v & 0x80000000) == 0)) {
+		v <<= 1;
+		n++;
+	}
+	return n;
+}
+
+#endif
+
+/* Twiddle factors for a DSP_FFT_MAX_LEN point transform: word k holds
+   cos(2*pi*k/N) in the low half and -sin(2*pi*k/N) in the high half */
+static const uint32_t fftTwiddle[DSP_FFT_MAX_LEN / 2] = {
+	0x00007FFF, 0xFF377FFE, 0xFE6E7FFD, 0xFDA57FF9, 0xFCDC7FF5, 0xFC137FF0,
+	0xFB4A7FE9, 0xFA817FE1, 0xF9B87FD8, 0xF8EF7FCD, 0xF8277FC1, 0xF75E7FB4,
+	0xF6967FA6, 0xF5CD7F97, 0xF5057F86, 0xF43C7F74, 0xF3747F61, 0xF2AC7F4D,
+	0xF1E47F37, 0xF11D7F21, 0xF0557F09, 0xEF8E7EEF, 0xEEC67ED5, 0xEDFF7EB9,
+	0xED387E9C, 0xEC717E7E, 0xEBAB7E5F, 0xEAE47E3E, 0xEA1E7E1D, 0xE9587DFA,
+	0xE8927DD5, 0xE7CD7DB0, 0xE7077D89, 0xE6427D62, 0xE57E7D39, 0xE4B97D0E,
+	0xE3F57CE3, 0xE3317CB6, 0xE26D7C88, 0xE1A97C59, 0xE0E67C29, 0xE0237BF8,
+	0xDF617BC5, 0xDE9F7B91, 0xDDDD7B5C, 0xDD1B7B26, 0xDC5A7AEE, 0xDB997AB6,
+	0xDAD87A7C, 0xDA187A41, 0xD9587A05, 0xD89979C8, 0xD7DA7989, 0xD71B794A,
+	0xD65D7909, 0xD59F78C7, 0xD4E17884, 0xD424783F, 0xD36777FA, 0xD2AB77B3,
+	0xD1EF776B, 0xD1347722, 0xD07976D8, 0xCFBF768D, 0xCF057641, 0xCE4B75F3,
+	0xCD9275A5, 0xCCDA7555, 0xCC217504, 0xCB6A74B2, 0xCAB3745F, 0xC9FC740A,
+	0xC94673B5, 0xC891735E, 0xC7DC7307, 0xC72772AE, 0xC6747254, 0xC5C071F9,
+	0xC50E719D, 0xC45B7140, 0xC3AA70E2, 0xC2F97083, 0xC2487022, 0xC1986FC1,
+	0xC0E96F5E, 0xC03B6EFB, 0xBF8D6E96, 0xBEDF6E30, 0xBE326DC9, 0xBD866D61,
+	0xBCDB6CF8, 0xBC306C8E, 0xBB866C23, 0xBADC6BB7, 0xBA336B4A, 0xB98B6ADC,
+	0xB8E46A6D, 0xB83D69FD, 0xB797698B, 0xB6F16919, 0xB64C68A6, 0xB5A86832,
+	0xB50567BC, 0xB4636746, 0xB3C166CF, 0xB3206656, 0xB27F65DD, 0xB1E06563,
+	0xB14164E8, 0xB0A3646C, 0xB00563EE, 0xAF696370, 0xAECD62F1, 0xAE326271,
+	0xAD9861F0, 0xACFE616E, 0xAC6560EB, 0xABCE6068, 0xAB375FE3, 0xAAA05F5D,
+	0xAA0B5ED7, 0xA9765E4F, 0xA8E35DC7, 0xA8505D3E, 0xA7BE5CB3, 0xA72D5C28,
+	0xA69C5B9C, 0xA60D5B0F, 0xA57E5A82, 0xA4F159F3, 0xA4645964, 0xA3D858D3,
+	0xA34D5842, 0xA2C257B0, 0xA239571D, 0xA1B1568A, 0xA12955F5, 0xA0A35560,
+	0xA01D54C9, 0x9F985432, 0x9F15539B, 0x9E925302, 0x9E105268, 0x9D8F51CE,
+	0x9D0F5133, 0x9C905097, 0x9C124FFB, 0x9B944F5D, 0x9B184EBF, 0x9A9D4E20,
+	0x9A234D81, 0x99AA4CE0, 0x99314C3F, 0x98BA4B9D, 0x98444AFB, 0x97CE4A58,
+	0x975A49B4, 0x96E7490F, 0x96754869, 0x960347C3, 0x9593471C, 0x95244675,
+	0x94B645CD, 0x94494524, 0x93DD447A, 0x937243D0, 0x93084325, 0x929F427A,
+	0x923741CE, 0x91D04121, 0x916A4073, 0x91053FC5, 0x90A23F17, 0x903F3E68,
+	0x8FDE3DB8, 0x8F7D3D07, 0x8F1E3C56, 0x8EC03BA5, 0x8E633AF2, 0x8E073A40,
+	0x8DAC398C, 0x8D5238D9, 0x8CF93824, 0x8CA2376F, 0x8C4B36BA, 0x8BF63604,
+	0x8BA1354D, 0x8B4E3496, 0x8AFC33DF, 0x8AAB3326, 0x8A5B326E, 0x8A0D31B5,
+	0x89BF30FB, 0x89733041, 0x89282F87, 0x88DE2ECC, 0x88952E11, 0x884D2D55,
+	0x88062C99, 0x87C12BDC, 0x877C2B1F, 0x87392A61, 0x86F729A3, 0x86B628E5,
+	0x86772826, 0x86382767, 0x85FB26A8, 0x85BF25E8, 0x85842528, 0x854A2467,
+	0x851223A6, 0x84DA22E5, 0x84A42223, 0x846F2161, 0x843B209F, 0x84081FDD,
+	0x83D71F1A, 0x83A71E57, 0x83781D93, 0x834A1CCF, 0x831D1C0B, 0x82F21B47,
+	0x82C71A82, 0x829E19BE, 0x827718F9, 0x82501833, 0x822B176E, 0x820616A8,
+	0x81E315E2, 0x81C2151C, 0x81A11455, 0x8182138F, 0x816412C8, 0x81471201,
+	0x812B113A, 0x81111072, 0x80F70FAB, 0x80DF0EE3, 0x80C90E1C, 0x80B30D54,
+	0x809F0C8C, 0x808C0BC4, 0x807A0AFB, 0x80690A33, 0x805A096A, 0x804C08A2,
+	0x803F07D9, 0x80330711, 0x80280648, 0x801F057F, 0x801704B6, 0x801003ED,
+	0x800B0324, 0x8007025B, 0x80030192, 0x800200C9, 0x80010000, 0x8002FF37,
+	0x8003FE6E, 0x8007FDA5, 0x800BFCDC, 0x8010FC13, 0x8017FB4A, 0x801FFA81,
+	0x8028F9B8, 0x8033F8EF, 0x803FF827, 0x804CF75E, 0x805AF696, 0x8069F5CD,
+	0x807AF505, 0x808CF43C, 0x809FF374, 0x80B3F2AC, 0x80C9F1E4, 0x80DFF11D,
+	0x80F7F055, 0x8111EF8E, 0x812BEEC6, 0x8147EDFF, 0x8164ED38, 0x8182EC71,
+	0x81A1EBAB, 0x81C2EAE4, 0x81E3EA1E, 0x8206E958, 0x822BE892, 0x8250E7CD,
+	0x8277E707, 0x829EE642, 0x82C7E57E, 0x82F2E4B9, 0x831DE3F5, 0x834AE331,
+	0x8378E26D, 0x83A7E1A9, 0x83D7E0E6, 0x8408E023, 0x843BDF61, 0x846FDE9F,
+	0x84A4DDDD, 0x84DADD1B, 0x8512DC5A, 0x854ADB99, 0x8584DAD8, 0x85BFDA18,
+	0x85FBD958, 0x8638D899, 0x8677D7DA, 0x86B6D71B, 0x86F7D65D, 0x8739D59F,
+	0x877CD4E1, 0x87C1D424, 0x8806D367, 0x884DD2AB, 0x8895D1EF, 0x88DED134,
+	0x8928D079, 0x8973CFBF, 0x89BFCF05, 0x8A0DCE4B, 0x8A5BCD92, 0x8AABCCDA,
+	0x8AFCCC21, 0x8B4ECB6A, 0x8BA1CAB3, 0x8BF6C9FC, 0x8C4BC946, 0x8CA2C891,
+	0x8CF9C7DC, 0x8D52C727, 0x8DACC674, 0x8E07C5C0, 0x8E63C50E, 0x8EC0C45B,
+	0x8F1EC3AA, 0x8F7DC2F9, 0x8FDEC248, 0x903FC198, 0x90A2C0E9, 0x9105C03B,
+	0x916ABF8D, 0x91D0BEDF, 0x9237BE32, 0x929FBD86, 0x9308BCDB, 0x9372BC30,
+	0x93DDBB86, 0x9449BADC, 0x94B6BA33, 0x9524B98B, 0x9593B8E4, 0x9603B83D,
+	0x9675B797, 0x96E7B6F1, 0x975AB64C, 0x97CEB5A8, 0x9844B505, 0x98BAB463,
+	0x9931B3C1, 0x99AAB320, 0x9A23B27F, 0x9A9DB1E0, 0x9B18B141, 0x9B94B0A3,
+	0x9C12B005, 0x9C90AF69, 0x9D0FAECD, 0x9D8FAE32, 0x9E10AD98, 0x9E92ACFE,
+	0x9F15AC65, 0x9F98ABCE, 0xA01DAB37, 0xA0A3AAA0, 0xA129AA0B, 0xA1B1A976,
+	0xA239A8E3, 0xA2C2A850, 0xA34DA7BE, 0xA3D8A72D, 0xA464A69C, 0xA4F1A60D,
+	0xA57EA57E, 0xA60DA4F1, 0xA69CA464, 0xA72DA3D8, 0xA7BEA34D, 0xA850A2C2,
+	0xA8E3A239, 0xA976A1B1, 0xAA0BA129, 0xAAA0A0A3, 0xAB37A01D, 0xABCE9F98,
+	0xAC659F15, 0xACFE9E92, 0xAD989E10, 0xAE329D8F, 0xAECD9D0F, 0xAF699C90,
+	0xB0059C12, 0xB0A39B94, 0xB1419B18, 0xB1E09A9D, 0xB27F9A23, 0xB32099AA,
+	0xB3C19931, 0xB46398BA, 0xB5059844, 0xB5A897CE, 0xB64C975A, 0xB6F196E7,
+	0xB7979675, 0xB83D9603, 0xB8E49593, 0xB98B9524, 0xBA3394B6, 0xBADC9449,
+	0xBB8693DD, 0xBC309372, 0xBCDB9308, 0xBD86929F, 0xBE329237, 0xBEDF91D0,
+	0xBF8D916A, 0xC03B9105, 0xC0E990A2, 0xC198903F, 0xC2488FDE, 0xC2F98F7D,
+	0xC3AA8F1E, 0xC45B8EC0, 0xC50E8E63, 0xC5C08E07, 0xC6748DAC, 0xC7278D52,
+	0xC7DC8CF9, 0xC8918CA2, 0xC9468C4B, 0xC9FC8BF6, 0xCAB38BA1, 0xCB6A8B4E,
+	0xCC218AFC, 0xCCDA8AAB, 0xCD928A5B, 0xCE4B8A0D, 0xCF0589BF, 0xCFBF8973,
+	0xD0798928, 0xD13488DE, 0xD1EF8895, 0xD2AB884D, 0xD3678806, 0xD42487C1,
+	0xD4E1877C, 0xD59F8739, 0xD65D86F7, 0xD71B86B6, 0xD7DA8677, 0xD8998638,
+	0xD95885FB, 0xDA1885BF, 0xDAD88584, 0xDB99854A, 0xDC5A8512, 0xDD1B84DA,
+	0xDDDD84A4, 0xDE9F846F, 0xDF61843B, 0xE0238408, 0xE0E683D7, 0xE1A983A7,
+	0xE26D8378, 0xE331834A, 0xE3F5831D, 0xE4B982F2, 0xE57E82C7, 0xE642829E,
+	0xE7078277, 0xE7CD8250, 0xE892822B, 0xE9588206, 0xEA1E81E3, 0xEAE481C2,
+	0xEBAB81A1, 0xEC718182, 0xED388164, 0xEDFF8147, 0xEEC6812B, 0xEF8E8111,
+	0xF05580F7, 0xF11D80DF, 0xF1E480C9, 0xF2AC80B3, 0xF374809F, 0xF43C808C,
+	0xF505807A, 0xF5CD8069, 0xF696805A, 0xF75E804C, 0xF827803F, 0xF8EF8033,
+	0xF9B88028, 0xFA81801F, 0xFB4A8017, 0xFC138010, 0xFCDC800B, 0xFDA58007,
+	0xFE6E8003, 0xFF378002
+};
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Saturate a 64-bit value to 16 bits */
+STATIC INLINE int16_t dspSat16(int64_t v)
+{
+	if (v > 32767) {
+		return 32767;
+	}
+	else if (v < -32768) {
+		return -32768;
+	}
+	return (int16_t) v;
+}
+
+/* Load and store two packed samples. memcpy() keeps this legal C and
+   compiles to a single LDR/STR, which the M4 allows unaligned. */
+STATIC INLINE uint32_t dspRead2(const int16_t *p)
+{
+	uint32_t v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+STATIC INLINE void dspWrite2(int16_t *p, uint32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+/* Single FIR output for the window starting at pState */
+static int16_t firDot(const int16_t *pCoeffs, const int16_t *pState, uint32_t numTaps)
+{
+	uint64_t acc = 0;
+	uint32_t j;
+
+	for (j = 0; j < numTaps; j += 2) {
+		acc = __SMLALD(dspRead2(&pCoeffs[j]), dspRead2(&pState[j]), acc);
+	}
+	return dspSat16((int64_t) acc >> 15);
+}
+
+/* Scalar FIR output for the window starting at pState */
+static int16_t firDotRef(const int16_t *pCoeffs, const int16_t *pState, uint32_t numTaps)
+{
+	int64_t acc = 0;
+	uint32_t j;
+
+	for (j = 0; j < numTaps; j++) {
+		acc += (int32_t) pCoeffs[j] * pState[j];
+	}
+	return dspSat16(acc >> 15);
+}
+
+/* Append a block to the FIR history */
+static int16_t *firLoad(DSP_FIR_Q15_T *pFIR, const int16_t *pSrc, uint32_t blockSize)
+{
+	memcpy(&pFIR->pState[pFIR->numTaps - 1], pSrc, blockSize * sizeof(int16_t));
+	return pFIR->pState;
+}
+
+/* Keep the last numTaps - 1 samples as history for the next block */
+static void firShift(DSP_FIR_Q15_T *pFIR, uint32_t blockSize)
+{
+	memmove(pFIR->pState, &pFIR->pState[blockSize], (pFIR->numTaps - 1) * sizeof(int16_t));
+}
+
+/* Integer square root */
+static uint32_t dspSqrt(uint64_t v)
+{
+	uint64_t bit = (uint64_t) 1 << 62;
+	uint64_t r = 0;
+
+	while (bit > v) {
+		bit >>= 2;
+	}
+	while (bit != 0) {
+		if (v >= r + bit) {
+			v -= r + bit;
+			r = (r >> 1) + bit;
+		}
+		else {
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return (uint32_t) r;
+}
+
+/* Final level computation shared by both versions */
+static void levelResult(uint64_t sumSq, uint32_t peak, uint32_t len, DSP_LEVEL_T *pLevel)
+{
+	uint32_t rms = 0;
+
+	if (len > 0) {
+		rms = dspSqrt(sumSq / len);
+	}
+	pLevel->rms = (int16_t) ((rms > 32767) ? 32767 : rms);
+	pLevel->peak = (int16_t) ((peak > 32767) ? 32767 : peak);
+}
+
+/* Swap the real and imaginary parts of every sample */
+static void fftSwap(int16_t *pData, uint32_t n)
+{
+	uint32_t i, v;
+
+	for (i = 0; i < n; i++) {
+		v = dspRead2(&pData[2 * i]);
+		dspWrite2(&pData[2 * i], (v << 16) | (v >> 16));
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize a FIR filter */
+void DSP_FIR_Q15_Init(DSP_FIR_Q15_T *pFIR, uint16_t numTaps, const int16_t *pCoeffs, int16_t *pState)
+{
+	pFIR->pCoeffs = pCoeffs;
+	pFIR->pState = pState;
+	pFIR->numTaps = numTaps;
+	memset(pState, 0, (numTaps - 1) * sizeof(int16_t));
+}
+
+/* Run a block of samples through a FIR filter */
+void DSP_FIR_Q15(DSP_FIR_Q15_T *pFIR, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	const int16_t *pCoeffs = pFIR->pCoeffs;
+	const int16_t *pState = firLoad(pFIR, pSrc, blockSize);
+	uint32_t numTaps = pFIR->numTaps;
+	uint32_t n, j, c, x0, x1;
+	uint64_t acc0, acc1;
+
+	/* Two outputs per pass. Each coefficient pair is applied to the window
+	   of output n directly and, with the halves crossed, to the window of
+	   output n + 1, so every load is shared by both outputs. */
+	for (n = 0; (n + 1) < blockSize; n += 2) {
+		acc0 = 0;
+		acc1 = 0;
+		x0 = dspRead2(&pState[n]);
+		for (j = 0; (j + 2) < numTaps; j += 2) {
+			c = dspRead2(&pCoeffs[j]);
+			x1 = dspRead2(&pState[n + j + 2]);
+			acc0 = __SMLALD(c, x0, acc0);
+			acc1 = __SMLALDX(c, __PKHBT(x1, x0, 0), acc1);
+			x0 = x1;
+		}
+
+		/* Last pair: only the newest sample of output n + 1 is left */
+		c = dspRead2(&pCoeffs[j]);
+		x1 = (uint16_t) pState[n + j + 2];
+		acc0 = __SMLALD(c, x0, acc0);
+		acc1 = __SMLALDX(c, __PKHBT(x1, x0, 0), acc1);
+		pDst[n] = dspSat16((int64_t) acc0 >> 15);
+		pDst[n + 1] = dspSat16((int64_t) acc1 >> 15);
+	}
+	if (n < blockSize) {
+		pDst[n] = firDot(pCoeffs, &pState[n], numTaps);
+	}
+
+	firShift(pFIR, blockSize);
+}
+
+/* Scalar reference FIR filter */
+void DSP_FIR_Q15_Ref(DSP_FIR_Q15_T *pFIR, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	const int16_t *pState = firLoad(pFIR, pSrc, blockSize);
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n++) {
+		pDst[n] = firDotRef(pFIR->pCoeffs, &pState[n], pFIR->numTaps);
+	}
+
+	firShift(pFIR, blockSize);
+}
+
+/* Initialize a FIR decimator */
+void DSP_Decimate_Q15_Init(DSP_DECIM_Q15_T *pDecim, uint8_t factor, uint16_t numTaps,
+						   const int16_t *pCoeffs, int16_t *pState)
+{
+	DSP_FIR_Q15_Init(&pDecim->fir, numTaps, pCoeffs, pState);
+	pDecim->factor = factor;
+}
+
+/* Filter and decimate a block of samples */
+void DSP_Decimate_Q15(DSP_DECIM_Q15_T *pDecim, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	DSP_FIR_Q15_T *pFIR = &pDecim->fir;
+	const int16_t *pState = firLoad(pFIR, pSrc, blockSize);
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n += pDecim->factor) {
+		*pDst++ = firDot(pFIR->pCoeffs, &pState[n], pFIR->numTaps);
+	}
+
+	firShift(pFIR, blockSize);
+}
+
+/* Scalar reference FIR decimator */
+void DSP_Decimate_Q15_Ref(DSP_DECIM_Q15_T *pDecim, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	DSP_FIR_Q15_T *pFIR = &pDecim->fir;
+	const int16_t *pState = firLoad(pFIR, pSrc, blockSize);
+	uint32_t n;
+
+	for (n = 0; n < blockSize; n += pDecim->factor) {
+		*pDst++ = firDotRef(pFIR->pCoeffs, &pState[n], pFIR->numTaps);
+	}
+
+	firShift(pFIR, blockSize);
+}
+
+/* Initialize a biquad cascade */
+void DSP_Biquad_Q15_Init(DSP_BIQUAD_Q15_T *pBQ, uint8_t numStages, const int16_t *pCoeffs,
+						 int16_t *pState, uint8_t postShift)
+{
+	pBQ->pCoeffs = pCoeffs;
+	pBQ->pState = pState;
+	pBQ->numStages = numStages;
+	pBQ->postShift = postShift;
+	memset(pState, 0, 4 * numStages * sizeof(int16_t));
+}
+
+/* Run a block of samples through a biquad cascade */
+void DSP_Biquad_Q15(DSP_BIQUAD_Q15_T *pBQ, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	const int16_t *pCoeffs = pBQ->pCoeffs;
+	int16_t *pState = pBQ->pState;
+	uint32_t shift = 15 - pBQ->postShift;
+	uint32_t stage, n, b12, a12, xs, ys;
+	int32_t b0, x, y;
+	uint64_t acc;
+
+	for (stage = 0; stage < pBQ->numStages; stage++) {
+		b0 = pCoeffs[0];
+		b12 = dspRead2(&pCoeffs[2]);
+		a12 = dspRead2(&pCoeffs[4]);
+		xs = dspRead2(&pState[0]);
+		ys = dspRead2(&pState[2]);
+
+		/* Delay lines stay packed; each new sample is pushed into the low
+		   half with one PKHBT */
+		for (n = 0; n < blockSize; n++) {
+			x = pSrc[n];
+			acc = (uint64_t) ((int64_t) b0 * x);
+			acc = __SMLALD(b12, xs, acc);
+			acc = __SMLALD(a12, ys, acc);
+			y = dspSat16((int64_t) acc >> shift);
+			xs = __PKHBT(x, xs, 16);
+			ys = __PKHBT(y, ys, 16);
+			pDst[n] = (int16_t) y;
+		}
+
+		dspWrite2(&pState[0], xs);
+		dspWrite2(&pState[2], ys);
+		pCoeffs += 6;
+		pState += 4;
+		pSrc = pDst;
+	}
+}
+
+/* Scalar reference biquad cascade */
+void DSP_Biquad_Q15_Ref(DSP_BIQUAD_Q15_T *pBQ, const int16_t *pSrc, int16_t *pDst, uint32_t blockSize)
+{
+	const int16_t *pCoeffs = pBQ->pCoeffs;
+	int16_t *pState = pBQ->pState;
+	uint32_t stage, n;
+	int16_t x, y;
+	int64_t acc;
+
+	for (stage = 0; stage < pBQ->numStages; stage++) {
+		for (n = 0; n < blockSize; n++) {
+			x = pSrc[n];
+			acc = (int64_t) pCoeffs[0] * x;
+			acc += (int64_t) pCoeffs[2] * pState[0];
+			acc += (int64_t) pCoeffs[3] * pState[1];
+			acc += (int64_t) pCoeffs[4] * pState[2];
+			acc += (int64_t) pCoeffs[5] * pState[3];
+			y = dspSat16(acc >> (15 - pBQ->postShift));
+			pState[1] = pState[0];
+			pState[0] = x;
+			pState[3] = pState[2];
+			pState[2] = y;
+			pDst[n] = y;
+		}
+
+		pCoeffs += 6;
+		pState += 4;
+		pSrc = pDst;
+	}
+}
+
+/* Measure the RMS and peak level of a block of samples */
+void DSP_Level_Q15(const int16_t *pSrc, uint32_t len, DSP_LEVEL_T *pLevel)
+{
+	uint64_t sumSq = 0;
+	uint32_t peak = 0;
+	uint32_t n, v;
+	int32_t lo, hi;
+
+	for (n = 0; n < len; n += 2) {
+		v = dspRead2(&pSrc[n]);
+		sumSq = __SMLALD(v, v, sumSq);
+		lo = (int16_t) v;
+		hi = (int32_t) v >> 16;
+		lo = (lo < 0) ? -lo : lo;
+		hi = (hi < 0) ? -hi : hi;
+		if ((uint32_t) lo > peak) {
+			peak = lo;
+		}
+		if ((uint32_t) hi > peak) {
+			peak = hi;
+		}
+	}
+
+	levelResult(sumSq, peak, len, pLevel);
+}
+
+/* Scalar reference level measurement */
+void DSP_Level_Q15_Ref(const int16_t *pSrc, uint32_t len, DSP_LEVEL_T *pLevel)
+{
+	uint64_t sumSq = 0;
+	uint32_t peak = 0;
+	uint32_t n;
+	int32_t x;
+
+	for (n = 0; n < len; n++) {
+		x = pSrc[n];
+		sumSq += (uint64_t) (x * x);
+		x = (x < 0) ? -x : x;
+		if ((uint32_t) x > peak) {
+			peak = x;
+		}
+	}
+
+	levelResult(sumSq, peak, len, pLevel);
+}
+
+/* In-place complex radix-2 FFT */
+void DSP_FFT_Q15(int16_t *pData, uint32_t n, bool inverse)
+{
+	uint32_t bits = 31 - __CLZ(n);
+	uint32_t i, j, k, len, half, step, a, b, w, h, t;
+	int32_t tr, ti;
+
+	/* The inverse transform is the forward one with re and im swapped on
+	   the way in and out */
+	if (inverse) {
+		fftSwap(pData, n);
+	}
+
+	for (i = 0; i < n; i++) {
+		j = __RBIT(i) >> (32 - bits);
+		if (i < j) {
+			a = dspRead2(&pData[2 * i]);
+			dspWrite2(&pData[2 * i], dspRead2(&pData[2 * j]));
+			dspWrite2(&pData[2 * j], a);
+		}
+	}
+
+	/* Each butterfly halves its outputs: a/2 comes from SHADD16 and the
+	   twiddled b/2 from shifting the SMUSD/SMUADX products by 16 */
+	for (len = 2; len <= n; len <<= 1) {
+		half = len >> 1;
+		step = DSP_FFT_MAX_LEN / len;
+		for (k = 0; k < half; k++) {
+			w = fftTwiddle[k * step];
+			for (i = k; i < n; i += len) {
+				a = dspRead2(&pData[2 * i]);
+				b = dspRead2(&pData[2 * (i + half)]);
+				h = __SHADD16(a, 0);
+				tr = (int32_t) __SMUSD(b, w) >> 16;
+				ti = (int32_t) __SMUADX(b, w) >> 16;
+				t = __PKHBT(tr, ti, 16);
+				dspWrite2(&pData[2 * i], __QADD16(h, t));
+				dspWrite2(&pData[2 * (i + half)], __QSUB16(h, t));
+			}
+		}
+	}
+
+	if (inverse) {
+		fftSwap(pData, n);
+	}
+}
+
+/* Scalar reference FFT */
+void DSP_FFT_Q15_Ref(int16_t *pData, uint32_t n, bool inverse)
+{
+	uint32_t i, j, k, m, len, half, step;
+	int32_t c, s, br, bi, tr, ti, hr, hi;
+	int16_t tmp;
+
+	if (inverse) {
+		for (i = 0; i < n; i++) {
+			tmp = pData[2 * i];
+			pData[2 * i] = pData[2 * i + 1];
+			pData[2 * i + 1] = tmp;
+		}
+	}
+
+	for (i = 0, j = 0; i < n; i++) {
+		if (i < j) {
+			tmp = pData[2 * i];
+			pData[2 * i] = pData[2 * j];
+			pData[2 * j] = tmp;
+			tmp = pData[2 * i + 1];
+			pData[2 * i + 1] = pData[2 * j + 1];
+			pData[2 * j + 1] = tmp;
+		}
+		m = n >> 1;
+		while ((m != 0) && ((j & m) != 0)) {
+			j ^= m;
+			m >>= 1;
+		}
+		j |= m;
+	}
+
+	for (len = 2; len <= n; len <<= 1) {
+		half = len >> 1;
+		step = DSP_FFT_MAX_LEN / len;
+		for (k = 0; k < half; k++) {
+			c = (int16_t) (fftTwiddle[k * step] & 0xFFFF);
+			s = (int16_t) (fftTwiddle[k * step] >> 16);
+			for (i = k; i < n; i += len) {
+				j = i + half;
+				hr = pData[2 * i] >> 1;
+				hi = pData[2 * i + 1] >> 1;
+				br = pData[2 * j];
+				bi = pData[2 * j + 1];
+				tr = (br * c - bi * s) >> 16;
+				ti = (br * s + bi * c) >> 16;
+				pData[2 * i] = dspSat16(hr + tr);
+				pData[2 * i + 1] = dspSat16(hi + ti);
+				pData[2 * j] = dspSat16(hr - tr);
+				pData[2 * j + 1] = dspSat16(hi - ti);
+			}
+		}
+	}
+
+	if (inverse) {
+		for (i = 0; i < n; i++) {
+			tmp = pData[2 * i];
+			pData[2 * i] = pData[2 * i + 1];
+			pData[2 * i + 1] = tmp;
+		}
+	}
+}
@@ -0,0 +1,411 @@
+/*
+ * @brief LPC18xx/43xx EEPROM key-value store
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Page layout: sequence number, magic and CRC of the records, records.
+   A record is a word holding the key and the value length, followed by
+   the value padded to words. A zero length deletes the key. */
+#define EEKV_PAGE_WORDS     (EEPROM_PAGE_SIZE / 4)
+#define EEKV_HDR_WORDS      2
+#define EEKV_DATA_WORDS     (EEKV_PAGE_WORDS - EEKV_HDR_WORDS)
+#define EEKV_PAGE_MAGIC     0x4B560000
+#define EEKV_PAGE_BUFFER    0xFF
+
+#define EEKV_REC(key, len)  ((key) | ((len) << 16))
+#define EEKV_REC_KEY(rec)   ((rec) & 0xFFFF)
+#define EEKV_REC_LEN(rec)   (((rec) >> 16) & 0xFF)
+#define EEKV_REC_WORDS(len) (1 + (((len) + 3) >> 2))
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Address of a page of the log */
+STATIC INLINE const uint32_t *eekvPage(EEKV_HANDLE_T *pHandle, uint32_t page)
+{
+	return (const uint32_t *) EEPROM_ADDRESS(pHandle->cfg.firstPage + page, 0);
+}
+
+/* Address of the record of an index entry */
+STATIC INLINE const uint32_t *eekvRecord(EEKV_HANDLE_T *pHandle, const EEKV_INDEX_T *pEntry)
+{
+	if (pEntry->page == EEKV_PAGE_BUFFER) {
+		return &pHandle->buf[pEntry->word];
+	}
+	return eekvPage(pHandle, pEntry->page) + pEntry->word;
+}
+
+/* CRC-16/CCITT of the records of a page */
+STATIC uint32_t eekvCRC(const uint32_t *page)
+{
+	const uint8_t *p = (const uint8_t *) &page[EEKV_HDR_WORDS];
+	uint32_t crc = 0xFFFF;
+	uint32_t i, b;
+
+	for (i = 0; i < EEKV_DATA_WORDS * 4; i++) {
+		crc ^= p[i] << 8;
+		for (b = 0; b < 8; b++) {
+			crc = (crc & 0x8000) ? ((crc << 1) ^ 0x1021) : (crc << 1);
+		}
+	}
+	return crc & 0xFFFF;
+}
+
+/* Position of a key in the sorted index, or of the entry to insert it before */
+STATIC uint32_t eekvFind(EEKV_HANDLE_T *pHandle, uint16_t key)
+{
+	const EEKV_INDEX_T *index = pHandle->cfg.index;
+	uint32_t lo = 0, hi = pHandle->numKeys, mid;
+
+	while (lo < hi) {
+		mid = (lo + hi) >> 1;
+		if (index[mid].key < key) {
+			lo = mid + 1;
+		}
+		else {
+			hi = mid;
+		}
+	}
+	return lo;
+}
+
+STATIC INLINE bool eekvFound(EEKV_HANDLE_T *pHandle, uint32_t pos, uint16_t key)
+{
+	return (pos < pHandle->numKeys) && (pHandle->cfg.index[pos].key == key);
+}
+
+/* Point a key to a record, adding it to the index if needed */
+STATIC Status eekvIndexSet(EEKV_HANDLE_T *pHandle, uint16_t key, uint32_t page, uint32_t word, uint32_t words)
+{
+	EEKV_INDEX_T *index = pHandle->cfg.index;
+	uint32_t pos = eekvFind(pHandle, key);
+
+	if (eekvFound(pHandle, pos, key)) {
+		pHandle->liveWords -= EEKV_REC_WORDS(EEKV_REC_LEN(*eekvRecord(pHandle, &index[pos])));
+	}
+	else {
+		if (pHandle->numKeys >= pHandle->cfg.indexSize) {
+			return ERROR;
+		}
+		memmove(&index[pos + 1], &index[pos], (pHandle->numKeys - pos) * sizeof(EEKV_INDEX_T));
+		pHandle->numKeys++;
+		index[pos].key = key;
+	}
+	index[pos].page = page;
+	index[pos].word = word;
+	pHandle->liveWords += words;
+	return SUCCESS;
+}
+
+/* Remove a key from the index */
+STATIC void eekvIndexRemove(EEKV_HANDLE_T *pHandle, uint16_t key)
+{
+	EEKV_INDEX_T *index = pHandle->cfg.index;
+	uint32_t pos = eekvFind(pHandle, key);
+
+	if (eekvFound(pHandle, pos, key)) {
+		pHandle->liveWords -= EEKV_REC_WORDS(EEKV_REC_LEN(*eekvRecord(pHandle, &index[pos])));
+		pHandle->numKeys--;
+		memmove(&index[pos], &index[pos + 1], (pHandle->numKeys - pos) * sizeof(EEKV_INDEX_T));
+	}
+}
+
+/* Start the image of the head page with the records still current in the
+   following page, which the next program may erase */
+STATIC void eekvStartImage(EEKV_HANDLE_T *pHandle)
+{
+	EEKV_INDEX_T *index = pHandle->cfg.index;
+	uint32_t next = (pHandle->head + 1) % pHandle->cfg.numPages;
+	const uint32_t *rec;
+	uint32_t i, words;
+
+	memset(pHandle->buf, 0xFF, sizeof(pHandle->buf));
+	pHandle->bufWords = EEKV_HDR_WORDS;
+
+	for (i = 0; i < pHandle->numKeys; i++) {
+		if (index[i].page == next) {
+			rec = eekvPage(pHandle, next) + index[i].word;
+			words = EEKV_REC_WORDS(EEKV_REC_LEN(*rec));
+			memcpy(&pHandle->buf[pHandle->bufWords], rec, words * 4);
+			index[i].page = EEKV_PAGE_BUFFER;
+			index[i].word = pHandle->bufWords;
+			pHandle->bufWords += words;
+			pHandle->stats.carriedBytes += words * 4;
+		}
+	}
+}
+
+/* Program the page image to the head page and start the next one */
+STATIC void eekvProgram(EEKV_HANDLE_T *pHandle)
+{
+	uint32_t *dst = (uint32_t *) EEPROM_ADDRESS(pHandle->cfg.firstPage + pHandle->head, 0);
+	uint32_t i;
+
+	pHandle->buf[0] = pHandle->seq;
+	pHandle->buf[1] = EEKV_PAGE_MAGIC | eekvCRC(pHandle->buf);
+
+	/* The page register takes word writes only */
+	for (i = 0; i < EEKV_PAGE_WORDS; i++) {
+		dst[i] = pHandle->buf[i];
+	}
+	Chip_EEPROM_EraseProgramPage(pHandle->pEEPROM);
+	pHandle->stats.programs++;
+
+	for (i = 0; i < pHandle->numKeys; i++) {
+		if (pHandle->cfg.index[i].page == EEKV_PAGE_BUFFER) {
+			pHandle->cfg.index[i].page = pHandle->head;
+		}
+	}
+
+	pHandle->head = (pHandle->head + 1) % pHandle->cfg.numPages;
+	pHandle->seq++;
+	pHandle->dirty = false;
+	eekvStartImage(pHandle);
+}
+
+/* Append a record to the page image, programming pages to make room */
+STATIC Status eekvAppend(EEKV_HANDLE_T *pHandle, uint16_t key, const void *data, uint32_t len)
+{
+	uint32_t words = EEKV_REC_WORDS(len);
+	uint32_t tries = pHandle->cfg.numPages;
+	uint32_t word;
+
+	while ((pHandle->bufWords + words) > EEKV_PAGE_WORDS) {
+		if (tries-- == 0) {
+			return ERROR;
+		}
+		eekvProgram(pHandle);
+	}
+
+	word = pHandle->bufWords;
+	pHandle->buf[word] = EEKV_REC(key, len);
+	if (len > 0) {
+		memcpy(&pHandle->buf[word + 1], data, len);
+	}
+	pHandle->bufWords += words;
+
+	if (len == 0) {
+		eekvIndexRemove(pHandle, key);
+	}
+	else if (eekvIndexSet(pHandle, key, EEKV_PAGE_BUFFER, word, words) != SUCCESS) {
+		/* Out of index entries, drop the record */
+		pHandle->bufWords = word;
+		memset(&pHandle->buf[word], 0xFF, words * 4);
+		return ERROR;
+	}
+
+	if (!pHandle->dirty) {
+		pHandle->dirty = true;
+		pHandle->dirtySince = pHandle->now;
+	}
+	pHandle->stats.updates++;
+	return SUCCESS;
+}
+
+/* Replay the records of a valid page into the index */
+STATIC Status eekvReplay(EEKV_HANDLE_T *pHandle, uint32_t page)
+{
+	const uint32_t *p = eekvPage(pHandle, page);
+	uint32_t word = EEKV_HDR_WORDS;
+	uint32_t rec, len;
+
+	while (word < EEKV_PAGE_WORDS) {
+		rec = p[word];
+		if (EEKV_REC_KEY(rec) == EEKV_KEY_INVALID) {
+			break;
+		}
+		len = EEKV_REC_LEN(rec);
+		if (len == 0) {
+			eekvIndexRemove(pHandle, EEKV_REC_KEY(rec));
+		}
+		else if (eekvIndexSet(pHandle, EEKV_REC_KEY(rec), page, word, EEKV_REC_WORDS(len)) != SUCCESS) {
+			return ERROR;
+		}
+		word += EEKV_REC_WORDS(len);
+	}
+	return SUCCESS;
+}
+
+/* Check the header and the records of a page */
+STATIC bool eekvPageValid(EEKV_HANDLE_T *pHandle, uint32_t page)
+{
+	const uint32_t *p = eekvPage(pHandle, page);
+
+	return (p[1] & 0xFFFF0000) == EEKV_PAGE_MAGIC && (p[1] & 0xFFFF) == eekvCRC(p);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Mount the store, building the index from the EEPROM pages */
+Status Chip_EEKV_Init(EEKV_HANDLE_T *pHandle, LPC_EEPROM_T *pEEPROM, const EEKV_CFG_T *pCfg)
+{
+	uint32_t newest = 0, i, page;
+	bool found = false;
+
+	if ((pCfg->numPages < 3) || (pCfg->numPages > EEKV_PAGE_BUFFER) ||
+		((pCfg->firstPage + pCfg->numPages) > (EEPROM_PAGE_NUM - 1)) ||
+		(pCfg->index == NULL) || (pCfg->indexSize == 0)) {
+		return ERROR;
+	}
+
+	pHandle->pEEPROM = pEEPROM;
+	pHandle->cfg = *pCfg;
+	pHandle->numKeys = 0;
+	pHandle->liveWords = 0;
+	pHandle->dirty = false;
+	pHandle->now = 0;
+	memset(&pHandle->stats, 0, sizeof(pHandle->stats));
+	Chip_EEPROM_SetAutoProg(pEEPROM, EEPROM_AUTOPROG_OFF);
+
+	/* The newest page has the highest sequence number */
+	for (i = 0; i < pCfg->numPages; i++) {
+		if (eekvPageValid(pHandle, i)) {
+			if (!found || ((int32_t) (eekvPage(pHandle, i)[0] - eekvPage(pHandle, newest)[0]) > 0)) {
+				newest = i;
+			}
+			found = true;
+		}
+	}
+
+	/* Replay from the oldest page, invalid pages were never written or
+	   were being programmed at a power loss */
+	if (found) {
+		for (i = 1; i <= pCfg->numPages; i++) {
+			page = (newest + i) % pCfg->numPages;
+			if (eekvPageValid(pHandle, page) && (eekvReplay(pHandle, page) != SUCCESS)) {
+				return ERROR;
+			}
+		}
+		pHandle->head = (newest + 1) % pCfg->numPages;
+		pHandle->seq = eekvPage(pHandle, newest)[0] + 1;
+	}
+	else {
+		pHandle->head = 0;
+		pHandle->seq = 1;
+	}
+
+	eekvStartImage(pHandle);
+	return SUCCESS;
+}
+
+/* Set the value of a key */
+Status Chip_EEKV_Set(EEKV_HANDLE_T *pHandle, uint16_t key, const void *data, uint32_t len)
+{
+	EEKV_INDEX_T *pEntry;
+	uint32_t pos, oldWords = 0;
+
+	if ((key == EEKV_KEY_INVALID) || (len == 0) || (len > EEKV_MAX_VALUE)) {
+		return ERROR;
+	}
+
+	pos = eekvFind(pHandle, key);
+	if (eekvFound(pHandle, pos, key)) {
+		pEntry = &pHandle->cfg.index[pos];
+
+		/* A buffered value of the same length is replaced in place */
+		if ((pEntry->page == EEKV_PAGE_BUFFER) && (EEKV_REC_LEN(pHandle->buf[pEntry->word]) == len)) {
+			memcpy(&pHandle->buf[pEntry->word + 1], data, len);
+			if (!pHandle->dirty) {
+				pHandle->dirty = true;
+				pHandle->dirtySince = pHandle->now;
+			}
+			pHandle->stats.updates++;
+			pHandle->stats.coalesced++;
+			return SUCCESS;
+		}
+		oldWords = EEKV_REC_WORDS(EEKV_REC_LEN(*eekvRecord(pHandle, pEntry)));
+	}
+
+	/* Keep a page of slack so that programming pages always frees space */
+	if ((pHandle->liveWords - oldWords + EEKV_REC_WORDS(len)) > ((pHandle->cfg.numPages - 2) * EEKV_DATA_WORDS)) {
+		return ERROR;
+	}
+
+	return eekvAppend(pHandle, key, data, len);
+}
+
+/* Read the value of a key */
+uint32_t Chip_EEKV_Get(EEKV_HANDLE_T *pHandle, uint16_t key, void *data, uint32_t maxLen)
+{
+	const uint32_t *rec;
+	uint32_t pos, len;
+
+	pHandle->stats.lookups++;
+	pos = eekvFind(pHandle, key);
+	if (!eekvFound(pHandle, pos, key)) {
+		return 0;
+	}
+
+	rec = eekvRecord(pHandle, &pHandle->cfg.index[pos]);
+	len = EEKV_REC_LEN(*rec);
+	memcpy(data, rec + 1, (len < maxLen) ? len : maxLen);
+	return len;
+}
+
+/* Delete a key */
+Status Chip_EEKV_Delete(EEKV_HANDLE_T *pHandle, uint16_t key)
+{
+	if (!eekvFound(pHandle, eekvFind(pHandle, key), key)) {
+		return ERROR;
+	}
+
+	/* Older records of the key stay in the log until their page is reused */
+	return eekvAppend(pHandle, key, NULL, 0);
+}
+
+/* Program the buffered updates now */
+void Chip_EEKV_Flush(EEKV_HANDLE_T *pHandle)
+{
+	if (pHandle->dirty) {
+		eekvProgram(pHandle);
+	}
+}
+
+/* Program the buffered updates once the flush delay expired */
+void Chip_EEKV_Poll(EEKV_HANDLE_T *pHandle, uint32_t nowMs)
+{
+	pHandle->now = nowMs;
+	if (pHandle->dirty && ((nowMs - pHandle->dirtySince) >= pHandle->cfg.flushMs)) {
+		eekvProgram(pHandle);
+	}
+}
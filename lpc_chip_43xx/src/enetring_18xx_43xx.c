@@ -0,0 +1,428 @@
+/*
+ * @brief LPC18xx/43xx zero-copy Ethernet descriptor ring driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Interrupts always enabled, the receive interrupt is added when armed */
+#define ENETRING_INT_BASE   (DMA_IE_NIE | DMA_IE_AIE | DMA_IE_TIE | DMA_IE_FBE)
+
+static LPC_ENET_T *ringDev;
+static ENETRING_CFG_T ringCfg;
+static ENETRING_STATS_T ringStats;
+static bool ringLinkUp;
+
+/* Transmit ring, descriptors between txTail and txHead belong to the DMA */
+static uint32_t txHead, txTail, txUsed;
+static uint32_t txFrameEnd;
+static ENETRING_TXCALLBACK_T txCb[ENETRING_MAX_DESCS];
+static void *txCbData[ENETRING_MAX_DESCS];
+
+/* Receive ring, descriptors handed out are flagged in rxHeld */
+static uint32_t rxHead;
+static uint32_t rxHeld;
+static volatile bool rxIntOn;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t ringEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void ringExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+STATIC INLINE uint32_t ringNext(uint32_t idx, uint32_t num)
+{
+	idx++;
+	return (idx == num) ? 0 : idx;
+}
+
+/* Give a receive descriptor and its buffer back to the DMA */
+STATIC void rxArm(uint32_t idx)
+{
+	ENET_ENHRXDESC_T *pDesc = &ringCfg.rxDescs[idx];
+	uint32_t ctrl = RDES_ENH_BS1(ENETRING_RX_BUFSIZE);
+
+	if (idx == (ringCfg.numRx - 1)) {
+		ctrl |= RDES_ENH_RER;
+	}
+	pDesc->CTRL = ctrl;
+
+	/* The buffer must be set up before the DMA may see the descriptor */
+	__DMB();
+	pDesc->STATUS = RDES_OWN;
+}
+
+/* A frame is waiting at the head of the receive ring */
+STATIC INLINE bool rxPending(void)
+{
+	return ((rxHeld & (1UL << rxHead)) == 0) &&
+		   ((ringCfg.rxDescs[rxHead].STATUS & RDES_OWN) == 0);
+}
+
+/* Complete sent frames, or with abort all frames, the DMA must be stopped */
+STATIC uint32_t txReclaim(bool abort)
+{
+	ENETRING_TXCALLBACK_T cb;
+	void *cbData;
+	uint32_t idx, ctrl, primask, frames = 0;
+	bool end, aborted;
+
+	while (1) {
+		primask = ringEnterCritical();
+		idx = txTail;
+		ctrl = ringCfg.txDescs[idx].CTRLSTAT;
+		aborted = (ctrl & TDES_OWN) != 0;
+		if ((txUsed == 0) || (aborted && !abort)) {
+			ringExitCritical(primask);
+			break;
+		}
+		if (aborted) {
+			/* Taken back from the stopped DMA before it was sent */
+			ringCfg.txDescs[idx].CTRLSTAT = ctrl & ~TDES_OWN;
+		}
+		txTail = ringNext(idx, ringCfg.numTx);
+		txUsed--;
+		end = (txFrameEnd & (1UL << idx)) != 0;
+		cb = txCb[idx];
+		cbData = txCbData[idx];
+		ringExitCritical(primask);
+
+		if (end) {
+			frames++;
+			if (aborted) {
+				ringStats.txAborted++;
+			}
+			else if (ctrl & TDES_ES) {
+				ringStats.txErrors++;
+			}
+			else {
+				ringStats.txFrames++;
+			}
+			if (cb) {
+				cb(cbData, (aborted || (ctrl & TDES_ES)) ? ERROR : SUCCESS);
+			}
+		}
+	}
+
+	return frames;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the descriptor rings and start the DMA */
+Status Chip_ENETRING_Init(LPC_ENET_T *pENET, const ENETRING_CFG_T *pCfg)
+{
+	uint32_t i;
+
+	if ((pCfg->numTx < 2) || (pCfg->numTx > ENETRING_MAX_DESCS) ||
+		(pCfg->numRx < 2) || (pCfg->numRx > ENETRING_MAX_DESCS)) {
+		return ERROR;
+	}
+
+	/* Stop the MAC and both DMA processes while the rings are rebuilt */
+	pENET->DMA_INT_EN = 0;
+	Chip_ENET_TXDisable(pENET);
+	Chip_ENET_RXDisable(pENET);
+	pENET->DMA_OP_MODE &= ~(DMA_OM_ST | DMA_OM_SR);
+
+	ringDev = pENET;
+	ringCfg = *pCfg;
+	memset(&ringStats, 0, sizeof(ringStats));
+	ringLinkUp = false;
+
+	for (i = 0; i < ringCfg.numTx; i++) {
+		ringCfg.txDescs[i].CTRLSTAT = (i == (ringCfg.numTx - 1)) ? TDES_ENH_TER : 0;
+		ringCfg.txDescs[i].BSIZE = 0;
+		ringCfg.txDescs[i].B1ADD = 0;
+		ringCfg.txDescs[i].B2ADD = 0;
+	}
+	txHead = txTail = txUsed = 0;
+	txFrameEnd = 0;
+
+	for (i = 0; i < ringCfg.numRx; i++) {
+		ringCfg.rxDescs[i].B1ADD = (uint32_t) &ringCfg.rxBuffers[i * (ENETRING_RX_BUFSIZE / 4)];
+		ringCfg.rxDescs[i].B2ADD = 0;
+		rxArm(i);
+	}
+	rxHead = 0;
+	rxHeld = 0;
+
+	Chip_ENET_InitDescriptors(pENET, ringCfg.txDescs, ringCfg.rxDescs);
+
+	/* Whole frames are buffered before sending, so slow segments fetched
+	   from scattered memory cannot underflow the transmitter */
+	pENET->DMA_OP_MODE |= DMA_OM_TSF;
+
+	pENET->DMA_STAT = DMA_ST_ALL;
+	rxIntOn = true;
+	pENET->DMA_INT_EN = ENETRING_INT_BASE | DMA_IE_RIE;
+
+	return SUCCESS;
+}
+
+/* Apply a PHY link state to the MAC */
+void Chip_ENETRING_SetLink(bool up, bool speed100, bool full)
+{
+	if (up != ringLinkUp) {
+		ringStats.linkChanges++;
+	}
+
+	if (up) {
+		/* The transmit DMA was stopped at link down, it restarts at the
+		   descriptor the next frame goes to */
+		if (!ringLinkUp) {
+			ringDev->DMA_TRANS_DES_ADDR = (uint32_t) &ringCfg.txDescs[txHead];
+		}
+		Chip_ENET_SetSpeed(ringDev, speed100);
+		Chip_ENET_SetDuplex(ringDev, full);
+		Chip_ENET_TXEnable(ringDev);
+		Chip_ENET_RXEnable(ringDev);
+		Chip_ENET_RXStart(ringDev);
+		ringLinkUp = true;
+	}
+	else {
+		/* Refuse new frames first, then stop the transmitter and fail the
+		   frames it still holds so their senders are not left waiting */
+		ringLinkUp = false;
+		Chip_ENET_TXDisable(ringDev);
+		Chip_ENET_RXDisable(ringDev);
+		ringDev->DMA_OP_MODE &= ~DMA_OM_ST;
+		ringDev->DMA_OP_MODE |= DMA_OM_FTF;
+		txReclaim(true);
+	}
+}
+
+/* Return the link state */
+bool Chip_ENETRING_IsLinkUp(void)
+{
+	return ringLinkUp;
+}
+
+/* Queue a frame made of one or more segments */
+Status Chip_ENETRING_Send(const ENETRING_SEG_T *pSegs, uint32_t numSegs,
+						  ENETRING_TXCALLBACK_T cb, void *cbData)
+{
+	ENET_ENHTXDESC_T *pDesc;
+	uint32_t i, idx, first, ctrl, bytes = 0;
+	uint32_t primask;
+
+	if (numSegs == 0) {
+		return ERROR;
+	}
+	for (i = 0; i < numSegs; i++) {
+		if ((pSegs[i].len == 0) || (pSegs[i].len > ENETRING_MAX_SEGSIZE)) {
+			return ERROR;
+		}
+		bytes += pSegs[i].len;
+	}
+
+	/* Checked with the frame queued atomically, a link down either sees
+	   the frame and fails it or the frame sees the link down */
+	primask = ringEnterCritical();
+	if (ringLinkUp == false) {
+		ringExitCritical(primask);
+		return ERROR;
+	}
+	if ((txUsed + numSegs) > ringCfg.numTx) {
+		ringStats.txFull++;
+		ringExitCritical(primask);
+		return ERROR;
+	}
+
+	first = idx = txHead;
+	for (i = 0; i < numSegs; i++) {
+		pDesc = &ringCfg.txDescs[idx];
+		pDesc->B1ADD = (uint32_t) pSegs[i].data;
+		pDesc->BSIZE = TDES_ENH_BS1(pSegs[i].len);
+
+		ctrl = (idx == (ringCfg.numTx - 1)) ? TDES_ENH_TER : 0;
+		if (i == 0) {
+			ctrl |= TDES_ENH_FS;
+		}
+		else {
+			/* Only the first descriptor is held back until the end */
+			ctrl |= TDES_OWN;
+		}
+		if (i == (numSegs - 1)) {
+			ctrl |= TDES_ENH_LS | TDES_ENH_IC;
+			txFrameEnd |= (1UL << idx);
+			txCb[idx] = cb;
+			txCbData[idx] = cbData;
+		}
+		else {
+			txFrameEnd &= ~(1UL << idx);
+		}
+		pDesc->CTRLSTAT = ctrl;
+		idx = ringNext(idx, ringCfg.numTx);
+	}
+	txHead = idx;
+	txUsed += numSegs;
+
+	/* Hand the whole chain over at once by owning the first descriptor last */
+	__DMB();
+	ringCfg.txDescs[first].CTRLSTAT |= TDES_OWN;
+	ringStats.txBytes += bytes;
+	ringExitCritical(primask);
+
+	Chip_ENET_TXStart(ringDev);
+
+	return SUCCESS;
+}
+
+/* Return the number of free transmit descriptors */
+uint32_t Chip_ENETRING_TXFree(void)
+{
+	return ringCfg.numTx - txUsed;
+}
+
+/* Complete the frames the DMA has sent */
+uint32_t Chip_ENETRING_ReclaimTX(void)
+{
+	return txReclaim(false);
+}
+
+/* Get the next received frame */
+bool Chip_ENETRING_Receive(ENETRING_RXFRAME_T *pFrame)
+{
+	uint32_t idx, status, len;
+
+	while (rxPending()) {
+		idx = rxHead;
+		status = ringCfg.rxDescs[idx].STATUS;
+		rxHead = ringNext(idx, ringCfg.numRx);
+
+		/* Buffers hold a full frame, so anything spanning descriptors is
+		   an error as well */
+		len = RDES_FLMSK(status);
+		if (((status & (RDES_ES | RDES_FS | RDES_LS)) != (RDES_FS | RDES_LS)) || (len <= 4)) {
+			ringStats.rxErrors++;
+			rxArm(idx);
+			Chip_ENET_RXStart(ringDev);
+			continue;
+		}
+
+		rxHeld |= (1UL << idx);
+		pFrame->data = (uint8_t *) ringCfg.rxDescs[idx].B1ADD;
+		pFrame->len = len - 4;
+		pFrame->index = idx;
+		ringStats.rxFrames++;
+		ringStats.rxBytes += pFrame->len;
+		return true;
+	}
+
+	return false;
+}
+
+/* Give the buffer of a received frame back to the DMA */
+void Chip_ENETRING_Release(const ENETRING_RXFRAME_T *pFrame)
+{
+	rxHeld &= ~(1UL << pFrame->index);
+	rxArm(pFrame->index);
+
+	/* Resume the receive DMA if it ran out of descriptors */
+	Chip_ENET_RXStart(ringDev);
+}
+
+/* Re-enable the receive interrupt once the ring is empty */
+bool Chip_ENETRING_EnableRXInt(void)
+{
+	uint32_t primask;
+	bool armed = true;
+
+	primask = ringEnterCritical();
+	ringDev->DMA_STAT = DMA_ST_RI;
+	if (rxPending()) {
+		armed = false;
+	}
+	else {
+		rxIntOn = true;
+		ringDev->DMA_INT_EN = ENETRING_INT_BASE | DMA_IE_RIE;
+	}
+	ringExitCritical(primask);
+
+	return armed;
+}
+
+/* ETH interrupt handler for the ring driver */
+void Chip_ENETRING_IRQHandler(void)
+{
+	uint32_t stat = ringDev->DMA_STAT & DMA_ST_ALL;
+
+	ringDev->DMA_STAT = stat;
+
+	if (stat & DMA_ST_RU) {
+		ringStats.rxNoBuffer++;
+	}
+	if (stat & DMA_ST_FBI) {
+		ringStats.busErrors++;
+	}
+
+	if (stat & DMA_ST_TI) {
+		Chip_ENETRING_ReclaimTX();
+	}
+
+	/* Switch to polling, the task pulls frames until the ring is empty */
+	if ((stat & DMA_ST_RI) && rxIntOn) {
+		rxIntOn = false;
+		ringDev->DMA_INT_EN = ENETRING_INT_BASE;
+		ringStats.rxInts++;
+		if (ringCfg.rxEvent) {
+			ringCfg.rxEvent();
+		}
+	}
+}
+
+/* Return the ring statistics */
+ENETRING_STATS_T *Chip_ENETRING_GetStats(void)
+{
+	return &ringStats;
+}
@@ -0,0 +1,286 @@
+/*
+ * @brief LPC18xx/43xx dual bank firmware updater
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define FWUPD_BUF_SIZE      (FWUPD_BUF_PAGES * FWUPD_PAGE_SIZE)
+
+/* Sector map of a bank: 8 sectors of 8K then sectors of 64K */
+#define FWUPD_SMALL_SECTORS 8
+#define FWUPD_SMALL_SIZE    0x2000
+#define FWUPD_LARGE_SIZE    0x10000
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Sector holding an offset of the bank */
+STATIC uint32_t fwupdSector(uint32_t offset)
+{
+	if (offset < (FWUPD_SMALL_SECTORS * FWUPD_SMALL_SIZE)) {
+		return offset / FWUPD_SMALL_SIZE;
+	}
+	return FWUPD_SMALL_SECTORS + (offset - (FWUPD_SMALL_SECTORS * FWUPD_SMALL_SIZE)) / FWUPD_LARGE_SIZE;
+}
+
+/* CRC-32 (IEEE 802.3) update, four bits at a time */
+STATIC uint32_t fwupdCRC(uint32_t crc, const uint8_t *p, uint32_t len)
+{
+	static const uint32_t nibble[16] = {
+		0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+		0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+	};
+
+	while (len--) {
+		crc ^= *p++;
+		crc = (crc >> 4) ^ nibble[crc & 0x0F];
+		crc = (crc >> 4) ^ nibble[crc & 0x0F];
+	}
+	return crc;
+}
+
+/* Mark the update failed, keeping the IAP status for the caller */
+STATIC void fwupdFail(FWUPD_HANDLE_T *pHandle, uint8_t status)
+{
+	pHandle->status = status;
+	pHandle->state = FWUPD_FAILED;
+}
+
+/* Erase the next sector of the image */
+STATIC void fwupdEraseNext(FWUPD_HANDLE_T *pHandle)
+{
+	uint32_t sector = fwupdSector(pHandle->erased);
+	uint8_t status;
+
+	status = Chip_IAP_PreSectorForReadWrite(sector, sector, pHandle->bank);
+	if (status == IAP_CMD_SUCCESS) {
+		status = Chip_IAP_EraseSector(sector, sector, pHandle->bank);
+	}
+	if (status != IAP_CMD_SUCCESS) {
+		fwupdFail(pHandle, status);
+		return;
+	}
+
+	pHandle->erased += (sector < FWUPD_SMALL_SECTORS) ? FWUPD_SMALL_SIZE : FWUPD_LARGE_SIZE;
+}
+
+/* Program a page and compare it with its buffer */
+STATIC uint8_t fwupdProgram(FWUPD_HANDLE_T *pHandle, uint32_t offset, uint32_t *page)
+{
+	uint32_t sector = fwupdSector(offset);
+	uint8_t status;
+
+	status = Chip_IAP_PreSectorForReadWrite(sector, sector, pHandle->bank);
+	if (status == IAP_CMD_SUCCESS) {
+		status = Chip_IAP_CopyRamToFlash(pHandle->base + offset, page, FWUPD_PAGE_SIZE);
+	}
+	if (status == IAP_CMD_SUCCESS) {
+		status = Chip_IAP_Compare(pHandle->base + offset, (uint32_t) page, FWUPD_PAGE_SIZE);
+	}
+	return status;
+}
+
+/* Check the programmed image before it can be activated */
+STATIC void fwupdCheck(FWUPD_HANDLE_T *pHandle)
+{
+	const uint32_t *vectors = (const uint32_t *) pHandle->base;
+	uint32_t sum = 0, i;
+
+	if ((pHandle->runCRC ^ 0xFFFFFFFF) != pHandle->crc) {
+		fwupdFail(pHandle, IAP_COMPARE_ERROR);
+		return;
+	}
+
+	/* The boot ROM only starts an image whose first 8 vectors add up to 0 */
+	for (i = 0; i < 8; i++) {
+		sum += vectors[i];
+	}
+	if (sum != 0) {
+		fwupdFail(pHandle, IAP_COMPARE_ERROR);
+		return;
+	}
+
+	pHandle->state = FWUPD_VERIFIED;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Start an update */
+Status Chip_FWUPD_Begin(FWUPD_HANDLE_T *pHandle, uint32_t size, uint32_t crc)
+{
+	if ((pHandle->state == FWUPD_RECEIVING) || (size < (8 * sizeof(uint32_t))) || (size > FWUPD_BANK_SIZE)) {
+		return ERROR;
+	}
+
+	/* Write the bank the application does not run from */
+	if ((LPC_CREG->MXMEMMAP & 0xFF000000) == FWUPD_BANK_B_BASE) {
+		pHandle->bank = IAP_FLASH_BANK_A;
+		pHandle->base = FWUPD_BANK_A_BASE;
+	}
+	else {
+		pHandle->bank = IAP_FLASH_BANK_B;
+		pHandle->base = FWUPD_BANK_B_BASE;
+	}
+
+	pHandle->status = Chip_IAP_Init();
+	if (pHandle->status != IAP_CMD_SUCCESS) {
+		return ERROR;
+	}
+
+	pHandle->size = size;
+	pHandle->crc = crc;
+	pHandle->runCRC = 0xFFFFFFFF;
+	pHandle->received = 0;
+	pHandle->programmed = 0;
+	pHandle->erased = 0;
+	memset(&pHandle->stats, 0, sizeof(pHandle->stats));
+	pHandle->state = FWUPD_RECEIVING;
+
+	return SUCCESS;
+}
+
+/* Hand received image data to the updater */
+uint32_t Chip_FWUPD_Write(FWUPD_HANDLE_T *pHandle, const void *data, uint32_t len)
+{
+	const uint8_t *src = (const uint8_t *) data;
+	uint8_t *buf = (uint8_t *) pHandle->buf;
+	uint32_t received = pHandle->received;
+	uint32_t room, off, n, done = 0;
+
+	if ((pHandle->state != FWUPD_RECEIVING) || (received >= pHandle->size)) {
+		return 0;
+	}
+	if (len > (pHandle->size - received)) {
+		len = pHandle->size - received;
+	}
+
+	while (done < len) {
+		room = FWUPD_BUF_SIZE - (received - pHandle->programmed);
+		if (room == 0) {
+			pHandle->stats.writeFull++;
+			break;
+		}
+		off = received % FWUPD_BUF_SIZE;
+		n = len - done;
+		if (n > room) {
+			n = room;
+		}
+		if (n > (FWUPD_BUF_SIZE - off)) {
+			n = FWUPD_BUF_SIZE - off;
+		}
+		memcpy(&buf[off], &src[done], n);
+		received += n;
+		done += n;
+	}
+
+	/* The last page is programmed whole, erased flash reads as 0xFF */
+	if ((received == pHandle->size) && (received % FWUPD_PAGE_SIZE)) {
+		n = FWUPD_PAGE_SIZE - (received % FWUPD_PAGE_SIZE);
+		memset(&buf[received % FWUPD_BUF_SIZE], 0xFF, n);
+		received += n;
+	}
+
+	pHandle->received = received;
+	return done;
+}
+
+/* Run the next flash operation of the update */
+bool Chip_FWUPD_Poll(FWUPD_HANDLE_T *pHandle)
+{
+	uint32_t offset = pHandle->programmed;
+	uint32_t *page;
+	uint8_t status;
+
+	if (pHandle->state != FWUPD_RECEIVING) {
+		return false;
+	}
+
+	if ((pHandle->received - offset) >= FWUPD_PAGE_SIZE) {
+		/* The data came faster than the erases */
+		if ((offset + FWUPD_PAGE_SIZE) > pHandle->erased) {
+			pHandle->stats.eraseStalls++;
+			fwupdEraseNext(pHandle);
+			return true;
+		}
+
+		page = pHandle->buf[(offset / FWUPD_PAGE_SIZE) % FWUPD_BUF_PAGES];
+		status = fwupdProgram(pHandle, offset, page);
+		if (status != IAP_CMD_SUCCESS) {
+			fwupdFail(pHandle, status);
+			return true;
+		}
+		pHandle->runCRC = fwupdCRC(pHandle->runCRC, (const uint8_t *) page,
+								   ((pHandle->size - offset) < FWUPD_PAGE_SIZE) ? (pHandle->size - offset) : FWUPD_PAGE_SIZE);
+		pHandle->programmed = offset + FWUPD_PAGE_SIZE;
+		pHandle->stats.pages++;
+
+		if (pHandle->programmed >= pHandle->size) {
+			fwupdCheck(pHandle);
+		}
+		return true;
+	}
+
+	/* No data waiting, erase ahead of it */
+	if (pHandle->erased < pHandle->size) {
+		pHandle->stats.eraseAhead++;
+		fwupdEraseNext(pHandle);
+		return true;
+	}
+
+	return false;
+}
+
+/* Make the verified image the boot image */
+Status Chip_FWUPD_Activate(FWUPD_HANDLE_T *pHandle)
+{
+	if (pHandle->state != FWUPD_VERIFIED) {
+		return ERROR;
+	}
+
+	pHandle->status = Chip_IAP_SetBootFlashBank(pHandle->bank);
+	if (pHandle->status != IAP_CMD_SUCCESS) {
+		return ERROR;
+	}
+
+	pHandle->state = FWUPD_IDLE;
+	return SUCCESS;
+}
@@ -69,7 +69,10 @@ static const uint8_t GPDMA_LUTPerBurst[] = {
 	GPDMA_BSIZE_4,	/* ADC 1              */
 	GPDMA_BSIZE_1,	/* DAC                */
 	GPDMA_BSIZE_32,	/* I2S channel 0      */
-	GPDMA_BSIZE_32	/* I2S channel 0      */
+	GPDMA_BSIZE_32,	/* I2S channel 0      */
+#if defined(CHIP_LPC43XX)
+	GPDMA_BSIZE_4,	/* HSADC              */
+#endif
 };
 
 /* Optimized Peripheral Source and Destination transfer width (18xx,43xx) */
@@ -103,7 +106,10 @@ static const uint8_t GPDMA_LUTPerWid[] = {
 	GPDMA_WIDTH_WORD,	/* ADC 1              */
 	GPDMA_WIDTH_WORD,	/* DAC                */
 	GPDMA_WIDTH_WORD,	/* I2S channel 0      */
-	GPDMA_WIDTH_WORD/* I2S channel 0      */
+	GPDMA_WIDTH_WORD,	/* I2S channel 0      */
+#if defined(CHIP_LPC43XX)
+	GPDMA_WIDTH_WORD,	/* HSADC              */
+#endif
 };
 
 /* Lookup Table of Connection Type matched with (18xx,43xx) Peripheral Data (FIFO) register base address */
@@ -137,7 +143,10 @@ volatile static const void *GPDMA_LUTPerAddr[] = {
 	(&LPC_ADC1->GDR),				/* ADC 1              */
 	(&LPC_DAC->CR),					/* DAC                */
 	(&LPC_I2S1->TXFIFO),			/* I2S1 Tx on channel 0 */
-	(&LPC_I2S1->RXFIFO)				/* I2S1 Rx on channel 1 */
+	(&LPC_I2S1->RXFIFO),			/* I2S1 Rx on channel 1 */
+#if defined(CHIP_LPC43XX)
+	(&LPC_ADCHS->FIFO_OUTPUT[0]),	/* HSADC              */
+#endif
 };
 
 /*****************************************************************************
@@ -298,6 +307,13 @@ STATIC uint8_t configDMAMux(uint32_t gpdma_peripheral_connection_number)
 		channel = 15;
 		break;
 
+#if defined(CHIP_LPC43XX)
+	case GPDMA_CONN_ADCHS:
+		function = 3;
+		channel = 8;
+		break;
+#endif
+
 	default:
 		function = 3;
 		channel = 15;
@@ -729,6 +745,40 @@ Status Chip_GPDMA_SGTransfer(LPC_GPDMA_T *pGPDMA,
 	return SUCCESS;
 }
 
+/* Do a DMA scatter-gather transfer with explicit peripheral connections */
+Status Chip_GPDMA_SGTransferConn(LPC_GPDMA_T *pGPDMA,
+								 uint8_t ChannelNum,
+								 const DMA_TransferDescriptor_t *DMADescriptor,
+								 GPDMA_FLOW_CONTROL_T TransferType,
+								 uint32_t SrcConn,
+								 uint32_t DstConn)
+{
+	GPDMA_CH_CFG_T GPDMACfg;
+	uint8_t SrcPeripheral = 0, DstPeripheral = 0;
+
+	/* Descriptor addresses are already resolved, only the mux needs the IDs */
+	GPDMACfg.ChannelNum = ChannelNum;
+	GPDMACfg.TransferType = TransferType;
+	GPDMACfg.SrcAddr = DMADescriptor->src;
+	GPDMACfg.DstAddr = DMADescriptor->dst;
+
+	if (SrcConn != GPDMA_CONN_MEMORY) {
+		SrcPeripheral = configDMAMux(SrcConn);
+	}
+	if (DstConn != GPDMA_CONN_MEMORY) {
+		DstPeripheral = configDMAMux(DstConn);
+	}
+
+	if (setupChannel(pGPDMA, &GPDMACfg, DMADescriptor->ctrl, DMADescriptor->lli,
+					 SrcPeripheral, DstPeripheral) == ERROR) {
+		return ERROR;
+	}
+
+	/* Start the Channel */
+	Chip_GPDMA_ChannelCmd(pGPDMA, ChannelNum, ENABLE);
+	return SUCCESS;
+}
+
 /* Get a free GPDMA channel for one DMA connection */
 uint8_t Chip_GPDMA_GetFreeChannel(LPC_GPDMA_T *pGPDMA,
 								  uint32_t PeripheralConnection_ID)
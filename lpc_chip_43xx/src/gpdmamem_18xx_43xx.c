@@ -0,0 +1,340 @@
+/*
+ * @brief LPC18xx/43xx GPDMA asynchronous memory copy/fill engine
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Channel manager request carrying the current segment */
+static GPDMAMGR_REQ_T memMgrReq;
+static bool memInit;
+
+/* Request queue, the head request is the one owning the channel */
+static GPDMAMEM_REQ_T *pMemHead, *pMemTail;
+
+/* Descriptors of the segment being transferred */
+static DMA_TransferDescriptor_t memDesc[GPDMAMEM_MAX_DESC];
+
+static uint32_t cpuThreshold = GPDMAMEM_CPU_THRESHOLD;
+static GPDMAMEM_STATS_T memStats;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t memEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void memExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Copy or fill part of a request using the CPU */
+STATIC void memCPUOp(GPDMAMEM_REQ_T *pReq, uint32_t offs, uint32_t len)
+{
+	if (len == 0) {
+		return;
+	}
+
+	if (pReq->op == GPDMAMEM_OP_COPY) {
+		memcpy(pReq->dst + offs, pReq->src + offs, len);
+	}
+	else {
+		memset(pReq->dst + offs, (int) (pReq->fill & 0xFF), len);
+	}
+}
+
+/* Select the transfer width and do the unaligned head and tail with the CPU */
+STATIC void memPrepareReq(GPDMAMEM_REQ_T *pReq)
+{
+	uint32_t dst = (uint32_t) pReq->dst;
+	uint32_t diff = (pReq->op == GPDMAMEM_OP_COPY) ? (dst ^ (uint32_t) pReq->src) : 0;
+	uint32_t unit, head;
+
+	if ((diff & 3) == 0) {
+		pReq->width = GPDMA_WIDTH_WORD;
+	}
+	else if ((diff & 1) == 0) {
+		pReq->width = GPDMA_WIDTH_HALFWORD;
+	}
+	else {
+		pReq->width = GPDMA_WIDTH_BYTE;
+	}
+	unit = 1UL << pReq->width;
+
+	head = (unit - (dst & (unit - 1))) & (unit - 1);
+	if (head > pReq->len) {
+		head = pReq->len;
+	}
+	pReq->pos = head;
+	pReq->end = head + ((pReq->len - head) & ~(unit - 1));
+
+	memCPUOp(pReq, 0, head);
+	memCPUOp(pReq, pReq->end, pReq->len - pReq->end);
+}
+
+STATIC void memSegmentDone(GPDMAMGR_REQ_T *pMgrReq);
+
+/* Build the next linked list segment of a request and queue it */
+STATIC Status memStartSegment(GPDMAMEM_REQ_T *pReq)
+{
+	uint32_t unit = 1UL << pReq->width;
+	uint32_t ctrl, cnt;
+	int i;
+
+	ctrl = GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_32)
+		   | GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_32)
+		   | GPDMA_DMACCxControl_SWidth(pReq->width)
+		   | GPDMA_DMACCxControl_DWidth(pReq->width)
+		   | GPDMA_DMACCxControl_DI;
+	if (pReq->op == GPDMAMEM_OP_COPY) {
+		ctrl |= GPDMA_DMACCxControl_SI;
+	}
+
+	for (i = 0; (i < GPDMAMEM_MAX_DESC) && (pReq->pos < pReq->end); i++) {
+		cnt = (pReq->end - pReq->pos) / unit;
+		if (cnt > GPDMAMEM_MAX_XFER) {
+			cnt = GPDMAMEM_MAX_XFER;
+		}
+
+		if (pReq->op == GPDMAMEM_OP_COPY) {
+			memDesc[i].src = (uint32_t) (pReq->src + pReq->pos);
+		}
+		else {
+			memDesc[i].src = (uint32_t) &pReq->fill;
+		}
+		memDesc[i].dst = (uint32_t) (pReq->dst + pReq->pos);
+		memDesc[i].lli = 0;
+		memDesc[i].ctrl = ctrl | GPDMA_DMACCxControl_TransferSize(cnt);
+		if (i > 0) {
+			memDesc[i - 1].lli = (uint32_t) &memDesc[i];
+		}
+		pReq->pos += cnt * unit;
+	}
+
+	/* Interrupt only at the end of the segment */
+	memDesc[i - 1].ctrl |= GPDMA_DMACCxControl_I;
+
+	memStats.segments++;
+	Chip_GPDMAMGR_SetupReq(&memMgrReq, &memDesc[0], GPDMA_TRANSFERTYPE_M2M_CONTROLLER_DMA,
+						   GPDMA_CONN_MEMORY, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_LOW,
+						   memSegmentDone, pReq);
+	return Chip_GPDMAMGR_Submit(&memMgrReq);
+}
+
+STATIC void memCompleteReq(GPDMAMEM_REQ_T *pReq, Status status)
+{
+	pReq->status = status;
+	pReq->done = 1;
+	if (pReq->cb) {
+		pReq->cb(pReq);
+	}
+}
+
+/* Remove the finished head request, start the next one and complete it.
+   A next request the channel manager refuses is completed with ERROR in
+   turn, so the queue never stalls behind a request that cannot start. */
+STATIC void memRetireHead(GPDMAMEM_REQ_T *pReq, Status status)
+{
+	GPDMAMEM_REQ_T *pNext, *pFailed;
+	uint32_t primask;
+
+	while (pReq) {
+		primask = memEnterCritical();
+		pNext = pMemHead = pReq->next;
+		if (pMemHead == NULL) {
+			pMemTail = NULL;
+		}
+		memExitCritical(primask);
+
+		/* Queue the next request before notifying so the channel stays busy */
+		pFailed = NULL;
+		if ((pNext) && (memStartSegment(pNext) != SUCCESS)) {
+			pFailed = pNext;
+		}
+
+		if (status == SUCCESS) {
+			memStats.dmaReqs++;
+			memStats.dmaBytes += pReq->len;
+		}
+		else {
+			memStats.errors++;
+		}
+		memCompleteReq(pReq, status);
+
+		pReq = pFailed;
+		status = ERROR;
+	}
+}
+
+/* Segment completion, called by the channel manager from the DMA interrupt */
+STATIC void memSegmentDone(GPDMAMGR_REQ_T *pMgrReq)
+{
+	GPDMAMEM_REQ_T *pReq = (GPDMAMEM_REQ_T *) pMgrReq->cbData;
+	Status status = pMgrReq->status;
+
+	/* Continue long requests with the next segment */
+	if ((status == SUCCESS) && (pReq->pos < pReq->end)) {
+		if (memStartSegment(pReq) == SUCCESS) {
+			return;
+		}
+		status = ERROR;
+	}
+
+	memRetireHead(pReq, status);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the GPDMA memory engine */
+void Chip_GPDMAMEM_Init(void)
+{
+	pMemHead = pMemTail = NULL;
+	memset(&memStats, 0, sizeof(memStats));
+	memInit = true;
+}
+
+/* Submit a memory request */
+Status Chip_GPDMAMEM_Submit(GPDMAMEM_REQ_T *pReq)
+{
+	uint32_t primask;
+	bool start;
+
+	if (!memInit) {
+		return ERROR;
+	}
+
+	pReq->done = 0;
+	pReq->status = SUCCESS;
+	pReq->next = NULL;
+
+	/* Small requests are cheaper on the CPU than setting up a channel */
+	if (pReq->len < cpuThreshold) {
+		memCPUOp(pReq, 0, pReq->len);
+		memStats.cpuReqs++;
+		memCompleteReq(pReq, SUCCESS);
+		return SUCCESS;
+	}
+
+	memPrepareReq(pReq);
+	if (pReq->pos >= pReq->end) {
+		memStats.cpuReqs++;
+		memCompleteReq(pReq, SUCCESS);
+		return SUCCESS;
+	}
+
+	primask = memEnterCritical();
+	if (pMemTail) {
+		pMemTail->next = pReq;
+	}
+	else {
+		pMemHead = pReq;
+	}
+	pMemTail = pReq;
+	start = (pMemHead == pReq);
+	memExitCritical(primask);
+
+	/* Started outside the critical section, so that the channel manager
+	   never runs callbacks with interrupts disabled. Requests submitted
+	   meanwhile queue behind this one as it is already the head. */
+	if ((start) && (memStartSegment(pReq) != SUCCESS)) {
+		memRetireHead(pReq, ERROR);
+	}
+
+	return SUCCESS;
+}
+
+/* Set the size below which requests are done by the CPU */
+void Chip_GPDMAMEM_SetThreshold(uint32_t bytes)
+{
+	cpuThreshold = bytes;
+}
+
+/* Return the size below which requests are done by the CPU */
+uint32_t Chip_GPDMAMEM_GetThreshold(void)
+{
+	return cpuThreshold;
+}
+
+/* Measure the memcpy() vs DMA crossover and set the CPU threshold */
+uint32_t Chip_GPDMAMEM_Calibrate(void *pBuf1, void *pBuf2, uint32_t maxLen)
+{
+	GPDMAMEM_REQ_T req;
+	uint32_t len, start, cpuTicks, dmaTicks;
+	uint32_t threshold = maxLen;
+
+	/* Enable the DWT cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	/* Force every request through DMA while measuring */
+	cpuThreshold = 0;
+	for (len = 16; len <= maxLen; len <<= 1) {
+		start = DWT->CYCCNT;
+		memcpy(pBuf2, pBuf1, len);
+		cpuTicks = DWT->CYCCNT - start;
+
+		Chip_GPDMAMEM_SetupCopy(&req, pBuf2, pBuf1, len, NULL, NULL);
+		start = DWT->CYCCNT;
+		Chip_GPDMAMEM_Submit(&req);
+		while (!Chip_GPDMAMEM_IsDone(&req)) {}
+		dmaTicks = DWT->CYCCNT - start;
+
+		if (dmaTicks <= cpuTicks) {
+			threshold = len;
+			break;
+		}
+	}
+	cpuThreshold = threshold;
+
+	return threshold;
+}
+
+/* Return the GPDMA memory engine statistics */
+const GPDMAMEM_STATS_T *Chip_GPDMAMEM_GetStats(void)
+{
+	return &memStats;
+}
@@ -0,0 +1,424 @@
+/*
+ * @brief LPC18xx/43xx GPDMA channel manager
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static LPC_GPDMA_T *pMgrDMA;
+
+/* Channels owned by the manager and channels currently idle */
+static uint8_t mgrChanMask;
+static uint8_t mgrFreeMask;
+
+/* Per connection queues, a connection runs one transfer at a time */
+static GPDMAMGR_REQ_T *pMgrQHead[GPDMAMGR_NUM_CONN], *pMgrQTail[GPDMAMGR_NUM_CONN];
+static uint8_t mgrQDepth[GPDMAMGR_NUM_CONN], mgrQMaxDepth[GPDMAMGR_NUM_CONN];
+static uint32_t mgrPendingMask;		/* Connections with queued requests */
+static uint32_t mgrActiveMask;		/* Connections with a running transfer */
+static uint32_t mgrSeq;
+
+/* Running request per channel */
+static GPDMAMGR_REQ_T *pMgrChReq[GPDMA_NUMBER_CHANNELS];
+static GPDMAMGR_CH_STATS_T mgrChStats[GPDMA_NUMBER_CHANNELS];
+static uint32_t mgrStatsTick;
+
+/* Completed requests waiting for their callback */
+static GPDMAMGR_REQ_T *pMgrDoneHead, *pMgrDoneTail;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t mgrEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void mgrExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* The queue of a request is its peripheral side, memory copies share queue 0 */
+STATIC INLINE uint8_t mgrConn(const GPDMAMGR_REQ_T *pReq)
+{
+	if (pReq->srcConn != GPDMA_CONN_MEMORY) {
+		return pReq->srcConn;
+	}
+	return pReq->dstConn;
+}
+
+/* Queue a completed request for its callback, called with interrupts off */
+STATIC void mgrFinish(GPDMAMGR_REQ_T *pReq, Status status)
+{
+	pReq->status = status;
+	pReq->next = NULL;
+	if (pMgrDoneTail) {
+		pMgrDoneTail->next = pReq;
+	}
+	else {
+		pMgrDoneHead = pReq;
+	}
+	pMgrDoneTail = pReq;
+}
+
+/* Release the channel of a running request, called with interrupts off */
+STATIC void mgrRelease(GPDMAMGR_REQ_T *pReq, Status status)
+{
+	uint8_t ch = pReq->channel;
+
+	mgrChStats[ch].busyTicks += DWT->CYCCNT - mgrChStats[ch].startTick;
+	if (status == SUCCESS) {
+		mgrChStats[ch].transfers++;
+	}
+	else {
+		mgrChStats[ch].errors++;
+	}
+
+	pMgrChReq[ch] = NULL;
+	mgrFreeMask |= 1 << ch;
+	mgrActiveMask &= ~(1UL << mgrConn(pReq));
+	mgrFinish(pReq, status);
+}
+
+/* Remove the head request of a connection queue */
+STATIC GPDMAMGR_REQ_T *mgrDequeue(uint8_t conn)
+{
+	GPDMAMGR_REQ_T *pReq = pMgrQHead[conn];
+
+	pMgrQHead[conn] = pReq->next;
+	if (pMgrQHead[conn] == NULL) {
+		pMgrQTail[conn] = NULL;
+		mgrPendingMask &= ~(1UL << conn);
+	}
+	mgrQDepth[conn]--;
+	pReq->next = NULL;
+
+	return pReq;
+}
+
+/* Give idle channels to the best queued requests, called with interrupts off */
+STATIC void mgrDispatch(void)
+{
+	GPDMAMGR_REQ_T *pReq, *pBest;
+	uint32_t ready;
+	uint8_t conn, ch;
+
+	while (mgrFreeMask != 0) {
+		ready = mgrPendingMask & ~mgrActiveMask;
+		if (ready == 0) {
+			return;
+		}
+
+		/* Highest priority first, oldest first within a priority */
+		pBest = NULL;
+		for (conn = 0; conn < GPDMAMGR_NUM_CONN; conn++) {
+			if ((ready & (1UL << conn)) == 0) {
+				continue;
+			}
+			pReq = pMgrQHead[conn];
+			if ((pBest == NULL) || (pReq->priority < pBest->priority) ||
+				((pReq->priority == pBest->priority) && ((int32_t) (pReq->seq - pBest->seq) < 0))) {
+				pBest = pReq;
+			}
+		}
+
+		/* Lowest free channel number has the highest hardware priority */
+		for (ch = 0; (mgrFreeMask & (1 << ch)) == 0; ch++) {}
+
+		pReq = mgrDequeue(mgrConn(pBest));
+		pReq->channel = ch;
+		pMgrChReq[ch] = pReq;
+		mgrFreeMask &= ~(1 << ch);
+		mgrActiveMask |= 1UL << mgrConn(pReq);
+		mgrChStats[ch].startTick = DWT->CYCCNT;
+
+		if (Chip_GPDMA_SGTransferConn(pMgrDMA, ch, pReq->pDesc, pReq->type,
+									  pReq->srcConn, pReq->dstConn) == ERROR) {
+			mgrRelease(pReq, ERROR);
+		}
+	}
+}
+
+/* Call the callbacks of completed requests, with interrupts enabled */
+STATIC void mgrRunCallbacks(void)
+{
+	GPDMAMGR_REQ_T *pReq;
+	uint32_t primask;
+
+	while (1) {
+		primask = mgrEnterCritical();
+		pReq = pMgrDoneHead;
+		if (pReq) {
+			pMgrDoneHead = pReq->next;
+			if (pMgrDoneHead == NULL) {
+				pMgrDoneTail = NULL;
+			}
+		}
+		mgrExitCritical(primask);
+
+		if (pReq == NULL) {
+			return;
+		}
+
+		pReq->done = 1;
+		if (pReq->cb) {
+			pReq->cb(pReq);
+		}
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the GPDMA channel manager */
+void Chip_GPDMAMGR_Init(LPC_GPDMA_T *pGPDMA, uint8_t chanMask)
+{
+	pMgrDMA = pGPDMA;
+	mgrChanMask = mgrFreeMask = chanMask;
+	mgrPendingMask = mgrActiveMask = 0;
+	pMgrDoneHead = pMgrDoneTail = NULL;
+	memset(pMgrQHead, 0, sizeof(pMgrQHead));
+	memset(pMgrQTail, 0, sizeof(pMgrQTail));
+	memset(mgrQDepth, 0, sizeof(mgrQDepth));
+	memset(pMgrChReq, 0, sizeof(pMgrChReq));
+
+	/* Busy time is measured with the DWT cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	Chip_GPDMAMGR_ResetStats();
+}
+
+/* Queue a transfer request */
+Status Chip_GPDMAMGR_Submit(GPDMAMGR_REQ_T *pReq)
+{
+	uint8_t conn = mgrConn(pReq);
+	uint32_t primask;
+
+	if ((pMgrDMA == NULL) || (pReq->pDesc == NULL) || (conn >= GPDMAMGR_NUM_CONN)) {
+		return ERROR;
+	}
+
+	pReq->done = 0;
+	pReq->status = SUCCESS;
+	pReq->channel = GPDMA_NUMBER_CHANNELS;
+	pReq->next = NULL;
+
+	primask = mgrEnterCritical();
+	pReq->seq = mgrSeq++;
+	if (pMgrQTail[conn]) {
+		pMgrQTail[conn]->next = pReq;
+	}
+	else {
+		pMgrQHead[conn] = pReq;
+	}
+	pMgrQTail[conn] = pReq;
+	mgrPendingMask |= 1UL << conn;
+	if (++mgrQDepth[conn] > mgrQMaxDepth[conn]) {
+		mgrQMaxDepth[conn] = mgrQDepth[conn];
+	}
+	mgrDispatch();
+	mgrExitCritical(primask);
+
+	/* Only requests that failed to start can be waiting here */
+	mgrRunCallbacks();
+
+	return SUCCESS;
+}
+
+/* Cancel a queued or running transfer request */
+Status Chip_GPDMAMGR_Cancel(GPDMAMGR_REQ_T *pReq)
+{
+	uint8_t conn = mgrConn(pReq);
+	GPDMAMGR_REQ_T *pPrev, *pCur;
+	Status status = ERROR;
+	uint32_t primask;
+
+	primask = mgrEnterCritical();
+	if ((pReq->channel < GPDMA_NUMBER_CHANNELS) && (pMgrChReq[pReq->channel] == pReq)) {
+		/* Running, stop the channel */
+		Chip_GPDMA_ChannelCmd(pMgrDMA, pReq->channel, DISABLE);
+		pMgrDMA->INTTCCLEAR = 1UL << pReq->channel;
+		pMgrDMA->INTERRCLR = 1UL << pReq->channel;
+		mgrRelease(pReq, ERROR);
+		mgrDispatch();
+		status = SUCCESS;
+	}
+	else {
+		/* Queued, unlink it */
+		pPrev = NULL;
+		for (pCur = pMgrQHead[conn]; pCur != NULL; pPrev = pCur, pCur = pCur->next) {
+			if (pCur != pReq) {
+				continue;
+			}
+			if (pPrev) {
+				pPrev->next = pCur->next;
+				if (pMgrQTail[conn] == pCur) {
+					pMgrQTail[conn] = pPrev;
+				}
+				mgrQDepth[conn]--;
+			}
+			else {
+				mgrDequeue(conn);
+			}
+			mgrFinish(pReq, ERROR);
+			status = SUCCESS;
+			break;
+		}
+	}
+	mgrExitCritical(primask);
+
+	mgrRunCallbacks();
+
+	return status;
+}
+
+/* Return the descriptor a running request will load next */
+const DMA_TransferDescriptor_t *Chip_GPDMAMGR_GetNextDesc(const GPDMAMGR_REQ_T *pReq)
+{
+	uint8_t ch = pReq->channel;
+
+	if ((ch >= GPDMA_NUMBER_CHANNELS) || (pMgrChReq[ch] != pReq)) {
+		return NULL;
+	}
+	return (const DMA_TransferDescriptor_t *) (pMgrDMA->CH[ch].LLI & ~3UL);
+}
+
+/* GPDMA channel manager interrupt handler */
+bool Chip_GPDMAMGR_IRQHandler(LPC_GPDMA_T *pGPDMA)
+{
+	GPDMAMGR_REQ_T *pProgress[GPDMA_NUMBER_CHANNELS];
+	uint32_t intStat, errStat, primask;
+	GPDMAMGR_REQ_T *pReq;
+	uint8_t ch, numProgress = 0;
+
+	intStat = pGPDMA->INTSTAT & mgrChanMask;
+	if ((pMgrDMA == NULL) || (intStat == 0)) {
+		return false;
+	}
+
+	primask = mgrEnterCritical();
+	errStat = pGPDMA->INTERRSTAT & intStat;
+	pGPDMA->INTTCCLEAR = intStat;
+	pGPDMA->INTERRCLR = intStat;
+
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		if ((intStat & (1 << ch)) == 0) {
+			continue;
+		}
+		pReq = pMgrChReq[ch];
+		if (pReq == NULL) {
+			continue;
+		}
+
+		if (errStat & (1 << ch)) {
+			Chip_GPDMA_ChannelCmd(pGPDMA, ch, DISABLE);
+			mgrRelease(pReq, ERROR);
+		}
+		else if ((pGPDMA->ENBLDCHNS & (1 << ch)) == 0) {
+			/* Channel disables itself after the last descriptor */
+			mgrRelease(pReq, SUCCESS);
+		}
+		else if (pReq->progressCb) {
+			pProgress[numProgress++] = pReq;
+		}
+	}
+
+	/* Chain queued transfers before notifying anyone */
+	mgrDispatch();
+	mgrExitCritical(primask);
+
+	for (ch = 0; ch < numProgress; ch++) {
+		pProgress[ch]->progressCb(pProgress[ch]);
+	}
+	mgrRunCallbacks();
+
+	return true;
+}
+
+/* Return the number of requests waiting on a connection */
+uint32_t Chip_GPDMAMGR_GetQueueDepth(uint8_t conn)
+{
+	return (conn < GPDMAMGR_NUM_CONN) ? mgrQDepth[conn] : 0;
+}
+
+/* Return the highest queue depth seen on a connection */
+uint32_t Chip_GPDMAMGR_GetMaxQueueDepth(uint8_t conn)
+{
+	return (conn < GPDMAMGR_NUM_CONN) ? mgrQMaxDepth[conn] : 0;
+}
+
+/* Return the statistics of a channel */
+const GPDMAMGR_CH_STATS_T *Chip_GPDMAMGR_GetChannelStats(uint8_t channel)
+{
+	return &mgrChStats[channel];
+}
+
+/* Return the utilization of a channel */
+uint32_t Chip_GPDMAMGR_GetUtilization(uint8_t channel)
+{
+	uint32_t elapsed = DWT->CYCCNT - mgrStatsTick;
+
+	if (elapsed == 0) {
+		return 0;
+	}
+	return (uint32_t) (((uint64_t) mgrChStats[channel].busyTicks * 1000) / elapsed);
+}
+
+/* Reset channel and queue statistics */
+void Chip_GPDMAMGR_ResetStats(void)
+{
+	uint32_t primask;
+	uint8_t ch;
+
+	primask = mgrEnterCritical();
+	mgrStatsTick = DWT->CYCCNT;
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		mgrChStats[ch].transfers = 0;
+		mgrChStats[ch].errors = 0;
+		mgrChStats[ch].busyTicks = 0;
+		mgrChStats[ch].startTick = mgrStatsTick;
+	}
+	memcpy(mgrQMaxDepth, mgrQDepth, sizeof(mgrQMaxDepth));
+	mgrExitCritical(primask);
+}
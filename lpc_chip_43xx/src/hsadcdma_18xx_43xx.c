@@ -0,0 +1,319 @@
+/*
+ * @brief LPC43xx HSADC streaming acquisition over GPDMA
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* The circular chain has one descriptor per block. An ended descriptor is
+   retargeted when it is retired and the DMA reaches it again only
+   numBlocks - 1 blocks later, so a late interrupt never lets the DMA reload
+   a descriptor still pointing at a block given to the consumer. */
+
+/* Block index of a descriptor writing to the discard word */
+#define HSADCDMA_DISCARD    0xFF
+
+static LPC_HSADC_T *hsadcDev;
+static uint32_t *hsadcBuffers;
+static uint32_t hsadcBlockWords, hsadcNumBlocks;
+static HSADCDMA_CALLBACK_T hsadcCb;
+static HSADCDMA_STATS_T hsadcStats;
+
+static DMA_TransferDescriptor_t hsadcDesc[HSADCDMA_MAX_BLOCKS];
+static uint8_t hsadcDescBlock[HSADCDMA_MAX_BLOCKS];
+static uint32_t hsadcDoneDesc;
+static uint32_t hsadcCtrlData, hsadcCtrlDiscard;
+static uint32_t hsadcDiscard;
+static GPDMAMGR_REQ_T hsadcReq;
+static bool hsadcRunning, hsadcDropping;
+
+/* Free blocks, and full blocks waiting for the consumer in order with their
+   sequence numbers. Every ended block, dropped or not, takes a number. */
+static uint32_t hsadcFreeMask;
+static uint8_t hsadcQueue[HSADCDMA_MAX_BLOCKS];
+static uint32_t hsadcQueueSeq[HSADCDMA_MAX_BLOCKS];
+static uint32_t hsadcQHead, hsadcQCount;
+static uint32_t hsadcSeq;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t hsadcEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void hsadcExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+STATIC INLINE void hsadcSetBlock(uint32_t desc, uint32_t block)
+{
+	hsadcDescBlock[desc] = block;
+	hsadcDesc[desc].dst = (uint32_t) &hsadcBuffers[block * hsadcBlockWords];
+	hsadcDesc[desc].ctrl = hsadcCtrlData;
+}
+
+/* Point a descriptor at a free block, or at the discard word */
+STATIC void hsadcAssign(uint32_t desc)
+{
+	uint32_t block;
+
+	if (hsadcFreeMask) {
+		for (block = 0; (hsadcFreeMask & (1UL << block)) == 0; block++) {}
+		hsadcFreeMask &= ~(1UL << block);
+		hsadcSetBlock(desc, block);
+	}
+	else {
+		hsadcDescBlock[desc] = HSADCDMA_DISCARD;
+		hsadcDesc[desc].dst = (uint32_t) &hsadcDiscard;
+		hsadcDesc[desc].ctrl = hsadcCtrlDiscard;
+	}
+}
+
+/* Hand a finished descriptor's block to the consumer */
+STATIC bool hsadcRetire(uint32_t desc)
+{
+	uint32_t block = hsadcDescBlock[desc];
+	uint32_t seq = hsadcSeq++;
+
+	if (block == HSADCDMA_DISCARD) {
+		hsadcStats.dropped++;
+		if (!hsadcDropping) {
+			hsadcStats.overruns++;
+		}
+		hsadcDropping = true;
+		return false;
+	}
+	hsadcDropping = false;
+
+	hsadcQueue[(hsadcQHead + hsadcQCount) % hsadcNumBlocks] = block;
+	hsadcQueueSeq[(hsadcQHead + hsadcQCount) % hsadcNumBlocks] = seq;
+	hsadcQCount++;
+	if (hsadcQCount > hsadcStats.maxQueued) {
+		hsadcStats.maxQueued = hsadcQCount;
+	}
+	hsadcStats.blocks++;
+	return true;
+}
+
+/* One or more descriptors of the chain have ended */
+STATIC void hsadcBlockDone(GPDMAMGR_REQ_T *pReq)
+{
+	const DMA_TransferDescriptor_t *pNext;
+	uint32_t running, desc, primask, ended = 0;
+	bool queued = false;
+
+	pNext = Chip_GPDMAMGR_GetNextDesc(pReq);
+	if (pNext == NULL) {
+		return;
+	}
+
+	/* Descriptor interrupts may be merged, so the position comes from the
+	   descriptor the DMA loads next rather than from counting calls */
+	running = ((pNext - hsadcDesc) + hsadcNumBlocks - 1) % hsadcNumBlocks;
+
+	primask = hsadcEnterCritical();
+	while (hsadcDoneDesc != running) {
+		desc = hsadcDoneDesc;
+		hsadcDoneDesc = (desc + 1) % hsadcNumBlocks;
+		queued |= hsadcRetire(desc);
+
+		/* The DMA reaches this descriptor last, give it the next block */
+		hsadcAssign(desc);
+		ended++;
+	}
+	if (ended > 1) {
+		hsadcStats.lateIrqs++;
+	}
+	hsadcExitCritical(primask);
+
+	if (Chip_HSADC_GetIntStatus(hsadcDev, 0) & HSADC_INT0_FIFO_OVERFLOW) {
+		Chip_HSADC_ClearIntStatus(hsadcDev, 0, HSADC_INT0_FIFO_OVERFLOW);
+		hsadcStats.fifoOverflows++;
+	}
+
+	if (queued && hsadcCb) {
+		hsadcCb();
+	}
+}
+
+/* The chain only ends when cancelled or on a DMA error */
+STATIC void hsadcStopped(GPDMAMGR_REQ_T *pReq)
+{
+	hsadcRunning = false;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the HSADC stream */
+Status Chip_HSADCDMA_Init(LPC_HSADC_T *pHSADC, uint32_t *buffers, uint32_t blockWords,
+						  uint32_t numBlocks, HSADCDMA_CALLBACK_T cb)
+{
+	if ((blockWords < 4) || (blockWords > HSADCDMA_MAX_BLOCK_WORDS) || (blockWords & 3) ||
+		(numBlocks < 3) || (numBlocks > HSADCDMA_MAX_BLOCKS)) {
+		return ERROR;
+	}
+
+	hsadcDev = pHSADC;
+	hsadcBuffers = buffers;
+	hsadcBlockWords = blockWords;
+	hsadcNumBlocks = numBlocks;
+	hsadcCb = cb;
+	hsadcRunning = false;
+
+	/* Word bursts from the FIFO register, interrupt at every block end */
+	hsadcCtrlDiscard = GPDMA_DMACCxControl_TransferSize(blockWords)
+					   | GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_4)
+					   | GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_4)
+					   | GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_WORD)
+					   | GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_WORD)
+					   | GPDMA_DMACCxControl_SrcTransUseAHBMaster1
+					   | GPDMA_DMACCxControl_I;
+	hsadcCtrlData = hsadcCtrlDiscard | GPDMA_DMACCxControl_DI;
+
+	Chip_HSADC_SetupFIFO(pHSADC, HSADCDMA_FIFO_TRIP, true);
+
+	return SUCCESS;
+}
+
+/* Start streaming the HSADC FIFO */
+Status Chip_HSADCDMA_Start(void)
+{
+	uint32_t i;
+
+	if (hsadcRunning) {
+		return ERROR;
+	}
+
+	memset(&hsadcStats, 0, sizeof(hsadcStats));
+	hsadcFreeMask = 0;
+	hsadcQHead = hsadcQCount = 0;
+	hsadcSeq = 0;
+	hsadcDropping = false;
+
+	/* Every descriptor starts on its own block */
+	for (i = 0; i < hsadcNumBlocks; i++) {
+		hsadcDesc[i].src = (uint32_t) &hsadcDev->FIFO_OUTPUT[0];
+		hsadcDesc[i].lli = (uint32_t) &hsadcDesc[(i + 1) % hsadcNumBlocks];
+		hsadcSetBlock(i, i);
+	}
+	hsadcDoneDesc = 0;
+
+	Chip_HSADC_FlushFIFO(hsadcDev);
+	Chip_HSADC_ClearIntStatus(hsadcDev, 0, HSADC_INT0_FIFO_OVERFLOW);
+
+	Chip_GPDMAMGR_SetupReq(&hsadcReq, &hsadcDesc[0], GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA,
+						   GPDMA_CONN_ADCHS, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_HIGHEST,
+						   hsadcStopped, NULL);
+	Chip_GPDMAMGR_SetProgressCb(&hsadcReq, hsadcBlockDone);
+	hsadcRunning = true;
+	if (Chip_GPDMAMGR_Submit(&hsadcReq) != SUCCESS) {
+		hsadcRunning = false;
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/* Stop streaming */
+void Chip_HSADCDMA_Stop(void)
+{
+	if (hsadcRunning) {
+		Chip_GPDMAMGR_Cancel(&hsadcReq);
+	}
+}
+
+/* Get the oldest full block */
+uint32_t *Chip_HSADCDMA_GetBlock(uint32_t *pSeq)
+{
+	uint32_t *block = NULL;
+	uint32_t primask;
+
+	primask = hsadcEnterCritical();
+	if (hsadcQCount) {
+		block = &hsadcBuffers[hsadcQueue[hsadcQHead] * hsadcBlockWords];
+		if (pSeq) {
+			*pSeq = hsadcQueueSeq[hsadcQHead];
+		}
+		hsadcQHead = (hsadcQHead + 1) % hsadcNumBlocks;
+		hsadcQCount--;
+	}
+	hsadcExitCritical(primask);
+
+	return block;
+}
+
+/* Give a block back to the stream */
+void Chip_HSADCDMA_ReleaseBlock(uint32_t *block)
+{
+	const DMA_TransferDescriptor_t *pNext;
+	uint32_t index = (block - hsadcBuffers) / hsadcBlockWords;
+	uint32_t desc, primask;
+
+	primask = hsadcEnterCritical();
+	pNext = hsadcRunning ? Chip_GPDMAMGR_GetNextDesc(&hsadcReq) : NULL;
+	if (pNext) {
+		/* Give the block to the nearest discarding descriptor the DMA has
+		   not loaded. The next one may be loaded at any time and is left. */
+		for (desc = ((pNext - hsadcDesc) + 1) % hsadcNumBlocks; desc != hsadcDoneDesc;
+			 desc = (desc + 1) % hsadcNumBlocks) {
+			if (hsadcDescBlock[desc] == HSADCDMA_DISCARD) {
+				hsadcSetBlock(desc, index);
+				hsadcExitCritical(primask);
+				return;
+			}
+		}
+	}
+	hsadcFreeMask |= 1UL << index;
+	hsadcExitCritical(primask);
+}
+
+/* Return the stream statistics */
+HSADCDMA_STATS_T *Chip_HSADCDMA_GetStats(void)
+{
+	return &hsadcStats;
+}
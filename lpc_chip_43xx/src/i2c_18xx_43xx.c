@@ -30,6 +30,7 @@
  */
 
 #include "chip.h"
+#include <string.h>
 
 /*****************************************************************************
  * Private types/enumerations/variables
@@ -65,6 +66,22 @@ static struct i2c_interface i2c[I2C_NUM_INTERFACE] = {
 
 static struct i2c_slave_interface i2c_slave[I2C_NUM_INTERFACE][I2C_SLAVE_NUM_INTERFACE];
 
+/* Queued master transfer interface structure */
+struct i2c_queue_interface {
+	I2C_QXFER_T *head;	/* Running transfer */
+	I2C_QXFER_T *tail;	/* Last queued transfer */
+	uint32_t startTick;	/* Start request time of the running transfer */
+	uint32_t doneTick;	/* Stop request time of the previous transfer */
+	uint32_t gapPending;/* Set until a chained transfer sends its start */
+	I2C_QXFER_T *waitXfer;			/* Transfer a task is blocked on */
+	I2C_EVENTHANDLER_T waitEvent;	/* Blocks and wakes tasks in Chip_I2C_MasterQueueWait() */
+	I2C_QSTATS_T stats;
+};
+
+static struct i2c_queue_interface i2c_queue[I2C_NUM_INTERFACE];
+
+STATIC void queueEventHandler(I2C_ID_T id, I2C_EVENT_T event);
+
 /*****************************************************************************
  * Public types/enumerations/variables
  ****************************************************************************/
@@ -244,6 +261,76 @@ int handleMasterXferState(LPC_I2C_T *pI2C, I2C_XFER_T  *xfer)
 	return 1;
 }
 
+STATIC INLINE uint32_t queueEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void queueExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Start the transfer at the head of the queue */
+STATIC void queueStartXfer(I2C_ID_T id)
+{
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+
+	i2c[id].mXfer = &iq->head->xfer;
+	iq->startTick = DWT->CYCCNT;
+	startMasterXfer(i2c[id].ip);
+}
+
+/* Event handler of queued master transfers */
+STATIC void queueEventHandler(I2C_ID_T id, I2C_EVENT_T event)
+{
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+	I2C_QXFER_T *pQXfer = iq->head;
+	uint32_t primask;
+
+	/* Waiting is done by the owner of the transfer */
+	if ((event != I2C_EVENT_DONE) || (pQXfer == NULL)) {
+		return;
+	}
+
+	iq->doneTick = DWT->CYCCNT;
+	iq->stats.busyTicks += iq->doneTick - iq->startTick;
+	if (pQXfer->xfer.status == I2C_STATUS_DONE) {
+		iq->stats.xfers++;
+	}
+	else {
+		iq->stats.errors++;
+	}
+
+	primask = queueEnterCritical();
+	iq->head = pQXfer->next;
+	if (iq->head) {
+		/* The start condition follows the stop just requested */
+		iq->gapPending = 1;
+		iq->stats.chained++;
+		queueStartXfer(id);
+	}
+	else {
+		iq->tail = NULL;
+		i2c[id].mXfer = NULL;
+	}
+	queueExitCritical(primask);
+
+	pQXfer->done = 1;
+	if (pQXfer->cb) {
+		pQXfer->cb(pQXfer);
+	}
+
+	/* Wake the task waiting for this transfer */
+	if (pQXfer == iq->waitXfer) {
+		iq->waitXfer = NULL;
+		iq->waitEvent(id, I2C_EVENT_DONE);
+	}
+}
+
 /* Find the slave address of SLA+W or SLA+R */
 I2C_SLAVE_ID getSlaveIndex(LPC_I2C_T *pI2C)
 {
@@ -417,6 +504,18 @@ int Chip_I2C_MasterTransfer(I2C_ID_T id, I2C_XFER_T *xfer)
 {
 	struct i2c_interface *iic = &i2c[id];
 
+	/* On a queued bus the transfer waits for its turn */
+	if (iic->mEvent == queueEventHandler) {
+		I2C_QXFER_T qxfer;
+
+		qxfer.xfer = *xfer;
+		qxfer.cb = NULL;
+		Chip_I2C_MasterSubmit(id, &qxfer, 1);
+		Chip_I2C_MasterQueueWait(id, &qxfer);
+		*xfer = qxfer.xfer;
+		return (int) xfer->status;
+	}
+
 	iic->mEvent(id, I2C_EVENT_LOCK);
 	xfer->status = I2C_STATUS_BUSY;
 	iic->mXfer = xfer;
@@ -486,6 +585,19 @@ int Chip_I2C_IsMasterActive(I2C_ID_T id)
 /* State change handler for master transfer */
 void Chip_I2C_MasterStateHandler(I2C_ID_T id)
 {
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+
+	/* First state of a chained transfer, the bus was idle until now */
+	if (iq->gapPending) {
+		uint32_t gap = DWT->CYCCNT - iq->doneTick;
+
+		iq->gapPending = 0;
+		iq->stats.gapTicks += gap;
+		if (gap > iq->stats.maxGapTicks) {
+			iq->stats.maxGapTicks = gap;
+		}
+	}
+
 	if (!handleMasterXferState(i2c[id].ip, i2c[id].mXfer)) {
 		i2c[id].mEvent(id, I2C_EVENT_DONE);
 	}
@@ -552,3 +664,106 @@ int Chip_I2C_IsStateChanged(I2C_ID_T id)
 	return (LPC_I2Cx(id)->CONSET & I2C_CON_SI) != 0;
 }
 
+/* Switch the master side of an I2C bus to queued operation */
+int Chip_I2C_MasterQueueInit(I2C_ID_T id)
+{
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+	I2C_EVENTHANDLER_T waitEvent;
+
+	if (i2c[id].mXfer) {
+		return 0;
+	}
+
+	/* Bus timing is measured with the DWT cycle counter */
+	CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+	DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+	/* Drivers may switch a bus again, the owner's wait handler stays */
+	waitEvent = iq->waitEvent;
+	memset(iq, 0, sizeof(*iq));
+	iq->waitEvent = waitEvent;
+	i2c[id].mEvent = queueEventHandler;
+	return 1;
+}
+
+/* Set the handler that blocks tasks waiting for queued transfers */
+void Chip_I2C_SetQueueWaitHandler(I2C_ID_T id, I2C_EVENTHANDLER_T event)
+{
+	i2c_queue[id].waitEvent = event;
+}
+
+/* Queue a batch of master transfers */
+void Chip_I2C_MasterSubmit(I2C_ID_T id, I2C_QXFER_T *pQXfer, uint32_t count)
+{
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+	uint32_t i, primask;
+
+	if (count == 0) {
+		return;
+	}
+
+	for (i = 0; i < count; i++) {
+		pQXfer[i].xfer.status = I2C_STATUS_BUSY;
+		pQXfer[i].done = 0;
+		pQXfer[i].next = (i + 1 < count) ? &pQXfer[i + 1] : NULL;
+	}
+
+	primask = queueEnterCritical();
+	if (iq->tail) {
+		iq->tail->next = pQXfer;
+		iq->tail = &pQXfer[count - 1];
+	}
+	else {
+		iq->head = pQXfer;
+		iq->tail = &pQXfer[count - 1];
+		queueStartXfer(id);
+	}
+	queueExitCritical(primask);
+}
+
+/* Run the queued master state machine without interrupts */
+void Chip_I2C_MasterQueuePoll(I2C_ID_T id)
+{
+	uint32_t primask;
+
+	/* Keeps the interrupt handler from taking the same state */
+	primask = queueEnterCritical();
+	if (i2c[id].mXfer && Chip_I2C_IsStateChanged(id)) {
+		Chip_I2C_MasterStateHandler(id);
+	}
+	queueExitCritical(primask);
+}
+
+/* Wait for a queued transfer to complete */
+I2C_STATUS_T Chip_I2C_MasterQueueWait(I2C_ID_T id, I2C_QXFER_T *pQXfer)
+{
+	struct i2c_queue_interface *iq = &i2c_queue[id];
+	I2C_EVENTHANDLER_T waitEvent = iq->waitEvent;
+	uint32_t primask;
+
+	/* The bus interrupt completes the transfer */
+	if (waitEvent == NULL) {
+		while (!pQXfer->done) {}
+		return pQXfer->xfer.status;
+	}
+
+	/* One waiter per bus, the completion wakes it with I2C_EVENT_DONE */
+	waitEvent(id, I2C_EVENT_LOCK);
+	primask = queueEnterCritical();
+	if (!pQXfer->done) {
+		iq->waitXfer = pQXfer;
+	}
+	queueExitCritical(primask);
+	while (!pQXfer->done) {
+		waitEvent(id, I2C_EVENT_WAIT);
+	}
+	waitEvent(id, I2C_EVENT_UNLOCK);
+
+	return pQXfer->xfer.status;
+}
+
+/* Return the queued transfer statistics of a bus */
+I2C_QSTATS_T *Chip_I2C_MasterGetQueueStats(I2C_ID_T id)
+{
+	return &i2c_queue[id].stats;
+}
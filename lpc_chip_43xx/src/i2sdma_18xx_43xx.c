@@ -0,0 +1,446 @@
+/*
+ * @brief LPC18xx/43xx full-duplex I2S audio streaming over GPDMA
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Descriptors in each circular chain. When one ends the DMA has already
+   loaded the next one, so the one after that is retargeted */
+#define I2SDMA_NUM_DESC     3
+
+/* Period index of a descriptor playing silence or discarding samples */
+#define I2SDMA_IDLE         0xFF
+
+/* One direction of the stream */
+typedef struct {
+	DMA_TransferDescriptor_t desc[I2SDMA_NUM_DESC];
+	uint8_t descPeriod[I2SDMA_NUM_DESC];
+	uint32_t doneDesc;					/* Next descriptor expected to end */
+	uint32_t ctrlData, ctrlIdle;
+	uint32_t *buffers;
+	uint32_t freeMask;					/* Transmit: empty periods, receive: periods for the DMA */
+	uint8_t queue[I2SDMA_MAX_PERIODS];	/* Transmit: periods to play, receive: periods to read */
+	uint32_t qHead, qCount;
+	I2SDMA_CALLBACK_T cb;
+	GPDMAMGR_REQ_T req;
+	bool tx;
+	bool running;
+} I2SDMA_STREAM_T;
+
+static LPC_I2S_T *i2sDev;
+static uint32_t i2sPeriodWords, i2sNumPeriods;
+static I2SDMA_STREAM_T i2sTx, i2sRx;
+static I2SDMA_STATS_T i2sStats;
+
+/* Silence source and discard destination of idle descriptors */
+static uint32_t i2sSilence;
+static uint32_t i2sDiscard;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC INLINE uint32_t i2sEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void i2sExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+STATIC INLINE uint32_t *i2sPeriodAddr(I2SDMA_STREAM_T *pStream, uint32_t period)
+{
+	return &pStream->buffers[period * i2sPeriodWords];
+}
+
+STATIC INLINE uint32_t i2sPeriodIndex(I2SDMA_STREAM_T *pStream, uint32_t *period)
+{
+	return (period - pStream->buffers) / i2sPeriodWords;
+}
+
+STATIC void i2sQueuePush(I2SDMA_STREAM_T *pStream, uint32_t period)
+{
+	pStream->queue[(pStream->qHead + pStream->qCount) % i2sNumPeriods] = period;
+	pStream->qCount++;
+}
+
+STATIC uint32_t i2sQueuePop(I2SDMA_STREAM_T *pStream)
+{
+	uint32_t period;
+
+	if (pStream->qCount == 0) {
+		return I2SDMA_IDLE;
+	}
+	period = pStream->queue[pStream->qHead];
+	pStream->qHead = (pStream->qHead + 1) % i2sNumPeriods;
+	pStream->qCount--;
+	return period;
+}
+
+STATIC uint32_t i2sTakeFree(I2SDMA_STREAM_T *pStream)
+{
+	uint32_t period;
+
+	if (pStream->freeMask == 0) {
+		return I2SDMA_IDLE;
+	}
+	for (period = 0; (pStream->freeMask & (1UL << period)) == 0; period++) {}
+	pStream->freeMask &= ~(1UL << period);
+	return period;
+}
+
+/* Point a descriptor at the next period, or at the idle word */
+STATIC void i2sAssign(I2SDMA_STREAM_T *pStream, uint32_t desc)
+{
+	DMA_TransferDescriptor_t *pDesc = &pStream->desc[desc];
+	uint32_t period;
+
+	if (pStream->tx) {
+		period = i2sQueuePop(pStream);
+		if (period != I2SDMA_IDLE) {
+			pDesc->src = (uint32_t) i2sPeriodAddr(pStream, period);
+			pDesc->ctrl = pStream->ctrlData;
+		}
+		else {
+			pDesc->src = (uint32_t) &i2sSilence;
+			pDesc->ctrl = pStream->ctrlIdle;
+			i2sStats.underruns++;
+		}
+	}
+	else {
+		period = i2sTakeFree(pStream);
+		if (period != I2SDMA_IDLE) {
+			pDesc->dst = (uint32_t) i2sPeriodAddr(pStream, period);
+			pDesc->ctrl = pStream->ctrlData;
+		}
+		else {
+			pDesc->dst = (uint32_t) &i2sDiscard;
+			pDesc->ctrl = pStream->ctrlIdle;
+			i2sStats.overruns++;
+		}
+	}
+	pStream->descPeriod[desc] = period;
+}
+
+/* Hand the period of an ended descriptor over to the application */
+STATIC bool i2sRetire(I2SDMA_STREAM_T *pStream, uint32_t desc)
+{
+	uint32_t period = pStream->descPeriod[desc];
+
+	pStream->descPeriod[desc] = I2SDMA_IDLE;
+	if (period == I2SDMA_IDLE) {
+		return false;
+	}
+
+	if (pStream->tx) {
+		pStream->freeMask |= 1UL << period;
+		i2sStats.txPeriods++;
+	}
+	else {
+		i2sQueuePush(pStream, period);
+		i2sStats.rxPeriods++;
+	}
+	return true;
+}
+
+/* One or more descriptors of a chain have ended */
+STATIC void i2sPeriodDone(GPDMAMGR_REQ_T *pReq)
+{
+	I2SDMA_STREAM_T *pStream = (I2SDMA_STREAM_T *) pReq->cbData;
+	const DMA_TransferDescriptor_t *pNext;
+	uint32_t running, desc, primask;
+	bool notify = false;
+
+	pNext = Chip_GPDMAMGR_GetNextDesc(pReq);
+	if (pNext == NULL) {
+		return;
+	}
+
+	/* Descriptor interrupts may be merged, so the position comes from the
+	   descriptor the DMA loads next rather than from counting calls */
+	running = ((pNext - pStream->desc) + I2SDMA_NUM_DESC - 1) % I2SDMA_NUM_DESC;
+
+	primask = i2sEnterCritical();
+	while (pStream->doneDesc != running) {
+		desc = pStream->doneDesc;
+		pStream->doneDesc = (desc + 1) % I2SDMA_NUM_DESC;
+		notify |= i2sRetire(pStream, desc);
+
+		if (((desc + 2) % I2SDMA_NUM_DESC) != running) {
+			i2sAssign(pStream, (desc + 2) % I2SDMA_NUM_DESC);
+		}
+		else {
+			/* Too late, the DMA already loaded the stale descriptor. Its
+			   period belongs to the application now, so it is not handed
+			   over again when it ends. */
+			pStream->descPeriod[running] = I2SDMA_IDLE;
+			i2sStats.lateIrqs++;
+			if (pStream->tx) {
+				i2sStats.underruns++;
+			}
+			else {
+				i2sStats.overruns++;
+			}
+		}
+	}
+	i2sExitCritical(primask);
+
+	if (notify && pStream->cb) {
+		pStream->cb();
+	}
+}
+
+/* The chain only ends when cancelled or on a DMA error */
+STATIC void i2sStopped(GPDMAMGR_REQ_T *pReq)
+{
+	I2SDMA_STREAM_T *pStream = (I2SDMA_STREAM_T *) pReq->cbData;
+	uint32_t desc, period;
+
+	/* Periods in flight go back to the pools, their contents are lost */
+	for (desc = 0; desc < I2SDMA_NUM_DESC; desc++) {
+		period = pStream->descPeriod[desc];
+		if (period != I2SDMA_IDLE) {
+			pStream->freeMask |= 1UL << period;
+			pStream->descPeriod[desc] = I2SDMA_IDLE;
+		}
+	}
+	pStream->running = false;
+}
+
+/* Build the descriptor chain of one direction and queue it */
+STATIC Status i2sStartStream(I2SDMA_STREAM_T *pStream, uint8_t conn)
+{
+	uint32_t i;
+
+	for (i = 0; i < I2SDMA_NUM_DESC; i++) {
+		if (pStream->tx) {
+			pStream->desc[i].dst = (uint32_t) &i2sDev->TXFIFO;
+		}
+		else {
+			pStream->desc[i].src = (uint32_t) &i2sDev->RXFIFO;
+		}
+		pStream->desc[i].lli = (uint32_t) &pStream->desc[(i + 1) % I2SDMA_NUM_DESC];
+		pStream->descPeriod[i] = I2SDMA_IDLE;
+	}
+
+	/* The first two descriptors get periods, the third is retargeted when
+	   the first one ends */
+	i2sAssign(pStream, 0);
+	i2sAssign(pStream, 1);
+	if (pStream->tx) {
+		pStream->desc[2].src = (uint32_t) &i2sSilence;
+	}
+	else {
+		pStream->desc[2].dst = (uint32_t) &i2sDiscard;
+	}
+	pStream->desc[2].ctrl = pStream->ctrlIdle;
+	pStream->doneDesc = 0;
+
+	if (pStream->tx) {
+		Chip_GPDMAMGR_SetupReq(&pStream->req, &pStream->desc[0], GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA,
+							   GPDMA_CONN_MEMORY, conn, GPDMAMGR_PRIO_HIGHEST, i2sStopped, pStream);
+	}
+	else {
+		Chip_GPDMAMGR_SetupReq(&pStream->req, &pStream->desc[0], GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA,
+							   conn, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_HIGHEST, i2sStopped, pStream);
+	}
+	Chip_GPDMAMGR_SetProgressCb(&pStream->req, i2sPeriodDone);
+
+	pStream->running = true;
+	if (Chip_GPDMAMGR_Submit(&pStream->req) != SUCCESS) {
+		i2sStopped(&pStream->req);
+		return ERROR;
+	}
+
+	return SUCCESS;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the audio streams */
+Status Chip_I2SDMA_Init(LPC_I2S_T *pI2S, const I2SDMA_CFG_T *pCfg)
+{
+	uint32_t ctrl, allMask;
+
+	if ((pCfg->periodWords < 4) || (pCfg->periodWords > I2SDMA_MAX_PERIOD_WORDS) ||
+		(pCfg->periodWords & 3) || (pCfg->numPeriods < I2SDMA_NUM_DESC) ||
+		(pCfg->numPeriods > I2SDMA_MAX_PERIODS) || (i2sTx.running) || (i2sRx.running)) {
+		return ERROR;
+	}
+
+	i2sDev = pI2S;
+	i2sPeriodWords = pCfg->periodWords;
+	i2sNumPeriods = pCfg->numPeriods;
+	allMask = (i2sNumPeriods == 32) ? 0xFFFFFFFF : ((1UL << i2sNumPeriods) - 1);
+
+	/* Word bursts of I2SDMA_FIFO_DEPTH, interrupt at every period end */
+	ctrl = GPDMA_DMACCxControl_TransferSize(i2sPeriodWords)
+		   | GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_4)
+		   | GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_4)
+		   | GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_WORD)
+		   | GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_WORD)
+		   | GPDMA_DMACCxControl_I;
+
+	memset(&i2sTx, 0, sizeof(i2sTx));
+	i2sTx.tx = true;
+	i2sTx.buffers = pCfg->txBuffers;
+	i2sTx.freeMask = allMask;
+	i2sTx.cb = pCfg->txCb;
+	i2sTx.ctrlIdle = ctrl | GPDMA_DMACCxControl_DestTransUseAHBMaster1;
+	i2sTx.ctrlData = i2sTx.ctrlIdle | GPDMA_DMACCxControl_SI;
+
+	memset(&i2sRx, 0, sizeof(i2sRx));
+	i2sRx.tx = false;
+	i2sRx.buffers = pCfg->rxBuffers;
+	i2sRx.freeMask = allMask;
+	i2sRx.cb = pCfg->rxCb;
+	i2sRx.ctrlIdle = ctrl | GPDMA_DMACCxControl_SrcTransUseAHBMaster1;
+	i2sRx.ctrlData = i2sRx.ctrlIdle | GPDMA_DMACCxControl_DI;
+
+	return SUCCESS;
+}
+
+/* Start streaming */
+Status Chip_I2SDMA_Start(void)
+{
+	bool i2s0 = (i2sDev == LPC_I2S0);
+
+	if ((i2sTx.running) || (i2sRx.running)) {
+		return ERROR;
+	}
+
+	memset(&i2sStats, 0, sizeof(i2sStats));
+	i2sSilence = 0;
+
+	if (i2sRx.buffers) {
+		if (i2sStartStream(&i2sRx, i2s0 ? GPDMA_CONN_I2S_Rx_Channel_1 : GPDMA_CONN_I2S1_Rx_Channel_1) != SUCCESS) {
+			return ERROR;
+		}
+		Chip_I2S_DMA_RxCmd(i2sDev, I2S_DMA_REQUEST_CHANNEL_2, ENABLE, I2SDMA_FIFO_DEPTH);
+	}
+	if (i2sTx.buffers) {
+		if (i2sStartStream(&i2sTx, i2s0 ? GPDMA_CONN_I2S_Tx_Channel_0 : GPDMA_CONN_I2S1_Tx_Channel_0) != SUCCESS) {
+			Chip_I2SDMA_Stop();
+			return ERROR;
+		}
+		Chip_I2S_DMA_TxCmd(i2sDev, I2S_DMA_REQUEST_CHANNEL_1, ENABLE, I2SDMA_FIFO_DEPTH);
+	}
+
+	if (i2sRx.buffers) {
+		Chip_I2S_RxStart(i2sDev);
+	}
+	if (i2sTx.buffers) {
+		Chip_I2S_TxStart(i2sDev);
+	}
+
+	return SUCCESS;
+}
+
+/* Stop streaming */
+void Chip_I2SDMA_Stop(void)
+{
+	if (i2sTx.running) {
+		Chip_I2S_TxPause(i2sDev);
+		Chip_I2S_DMA_TxCmd(i2sDev, I2S_DMA_REQUEST_CHANNEL_1, DISABLE, I2SDMA_FIFO_DEPTH);
+		Chip_GPDMAMGR_Cancel(&i2sTx.req);
+	}
+	if (i2sRx.running) {
+		Chip_I2S_RxPause(i2sDev);
+		Chip_I2S_DMA_RxCmd(i2sDev, I2S_DMA_REQUEST_CHANNEL_2, DISABLE, I2SDMA_FIFO_DEPTH);
+		Chip_GPDMAMGR_Cancel(&i2sRx.req);
+	}
+}
+
+/* Get an empty transmit period to fill */
+uint32_t *Chip_I2SDMA_GetTxPeriod(void)
+{
+	uint32_t period, primask;
+
+	primask = i2sEnterCritical();
+	period = i2sTakeFree(&i2sTx);
+	i2sExitCritical(primask);
+
+	return (period != I2SDMA_IDLE) ? i2sPeriodAddr(&i2sTx, period) : NULL;
+}
+
+/* Queue a filled transmit period */
+void Chip_I2SDMA_QueueTxPeriod(uint32_t *period)
+{
+	uint32_t primask;
+
+	primask = i2sEnterCritical();
+	i2sQueuePush(&i2sTx, i2sPeriodIndex(&i2sTx, period));
+	i2sExitCritical(primask);
+}
+
+/* Get the oldest full receive period */
+uint32_t *Chip_I2SDMA_GetRxPeriod(void)
+{
+	uint32_t period, primask;
+
+	primask = i2sEnterCritical();
+	period = i2sQueuePop(&i2sRx);
+	i2sExitCritical(primask);
+
+	return (period != I2SDMA_IDLE) ? i2sPeriodAddr(&i2sRx, period) : NULL;
+}
+
+/* Give a receive period back to the stream */
+void Chip_I2SDMA_ReleaseRxPeriod(uint32_t *period)
+{
+	uint32_t primask;
+
+	primask = i2sEnterCritical();
+	i2sRx.freeMask |= 1UL << i2sPeriodIndex(&i2sRx, period);
+	i2sExitCritical(primask);
+}
+
+/* Return the stream statistics */
+I2SDMA_STATS_T *Chip_I2SDMA_GetStats(void)
+{
+	return &i2sStats;
+}
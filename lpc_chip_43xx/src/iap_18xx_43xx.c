@@ -47,6 +47,17 @@
  * Public functions
  ****************************************************************************/
 
+/* Initialize the IAP functions */
+uint8_t Chip_IAP_Init(void)
+{
+	uint32_t command[5], result[4];
+
+	command[0] = IAP_INIT_CMD;
+	iap_entry(command, result);
+
+	return result[0];
+}
+
 /* Prepare sector for write operation */
 uint8_t Chip_IAP_PreSectorForReadWrite(uint32_t strSector, uint32_t endSector, uint8_t flashBank)
 {
@@ -0,0 +1,217 @@
+/*
+ * @brief LPC43xx inter-core mailbox
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Bytes of a message ahead of the payload */
+#define IPCMBX_MSG_HDR      (IPCMBX_MSG_SIZE - IPCMBX_MSG_DATA)
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Raise the IPC interrupt of the other core */
+STATIC INLINE void ipcmbxDoorbell(IPCMBX_HANDLE_T *pHandle)
+{
+	pHandle->stats.doorbells++;
+	__DSB();
+	__SEV();
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Attach to the shared mailbox block */
+Status Chip_IPCMBX_Init(IPCMBX_HANDLE_T *pHandle, IPCMBX_SHARED_T *pShared)
+{
+	memset(pHandle, 0, sizeof(*pHandle));
+	pHandle->pShared = pShared;
+#if defined(CORE_M4)
+	pHandle->pTx = &pShared->toM0;
+	pHandle->pRx = &pShared->toM4;
+
+	memset((void *) pShared, 0, sizeof(*pShared));
+	__DMB();
+	pShared->magic = IPCMBX_MAGIC;
+	__DSB();
+	Chip_CREG_ClearM0AppEvent();
+#else
+	pHandle->pTx = &pShared->toM4;
+	pHandle->pRx = &pShared->toM0;
+
+	if (pShared->magic != IPCMBX_MAGIC) {
+		return ERROR;
+	}
+	Chip_CREG_ClearM4Event();
+#endif
+
+	return SUCCESS;
+}
+
+/* Send a message to the other core without blocking */
+Status Chip_IPCMBX_Send(IPCMBX_HANDLE_T *pHandle, const IPCMBX_MSG_T *pMsg)
+{
+	IPCMBX_RING_T *pRing = pHandle->pTx;
+	uint32_t head = pRing->head;
+
+	if (pMsg->len > IPCMBX_MSG_DATA) {
+		return ERROR;
+	}
+	if ((head - pRing->tail) >= IPCMBX_RING_MSGS) {
+		pHandle->stats.txFull++;
+		return ERROR;
+	}
+
+	/* The tail was read before the slot is written, and the slot is
+	   written before the new head is published */
+	__DMB();
+	memcpy(&pRing->msg[head & (IPCMBX_RING_MSGS - 1)], pMsg, IPCMBX_MSG_HDR + pMsg->len);
+	pRing->txWait = 0;
+	__DMB();
+	pRing->head = head + 1;
+	pHandle->stats.sent++;
+
+	/* The head must be visible before the wait flag of the receiver is
+	   read, the receiver sets its flag before it reads the head */
+	__DMB();
+	if (pRing->rxWait) {
+		ipcmbxDoorbell(pHandle);
+	}
+
+	return SUCCESS;
+}
+
+/* Take the oldest message from the other core */
+bool Chip_IPCMBX_Receive(IPCMBX_HANDLE_T *pHandle, IPCMBX_MSG_T *pMsg)
+{
+	IPCMBX_RING_T *pRing = pHandle->pRx;
+	uint32_t tail = pRing->tail;
+	IPCMBX_MSG_T *pSlot;
+
+	if (pRing->head == tail) {
+		return false;
+	}
+
+	/* The head was read before the slot, and the slot is read before it
+	   is handed back */
+	__DMB();
+	pSlot = &pRing->msg[tail & (IPCMBX_RING_MSGS - 1)];
+	memcpy(pMsg, pSlot, IPCMBX_MSG_HDR);
+	if (pMsg->len > IPCMBX_MSG_DATA) {
+		pMsg->len = IPCMBX_MSG_DATA;
+	}
+	memcpy(pMsg->data, pSlot->data, pMsg->len);
+	pRing->rxWait = 0;
+	__DMB();
+	pRing->tail = tail + 1;
+	pHandle->stats.received++;
+
+	__DMB();
+	if (pRing->txWait) {
+		ipcmbxDoorbell(pHandle);
+	}
+
+	return true;
+}
+
+/* Ask for a doorbell when the next message arrives */
+bool Chip_IPCMBX_WaitRx(IPCMBX_HANDLE_T *pHandle)
+{
+	IPCMBX_RING_T *pRing = pHandle->pRx;
+
+	pRing->rxWait = 1;
+	__DMB();
+	return pRing->head == pRing->tail;
+}
+
+/* Ask for a doorbell when the other core frees a slot */
+bool Chip_IPCMBX_WaitTx(IPCMBX_HANDLE_T *pHandle)
+{
+	IPCMBX_RING_T *pRing = pHandle->pTx;
+
+	pRing->txWait = 1;
+	__DMB();
+	return (pRing->head - pRing->tail) >= IPCMBX_RING_MSGS;
+}
+
+/* Handle the IPC interrupt from the other core */
+uint32_t Chip_IPCMBX_IRQHandler(IPCMBX_HANDLE_T *pHandle)
+{
+	uint32_t events = 0;
+
+	/* Clear the event first, a doorbell rung while the rings are checked
+	   raises the interrupt again */
+#if defined(CORE_M4)
+	Chip_CREG_ClearM0AppEvent();
+#else
+	Chip_CREG_ClearM4Event();
+#endif
+	__DSB();
+	pHandle->stats.irqs++;
+
+	if (pHandle->pRx->rxWait && (pHandle->pRx->head != pHandle->pRx->tail)) {
+		events |= IPCMBX_EVENT_RX;
+	}
+	if (pHandle->pTx->txWait && ((pHandle->pTx->head - pHandle->pTx->tail) < IPCMBX_RING_MSGS)) {
+		events |= IPCMBX_EVENT_TX;
+	}
+
+	return events;
+}
+
+#if defined(CORE_M4)
+/* Start the M0APP core on an image */
+Status Chip_IPCMBX_StartM0(uint32_t imageAddr)
+{
+	if (imageAddr & 0xFFF) {
+		return ERROR;
+	}
+
+	Chip_RGU_TriggerReset(RGU_M0APP_RST);
+	Chip_Clock_Enable(CLK_M4_M0APP);
+	Chip_CREG_SetM0AppMemMap(imageAddr);
+	Chip_RGU_ClearReset(RGU_M0APP_RST);
+
+	return SUCCESS;
+}
+
+#endif /* defined(CORE_M4) */
@@ -0,0 +1,301 @@
+/*
+ * @brief LPC18xx/43xx asynchronous SD/MMC block I/O driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Driver states */
+#define SDBLK_ST_IDLE       0	/* No request running */
+#define SDBLK_ST_WAIT_BUSY  1	/* Head request waits for the card to be ready */
+#define SDBLK_ST_DATA       2	/* Data command running, completes on interrupt */
+#define SDBLK_ST_PROGRAM    3	/* Write data sent, card is programming */
+
+/* All SD error conditions in the interrupt status word */
+#define SDBLK_INT_ERROR (MCI_INT_RESP_ERR | MCI_INT_RCRC | MCI_INT_DCRC | \
+						 MCI_INT_RTO | MCI_INT_DTO | MCI_INT_HTO | MCI_INT_FRUN | MCI_INT_HLE | \
+						 MCI_INT_SBE | MCI_INT_EBE)
+
+static LPC_SDMMC_T *sdblkDev;
+static mci_card_struct *sdblkCard;
+static SDBLK_REQ_T *sdblkHead, *sdblkTail;
+static volatile uint32_t sdblkState;
+static uint32_t sdblkIntStatus, sdblkDoneMask;
+static SDBLK_STATS_T sdblkStats;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC void sdblkStart(void);
+
+STATIC INLINE uint32_t sdblkEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void sdblkExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* The card holds DAT0 low while it programs or handles a stop */
+STATIC INLINE bool sdblkCardBusy(void)
+{
+	return (sdblkDev->STATUS & MCI_STS_DATA_BUSY) != 0;
+}
+
+/* Complete the head request and start the next one */
+STATIC void sdblkComplete(Status status)
+{
+	SDBLK_REQ_T *pReq = sdblkHead;
+	uint32_t primask;
+
+	Chip_SDIF_SetIntMask(sdblkDev, 0);
+	if (status == SUCCESS) {
+		if (pReq->write) {
+			sdblkStats.writes++;
+		}
+		else {
+			sdblkStats.reads++;
+		}
+		sdblkStats.blocks += pReq->count;
+	}
+	else {
+		sdblkStats.errors++;
+	}
+
+	primask = sdblkEnterCritical();
+	sdblkHead = pReq->next;
+	if (sdblkHead == NULL) {
+		sdblkTail = NULL;
+	}
+	sdblkState = SDBLK_ST_IDLE;
+	sdblkExitCritical(primask);
+
+	if (sdblkHead) {
+		sdblkStart();
+	}
+
+	pReq->status = status;
+	pReq->done = 1;
+	if (pReq->cb) {
+		pReq->cb(pReq);
+	}
+}
+
+/* Issue the data command of the head request */
+STATIC void sdblkStart(void)
+{
+	SDBLK_REQ_T *pReq = sdblkHead;
+	uint32_t bytes = pReq->count * MMC_SECTOR_SIZE;
+	uint32_t cmd, arg;
+
+	/* A command must not be issued while the card programs */
+	if (sdblkCardBusy()) {
+		sdblkState = SDBLK_ST_WAIT_BUSY;
+		return;
+	}
+	sdblkState = SDBLK_ST_DATA;
+
+	Chip_SDIF_SetClearIntFifo(sdblkDev);
+	Chip_SDIF_SetByteCnt(sdblkDev, bytes);
+	Chip_SDIF_DmaSetup(sdblkDev, &sdblkCard->sdif_dev, (uint32_t) pReq->buffer, bytes);
+
+	/* if high capacity card use block indexing */
+	if (sdblkCard->card_info.card_type & CARD_TYPE_HC) {
+		arg = pReq->block;
+	}
+	else {
+		arg = pReq->block << 9;
+	}
+
+	cmd = MCI_CMD_DAT_EXP | MCI_CMD_PRV_DAT_WAIT | MCI_CMD_RESP_EXP;
+	if (pReq->count > 1) {
+		cmd |= MCI_CMD_SEND_STOP |
+			   MCI_CMD_INDX(pReq->write ? MMC_WRITE_MULTIPLE_BLOCK : MMC_READ_MULTIPLE_BLOCK);
+		sdblkDoneMask = MCI_INT_DATA_OVER | MCI_INT_ACD;
+	}
+	else {
+		cmd |= MCI_CMD_INDX(pReq->write ? MMC_WRITE_BLOCK : MMC_READ_SINGLE_BLOCK);
+		sdblkDoneMask = MCI_INT_DATA_OVER;
+	}
+	if (pReq->write) {
+		cmd |= MCI_CMD_DAT_WR;
+	}
+
+	sdblkIntStatus = 0;
+	Chip_SDIF_SetIntMask(sdblkDev, sdblkDoneMask | SDBLK_INT_ERROR);
+	if (Chip_SDIF_SendCmd(sdblkDev, cmd, arg) != 0) {
+		sdblkComplete(ERROR);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the asynchronous block driver */
+Status Chip_SDBLK_Init(LPC_SDMMC_T *pSDMMC, mci_card_struct *pCard)
+{
+	/* Last blocking command, the card must already be selected */
+	if (Chip_SDMMC_GetState(pSDMMC) != SDMMC_TRAN_ST) {
+		return ERROR;
+	}
+
+	sdblkDev = pSDMMC;
+	sdblkCard = pCard;
+	sdblkHead = sdblkTail = NULL;
+	sdblkState = SDBLK_ST_IDLE;
+	sdblkStats.reads = 0;
+	sdblkStats.writes = 0;
+	sdblkStats.blocks = 0;
+	sdblkStats.errors = 0;
+	sdblkStats.busyPolls = 0;
+
+	Chip_SDIF_SetIntMask(pSDMMC, 0);
+	Chip_SDIF_ClrIntStatus(pSDMMC, 0xFFFFFFFF);
+
+	return SUCCESS;
+}
+
+/* Queue a block request */
+Status Chip_SDBLK_Submit(SDBLK_REQ_T *pReq)
+{
+	uint32_t primask;
+	bool start;
+
+	if ((sdblkCard == NULL) || (pReq->count == 0) || (pReq->count > SDBLK_MAX_BLOCKS) ||
+		(pReq->block + pReq->count > sdblkCard->card_info.blocknr)) {
+		return ERROR;
+	}
+
+	pReq->status = SUCCESS;
+	pReq->done = 0;
+	pReq->next = NULL;
+
+	primask = sdblkEnterCritical();
+	if (sdblkTail) {
+		sdblkTail->next = pReq;
+	}
+	else {
+		sdblkHead = pReq;
+	}
+	sdblkTail = pReq;
+	start = (sdblkHead == pReq);
+	sdblkExitCritical(primask);
+
+	if (start) {
+		sdblkStart();
+	}
+
+	return SUCCESS;
+}
+
+/* Check the card busy line and advance waiting requests */
+void Chip_SDBLK_Poll(void)
+{
+	uint32_t primask, state;
+
+	primask = sdblkEnterCritical();
+	state = sdblkState;
+	if ((state == SDBLK_ST_WAIT_BUSY) || (state == SDBLK_ST_PROGRAM)) {
+		if (sdblkCardBusy()) {
+			sdblkStats.busyPolls++;
+			state = SDBLK_ST_IDLE;
+		}
+		else {
+			/* Claim the request so the next poll leaves it alone */
+			sdblkState = SDBLK_ST_IDLE;
+		}
+	}
+	sdblkExitCritical(primask);
+
+	if (state == SDBLK_ST_WAIT_BUSY) {
+		sdblkStart();
+	}
+	else if (state == SDBLK_ST_PROGRAM) {
+		sdblkComplete(SUCCESS);
+	}
+}
+
+/* SDIO interrupt handler for the block driver */
+void Chip_SDBLK_IRQHandler(void)
+{
+	uint32_t status;
+
+	/* Not attached yet, the interrupt belongs to the card acquire code */
+	if (sdblkDev == NULL) {
+		return;
+	}
+
+	status = Chip_SDIF_GetIntStatus(sdblkDev) & sdblkDev->INTMASK;
+	Chip_SDIF_ClrIntStatus(sdblkDev, status);
+	if (sdblkState != SDBLK_ST_DATA) {
+		return;
+	}
+
+	sdblkIntStatus |= status;
+	if (sdblkIntStatus & SDBLK_INT_ERROR) {
+		Chip_SDIF_SetIntMask(sdblkDev, 0);
+
+		/* Take the card back to transfer state, the next request waits for its busy */
+		if (sdblkHead->count > 1) {
+			Chip_SDIF_SendCmd(sdblkDev, MCI_CMD_STOP | MCI_CMD_RESP_EXP | MCI_CMD_INDX(MMC_STOP_TRANSMISSION), 0);
+		}
+		sdblkComplete(ERROR);
+	}
+	else if ((sdblkIntStatus & sdblkDoneMask) == sdblkDoneMask) {
+		if (sdblkHead->write && sdblkCardBusy()) {
+			/* Completion comes from Chip_SDBLK_Poll() once the card is ready */
+			Chip_SDIF_SetIntMask(sdblkDev, 0);
+			sdblkState = SDBLK_ST_PROGRAM;
+		}
+		else {
+			sdblkComplete(SUCCESS);
+		}
+	}
+}
+
+/* Return the block driver statistics */
+SDBLK_STATS_T *Chip_SDBLK_GetStats(void)
+{
+	return &sdblkStats;
+}
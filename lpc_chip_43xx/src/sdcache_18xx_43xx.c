@@ -0,0 +1,363 @@
+/*
+ * @brief LPC18xx/43xx SD/MMC block cache
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+static SDCACHE_LINE_T *cacheLines;
+static uint32_t cacheNumLines;
+static uint8_t *cacheStage;
+static uint32_t cacheStageBlocks;
+static uint32_t cacheNumBlocks;
+static SDCACHE_IO_T cacheIO;
+static uint32_t cacheStamp;
+static uint32_t cacheNextSeq;
+static SDCACHE_STATS_T cacheStats;
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Default block I/O, waits on the asynchronous driver by polling */
+STATIC Status cachePollIO(void *buffer, uint32_t block, uint32_t count, bool write)
+{
+	SDBLK_REQ_T req;
+
+	Chip_SDBLK_SetupReq(&req, buffer, block, count, write, NULL, NULL);
+	if (Chip_SDBLK_Submit(&req) != SUCCESS) {
+		return ERROR;
+	}
+	while (!Chip_SDBLK_IsDone(&req)) {
+		Chip_SDBLK_Poll();
+	}
+
+	return req.status;
+}
+
+/* Find the line holding a block */
+STATIC SDCACHE_LINE_T *cacheFind(uint32_t block)
+{
+	uint32_t i;
+
+	for (i = 0; i < cacheNumLines; i++) {
+		if (cacheLines[i].valid && (cacheLines[i].block == block)) {
+			return &cacheLines[i];
+		}
+	}
+
+	return NULL;
+}
+
+STATIC INLINE void cacheTouch(SDCACHE_LINE_T *pLine)
+{
+	pLine->lastUse = ++cacheStamp;
+}
+
+/* Write back the run of adjacent dirty blocks holding a line */
+STATIC Status cacheWriteRun(SDCACHE_LINE_T *pLine)
+{
+	SDCACHE_LINE_T *p;
+	uint32_t first = pLine->block, last = pLine->block;
+	uint32_t i, n;
+	uint8_t *data;
+
+	/* Grow the run while the neighbours are dirty and the stage has room */
+	while (last - first + 1 < cacheStageBlocks) {
+		if ((first > 0) && ((p = cacheFind(first - 1)) != NULL) && p->dirty) {
+			first--;
+		}
+		else if (((p = cacheFind(last + 1)) != NULL) && p->dirty) {
+			last++;
+		}
+		else {
+			break;
+		}
+	}
+	n = last - first + 1;
+
+	/* A single block goes straight from its line */
+	if (n == 1) {
+		data = pLine->data;
+	}
+	else {
+		data = cacheStage;
+		for (i = 0; i < n; i++) {
+			memcpy(&cacheStage[i * MMC_SECTOR_SIZE], cacheFind(first + i)->data, MMC_SECTOR_SIZE);
+		}
+	}
+
+	cacheStats.writeCmds++;
+	if (cacheIO(data, first, n, true) != SUCCESS) {
+		return ERROR;
+	}
+
+	for (i = 0; i < n; i++) {
+		cacheFind(first + i)->dirty = 0;
+	}
+	cacheStats.blocksWritten += n;
+
+	return SUCCESS;
+}
+
+/* Get a line for a block, evicting the least recently used one */
+STATIC SDCACHE_LINE_T *cacheAlloc(uint32_t block, bool writeBack)
+{
+	SDCACHE_LINE_T *pVictim = NULL;
+	uint32_t i;
+
+	for (i = 0; i < cacheNumLines; i++) {
+		SDCACHE_LINE_T *p = &cacheLines[i];
+
+		if (!p->valid) {
+			pVictim = p;
+			break;
+		}
+		if ((p->dirty && !writeBack) || (pVictim && (pVictim->lastUse <= p->lastUse))) {
+			continue;
+		}
+		pVictim = p;
+	}
+
+	if (pVictim == NULL) {
+		return NULL;
+	}
+	if (pVictim->valid && pVictim->dirty && (cacheWriteRun(pVictim) != SUCCESS)) {
+		return NULL;
+	}
+
+	pVictim->block = block;
+	pVictim->valid = 1;
+	pVictim->dirty = 0;
+	cacheTouch(pVictim);
+
+	return pVictim;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize the block cache */
+void Chip_SDCACHE_Init(SDCACHE_LINE_T *lines, void *lineData, uint32_t numLines,
+					   void *stage, uint32_t stageBlocks, uint32_t numBlocks, SDCACHE_IO_T io)
+{
+	uint32_t i;
+
+	cacheLines = lines;
+	cacheNumLines = numLines;
+	for (i = 0; i < numLines; i++) {
+		lines[i].valid = 0;
+		lines[i].dirty = 0;
+		lines[i].data = (uint8_t *) lineData + (i * MMC_SECTOR_SIZE);
+	}
+	cacheStage = stage;
+	cacheStageBlocks = stageBlocks;
+	cacheNumBlocks = numBlocks;
+	cacheIO = io ? io : cachePollIO;
+	cacheStamp = 0;
+	cacheNextSeq = 0xFFFFFFFF;
+	memset(&cacheStats, 0, sizeof(cacheStats));
+}
+
+/* Read blocks through the cache */
+Status Chip_SDCACHE_Read(void *buffer, uint32_t block, uint32_t count)
+{
+	uint8_t *dst = buffer;
+	bool sequential = (block == cacheNextSeq);
+	SDCACHE_LINE_T *p;
+	uint32_t i, run, ahead;
+
+	if ((count == 0) || (block + count > cacheNumBlocks)) {
+		return ERROR;
+	}
+	cacheNextSeq = block + count;
+
+	while (count > 0) {
+		p = cacheFind(block);
+		if (p) {
+			memcpy(dst, p->data, MMC_SECTOR_SIZE);
+			cacheTouch(p);
+			cacheStats.hits++;
+			dst += MMC_SECTOR_SIZE;
+			block++;
+			count--;
+			continue;
+		}
+
+		/* Read the uncached run with one command */
+		for (run = 1; (run < count) && (run < cacheStageBlocks) && !cacheFind(block + run); run++) {}
+
+		/* A stream that reaches its end is extended with the next blocks */
+		ahead = 0;
+		if (sequential && (run == count)) {
+			while ((ahead < SDCACHE_READAHEAD) && (run + ahead < cacheStageBlocks) &&
+				   (block + run + ahead < cacheNumBlocks) && !cacheFind(block + run + ahead)) {
+				ahead++;
+			}
+		}
+
+		cacheStats.readCmds++;
+		if (cacheIO(cacheStage, block, run + ahead, false) != SUCCESS) {
+			return ERROR;
+		}
+		cacheStats.misses += run;
+		cacheStats.readAhead += ahead;
+		memcpy(dst, cacheStage, run * MMC_SECTOR_SIZE);
+
+		/* Keep the blocks if clean lines are available, the stage is still in use */
+		for (i = 0; i < run + ahead; i++) {
+			p = cacheAlloc(block + i, false);
+			if (p == NULL) {
+				break;
+			}
+			memcpy(p->data, &cacheStage[i * MMC_SECTOR_SIZE], MMC_SECTOR_SIZE);
+		}
+
+		dst += run * MMC_SECTOR_SIZE;
+		block += run;
+		count -= run;
+	}
+
+	return SUCCESS;
+}
+
+/* Write blocks into the cache */
+Status Chip_SDCACHE_Write(const void *buffer, uint32_t block, uint32_t count)
+{
+	const uint8_t *src = buffer;
+	SDCACHE_LINE_T *p;
+	uint32_t i, n;
+	void *data;
+
+	if ((count == 0) || (block + count > cacheNumBlocks)) {
+		return ERROR;
+	}
+
+	/* Long writes go to the card directly, cached copies are refreshed */
+	if (count >= cacheStageBlocks) {
+		while (count > 0) {
+			n = (count < SDBLK_MAX_BLOCKS) ? count : SDBLK_MAX_BLOCKS;
+
+			/* The IDMAC only moves word aligned buffers */
+			if (((uint32_t) src & 3) != 0) {
+				if (n > cacheStageBlocks) {
+					n = cacheStageBlocks;
+				}
+				memcpy(cacheStage, src, n * MMC_SECTOR_SIZE);
+				data = cacheStage;
+			}
+			else {
+				data = (void *) src;
+			}
+
+			cacheStats.writeCmds++;
+			if (cacheIO(data, block, n, true) != SUCCESS) {
+				return ERROR;
+			}
+			cacheStats.blocksWritten += n;
+			for (i = 0; i < n; i++) {
+				p = cacheFind(block + i);
+				if (p) {
+					memcpy(p->data, &src[i * MMC_SECTOR_SIZE], MMC_SECTOR_SIZE);
+					p->dirty = 0;
+				}
+			}
+			src += n * MMC_SECTOR_SIZE;
+			block += n;
+			count -= n;
+		}
+		return SUCCESS;
+	}
+
+	for (i = 0; i < count; i++) {
+		p = cacheFind(block + i);
+		if (p == NULL) {
+			p = cacheAlloc(block + i, true);
+			if (p == NULL) {
+				return ERROR;
+			}
+		}
+		memcpy(p->data, &src[i * MMC_SECTOR_SIZE], MMC_SECTOR_SIZE);
+		p->dirty = 1;
+		cacheTouch(p);
+	}
+
+	return SUCCESS;
+}
+
+/* Write all dirty blocks back to the card */
+Status Chip_SDCACHE_Flush(void)
+{
+	SDCACHE_LINE_T *pLowest;
+	uint32_t i;
+
+	/* Lowest dirty block first so every run only grows upwards */
+	do {
+		pLowest = NULL;
+		for (i = 0; i < cacheNumLines; i++) {
+			if (cacheLines[i].valid && cacheLines[i].dirty &&
+				((pLowest == NULL) || (cacheLines[i].block < pLowest->block))) {
+				pLowest = &cacheLines[i];
+			}
+		}
+		if (pLowest && (cacheWriteRun(pLowest) != SUCCESS)) {
+			return ERROR;
+		}
+	} while (pLowest);
+
+	return SUCCESS;
+}
+
+/* Drop all cached blocks without writing them back */
+void Chip_SDCACHE_Invalidate(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < cacheNumLines; i++) {
+		cacheLines[i].valid = 0;
+		cacheLines[i].dirty = 0;
+	}
+	cacheNextSeq = 0xFFFFFFFF;
+}
+
+/* Return the cache statistics */
+SDCACHE_STATS_T *Chip_SDCACHE_GetStats(void)
+{
+	return &cacheStats;
+}
@@ -0,0 +1,470 @@
+/*
+ * @brief LPC18xx/43xx append-only record log on SD/MMC
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+#include <string.h>
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define SDLOG_PAGE_MAGIC    0x474F4C53	/* "SLOG" */
+#define SDLOG_CP_MAGIC      0x50434C53	/* "SLCP" */
+#define SDLOG_PAGE_SEALED   (1 << 0)	/* Page is full, the next page follows */
+#define SDLOG_CP_BLOCKS     2			/* Checkpoints alternate between two blocks */
+#define SDLOG_TAIL_BLOCKS   2			/* Synced partial pages alternate between two blocks */
+
+/* Page header, followed by the records */
+typedef struct {
+	uint32_t magic;
+	uint32_t epoch;
+	uint32_t seq;
+	uint32_t firstTs;
+	uint32_t lastTs;
+	uint16_t count;
+	uint16_t used;		/* Record bytes after the header */
+	uint16_t flags;
+	uint16_t syncs;		/* Partial copies written, picks the newest tail slot */
+	uint32_t crc;
+} SDLOG_PAGE_HDR_T;
+
+/* Checkpoint block */
+typedef struct {
+	uint32_t magic;
+	uint32_t epoch;
+	uint32_t gen;
+	uint32_t headPage;
+	uint32_t headSeq;
+	uint32_t lastTs;
+	uint32_t crc;
+} SDLOG_CP_T;
+
+/* CRC-32 (IEEE 802.3), four bits at a time */
+static const uint32_t sdlogCrcTable[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C
+};
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC uint32_t sdlogCrc(const void *data, uint32_t len)
+{
+	const uint8_t *p = data;
+	uint32_t crc = 0xFFFFFFFF;
+
+	while (len--) {
+		crc ^= *p++;
+		crc = (crc >> 4) ^ sdlogCrcTable[crc & 0xF];
+		crc = (crc >> 4) ^ sdlogCrcTable[crc & 0xF];
+	}
+
+	return ~crc;
+}
+
+STATIC INLINE uint32_t sdlogNumPages(SDLOG_T *pLog)
+{
+	return pLog->segPages * SDLOG_MAX_SEGMENTS;
+}
+
+STATIC INLINE uint32_t sdlogTailBlock(SDLOG_T *pLog, uint32_t slot)
+{
+	return pLog->base + SDLOG_CP_BLOCKS + slot;
+}
+
+STATIC INLINE uint32_t sdlogPageBlock(SDLOG_T *pLog, uint32_t page)
+{
+	return pLog->base + SDLOG_CP_BLOCKS + SDLOG_TAIL_BLOCKS + page;
+}
+
+/* CRC of a page, computed with the CRC field cleared */
+STATIC uint32_t sdlogPageCrc(SDLOG_PAGE_HDR_T *pHdr)
+{
+	uint32_t crc, saved = pHdr->crc;
+
+	pHdr->crc = 0;
+	crc = sdlogCrc(pHdr, SDLOG_PAGE_HDR_SIZE + pHdr->used);
+	pHdr->crc = saved;
+
+	return crc;
+}
+
+/* Check that a page read from the card belongs to this log */
+STATIC bool sdlogPageValid(SDLOG_T *pLog, SDLOG_PAGE_HDR_T *pHdr)
+{
+	return (pHdr->magic == SDLOG_PAGE_MAGIC) && (pHdr->epoch == pLog->epoch) &&
+		   (pHdr->used <= MMC_SECTOR_SIZE - SDLOG_PAGE_HDR_SIZE) && (sdlogPageCrc(pHdr) == pHdr->crc);
+}
+
+STATIC Status sdlogRead(SDLOG_T *pLog, void *buffer, uint32_t block)
+{
+	pLog->stats.blocksRead++;
+	return pLog->io(buffer, block, 1, false);
+}
+
+STATIC Status sdlogWrite(SDLOG_T *pLog, void *buffer, uint32_t block)
+{
+	pLog->stats.blocksWritten++;
+	return pLog->io(buffer, block, 1, true);
+}
+
+/* Start an empty page at the head position */
+STATIC void sdlogResetPage(SDLOG_T *pLog)
+{
+	SDLOG_PAGE_HDR_T *pHdr = (SDLOG_PAGE_HDR_T *) pLog->page;
+
+	memset(pHdr, 0, SDLOG_PAGE_HDR_SIZE);
+	pHdr->magic = SDLOG_PAGE_MAGIC;
+	pHdr->epoch = pLog->epoch;
+	pHdr->seq = pLog->headSeq;
+}
+
+/* Store the write position in the next checkpoint slot */
+STATIC Status sdlogWriteCheckpoint(SDLOG_T *pLog)
+{
+	SDLOG_CP_T *pCp = (SDLOG_CP_T *) pLog->scratch;
+
+	memset(pLog->scratch, 0, sizeof(pLog->scratch));
+	pLog->cpGen++;
+	pCp->magic = SDLOG_CP_MAGIC;
+	pCp->epoch = pLog->epoch;
+	pCp->gen = pLog->cpGen;
+	pCp->headPage = pLog->headPage;
+	pCp->headSeq = pLog->headSeq;
+	pCp->lastTs = pLog->lastTs;
+	pCp->crc = sdlogCrc(pCp, sizeof(*pCp) - sizeof(pCp->crc));
+
+	return sdlogWrite(pLog, pLog->scratch, pLog->base + (pLog->cpGen & 1));
+}
+
+/* Write the page being filled, sealed pages are followed by a fresh one.
+   A partial page goes to the tail slot not holding its previous copy, so a
+   torn write never destroys synced records. Its own block is only written
+   once, sealed. */
+STATIC Status sdlogWritePage(SDLOG_T *pLog, bool seal)
+{
+	SDLOG_PAGE_HDR_T *pHdr = (SDLOG_PAGE_HDR_T *) pLog->page;
+	SDLOG_SEG_T *pSeg = &pLog->seg[pLog->headPage / pLog->segPages];
+	uint32_t block;
+
+	if (seal) {
+		pHdr->flags |= SDLOG_PAGE_SEALED;
+		block = sdlogPageBlock(pLog, pLog->headPage);
+	}
+	else {
+		pHdr->syncs++;
+		block = sdlogTailBlock(pLog, pHdr->syncs % SDLOG_TAIL_BLOCKS);
+	}
+	pHdr->crc = sdlogPageCrc(pHdr);
+	if (sdlogWrite(pLog, pLog->page, block) != SUCCESS) {
+		return ERROR;
+	}
+
+	/* First page of a segment opens its index entry */
+	if ((pLog->headPage % pLog->segPages) == 0) {
+		pSeg->firstSeq = pHdr->seq;
+		pSeg->firstTs = pHdr->firstTs;
+		pSeg->valid = 1;
+	}
+	if (!seal) {
+		return SUCCESS;
+	}
+
+	pLog->headPage = (pLog->headPage + 1) % sdlogNumPages(pLog);
+	pLog->headSeq++;
+	sdlogResetPage(pLog);
+
+	/* Entering a segment drops its old pages and moves the checkpoint */
+	if ((pLog->headPage % pLog->segPages) == 0) {
+		pLog->seg[pLog->headPage / pLog->segPages].valid = 0;
+		return sdlogWriteCheckpoint(pLog);
+	}
+
+	return SUCCESS;
+}
+
+/* Set the geometry of the log range */
+STATIC Status sdlogSetup(SDLOG_T *pLog, uint32_t firstBlock, uint32_t numBlocks, SDLOG_IO_T io)
+{
+	if (numBlocks < SDLOG_CP_BLOCKS + SDLOG_TAIL_BLOCKS + SDLOG_MAX_SEGMENTS) {
+		return ERROR;
+	}
+
+	memset(pLog, 0, sizeof(*pLog));
+	pLog->io = io;
+	pLog->base = firstBlock;
+	pLog->segPages = (numBlocks - SDLOG_CP_BLOCKS - SDLOG_TAIL_BLOCKS) / SDLOG_MAX_SEGMENTS;
+
+	return SUCCESS;
+}
+
+/* Read the newest valid checkpoint, NULL if there is none */
+STATIC SDLOG_CP_T *sdlogReadCheckpoint(SDLOG_T *pLog, SDLOG_CP_T *pCp)
+{
+	SDLOG_CP_T *pBest = NULL;
+	uint32_t i;
+
+	for (i = 0; i < SDLOG_CP_BLOCKS; i++) {
+		SDLOG_CP_T *pRead = (SDLOG_CP_T *) pLog->scratch;
+
+		if ((sdlogRead(pLog, pLog->scratch, pLog->base + i) != SUCCESS) || (pRead->magic != SDLOG_CP_MAGIC) ||
+			(pRead->crc != sdlogCrc(pRead, sizeof(*pRead) - sizeof(pRead->crc)))) {
+			continue;
+		}
+		if ((pBest == NULL) || ((int32_t) (pRead->gen - pBest->gen) > 0)) {
+			*pCp = *pRead;
+			pBest = pCp;
+		}
+	}
+
+	return pBest;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Create an empty log over a range of blocks */
+Status Chip_SDLOG_Format(SDLOG_T *pLog, uint32_t firstBlock, uint32_t numBlocks, SDLOG_IO_T io)
+{
+	SDLOG_CP_T cp;
+	uint32_t epoch = 1;
+
+	if (sdlogSetup(pLog, firstBlock, numBlocks, io) != SUCCESS) {
+		return ERROR;
+	}
+
+	/* A new epoch keeps pages of an older log from being recovered */
+	if (sdlogReadCheckpoint(pLog, &cp)) {
+		epoch = cp.epoch + 1;
+	}
+	pLog->epoch = epoch;
+	pLog->headSeq = 1;
+	sdlogResetPage(pLog);
+
+	/* Both slots, so the older epoch can never win */
+	if (sdlogWriteCheckpoint(pLog) != SUCCESS) {
+		return ERROR;
+	}
+	return sdlogWriteCheckpoint(pLog);
+}
+
+/* Open an existing log and recover its write position */
+Status Chip_SDLOG_Mount(SDLOG_T *pLog, uint32_t firstBlock, uint32_t numBlocks, SDLOG_IO_T io)
+{
+	SDLOG_PAGE_HDR_T *pHdr = (SDLOG_PAGE_HDR_T *) pLog->scratch;
+	SDLOG_PAGE_HDR_T *pPage = (SDLOG_PAGE_HDR_T *) pLog->page;
+	SDLOG_SEG_T *pSeg;
+	SDLOG_CP_T cp;
+	bool found;
+	uint32_t i;
+
+	if (sdlogSetup(pLog, firstBlock, numBlocks, io) != SUCCESS) {
+		return ERROR;
+	}
+	if ((sdlogReadCheckpoint(pLog, &cp) == NULL) || (cp.headPage >= sdlogNumPages(pLog))) {
+		return ERROR;
+	}
+	pLog->epoch = cp.epoch;
+	pLog->cpGen = cp.gen;
+	pLog->headPage = cp.headPage;
+	pLog->headSeq = cp.headSeq;
+	pLog->lastTs = cp.lastTs;
+
+	/* Follow the sealed pages written since the checkpoint */
+	for (i = 0; i < sdlogNumPages(pLog); i++) {
+		if ((sdlogRead(pLog, pLog->scratch, sdlogPageBlock(pLog, pLog->headPage)) != SUCCESS) ||
+			!sdlogPageValid(pLog, pHdr) || (pHdr->seq != pLog->headSeq) ||
+			!(pHdr->flags & SDLOG_PAGE_SEALED)) {
+			break;
+		}
+		pLog->stats.scanned++;
+		if (pHdr->count) {
+			pLog->lastTs = pHdr->lastTs;
+		}
+		pLog->headPage = (pLog->headPage + 1) % sdlogNumPages(pLog);
+		pLog->headSeq++;
+	}
+
+	/* Keep filling a partly written page from its newest tail copy */
+	sdlogResetPage(pLog);
+	found = false;
+	for (i = 0; i < SDLOG_TAIL_BLOCKS; i++) {
+		if ((sdlogRead(pLog, pLog->scratch, sdlogTailBlock(pLog, i)) == SUCCESS) &&
+			sdlogPageValid(pLog, pHdr) && (pHdr->seq == pLog->headSeq) && !(pHdr->flags & SDLOG_PAGE_SEALED) &&
+			(!found || ((int16_t) (pHdr->syncs - pPage->syncs) > 0))) {
+			memcpy(pLog->page, pLog->scratch, sizeof(pLog->page));
+			found = true;
+		}
+	}
+	if (pPage->count) {
+		pLog->lastTs = pPage->lastTs;
+	}
+
+	/* Rebuild the segment index from the first page of each segment */
+	for (i = 0; i < SDLOG_MAX_SEGMENTS; i++) {
+		SDLOG_SEG_T *pSeg = &pLog->seg[i];
+
+		pSeg->valid = 0;
+		if ((sdlogRead(pLog, pLog->scratch, sdlogPageBlock(pLog, i * pLog->segPages)) == SUCCESS) &&
+			sdlogPageValid(pLog, pHdr) && ((int32_t) (pHdr->seq - pLog->headSeq) <= 0)) {
+			pSeg->firstSeq = pHdr->seq;
+			pSeg->firstTs = pHdr->firstTs;
+			pSeg->valid = 1;
+		}
+	}
+
+	/* The head segment restarts when the head is on its first page, whose
+	   block still holds an older page */
+	if ((pLog->headPage % pLog->segPages) == 0) {
+		pSeg = &pLog->seg[pLog->headPage / pLog->segPages];
+		pSeg->firstSeq = pPage->seq;
+		pSeg->firstTs = pPage->firstTs;
+		pSeg->valid = (pPage->count != 0);
+	}
+
+	return SUCCESS;
+}
+
+/* Append a record */
+Status Chip_SDLOG_Append(SDLOG_T *pLog, uint32_t ts, const void *data, uint32_t len)
+{
+	SDLOG_PAGE_HDR_T *pHdr = (SDLOG_PAGE_HDR_T *) pLog->page;
+	uint8_t *pRec;
+	uint16_t len16 = (uint16_t) len;
+
+	if ((len > SDLOG_MAX_RECORD) || (ts < pLog->lastTs)) {
+		return ERROR;
+	}
+
+	if (SDLOG_PAGE_HDR_SIZE + pHdr->used + SDLOG_REC_HDR_SIZE + len > MMC_SECTOR_SIZE) {
+		if (sdlogWritePage(pLog, true) != SUCCESS) {
+			return ERROR;
+		}
+	}
+
+	pRec = (uint8_t *) pLog->page + SDLOG_PAGE_HDR_SIZE + pHdr->used;
+	memcpy(pRec, &ts, 4);
+	memcpy(pRec + 4, &len16, 2);
+	memcpy(pRec + SDLOG_REC_HDR_SIZE, data, len);
+
+	if (pHdr->count == 0) {
+		pHdr->firstTs = ts;
+	}
+	pHdr->lastTs = ts;
+	pHdr->count++;
+	pHdr->used += SDLOG_REC_HDR_SIZE + len;
+	pLog->lastTs = ts;
+	pLog->stats.records++;
+	pLog->stats.recordBytes += len;
+
+	return SUCCESS;
+}
+
+/* Write the page being filled to the card */
+Status Chip_SDLOG_Sync(SDLOG_T *pLog)
+{
+	if (((SDLOG_PAGE_HDR_T *) pLog->page)->count == 0) {
+		return SUCCESS;
+	}
+
+	return sdlogWritePage(pLog, false);
+}
+
+/* Read the records of a time range, oldest first */
+Status Chip_SDLOG_ReadRange(SDLOG_T *pLog, uint32_t tsFrom, uint32_t tsTo, SDLOG_RECORD_CB_T cb, void *arg)
+{
+	SDLOG_PAGE_HDR_T *pHdr;
+	uint32_t headSeg = pLog->headPage / pLog->segPages;
+	uint32_t n, s, next, k, page, off, ts;
+	uint16_t len;
+	uint8_t *pRec;
+
+	/* The oldest segment follows the one being written */
+	for (n = 1; n <= SDLOG_MAX_SEGMENTS; n++) {
+		s = (headSeg + n) % SDLOG_MAX_SEGMENTS;
+		if (!pLog->seg[s].valid) {
+			continue;
+		}
+		if (pLog->seg[s].firstTs > tsTo) {
+			break;
+		}
+
+		/* Every record of the segment is older than the next segment start */
+		next = (s + 1) % SDLOG_MAX_SEGMENTS;
+		if ((n < SDLOG_MAX_SEGMENTS) && pLog->seg[next].valid && (pLog->seg[next].firstTs < tsFrom)) {
+			continue;
+		}
+
+		for (k = 0; k < pLog->segPages; k++) {
+			page = (s * pLog->segPages) + k;
+			if (page == pLog->headPage) {
+				/* Newest records are still in RAM */
+				pHdr = (SDLOG_PAGE_HDR_T *) pLog->page;
+			}
+			else {
+				pHdr = (SDLOG_PAGE_HDR_T *) pLog->scratch;
+				if (sdlogRead(pLog, pLog->scratch, sdlogPageBlock(pLog, page)) != SUCCESS) {
+					return ERROR;
+				}
+
+				/* Older pages of a segment being rewritten end it */
+				if (!sdlogPageValid(pLog, pHdr) || (pHdr->seq != pLog->seg[s].firstSeq + k)) {
+					break;
+				}
+			}
+
+			if (pHdr->count && (pHdr->firstTs > tsTo)) {
+				return SUCCESS;
+			}
+			if (pHdr->count && (pHdr->lastTs >= tsFrom)) {
+				for (off = 0; off < pHdr->used; off += SDLOG_REC_HDR_SIZE + len) {
+					pRec = (uint8_t *) pHdr + SDLOG_PAGE_HDR_SIZE + off;
+					memcpy(&ts, pRec, 4);
+					memcpy(&len, pRec + 4, 2);
+					if ((ts >= tsFrom) && (ts <= tsTo)) {
+						cb(ts, pRec + SDLOG_REC_HDR_SIZE, len, arg);
+					}
+				}
+			}
+			if (page == pLog->headPage) {
+				return SUCCESS;
+			}
+		}
+	}
+
+	return SUCCESS;
+}
@@ -0,0 +1,265 @@
+/*
+ * @brief LPC18xx/43xx SSP DMA transaction queue driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "chip.h"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Public types/enumerations/variables
+ ****************************************************************************/
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+STATIC void sspDMADone(GPDMAMGR_REQ_T *pReq);
+
+STATIC INLINE uint32_t sspEnterCritical(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+	return primask;
+}
+
+STATIC INLINE void sspExitCritical(uint32_t primask)
+{
+	__set_PRIMASK(primask);
+}
+
+/* Build a descriptor chain between memory and the SSP data register */
+STATIC void sspBuildDesc(DMA_TransferDescriptor_t *pDesc, uint32_t mem, bool memInc,
+						 uint32_t periph, bool toPeriph, uint32_t len, uint32_t width)
+{
+	uint32_t ctrl, cnt;
+	int i;
+
+	ctrl = GPDMA_DMACCxControl_SBSize(GPDMA_BSIZE_4)
+		   | GPDMA_DMACCxControl_DBSize(GPDMA_BSIZE_4)
+		   | GPDMA_DMACCxControl_SWidth(width)
+		   | GPDMA_DMACCxControl_DWidth(width);
+	if (toPeriph) {
+		ctrl |= GPDMA_DMACCxControl_DestTransUseAHBMaster1 | (memInc ? GPDMA_DMACCxControl_SI : 0);
+	}
+	else {
+		ctrl |= GPDMA_DMACCxControl_SrcTransUseAHBMaster1 | (memInc ? GPDMA_DMACCxControl_DI : 0);
+	}
+
+	for (i = 0; len > 0; i++) {
+		cnt = (len > 0xFFF) ? 0xFFF : len;
+		pDesc[i].src = toPeriph ? mem : periph;
+		pDesc[i].dst = toPeriph ? periph : mem;
+		pDesc[i].lli = 0;
+		pDesc[i].ctrl = ctrl | GPDMA_DMACCxControl_TransferSize(cnt);
+		if (i > 0) {
+			pDesc[i - 1].lli = (uint32_t) &pDesc[i];
+		}
+		if (memInc) {
+			mem += cnt << width;
+		}
+		len -= cnt;
+	}
+
+	/* Interrupt only after the last descriptor */
+	pDesc[i - 1].ctrl |= GPDMA_DMACCxControl_I;
+}
+
+/* Start the transaction at the head of the queue */
+STATIC void sspStart(SSPDMA_HANDLE_T *pHandle)
+{
+	SSPDMA_XFER_T *pXfer = pHandle->pHead;
+	LPC_SSP_T *pSSP = pHandle->pSSP;
+	uint32_t width, periph = (uint32_t) &pSSP->DR;
+
+	pHandle->savedCR0 = pSSP->CR0;
+	if (pXfer->cr0) {
+		pSSP->CR0 = pXfer->cr0;
+	}
+	width = (Chip_SSP_GetDataSize(pSSP) > 7) ? GPDMA_WIDTH_HALFWORD : GPDMA_WIDTH_BYTE;
+
+	/* Drop stale frames so the receive side stays in step */
+	Chip_SSP_Int_FlushData(pSSP);
+
+	if (pHandle->csCb) {
+		pHandle->csCb(pXfer->cs, true);
+	}
+
+	if (pXfer->rx) {
+		sspBuildDesc(pHandle->rxDesc, (uint32_t) pXfer->rx, true, periph, false, pXfer->len, width);
+	}
+	else {
+		sspBuildDesc(pHandle->rxDesc, (uint32_t) &pHandle->dummyRx, false, periph, false, pXfer->len, width);
+	}
+	if (pXfer->tx) {
+		sspBuildDesc(pHandle->txDesc, (uint32_t) pXfer->tx, true, periph, true, pXfer->len, width);
+	}
+	else {
+		sspBuildDesc(pHandle->txDesc, (uint32_t) &pHandle->dummyTx, false, periph, true, pXfer->len, width);
+	}
+
+	pHandle->pending = 2;
+	pHandle->dmaStatus = SUCCESS;
+	pHandle->stats.startTick = DWT->CYCCNT;
+	Chip_SSP_DMA_Enable(pSSP);
+
+	/* Receive first so no frame is missed once transmit starts */
+	Chip_GPDMAMGR_SetupReq(&pHandle->rxReq, pHandle->rxDesc, GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA,
+						   pHandle->rxConn, GPDMA_CONN_MEMORY, pHandle->priority, sspDMADone, pHandle);
+	Chip_GPDMAMGR_SetupReq(&pHandle->txReq, pHandle->txDesc, GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA,
+						   GPDMA_CONN_MEMORY, pHandle->txConn, pHandle->priority, sspDMADone, pHandle);
+	Chip_GPDMAMGR_Submit(&pHandle->rxReq);
+	Chip_GPDMAMGR_Submit(&pHandle->txReq);
+}
+
+/* Complete the running transaction and start the next one */
+STATIC void sspFinish(SSPDMA_HANDLE_T *pHandle)
+{
+	SSPDMA_XFER_T *pXfer = pHandle->pHead;
+	SSPDMA_XFER_T *pNext;
+	Status status = pHandle->dmaStatus;
+	uint32_t primask;
+
+	if (pHandle->csCb) {
+		pHandle->csCb(pXfer->cs, false);
+	}
+	if (pXfer->cr0) {
+		pHandle->pSSP->CR0 = pHandle->savedCR0;
+	}
+
+	pHandle->stats.busyTicks += DWT->CYCCNT - pHandle->stats.startTick;
+	if (status == SUCCESS) {
+		pHandle->stats.xfers++;
+		pHandle->stats.frames += pXfer->len;
+	}
+	else {
+		pHandle->stats.errors++;
+	}
+
+	primask = sspEnterCritical();
+	pNext = pHandle->pHead = pXfer->next;
+	if (pNext == NULL) {
+		pHandle->pTail = NULL;
+		Chip_SSP_DMA_Disable(pHandle->pSSP);
+	}
+	sspExitCritical(primask);
+
+	/* Chain the next transaction before notifying, this resets dmaStatus */
+	if (pNext) {
+		sspStart(pHandle);
+	}
+
+	pXfer->status = status;
+	pXfer->done = 1;
+	if (pXfer->cb) {
+		pXfer->cb(pXfer);
+	}
+}
+
+/* Completion of one DMA direction, called by the channel manager */
+STATIC void sspDMADone(GPDMAMGR_REQ_T *pReq)
+{
+	SSPDMA_HANDLE_T *pHandle = (SSPDMA_HANDLE_T *) pReq->cbData;
+
+	if (pReq->status != SUCCESS) {
+		pHandle->dmaStatus = ERROR;
+		if (--pHandle->pending != 0) {
+			/* The other direction would wait forever, stop it */
+			Chip_GPDMAMGR_Cancel((pReq == &pHandle->txReq) ? &pHandle->rxReq : &pHandle->txReq);
+			return;
+		}
+	}
+	else if (--pHandle->pending != 0) {
+		return;
+	}
+
+	sspFinish(pHandle);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Initialize an SSP DMA handle */
+void Chip_SSPDMA_Init(SSPDMA_HANDLE_T *pHandle, LPC_SSP_T *pSSP, uint8_t priority, SSPDMA_CS_CALLBACK_T csCb)
+{
+	pHandle->pSSP = pSSP;
+	if (pSSP == LPC_SSP0) {
+		pHandle->txConn = GPDMA_CONN_SSP0_Tx;
+		pHandle->rxConn = GPDMA_CONN_SSP0_Rx;
+	}
+	else {
+		pHandle->txConn = GPDMA_CONN_SSP1_Tx;
+		pHandle->rxConn = GPDMA_CONN_SSP1_Rx;
+	}
+	pHandle->priority = priority;
+	pHandle->csCb = csCb;
+	pHandle->pHead = pHandle->pTail = NULL;
+	pHandle->dummyTx = 0xFFFF;
+	pHandle->stats.xfers = 0;
+	pHandle->stats.frames = 0;
+	pHandle->stats.errors = 0;
+	pHandle->stats.busyTicks = 0;
+}
+
+/* Queue a transaction */
+Status Chip_SSPDMA_Submit(SSPDMA_HANDLE_T *pHandle, SSPDMA_XFER_T *pXfer)
+{
+	uint32_t primask;
+	bool start;
+
+	if ((pXfer->len == 0) || (pXfer->len > SSPDMA_MAX_FRAMES)) {
+		return ERROR;
+	}
+
+	pXfer->done = 0;
+	pXfer->status = SUCCESS;
+	pXfer->next = NULL;
+
+	primask = sspEnterCritical();
+	if (pHandle->pTail) {
+		pHandle->pTail->next = pXfer;
+	}
+	else {
+		pHandle->pHead = pXfer;
+	}
+	pHandle->pTail = pXfer;
+	start = (pHandle->pHead == pXfer);
+	sspExitCritical(primask);
+
+	if (start) {
+		sspStart(pHandle);
+	}
+
+	return SUCCESS;
+}
@@ -51,6 +51,9 @@ static const CHIP_CCU_CLK_T UART_PClock[] = {CLK_MX_UART0, CLK_MX_UART1, CLK_MX_
 /* UART Bus clocks */
 static const CHIP_CCU_CLK_T UART_BClock[] = {CLK_APB0_UART0, CLK_APB0_UART1, CLK_APB2_UART2, CLK_APB2_UART3};
 
+/* Receive FIFO trigger levels in characters, indexed by UART_FCR_TRG_LEVx >> 6 */
+static const uint8_t UART_RxTrigChars[] = {1, 4, 8, 14};
+
 /* Returns clock index for the peripheral block */
 static int Chip_UART_GetIndex(LPC_USART_T *pUART)
 {
@@ -147,15 +150,20 @@ void Chip_UART_DeInit(LPC_USART_T *pUART)
 /* Transmit a byte array through the UART peripheral (non-blocking) */
 int Chip_UART_Send(LPC_USART_T *pUART, const void *data, int numBytes)
 {
-	int sent = 0;
+	int burst, sent = 0;
 	uint8_t *p8 = (uint8_t *) data;
 
-	/* Send until the transmit FIFO is full or out of bytes */
+	/* THRE means the whole transmit FIFO is empty, fill it in one go */
 	while ((sent < numBytes) &&
 		   ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0)) {
-		Chip_UART_SendByte(pUART, *p8);
-		p8++;
-		sent++;
+		burst = numBytes - sent;
+		if (burst > UART_TX_FIFO_SIZE) {
+			burst = UART_TX_FIFO_SIZE;
+		}
+		sent += burst;
+		while (burst-- > 0) {
+			Chip_UART_SendByte(pUART, *p8++);
+		}
 	}
 
 	return sent;
@@ -246,22 +254,32 @@ uint32_t Chip_UART_SetBaud(LPC_USART_T *pUART, uint32_t baudrate)
 /* UART receive-only interrupt handler for ring buffers */
 void Chip_UART_RXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
+	uint8_t chunk[UART_RX_FIFO_SIZE];
+	int num;
+
 	/* New data will be ignored if data not popped in time */
-	while (Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) {
-		uint8_t ch = Chip_UART_ReadByte(pUART);
-		RingBuffer_Insert(pRB, &ch);
-	}
+	do {
+		num = 0;
+		while ((num < UART_RX_FIFO_SIZE) &&
+			   ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_RDR) != 0)) {
+			chunk[num++] = Chip_UART_ReadByte(pUART);
+		}
+		RingBuffer_InsertMult(pRB, chunk, num);
+	} while (num == UART_RX_FIFO_SIZE);
 }
 
 /* UART transmit-only interrupt handler for ring buffers */
 void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
 {
-	uint8_t ch;
-
-	/* Fill FIFO until full or until TX ring buffer is empty */
-	while ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0 &&
-		   RingBuffer_Pop(pRB, &ch)) {
-		Chip_UART_SendByte(pUART, ch);
+	uint8_t chunk[UART_TX_FIFO_SIZE];
+	int i, num;
+
+	/* Refill the whole FIFO each time it drains, until the TX ring buffer is empty */
+	if ((Chip_UART_ReadLineStatus(pUART) & UART_LSR_THRE) != 0) {
+		num = RingBuffer_PopMult(pRB, chunk, UART_TX_FIFO_SIZE);
+		for (i = 0; i < num; i++) {
+			Chip_UART_SendByte(pUART, chunk[i]);
+		}
 	}
 
 	/* Turn off interrupt if the ring buffer is empty */
@@ -321,6 +339,51 @@ void Chip_UART_IRQRBHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *p
     Chip_UART_ABIntHandler(pUART);
 }
 
+/* UART FIFO interrupt handler for ring buffers */
+void Chip_UART_IRQRBFIFOHandler(LPC_USART_T *pUART, RINGBUFF_T *pRXRB, RINGBUFF_T *pTXRB, uint32_t rxTrig)
+{
+	uint8_t chunk[UART_RX_FIFO_SIZE];
+	uint32_t iir;
+	int i, num;
+
+	num = UART_RxTrigChars[(rxTrig & UART_FCR_TRG_LEV3) >> 6];
+
+	/* Service interrupts in IIR priority order until none are pending */
+	while (((iir = Chip_UART_ReadIntIDReg(pUART)) & UART_IIR_INTSTAT_PEND) == 0) {
+		switch (iir & UART_IIR_INTID_MASK) {
+		case UART_IIR_INTID_RLS:
+			/* Reading LSR clears the error, the data stays in the FIFO */
+			Chip_UART_ReadLineStatus(pUART);
+			break;
+
+		case UART_IIR_INTID_RDA:
+			/* At least the trigger level is in the FIFO, no need to poll RDR */
+			for (i = 0; i < num; i++) {
+				chunk[i] = Chip_UART_ReadByte(pUART);
+			}
+			RingBuffer_InsertMult(pRXRB, chunk, num);
+			break;
+
+		case UART_IIR_INTID_CTI:
+			/* Fewer than the trigger level left and the line went idle */
+			Chip_UART_RXIntHandlerRB(pUART, pRXRB);
+			break;
+
+		case UART_IIR_INTID_THRE:
+			Chip_UART_TXIntHandlerRB(pUART, pTXRB);
+			break;
+
+		default:
+			/* Modem status, cleared by reading MSR */
+			Chip_UART_ReadModemStatus(pUART);
+			break;
+		}
+	}
+
+	/* Handle Autobaud interrupts */
+	Chip_UART_ABIntHandler(pUART);
+}
+
 /* Determines and sets best dividers to get a target baud rate */
 uint32_t Chip_UART_SetBaudFDR(LPC_USART_T *pUART, uint32_t baud)
 {
@@ -0,0 +1,230 @@
+/*
+ * @brief Host register model of the LPC18xx/43xx GPDMA
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __GPDMA_MODEL_H_
+#define __GPDMA_MODEL_H_
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* The model runs a channel's whole descriptor chain in one step, then raises
+   its terminal count (or error) interrupt and calls the manager's handler,
+   like DMA_IRQHandler() does on target. Descriptor and buffer addresses are
+   32 bit, so tests keep them in static storage and link with -no-pie.
+
+   One peripheral data register can be attached with hostAttachFifo(): reads
+   of it pop and writes push a loopback FIFO, so a transmit and a receive
+   channel on it see each other's frames. A channel reading the FIFO stalls
+   until the whole transfer is available. */
+
+#define HOST_REG(r)         (*(volatile uint32_t *) &(r))
+
+#define HOST_FIFO_SIZE      (1 << 16)
+
+LPC_GPDMA_T hostGPDMA;
+
+static uint32_t hostFifoAddr;
+static uint16_t hostFifo[HOST_FIFO_SIZE];
+static uint32_t hostFifoHead, hostFifoTail;
+
+/* Channels that end their next run with a bus error instead of moving data */
+static uint8_t hostFailMask;
+
+/* Interrupts taken by the model */
+static uint32_t hostIRQs;
+
+static void hostAttachFifo(volatile void *pReg)
+{
+	hostFifoAddr = (uint32_t) (uintptr_t) pReg;
+	hostFifoHead = hostFifoTail = 0;
+}
+
+static uint32_t hostFifoCount(void)
+{
+	return hostFifoHead - hostFifoTail;
+}
+
+static void hostFifoFlush(void)
+{
+	hostFifoTail = hostFifoHead;
+}
+
+/* The enabled channels register follows the channel enable bits */
+static void hostSyncEnabled(void)
+{
+	uint32_t en = 0;
+	int ch;
+
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		if (hostGPDMA.CH[ch].CONFIG & GPDMA_DMACCxConfig_E) {
+			en |= 1 << ch;
+		}
+	}
+	HOST_REG(hostGPDMA.ENBLDCHNS) = en;
+}
+
+/* Enabled channels as the hardware would report them now */
+static uint32_t hostEnabled(void)
+{
+	hostSyncEnabled();
+	return hostGPDMA.ENBLDCHNS;
+}
+
+/* Chip_GPDMA_ChannelCmd() as seen by the drivers under test, the enabled
+   channels register changes at once like on the hardware */
+static void hostChannelCmd(LPC_GPDMA_T *pGPDMA, uint8_t channelNum, FunctionalState NewState)
+{
+	Chip_GPDMA_ChannelCmd(pGPDMA, channelNum, NewState);
+	hostSyncEnabled();
+}
+
+/* Number of items the chain of a channel reads from the FIFO */
+static uint32_t hostFifoNeed(const GPDMA_CH_T *pCh)
+{
+	uint32_t need = 0, src = pCh->SRCADDR, ctrl = pCh->CONTROL, lli = pCh->LLI;
+	const DMA_TransferDescriptor_t *pDesc;
+
+	while (1) {
+		if (src == hostFifoAddr) {
+			need += ctrl & 0xFFF;
+		}
+		if (lli == 0) {
+			return need;
+		}
+		pDesc = (const DMA_TransferDescriptor_t *) (uintptr_t) lli;
+		src = pDesc->src;
+		ctrl = pDesc->ctrl;
+		lli = pDesc->lli;
+	}
+}
+
+/* Run the whole chain of a channel, false if it has to wait for the FIFO */
+static bool hostRunChannel(int ch)
+{
+	GPDMA_CH_T *pCh = &hostGPDMA.CH[ch];
+	uint32_t src = pCh->SRCADDR, dst = pCh->DESTADDR, ctrl = pCh->CONTROL, lli = pCh->LLI;
+	const DMA_TransferDescriptor_t *pDesc;
+	uint32_t i, n, width, v;
+
+	if (hostFailMask & (1 << ch)) {
+		hostFailMask &= ~(1 << ch);
+		pCh->CONFIG &= ~GPDMA_DMACCxConfig_E;
+		HOST_REG(hostGPDMA.INTSTAT) |= 1 << ch;
+		HOST_REG(hostGPDMA.INTERRSTAT) |= 1 << ch;
+		return true;
+	}
+	if (hostFifoNeed(pCh) > hostFifoCount()) {
+		return false;
+	}
+
+	while (1) {
+		n = ctrl & 0xFFF;
+		width = 1 << ((ctrl >> 18) & 7);
+		for (i = 0; i < n; i++) {
+			if (src == hostFifoAddr) {
+				v = hostFifo[hostFifoTail++ % HOST_FIFO_SIZE];
+			}
+			else {
+				v = 0;
+				memcpy(&v, (const void *) (uintptr_t) src, width);
+			}
+			if (dst == hostFifoAddr) {
+				hostFifo[hostFifoHead++ % HOST_FIFO_SIZE] = (uint16_t) v;
+			}
+			else {
+				memcpy((void *) (uintptr_t) dst, &v, width);
+			}
+			if (ctrl & GPDMA_DMACCxControl_SI) {
+				src += width;
+			}
+			if (ctrl & GPDMA_DMACCxControl_DI) {
+				dst += width;
+			}
+		}
+		/* One bus cycle per item is enough for the busy time counters */
+		hostDWT.CYCCNT += n;
+		if (lli == 0) {
+			break;
+		}
+		pDesc = (const DMA_TransferDescriptor_t *) (uintptr_t) lli;
+		src = pDesc->src;
+		dst = pDesc->dst;
+		ctrl = pDesc->ctrl;
+		lli = pDesc->lli;
+	}
+
+	pCh->CONFIG &= ~GPDMA_DMACCxConfig_E;
+	HOST_REG(hostGPDMA.INTSTAT) |= 1 << ch;
+	HOST_REG(hostGPDMA.INTTCSTAT) |= 1 << ch;
+	return true;
+}
+
+/* Run every channel that can make progress, then take the interrupt.
+   Returns false once nothing is left to run. */
+static bool hostPump(void)
+{
+	uint32_t pending;
+	bool ran = false;
+	int ch;
+
+	hostSyncEnabled();
+	for (ch = 0; ch < GPDMA_NUMBER_CHANNELS; ch++) {
+		if ((hostGPDMA.CH[ch].CONFIG & GPDMA_DMACCxConfig_E) && hostRunChannel(ch)) {
+			ran = true;
+		}
+	}
+	if (!ran) {
+		return false;
+	}
+
+	hostSyncEnabled();
+	pending = hostGPDMA.INTSTAT;
+	hostIRQs++;
+	Chip_GPDMAMGR_IRQHandler(&hostGPDMA);
+
+	/* The handler clears what it saw, the clear registers are write only */
+	HOST_REG(hostGPDMA.INTSTAT) &= ~pending;
+	HOST_REG(hostGPDMA.INTTCSTAT) &= ~pending;
+	HOST_REG(hostGPDMA.INTERRSTAT) &= ~pending;
+	return true;
+}
+
+static void hostPumpAll(void)
+{
+	int guard = 0;
+
+	while (hostPump()) {
+		TEST_CHECK(++guard < 100000);
+	}
+}
+
+#endif /* __GPDMA_MODEL_H_ */
@@ -0,0 +1,76 @@
+/*
+ * @brief Host test shim for the LPC18xx/43xx chip drivers
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#ifndef __HOST_SHIM_H_
+#define __HOST_SHIM_H_
+
+/* Forced in front of every test source by the Makefile (-include). The chip
+   headers are used as is, only the core registers and the fixed peripheral
+   addresses the drivers under test touch are moved to host memory. */
+#include "chip.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+typedef struct {
+	uint32_t CTRL;
+	uint32_t CYCCNT;
+} HOST_DWT_T;
+
+typedef struct {
+	uint32_t DEMCR;
+} HOST_COREDEBUG_T;
+
+extern HOST_DWT_T hostDWT;
+extern HOST_COREDEBUG_T hostCoreDebug;
+extern LPC_CREG_T hostCREG;
+
+#undef DWT
+#undef CoreDebug
+#undef LPC_CREG
+#define DWT                 (&hostDWT)
+#define CoreDebug           (&hostCoreDebug)
+#define LPC_CREG            (&hostCREG)
+
+/* Interrupts do not exist on the host, the tests call the handlers directly */
+#define __get_PRIMASK()     0
+#define __set_PRIMASK(x)    ((void) (x))
+#define __disable_irq()     do {} while (0)
+#define __enable_irq()      do {} while (0)
+
+/* Barriers, the tests run on one host thread */
+#define __DMB()             __sync_synchronize()
+#define __DSB()             __sync_synchronize()
+
+/* Stop the test at the first failed check */
+#define TEST_CHECK(x) \
+	do { if (!(x)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, # x); exit(1); } } while (0)
+
+#endif /* __HOST_SHIM_H_ */
@@ -0,0 +1,275 @@
+/*
+ * @brief Host test of the streaming AES service
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+/* The engine is modelled at the ROM API, only the channel enable register of
+   the GPDMA is read by the driver */
+static LPC_GPDMA_T hostGPDMA;
+#undef LPC_GPDMA
+#define LPC_GPDMA           (&hostGPDMA)
+
+#include "../lpc_chip_43xx/src/aesstream_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define DMA_CHANNEL     6
+#define NUM_WORDS       3000
+
+/* SP800-38A F.2.1, F.2.5 and F.5.1 */
+static const char vecKey[] = "2b7e151628aed2a6abf7158809cf4f3c";
+static const char vecCbcIV[] = "000102030405060708090a0b0c0d0e0f";
+static const char vecCtrIV[] = "f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff";
+static const char vecPlain[] =
+	"6bc1bee22e409f96e93d7e117393172aae2d8a571e03ac9c9eb76fac45af8e51"
+	"30c81c46a35ce411e5fbc1191a0a52eff69f2445df4f9b17ad2b417be66c3710";
+static const char vecCbc[] =
+	"7649abac8119b246cee98e9b12e9197d5086cb9b507219ee95db113a917678b2"
+	"73bed6b8e3c1743b7116e69e222295163ff1caa1681fac09120eca307586e1a7";
+static const char vecCtr[] =
+	"874d6191b620e3261bef6864990db6ce9806f66b7970fdff8617187bb9fffdff"
+	"5ae4df3edbd5d35e5b4f09020db03eab1e031dda2fbe03d1792170a0f3009cee";
+
+/* Engine state loaded through the ROM API */
+static CHIP_AES_OP_MODE_T engMode;
+static uint8_t engKey[16], engIV[16];
+static uint8_t *pEngOut, *pEngIn;
+static uint32_t engBlocks;
+static bool engBusy;
+
+static uint32_t numDone;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* ROM AES API model, the operation runs when the test lets the engine go */
+void Chip_AES_Init(void)
+{}
+
+uint32_t Chip_AES_Config_DMA(uint32_t channel_id)
+{
+	return LPC_OK;
+}
+
+uint32_t Chip_AES_SetMode(CHIP_AES_OP_MODE_T AesMode)
+{
+	engMode = AesMode;
+	return LPC_OK;
+}
+
+void Chip_AES_LoadKeySW(uint8_t *pKey)
+{
+	memcpy(engKey, pKey, 16);
+}
+
+void Chip_AES_LoadIV_SW(uint8_t *pVector)
+{
+	memcpy(engIV, pVector, 16);
+}
+
+uint32_t Chip_AES_OperateDMA(uint32_t channel_id, uint8_t *dataOutAddr, uint8_t *dataInAddr, uint32_t size)
+{
+	pEngOut = dataOutAddr;
+	pEngIn = dataInAddr;
+	engBlocks = size;
+	engBusy = true;
+	*(volatile uint32_t *) &hostGPDMA.ENBLDCHNS = 3 << channel_id;
+	return LPC_OK;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Run the loaded operation block by block, as the DMA feeds the engine */
+static void hostEngineRun(void)
+{
+	uint8_t rk[176], b[16], prev[16], c[16];
+	uint32_t i;
+
+	aesExpandKey(engKey, rk);
+	memcpy(prev, engIV, 16);
+	for (i = 0; i < engBlocks; i++) {
+		memcpy(b, pEngIn + 16 * i, 16);
+		if (engMode == CHIP_AES_API_CMD_ENCODE_ECB) {
+			aesEncryptBlock(rk, b);
+		}
+		else if (engMode == CHIP_AES_API_CMD_ENCODE_CBC) {
+			aesXor(b, b, prev, 16);
+			aesEncryptBlock(rk, b);
+			memcpy(prev, b, 16);
+		}
+		else {
+			memcpy(c, b, 16);
+			aesDecryptBlock(rk, b);
+			aesXor(b, b, prev, 16);
+			memcpy(prev, c, 16);
+		}
+		memcpy(pEngOut + 16 * i, b, 16);
+	}
+	engBusy = false;
+	*(volatile uint32_t *) &hostGPDMA.ENBLDCHNS = 0;
+}
+
+static void hex(const char *pHex, uint8_t *pOut)
+{
+	unsigned v;
+
+	while (pHex[0] && pHex[1]) {
+		sscanf(pHex, "%2x", &v);
+		*pOut++ = (uint8_t) v;
+		pHex += 2;
+	}
+}
+
+static void reqDone(AESSTREAM_REQ_T *pReq)
+{
+	numDone++;
+}
+
+/* The software path against the standard vectors, split across calls */
+static void testVectors(void)
+{
+	AESSTREAM_CTX_T ctx;
+	uint8_t key[16], iv[16], plain[64], expect[64], out[64];
+
+	hex(vecKey, key);
+	hex(vecPlain, plain);
+	hex(vecCbcIV, iv);
+	hex(vecCbc, expect);
+	Chip_AESSTREAM_InitCtx(&ctx, AESSTREAM_CBC_ENCRYPT, key, iv);
+	Chip_AESSTREAM_ProcessSW(&ctx, out, plain, 32);
+	Chip_AESSTREAM_ProcessSW(&ctx, out + 32, plain + 32, 32);
+	TEST_CHECK(memcmp(out, expect, 64) == 0);
+
+	Chip_AESSTREAM_InitCtx(&ctx, AESSTREAM_CBC_DECRYPT, key, iv);
+	Chip_AESSTREAM_ProcessSW(&ctx, out, out, 64);
+	TEST_CHECK(memcmp(out, plain, 64) == 0);
+
+	hex(vecCtrIV, iv);
+	hex(vecCtr, expect);
+	Chip_AESSTREAM_InitCtx(&ctx, AESSTREAM_CTR, key, iv);
+	Chip_AESSTREAM_ProcessSW(&ctx, out, plain, 16);
+	Chip_AESSTREAM_ProcessSW(&ctx, out + 16, plain + 16, 48);
+	TEST_CHECK(memcmp(out, expect, 64) == 0);
+}
+
+/* Queues of up to six requests through the engine, in place or not, must
+   give the software result and leave the same chaining value */
+static void testPipeline(void)
+{
+	static uint32_t src[NUM_WORDS], dst[NUM_WORDS], ref[NUM_WORDS];
+	AESSTREAM_CTX_T hw, sw;
+	AESSTREAM_REQ_T req[6];
+	AESSTREAM_MODE_T mode;
+	uint8_t key[16], iv[16];
+	uint32_t off, len;
+	int it, i, numReq;
+	bool inPlace;
+
+	TEST_CHECK(Chip_AESSTREAM_Init(DMA_CHANNEL) == SUCCESS);
+	for (it = 0; it < 200; it++) {
+		mode = (AESSTREAM_MODE_T) (rand() % 3);
+		numReq = 1 + rand() % 6;
+		inPlace = rand() & 1;
+		for (i = 0; i < NUM_WORDS; i++) {
+			src[i] = rand();
+		}
+		for (i = 0; i < 16; i++) {
+			key[i] = rand();
+			iv[i] = rand();
+		}
+		Chip_AESSTREAM_InitCtx(&hw, mode, key, iv);
+		Chip_AESSTREAM_InitCtx(&sw, mode, key, iv);
+		memcpy(dst, src, sizeof(src));
+
+		numDone = 0;
+		for (off = 0, i = 0; i < numReq; i++) {
+			len = 16 * (1 + rand() % 120);
+			if ((mode == AESSTREAM_CTR) && (i == numReq - 1)) {
+				len -= rand() % 16;
+			}
+			Chip_AESSTREAM_SetupReq(&req[i], &hw, (uint8_t *) dst + off,
+									inPlace ? (uint8_t *) dst + off : (uint8_t *) src + off, len, reqDone, NULL);
+			TEST_CHECK(Chip_AESSTREAM_Submit(&req[i]) == SUCCESS);
+			off += len;
+		}
+		while (engBusy) {
+			/* Still running, nothing may complete */
+			Chip_AESSTREAM_Poll();
+			TEST_CHECK(numDone < (uint32_t) numReq);
+			hostEngineRun();
+			Chip_AESSTREAM_Poll();
+		}
+		TEST_CHECK(numDone == (uint32_t) numReq);
+		for (i = 0; i < numReq; i++) {
+			TEST_CHECK(req[i].done && (req[i].status == SUCCESS));
+		}
+		Chip_AESSTREAM_ProcessSW(&sw, (uint8_t *) ref, (uint8_t *) src, off);
+		TEST_CHECK(memcmp(dst, ref, off) == 0);
+		TEST_CHECK(memcmp(hw.iv, sw.iv, 16) == 0);
+	}
+}
+
+/* CBC lengths must be whole blocks, and the software backend completes a
+   request in the submit call */
+static void testSoftware(void)
+{
+	AESSTREAM_CTX_T ctx;
+	AESSTREAM_REQ_T req;
+	uint8_t key[16], iv[16], plain[64], expect[64], out[64];
+
+	hex(vecKey, key);
+	hex(vecPlain, plain);
+	hex(vecCbcIV, iv);
+	hex(vecCbc, expect);
+	Chip_AESSTREAM_InitCtx(&ctx, AESSTREAM_CBC_ENCRYPT, key, iv);
+	Chip_AESSTREAM_SetupReq(&req, &ctx, out, plain, 20, NULL, NULL);
+	TEST_CHECK(Chip_AESSTREAM_Submit(&req) == ERROR);
+
+	TEST_CHECK(Chip_AESSTREAM_Init(AESSTREAM_SOFTWARE) == SUCCESS);
+	Chip_AESSTREAM_SetupReq(&req, &ctx, out, plain, 64, NULL, NULL);
+	TEST_CHECK(Chip_AESSTREAM_Submit(&req) == SUCCESS);
+	TEST_CHECK(req.done && (memcmp(out, expect, 64) == 0));
+}
+
+int main(void)
+{
+	srand(9);
+	testVectors();
+	testPipeline();
+	testSoftware();
+	printf("test_aesstream: passed\n");
+	return 0;
+}
@@ -0,0 +1,407 @@
+/*
+ * @brief Host test of the interrupt driven C_CAN driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+/* The bit instructions of the core, in C */
+static uint32_t hostCLZ(uint32_t x)
+{
+	return x ? __builtin_clz(x) : 32;
+}
+
+static uint32_t hostRBIT(uint32_t x)
+{
+	uint32_t r = 0;
+	int i;
+
+	for (i = 0; i < 32; i++) {
+		r = (r << 1) | (x & 1);
+		x >>= 1;
+	}
+	return r;
+}
+
+#define __CLZ   hostCLZ
+#define __RBIT  hostRBIT
+#include "../lpc_chip_43xx/src/ccanq_18xx_43xx.c"
+#undef __CLZ
+#undef __RBIT
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* 1 Mbit/s bus saturated with 8 byte frames, 125 us each */
+#define FRAME_US        125
+#define RUN_US          5000000
+#define BLACKOUT_PERIOD 10000
+
+#define RX_RING_SIZE    64
+#define TX_QUEUE_SIZE   32
+#define NUM_IDS         16
+
+/* Message RAM model */
+typedef struct {
+	uint32_t msk1, msk2, arb1, arb2, mctrl, da1, da2, db1, db2;
+} HOST_MSGOBJ_T;
+
+typedef struct {
+	uint32_t rxFrames;
+	uint32_t lost;
+	uint32_t reordered;
+	uint32_t txFrames;
+	uint32_t txOrderErrors;
+	uint32_t xfers;
+} RUN_RESULT_T;
+
+static LPC_CCAN_T hostCCAN;
+static HOST_MSGOBJ_T msgRam[CCAN_MSG_MAX_NUM + 1];
+static uint32_t numXfers;
+
+static CCANQ_HANDLE_T hCAN;
+static CCAN_MSG_OBJ_T rxRing[RX_RING_SIZE];
+static CCANQ_TXENTRY_T txQueue[TX_QUEUE_SIZE];
+static bool rxEvent;
+
+static void hostUpdate(void);
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The C_CAN register driver is modelled, IF transfers move an object
+   between the interface registers and the message RAM */
+void Chip_CCAN_TransferMsgObject(LPC_CCAN_T *pCCAN, CCAN_MSG_IF_T IFSel, uint32_t mask, uint32_t msgNum)
+{
+	CCAN_IF_T *pIF = &pCCAN->IF[IFSel];
+	HOST_MSGOBJ_T *pObj = &msgRam[msgNum];
+
+	numXfers++;
+	if (mask & CCAN_IF_CMDMSK_WR) {
+		if (mask & CCAN_IF_CMDMSK_MASK) {
+			pObj->msk1 = pIF->MSK1;
+			pObj->msk2 = pIF->MSK2;
+		}
+		if (mask & CCAN_IF_CMDMSK_ARB) {
+			pObj->arb1 = pIF->ARB1;
+			pObj->arb2 = pIF->ARB2;
+		}
+		if (mask & CCAN_IF_CMDMSK_CTRL) {
+			pObj->mctrl = pIF->MCTRL;
+		}
+		if (mask & CCAN_IF_CMDMSK_DATAA) {
+			pObj->da1 = pIF->DA1;
+			pObj->da2 = pIF->DA2;
+		}
+		if (mask & CCAN_IF_CMDMSK_DATAB) {
+			pObj->db1 = pIF->DB1;
+			pObj->db2 = pIF->DB2;
+		}
+	}
+	else {
+		if (mask & CCAN_IF_CMDMSK_MASK) {
+			pIF->MSK1 = pObj->msk1;
+			pIF->MSK2 = pObj->msk2;
+		}
+		if (mask & CCAN_IF_CMDMSK_ARB) {
+			pIF->ARB1 = pObj->arb1;
+			pIF->ARB2 = pObj->arb2;
+		}
+		if (mask & CCAN_IF_CMDMSK_CTRL) {
+			pIF->MCTRL = pObj->mctrl;
+		}
+		if (mask & CCAN_IF_CMDMSK_DATAA) {
+			pIF->DA1 = pObj->da1;
+			pIF->DA2 = pObj->da2;
+		}
+		if (mask & CCAN_IF_CMDMSK_DATAB) {
+			pIF->DB1 = pObj->db1;
+			pIF->DB2 = pObj->db2;
+		}
+		if (mask & CCAN_IF_CMDMSK_R_CLRINTPND) {
+			pObj->mctrl &= ~CCAN_IF_MCTRL_INTP;
+		}
+		if (mask & CCAN_IF_CMDMSK_R_NEWDAT) {
+			pObj->mctrl &= ~CCAN_IF_MCTRL_NEWD;
+		}
+	}
+	hostUpdate();
+}
+
+void Chip_CCAN_Init(LPC_CCAN_T *pCCAN)
+{}
+
+Status Chip_CCAN_SetBitRate(LPC_CCAN_T *pCCAN, uint32_t bitRate)
+{
+	return SUCCESS;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* New data, interrupt pending and interrupt identifier registers */
+static void hostUpdate(void)
+{
+	uint32_t newData = 0, pending = 0, intId = 0;
+	int i;
+
+	for (i = 1; i <= CCAN_MSG_MAX_NUM; i++) {
+		if (msgRam[i].mctrl & CCAN_IF_MCTRL_NEWD) {
+			newData |= 1UL << (i - 1);
+		}
+		if (msgRam[i].mctrl & CCAN_IF_MCTRL_INTP) {
+			pending |= 1UL << (i - 1);
+			if (intId == 0) {
+				intId = i;
+			}
+		}
+	}
+	*(volatile uint32_t *) &hostCCAN.ND1 = newData & 0xFFFF;
+	*(volatile uint32_t *) &hostCCAN.ND2 = newData >> 16;
+	*(volatile uint32_t *) &hostCCAN.IR1 = pending & 0xFFFF;
+	*(volatile uint32_t *) &hostCCAN.IR2 = pending >> 16;
+	*(volatile uint32_t *) &hostCCAN.INT = intId;
+}
+
+static uint32_t hostObjId(const HOST_MSGOBJ_T *pObj)
+{
+	if (pObj->arb2 & CCAN_IF_ARB2_XTD) {
+		return (((pObj->arb2 & 0x1FFF) << 16) | pObj->arb1) | CCANQ_ID_EXT;
+	}
+	return (pObj->arb2 >> 2) & 0x7FF;
+}
+
+/* Store a received frame in the first matching object, as the message
+   handler does. A FIFO object only takes a frame while it has none or is
+   the last one of its FIFO, where the frame overwrites the old one. */
+static void hostDeliver(uint32_t id, const uint8_t *pData)
+{
+	HOST_MSGOBJ_T *pObj;
+	uint32_t mask, ext, objExt;
+	int i;
+
+	ext = (id & CCANQ_ID_EXT) != 0;
+	for (i = 1; i <= CCAN_MSG_MAX_NUM; i++) {
+		pObj = &msgRam[i];
+		if (!(pObj->arb2 & CCAN_IF_ARB2_MSGVAL) || (pObj->arb2 & CCAN_IF_ARB2_DIR(1))) {
+			continue;
+		}
+		objExt = (pObj->arb2 & CCAN_IF_ARB2_XTD) != 0;
+		if (!(pObj->mctrl & CCAN_IF_MCTRL_UMSK)) {
+			mask = 0x1FFFFFFF;
+		}
+		else if (objExt) {
+			mask = ((pObj->msk2 & 0x1FFF) << 16) | pObj->msk1;
+		}
+		else {
+			mask = (pObj->msk2 >> 2) & 0x7FF;
+		}
+		if (((pObj->msk2 & CCAN_IF_MASK2_MXTD) || !(pObj->mctrl & CCAN_IF_MCTRL_UMSK)) && (ext != objExt)) {
+			continue;
+		}
+		if ((id ^ hostObjId(pObj)) & mask & 0x1FFFFFFF) {
+			continue;
+		}
+		if ((pObj->mctrl & CCAN_IF_MCTRL_NEWD) && !(pObj->mctrl & CCAN_IF_MCTRL_EOB)) {
+			continue;
+		}
+
+		if (pObj->mctrl & CCAN_IF_MCTRL_NEWD) {
+			pObj->mctrl |= CCAN_IF_MCTRL_MLST;
+		}
+		pObj->mctrl = (pObj->mctrl & ~0xF) | 8 | CCAN_IF_MCTRL_NEWD;
+		if (pObj->mctrl & CCAN_IF_MCTRL_RXIE) {
+			pObj->mctrl |= CCAN_IF_MCTRL_INTP;
+		}
+		if (ext) {
+			pObj->arb2 = (pObj->arb2 & ~0x1FFF) | ((id >> 16) & 0x1FFF);
+			pObj->arb1 = id & 0xFFFF;
+		}
+		else {
+			pObj->arb2 = (pObj->arb2 & ~0x1FFC) | ((id & 0x7FF) << 2);
+		}
+		pObj->da1 = pData[0] | (pData[1] << 8);
+		pObj->da2 = pData[2] | (pData[3] << 8);
+		pObj->db1 = pData[4] | (pData[5] << 8);
+		pObj->db2 = pData[6] | (pData[7] << 8);
+		hostUpdate();
+		return;
+	}
+}
+
+/* The controller sends the lowest numbered pending transmit object */
+static int hostTxObj(void)
+{
+	int i;
+
+	for (i = 1; i <= CCAN_MSG_MAX_NUM; i++) {
+		if ((msgRam[i].arb2 & CCAN_IF_ARB2_MSGVAL) && (msgRam[i].mctrl & CCAN_IF_MCTRL_TXRQ)) {
+			return i;
+		}
+	}
+	return 0;
+}
+
+static void canRxEvent(void)
+{
+	rxEvent = true;
+}
+
+/* Run the saturated bus for RUN_US. Remote nodes send IDs 0x100-0x107,
+   0x200-0x203 and 0x40C-0x40F in turn, each with its own sequence
+   number, and lose arbitration to a lower pending frame of ours. The
+   interrupts are masked for blackoutUs of every 10 ms. With txPeriodUs
+   set, a task queues frames of 16 IDs at random intervals averaging it. */
+static void runBus(RUN_RESULT_T *pRes, uint32_t depth, uint32_t blackoutUs, uint32_t txPeriodUs)
+{
+	CCANQ_CFG_T cfg = {rxRing, RX_RING_SIZE, txQueue, TX_QUEUE_SIZE, canRxEvent};
+	uint32_t rxNext[NUM_IDS], remoteSeq[NUM_IDS], txSeq[NUM_IDS], txExpect[NUM_IDS];
+	uint32_t t, nextTx = 0, remoteIdx = 0, remoteId, seq, k;
+	CCAN_MSG_OBJ_T msg;
+	HOST_MSGOBJ_T *pObj;
+	uint8_t data[8];
+	int tx;
+
+	memset(msgRam, 0, sizeof(msgRam));
+	memset(&hostCCAN, 0, sizeof(hostCCAN));
+	memset(rxNext, 0, sizeof(rxNext));
+	memset(remoteSeq, 0, sizeof(remoteSeq));
+	memset(txSeq, 0, sizeof(txSeq));
+	memset(txExpect, 0, sizeof(txExpect));
+	memset(pRes, 0, sizeof(*pRes));
+	numXfers = 0;
+	srand(1);
+
+	TEST_CHECK(Chip_CCANQ_Init(&hCAN, &hostCCAN, &cfg) == SUCCESS);
+	TEST_CHECK(Chip_CCANQ_AddFilter(&hCAN, 0x100, 0x7F8, depth) != 0);
+	TEST_CHECK(Chip_CCANQ_AddFilter(&hCAN, 0x200, 0x7F8, depth) != 0);
+
+	for (t = FRAME_US; t <= RUN_US; t += FRAME_US) {
+		while (txPeriodUs && (nextTx <= t)) {
+			k = rand() % NUM_IDS;
+			msg.id = (k < 8) ? (0x080 + k) : (0x300 + k);
+			msg.dlc = 8;
+			memset(msg.data, 0, 8);
+			msg.data[0] = k;
+			memcpy(&msg.data[4], &txSeq[k], 4);
+			if (Chip_CCANQ_Send(&hCAN, &msg) == SUCCESS) {
+				txSeq[k]++;
+			}
+			nextTx += (rand() % 1000) * txPeriodUs / 500;
+		}
+
+		/* Arbitration between the next remote frame and our pending object */
+		k = remoteIdx % NUM_IDS;
+		remoteId = (k < 8) ? (0x100 + k) : ((k < 12) ? (0x200 + k - 8) : (0x400 + k));
+		tx = hostTxObj();
+		if (tx && (ccanqPrio(hostObjId(&msgRam[tx])) < ccanqPrio(remoteId))) {
+			pObj = &msgRam[tx];
+			k = pObj->da1 & 0xFF;
+			seq = pObj->db1 | (pObj->db2 << 16);
+			if (seq != txExpect[k]) {
+				pRes->txOrderErrors++;
+			}
+			txExpect[k] = seq + 1;
+			pRes->txFrames++;
+			pObj->mctrl &= ~CCAN_IF_MCTRL_TXRQ;
+			if (pObj->mctrl & CCAN_IF_MCTRL_TXIE) {
+				pObj->mctrl |= CCAN_IF_MCTRL_INTP;
+			}
+			hostUpdate();
+		}
+		else {
+			memset(data, 0, sizeof(data));
+			data[0] = k;
+			memcpy(&data[4], &remoteSeq[k], 4);
+			remoteSeq[k]++;
+			hostDeliver(remoteId, data);
+			remoteIdx++;
+		}
+
+		if (((t % BLACKOUT_PERIOD) >= blackoutUs) && hostCCAN.INT) {
+			Chip_CCANQ_IRQHandler(&hCAN);
+		}
+		if (rxEvent) {
+			rxEvent = false;
+			while (Chip_CCANQ_Receive(&hCAN, &msg)) {
+				k = msg.data[0];
+				memcpy(&seq, &msg.data[4], 4);
+				TEST_CHECK((msg.id & 0x7F8) == ((k < 8) ? 0x100 : 0x200));
+				pRes->rxFrames++;
+				if (seq < rxNext[k]) {
+					pRes->reordered++;
+				}
+				else {
+					pRes->lost += seq - rxNext[k];
+					rxNext[k] = seq + 1;
+				}
+			}
+		}
+	}
+	pRes->xfers = numXfers;
+}
+
+int main(void)
+{
+	static const uint32_t depths[4] = {1, 2, 4, 8};
+	static const uint32_t blackouts[3] = {0, 500, 2000};
+	RUN_RESULT_T res;
+	uint32_t b, d, lastLost;
+
+	/* Receive FIFOs against interrupt blackouts, deeper FIFOs lose less and
+	   8 objects ride out 2 ms. About one IF transfer is used per frame. */
+	for (b = 0; b < 3; b++) {
+		printf("test_ccanq: %4u us blackout, lost", (unsigned) blackouts[b]);
+		lastLost = 0xFFFFFFFF;
+		for (d = 0; d < 4; d++) {
+			runBus(&res, depths[d], blackouts[b], 0);
+			TEST_CHECK((res.reordered == 0) && (res.lost <= lastLost));
+			TEST_CHECK(res.xfers < (res.rxFrames + res.rxFrames / 20));
+			if ((blackouts[b] == 0) || (depths[d] == 8)) {
+				TEST_CHECK(res.lost == 0);
+			}
+			lastLost = res.lost;
+			printf(" %5.2f%%", 100.0 * res.lost / (res.rxFrames + res.lost));
+		}
+		printf(" at FIFO depths 1/2/4/8\n");
+	}
+
+	/* Sending 4000 frames/s keeps the order of every ID */
+	runBus(&res, 8, 1000, 250);
+	TEST_CHECK((res.txOrderErrors == 0) && (res.reordered == 0) && (res.lost == 0));
+	TEST_CHECK(res.txFrames > 4 * (RUN_US / 1000) * 99 / 100);
+	printf("test_ccanq: %u frames/s sent, %u frames/s received\n",
+		   (unsigned) (res.txFrames / (RUN_US / 1000000)), (unsigned) (res.rxFrames / (RUN_US / 1000000)));
+
+	printf("test_ccanq: passed\n");
+	return 0;
+}
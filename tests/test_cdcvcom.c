@@ -0,0 +1,276 @@
+/*
+ * @brief Host test of the USB CDC virtual COM port
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../freertos_statechart/example/src/cdc_vcom.c"
+#include "../freertos_statechart/example/src/usb_desc.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define LOOP_BYTES      300000
+#define CDC_MEM_SIZE    256
+
+/* Endpoint indexes of the stack, IN and OUT of the data interface */
+#define EP_IN_INDEX     3
+#define EP_OUT_INDEX    2
+
+const USBD_API_T *g_pUsbApi;
+
+static USBD_HW_API_T hostHw;
+static USBD_CORE_API_T hostCore;
+static USBD_CDC_API_T hostCdc;
+static USBD_API_T hostApi;
+static USB_CORE_CTRL_T hostCtrl;
+
+/* Endpoint model, at most one transfer armed per direction */
+static USB_EP_HANDLER_T hostInHandler, hostOutHandler;
+static uint8_t *pInBuf, *pOutBuf;
+static uint32_t inLen, outMax, outGot;
+static bool inArmed, outArmed;
+
+static uint8_t txRing[4096], rxRing[1024];
+static uint8_t txBuffers[2 * VCOM_TX_BUF_SIZE], rxBuffers[2 * VCOM_RX_BUF_SIZE];
+static uint8_t srcData[LOOP_BYTES], echoData[LOOP_BYTES], hostData[LOOP_BYTES];
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* ROM stack model */
+static uint32_t hostWriteEP(USBD_HANDLE_T hUsb, uint32_t EPNum, uint8_t *pData, uint32_t cnt)
+{
+	TEST_CHECK(!inArmed);
+	pInBuf = pData;
+	inLen = cnt;
+	inArmed = true;
+	return cnt;
+}
+
+static uint32_t hostReadReqEP(USBD_HANDLE_T hUsb, uint32_t EPNum, uint8_t *pData, uint32_t len)
+{
+	TEST_CHECK(!outArmed);
+	pOutBuf = pData;
+	outMax = len;
+	outArmed = true;
+	return len;
+}
+
+static uint32_t hostReadEP(USBD_HANDLE_T hUsb, uint32_t EPNum, uint8_t *pData)
+{
+	TEST_CHECK(pData == pOutBuf);
+	return outGot;
+}
+
+static ErrorCode_t hostRegisterEpHandler(USBD_HANDLE_T hUsb, uint32_t ep_index, USB_EP_HANDLER_T pfn, void *data)
+{
+	if (ep_index == EP_IN_INDEX) {
+		hostInHandler = pfn;
+	}
+	else if (ep_index == EP_OUT_INDEX) {
+		hostOutHandler = pfn;
+	}
+	else {
+		return ERR_FAILED;
+	}
+	return LPC_OK;
+}
+
+static ErrorCode_t hostCdcInit(USBD_HANDLE_T hUsb, USBD_CDC_INIT_PARAM_T *param, USBD_HANDLE_T *phCDC)
+{
+	USB_INTERFACE_DESCRIPTOR *pCif = (USB_INTERFACE_DESCRIPTOR *) param->cif_intf_desc;
+	USB_INTERFACE_DESCRIPTOR *pDif = (USB_INTERFACE_DESCRIPTOR *) param->dif_intf_desc;
+
+	TEST_CHECK(pCif && pDif && (pCif->bInterfaceNumber == 0) && (pDif->bInterfaceNumber == 1));
+	param->mem_base += CDC_MEM_SIZE;
+	param->mem_size -= CDC_MEM_SIZE;
+	*phCDC = (USBD_HANDLE_T) 1;
+	return LPC_OK;
+}
+
+/* The host takes the armed IN transfer */
+static void hostTakeIn(uint8_t *pDst)
+{
+	if (pDst) {
+		memcpy(pDst, pInBuf, inLen);
+	}
+	inArmed = false;
+	hostInHandler(&hostCtrl, NULL, USB_EVT_IN);
+}
+
+static void hostConnect(bool highSpeed)
+{
+	USB_CORE_DESCS_T desc;
+	USBD_API_INIT_PARAM_T usbParam;
+	VCOM_CFG_T cfg;
+
+	memset(&hostCtrl, 0, sizeof(hostCtrl));
+	inArmed = outArmed = false;
+	desc.high_speed_desc = USB_HsConfigDescriptor;
+	desc.full_speed_desc = USB_FsConfigDescriptor;
+	usbParam.mem_base = 0x1000;
+	usbParam.mem_size = 0x2000;
+	cfg.txRing = txRing;
+	cfg.txRingSize = sizeof(txRing);
+	cfg.rxRing = rxRing;
+	cfg.rxRingSize = sizeof(rxRing);
+	cfg.txBuffers = txBuffers;
+	cfg.rxBuffers = rxBuffers;
+	cfg.txCb = NULL;
+	cfg.rxCb = NULL;
+	TEST_CHECK(vcom_init(&hostCtrl, &desc, &usbParam, &cfg) == LPC_OK);
+	TEST_CHECK(usbParam.mem_base == 0x1000 + CDC_MEM_SIZE);
+
+	/* Data written before the configuration is kept for it */
+	TEST_CHECK(vcom_write((const uint8_t *) "hello", 5) == 5);
+	TEST_CHECK(!inArmed);
+	hostCtrl.config_value = 1;
+	hostCtrl.device_speed = highSpeed ? USB_HIGH_SPEED : USB_FULL_SPEED;
+	vcom_configure_event(&hostCtrl);
+	TEST_CHECK(inArmed && (inLen == 5) && outArmed);
+	hostTakeIn(NULL);
+}
+
+/* The host sends random sized OUT transfers, the application reads and
+   echoes them in random pieces and the host collects the IN transfers */
+static void testLoopback(void)
+{
+	uint32_t sent = 0, got = 0, read = 0, echoed = 0, n, steps = 0;
+	uint8_t tmp[700];
+	int i;
+
+	for (i = 0; i < LOOP_BYTES; i++) {
+		srcData[i] = (uint8_t) rand();
+	}
+	while (got < LOOP_BYTES) {
+		TEST_CHECK(++steps < 50000000);
+		switch (rand() % 4) {
+		case 0:
+			if (outArmed && (sent < LOOP_BYTES)) {
+				n = 1 + rand() % outMax;
+				if (n > LOOP_BYTES - sent) {
+					n = LOOP_BYTES - sent;
+				}
+				memcpy(pOutBuf, srcData + sent, n);
+				sent += n;
+				outGot = n;
+				outArmed = false;
+				hostOutHandler(&hostCtrl, NULL, USB_EVT_OUT);
+			}
+			break;
+
+		case 1:
+			n = vcom_bread(tmp, 1 + rand() % sizeof(tmp));
+			memcpy(echoData + read, tmp, n);
+			read += n;
+			break;
+
+		case 2:
+			if (echoed < read) {
+				n = 1 + rand() % 600;
+				if (n > read - echoed) {
+					n = read - echoed;
+				}
+				echoed += vcom_write(echoData + echoed, n);
+			}
+			break;
+
+		default:
+			if (inArmed) {
+				n = inLen;
+				hostTakeIn(hostData + got);
+				got += n;
+			}
+			break;
+		}
+	}
+	TEST_CHECK(memcmp(hostData, srcData, LOOP_BYTES) == 0);
+}
+
+/* A transfer of a whole number of packets ends with a zero length packet */
+static void testZlp(uint32_t maxPacket)
+{
+	uint8_t buf[USB_HS_MAX_BULK_PACKET];
+
+	memset(buf, 1, sizeof(buf));
+	TEST_CHECK(!inArmed);
+	vcom_write(buf, maxPacket);
+	TEST_CHECK(inArmed && (inLen == maxPacket));
+	hostTakeIn(NULL);
+	TEST_CHECK(inArmed && (inLen == 0));
+	hostTakeIn(NULL);
+	TEST_CHECK(!inArmed);
+}
+
+/* A reset drops the transfer in flight and keeps the queued data */
+static void testReset(void)
+{
+	vcom_write((const uint8_t *) "abc", 3);
+	vcom_write((const uint8_t *) "def", 3);
+	vcom_reset_event(&hostCtrl);
+	inArmed = outArmed = false;
+	vcom_configure_event(&hostCtrl);
+	TEST_CHECK(inArmed && (inLen == 3) && (memcmp(pInBuf, "def", 3) == 0));
+}
+
+int main(void)
+{
+	const VCOM_STATS_T *pStats;
+	int speed;
+
+	hostHw.WriteEP = hostWriteEP;
+	hostHw.ReadReqEP = hostReadReqEP;
+	hostHw.ReadEP = hostReadEP;
+	hostCore.RegisterEpHandler = hostRegisterEpHandler;
+	hostCdc.init = hostCdcInit;
+	hostApi.hw = &hostHw;
+	hostApi.core = &hostCore;
+	hostApi.cdc = &hostCdc;
+	g_pUsbApi = &hostApi;
+	srand(12345);
+
+	TEST_CHECK((USB_HsConfigDescriptor[2] | (USB_HsConfigDescriptor[3] << 8)) == sizeof(USB_HsConfigDescriptor) - 1);
+	for (speed = 0; speed < 2; speed++) {
+		hostConnect(speed != 0);
+		testLoopback();
+		pStats = vcom_stats();
+		printf("test_cdcvcom: %s speed, %u bytes in %u transfers, %u zero length, %u OUT stalls\n",
+			   speed ? "high" : "full", (unsigned) pStats->txBytes, (unsigned) pStats->txTransfers,
+			   (unsigned) pStats->txZlps, (unsigned) pStats->rxStalls);
+		TEST_CHECK(pStats->txDropped == 0);
+		testZlp(speed ? USB_HS_MAX_BULK_PACKET : USB_FS_MAX_BULK_PACKET);
+		testReset();
+	}
+	printf("test_cdcvcom: passed\n");
+	return 0;
+}
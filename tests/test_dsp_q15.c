@@ -0,0 +1,277 @@
+/*
+ * @brief Host test of the q15 DSP kernels against their scalar references
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+/* Built without __ARM_FEATURE_DSP and without host_shim.h, so the kernels
+   run on the C versions of the SIMD instructions at the top of dsp_q15.c
+   instead of the CMSIS ones. testIntrinsics() pins those to the Cortex-M4
+   results, the other tests check every kernel against its scalar *_Ref
+   version. */
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lpc_chip_43xx/src/dsp_q15.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define MAX_TAPS    64
+#define MAX_BLOCK   129
+#define MAX_STAGES  4
+#define ROUNDS      300
+
+#define TEST_CHECK(x) \
+	do { if (!(x)) { printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, # x); exit(1); } } while (0)
+
+/* Test signals, SIG_FULL only uses 0x7FFF and -0x8000 so that the sums
+   saturate */
+typedef enum {
+	SIG_RANDOM,
+	SIG_FULL,
+	SIG_SMALL,
+	SIG_NUM
+} SIG_T;
+
+static uint32_t rndState = 1;
+
+/* Outputs that hit the 16-bit limits, to show the saturating paths ran */
+static uint32_t satHits;
+
+static int16_t coeffs[6 * MAX_STAGES > MAX_TAPS ? 6 * MAX_STAGES : MAX_TAPS] __attribute__ ((aligned(4)));
+static int16_t state1[MAX_TAPS + MAX_BLOCK] __attribute__ ((aligned(4)));
+static int16_t state2[MAX_TAPS + MAX_BLOCK] __attribute__ ((aligned(4)));
+static int16_t src[MAX_BLOCK + 1] __attribute__ ((aligned(4)));
+static int16_t dst1[MAX_BLOCK + 1] __attribute__ ((aligned(4)));
+static int16_t dst2[MAX_BLOCK + 1] __attribute__ ((aligned(4)));
+static int16_t fft1[2 * DSP_FFT_MAX_LEN] __attribute__ ((aligned(4)));
+static int16_t fft2[2 * DSP_FFT_MAX_LEN] __attribute__ ((aligned(4)));
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* xorshift32, so that the inputs do not depend on the host C library */
+static uint32_t rnd(void)
+{
+	rndState ^= rndState << 13;
+	rndState ^= rndState >> 17;
+	rndState ^= rndState << 5;
+	return rndState;
+}
+
+static void fillSig(int16_t *p, uint32_t len, SIG_T sig)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		if (sig == SIG_FULL) {
+			p[i] = (rnd() & 1) ? 0x7FFF : -0x8000;
+		}
+		else if (sig == SIG_SMALL) {
+			p[i] = (int16_t) rnd() >> 6;
+		}
+		else {
+			p[i] = (int16_t) rnd();
+		}
+	}
+}
+
+static void countSat(const int16_t *p, uint32_t len)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		if ((p[i] == 0x7FFF) || (p[i] == -0x8000)) {
+			satHits++;
+		}
+	}
+}
+
+/* The emulated SIMD instructions against results worked out from the
+   Cortex-M4 instruction descriptions */
+static void testIntrinsics(void)
+{
+	TEST_CHECK(__QADD16(0x7FFF8000, 0x0001FFFF) == 0x7FFF8000);
+	TEST_CHECK(__QADD16(0x12340001, 0x00010002) == 0x12350003);
+	TEST_CHECK(__QSUB16(0x80007FFF, 0x0001FFFF) == 0x80007FFF);
+	TEST_CHECK(__QSUB16(0x00000000, 0x80008000) == 0x7FFF7FFF);
+	TEST_CHECK(__SHADD16(0x7FFF7FFF, 0x7FFF7FFF) == 0x7FFF7FFF);
+	TEST_CHECK(__SHADD16(0x80000001, 0x80000000) == 0x80000000);
+	TEST_CHECK(__SHADD16(0xFFFFFFFF, 0x00000000) == 0xFFFFFFFF);
+	TEST_CHECK(__SMUSD(0x00028000, 0x00038000) == 0x3FFFFFFA);
+	TEST_CHECK(__SMUADX(0x00028000, 0x7FFF0003) == (uint32_t) (3 * 2 + 0x7FFF * -0x8000));
+	TEST_CHECK(__SMLALD(0x80008000, 0x80008000, 1) == 0x80000001ULL);
+	TEST_CHECK(__SMLALD(0x7FFF8000, 0x80007FFF, 0) == (uint64_t) (2LL * 0x7FFF * -0x8000));
+	TEST_CHECK(__SMLALDX(0x00028000, 0x7FFF0003, 5) == (uint64_t) (5LL + 3 * 2 + 0x7FFFLL * -0x8000));
+	TEST_CHECK(__PKHBT(0x1234ABCD, 0x00005678, 16) == 0x5678ABCD);
+	TEST_CHECK(__PKHBT(0x1234ABCD, 0x5678EF01, 0) == 0x5678ABCD);
+	TEST_CHECK(__RBIT(0x00000001) == 0x80000000);
+	TEST_CHECK(__RBIT(0x12345678) == 0x1E6A2C48);
+	TEST_CHECK(__CLZ(0) == 32 && __CLZ(1) == 31 && __CLZ(0x80000000) == 0);
+}
+
+/* Odd and even block sizes, the state carried across several blocks, and
+   the optimized filter run in place */
+static void testFIR(void)
+{
+	DSP_FIR_Q15_T f1, f2;
+	uint32_t r, blk, taps, len;
+
+	for (r = 0; r < ROUNDS; r++) {
+		taps = 2 * (1 + (rnd() % (MAX_TAPS / 2)));
+		fillSig(coeffs, taps, (SIG_T) (r % SIG_NUM));
+		DSP_FIR_Q15_Init(&f1, taps, coeffs, state1);
+		DSP_FIR_Q15_Init(&f2, taps, coeffs, state2);
+		for (blk = 0; blk < 4; blk++) {
+			len = 1 + (rnd() % MAX_BLOCK);
+			if (blk == 0) {
+				len |= 1;
+			}
+			fillSig(src, len, (SIG_T) ((r + blk) % SIG_NUM));
+			memcpy(dst1, src, len * sizeof(int16_t));
+			DSP_FIR_Q15(&f1, dst1, dst1, len);
+			DSP_FIR_Q15_Ref(&f2, src, dst2, len);
+			TEST_CHECK(memcmp(dst1, dst2, len * sizeof(int16_t)) == 0);
+			countSat(dst2, len);
+		}
+	}
+}
+
+/* Odd factors and odd output counts */
+static void testDecimate(void)
+{
+	DSP_DECIM_Q15_T d1, d2;
+	uint32_t r, blk, taps, factor, len;
+
+	for (r = 0; r < ROUNDS; r++) {
+		taps = 2 * (1 + (rnd() % (MAX_TAPS / 2)));
+		factor = 1 + (rnd() % 5);
+		fillSig(coeffs, taps, (SIG_T) (r % SIG_NUM));
+		DSP_Decimate_Q15_Init(&d1, factor, taps, coeffs, state1);
+		DSP_Decimate_Q15_Init(&d2, factor, taps, coeffs, state2);
+		for (blk = 0; blk < 3; blk++) {
+			len = factor * (1 + (rnd() % (MAX_BLOCK / factor)));
+			fillSig(src, len, (SIG_T) ((r + blk) % SIG_NUM));
+			DSP_Decimate_Q15(&d1, src, dst1, len);
+			DSP_Decimate_Q15_Ref(&d2, src, dst2, len);
+			TEST_CHECK(memcmp(dst1, dst2, (len / factor) * sizeof(int16_t)) == 0);
+			countSat(dst2, len / factor);
+		}
+	}
+}
+
+/* Saturation inside the feedback loop must leave both versions with the same
+   state, so the state is compared as well as the output */
+static void testBiquad(void)
+{
+	DSP_BIQUAD_Q15_T q1, q2;
+	uint32_t r, blk, i, stages, shift, len;
+
+	for (r = 0; r < ROUNDS; r++) {
+		stages = 1 + (rnd() % MAX_STAGES);
+		shift = rnd() % 3;
+		fillSig(coeffs, 6 * stages, (SIG_T) (r % SIG_NUM));
+		for (i = 0; i < stages; i++) {
+			coeffs[6 * i + 1] = 0;
+		}
+		DSP_Biquad_Q15_Init(&q1, stages, coeffs, state1, shift);
+		DSP_Biquad_Q15_Init(&q2, stages, coeffs, state2, shift);
+		for (blk = 0; blk < 3; blk++) {
+			len = 1 + (rnd() % MAX_BLOCK);
+			if (blk == 0) {
+				len |= 1;
+			}
+			fillSig(src, len, (SIG_T) ((r + blk) % SIG_NUM));
+			memcpy(dst2, src, len * sizeof(int16_t));
+			DSP_Biquad_Q15(&q1, src, dst1, len);
+			DSP_Biquad_Q15_Ref(&q2, dst2, dst2, len);
+			TEST_CHECK(memcmp(dst1, dst2, len * sizeof(int16_t)) == 0);
+			TEST_CHECK(memcmp(state1, state2, 4 * stages * sizeof(int16_t)) == 0);
+			countSat(dst2, len);
+		}
+	}
+}
+
+/* The length must be even, a full scale negative sample reads as 0x7FFF */
+static void testLevel(void)
+{
+	DSP_LEVEL_T l1, l2;
+	uint32_t r, len;
+
+	for (r = 0; r < ROUNDS; r++) {
+		len = 2 * (rnd() % ((MAX_BLOCK + 1) / 2));
+		fillSig(src, len, (SIG_T) (r % SIG_NUM));
+		DSP_Level_Q15(src, len, &l1);
+		DSP_Level_Q15_Ref(src, len, &l2);
+		TEST_CHECK(l1.rms == l2.rms && l1.peak == l2.peak);
+	}
+
+	src[0] = 0;
+	src[1] = -0x8000;
+	DSP_Level_Q15(src, 2, &l1);
+	TEST_CHECK(l1.peak == 0x7FFF);
+}
+
+/* Every size, both directions, including inputs with a complex magnitude
+   above 1 that saturate */
+static void testFFT(void)
+{
+	uint32_t r, n;
+	bool inverse;
+
+	for (r = 0; r < ROUNDS; r++) {
+		n = 4 << (r % 9);
+		inverse = ((r / 9) & 1) != 0;
+		fillSig(fft1, 2 * n, (SIG_T) ((r / 18) % SIG_NUM));
+		memcpy(fft2, fft1, 2 * n * sizeof(int16_t));
+		DSP_FFT_Q15(fft1, n, inverse);
+		DSP_FFT_Q15_Ref(fft2, n, inverse);
+		TEST_CHECK(memcmp(fft1, fft2, 2 * n * sizeof(int16_t)) == 0);
+		countSat(fft2, 2 * n);
+	}
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	testIntrinsics();
+	testFIR();
+	testDecimate();
+	testBiquad();
+	testLevel();
+	testFFT();
+	TEST_CHECK(satHits != 0);
+	printf("test_dsp_q15: passed, %u saturated outputs\n", (unsigned) satHits);
+	return 0;
+}
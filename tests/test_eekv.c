@@ -0,0 +1,279 @@
+/*
+ * @brief Host test of the EEPROM key-value store
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include <time.h>
+
+/* EEPROM pages in host memory, the last page addressed is the one the
+   next program goes to */
+static uint32_t hostEE[EEPROM_PAGE_NUM * EEPROM_PAGE_SIZE / 4];
+static uint32_t hostLastPage;
+
+static uintptr_t hostEEAddr(uint32_t page, uint32_t offset)
+{
+	hostLastPage = page;
+	return (uintptr_t) &hostEE[page * (EEPROM_PAGE_SIZE / 4)] + offset;
+}
+
+#undef EEPROM_ADDRESS
+#define EEPROM_ADDRESS(page, offset) hostEEAddr(page, offset)
+
+#include "../lpc_chip_43xx/src/eekv_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_KEYS        48
+#define NUM_PAGES       24
+#define FLUSH_MS        500
+#define RUN_MS          600000
+
+static LPC_EEPROM_T hostEEPROM;
+static uint32_t numPrograms, wear[EEPROM_PAGE_NUM];
+static int32_t crashAt = -1;
+
+static EEKV_HANDLE_T hKV;
+static EEKV_INDEX_T kvIndex[64];
+static const EEKV_CFG_T kvCfg = {0, NUM_PAGES, kvIndex, 64, FLUSH_MS};
+
+/* Values set so far and values at the last flush */
+static uint8_t model[NUM_KEYS][EEKV_MAX_VALUE], flushed[NUM_KEYS][EEKV_MAX_VALUE];
+static uint32_t modelLen[NUM_KEYS], flushedLen[NUM_KEYS];
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* A power loss at the crash point tears the page being programmed */
+void Chip_EEPROM_EraseProgramPage(LPC_EEPROM_T *pEEPROM)
+{
+	numPrograms++;
+	wear[hostLastPage]++;
+	if ((crashAt >= 0) && ((int32_t) numPrograms == crashAt)) {
+		memset(&hostEE[hostLastPage * (EEPROM_PAGE_SIZE / 4) + 16], 0xA5, EEPROM_PAGE_SIZE / 2);
+	}
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static uint16_t keyOf(int i)
+{
+	return 0x100 + i * 7;
+}
+
+static uint32_t lenOf(int i)
+{
+	return 4 + (i % 4) * 4;
+}
+
+/* 80% of the updates go to 8 keys */
+static int pickKey(void)
+{
+	return ((rand() % 10) < 8) ? (rand() % 8) : (rand() % NUM_KEYS);
+}
+
+static void setKey(int k)
+{
+	uint32_t i;
+
+	for (i = 0; i < lenOf(k); i++) {
+		model[k][i] = (uint8_t) rand();
+	}
+	modelLen[k] = lenOf(k);
+	TEST_CHECK(Chip_EEKV_Set(&hKV, keyOf(k), model[k], modelLen[k]) == SUCCESS);
+}
+
+static void resetStore(void)
+{
+	memset(hostEE, 0xFF, sizeof(hostEE));
+	memset(model, 0, sizeof(model));
+	memset(modelLen, 0, sizeof(modelLen));
+	memset(wear, 0, sizeof(wear));
+	numPrograms = 0;
+	crashAt = -1;
+	TEST_CHECK(Chip_EEKV_Init(&hKV, &hostEEPROM, &kvCfg) == SUCCESS);
+}
+
+static void checkModel(void)
+{
+	uint8_t buf[EEKV_MAX_VALUE];
+	uint32_t len;
+	int i;
+
+	for (i = 0; i < NUM_KEYS; i++) {
+		len = Chip_EEKV_Get(&hKV, keyOf(i), buf, sizeof(buf));
+		TEST_CHECK((len == modelLen[i]) && (memcmp(buf, model[i], len) == 0));
+	}
+}
+
+/* Ten minutes of bursty parameter changes, about 20 per second, flushed
+   after every update or after the flush delay. The values must survive a
+   remount and the wear must be spread over all pages. */
+static void testWorkload(bool buffered)
+{
+	uint32_t t, updates = 0, minWear = 0xFFFFFFFF, maxWear = 0, p;
+	int n, k;
+
+	resetStore();
+	for (t = 0; t < RUN_MS; t += 10) {
+		n = ((rand() % 50) == 0) ? (10 + rand() % 30) : 0;
+		while (n-- > 0) {
+			k = pickKey();
+			if (((rand() % 50) == 0) && modelLen[k]) {
+				TEST_CHECK(Chip_EEKV_Delete(&hKV, keyOf(k)) == SUCCESS);
+				modelLen[k] = 0;
+			}
+			else {
+				setKey(k);
+			}
+			updates++;
+			if (!buffered) {
+				Chip_EEKV_Flush(&hKV);
+			}
+		}
+		Chip_EEKV_Poll(&hKV, t);
+	}
+	checkModel();
+	Chip_EEKV_Flush(&hKV);
+	TEST_CHECK(Chip_EEKV_Init(&hKV, &hostEEPROM, &kvCfg) == SUCCESS);
+	checkModel();
+
+	for (p = 0; p < NUM_PAGES; p++) {
+		minWear = MIN(minWear, wear[p]);
+		maxWear = MAX(maxWear, wear[p]);
+	}
+	TEST_CHECK(maxWear - minWear <= 1);
+	if (buffered) {
+		TEST_CHECK(numPrograms < updates / 5);
+	}
+	printf("test_eekv: %s, %u updates, %.3f page programs per update, %u-%u programs per page\n",
+		   buffered ? "buffered" : "program per update", (unsigned) updates,
+		   (double) numPrograms / updates, (unsigned) minWear, (unsigned) maxWear);
+}
+
+/* Index lookups against finding the newest record by scanning the log */
+static void testLookup(void)
+{
+	uint8_t buf[EEKV_MAX_VALUE];
+	const uint32_t *pPage, *pHit;
+	uint32_t i, pg, w, rec, sink = 0;
+	clock_t start;
+	double indexNs, scanNs;
+	int r;
+
+	start = clock();
+	for (r = 0; r < 100000; r++) {
+		sink += Chip_EEKV_Get(&hKV, keyOf(r % NUM_KEYS), buf, sizeof(buf));
+	}
+	indexNs = (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 100000;
+
+	start = clock();
+	for (r = 0; r < 10000; r++) {
+		pHit = NULL;
+		for (i = 1; i <= NUM_PAGES; i++) {
+			pg = (hKV.head + i - 1) % NUM_PAGES;
+			if (!eekvPageValid(&hKV, pg)) {
+				continue;
+			}
+			pPage = eekvPage(&hKV, pg);
+			for (w = EEKV_HDR_WORDS; w < EEKV_PAGE_WORDS; w += EEKV_REC_WORDS(EEKV_REC_LEN(rec))) {
+				rec = pPage[w];
+				if (EEKV_REC_KEY(rec) == EEKV_KEY_INVALID) {
+					break;
+				}
+				if (EEKV_REC_KEY(rec) == keyOf(r % NUM_KEYS)) {
+					pHit = &pPage[w];
+				}
+			}
+		}
+		if (pHit) {
+			memcpy(buf, pHit + 1, EEKV_REC_LEN(*pHit));
+			sink += EEKV_REC_LEN(*pHit);
+		}
+	}
+	scanNs = (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 10000;
+	printf("test_eekv: lookup %.0f ns with the index, %.0f ns scanning the log (%u)\n",
+		   indexNs, scanNs, (unsigned) (sink & 1));
+}
+
+/* Tear the page being programmed at many points of a run. After the
+   remount every key must hold its value of the last flush or a newer
+   one. */
+static void testPowerLoss(void)
+{
+	uint8_t buf[EEKV_MAX_VALUE];
+	uint32_t len;
+	int32_t c;
+	int s, i, numPoints = 0;
+	bool ok;
+
+	for (c = 1; c < 400; c += 7) {
+		resetStore();
+		memcpy(flushed, model, sizeof(flushed));
+		memcpy(flushedLen, modelLen, sizeof(flushedLen));
+		crashAt = c;
+		for (s = 0; (s < 4000) && ((int32_t) numPrograms < c); s++) {
+			setKey(pickKey());
+			if (((s % 5) == 4) && ((int32_t) numPrograms < c)) {
+				Chip_EEKV_Flush(&hKV);
+				if ((int32_t) numPrograms < c) {
+					memcpy(flushed, model, sizeof(flushed));
+					memcpy(flushedLen, modelLen, sizeof(flushedLen));
+				}
+			}
+		}
+
+		crashAt = -1;
+		TEST_CHECK(Chip_EEKV_Init(&hKV, &hostEEPROM, &kvCfg) == SUCCESS);
+		for (i = 0; i < NUM_KEYS; i++) {
+			len = Chip_EEKV_Get(&hKV, keyOf(i), buf, sizeof(buf));
+			ok = (len == flushedLen[i]) && (memcmp(buf, flushed[i], len) == 0);
+			ok |= (len == modelLen[i]) && (memcmp(buf, model[i], len) == 0);
+			TEST_CHECK(ok);
+		}
+		numPoints++;
+	}
+	printf("test_eekv: %d power loss points, no flushed value lost\n", numPoints);
+}
+
+int main(void)
+{
+	srand(7);
+	testWorkload(false);
+	testWorkload(true);
+	testLookup();
+	testPowerLoss();
+	printf("test_eekv: passed\n");
+	return 0;
+}
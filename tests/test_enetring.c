@@ -0,0 +1,279 @@
+/*
+ * @brief Host test of the Ethernet descriptor ring driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/enetring_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_TX      8
+#define NUM_RX      6
+
+static LPC_ENET_T hostENET;
+static ENET_ENHTXDESC_T txDescs[NUM_TX];
+static ENET_ENHRXDESC_T rxDescs[NUM_RX];
+static uint32_t rxBuffers[NUM_RX * ENETRING_RX_BUFSIZE / 4];
+
+/* DMA model state: descriptor positions, frames lost for lack of a receive
+   descriptor and the raw status bits. DMA_STAT is write one to clear. */
+static uint32_t dmaTx, dmaRx, numMissed, hostStat;
+
+static uint32_t numEvents, numSentOk, numSentBad;
+static uint8_t src[64][1600];
+static uint32_t srcLen[64];
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The MAC driver is not under test */
+void Chip_ENET_SetSpeed(LPC_ENET_T *pENET, bool speed100)
+{}
+
+void Chip_ENET_SetDuplex(LPC_ENET_T *pENET, bool full)
+{}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void hostClearStat(void)
+{
+	hostStat &= ~hostENET.DMA_STAT;
+	hostENET.DMA_STAT = 0;
+}
+
+static void hostIRQ(void)
+{
+	hostClearStat();
+	if (hostStat & hostENET.DMA_INT_EN & 0xFFFF) {
+		hostENET.DMA_STAT = hostStat;
+		Chip_ENETRING_IRQHandler();
+		hostClearStat();
+	}
+}
+
+/* Send the frame at the transmit DMA position. With loopback set and the
+   receiver on, it is received into the next receive descriptor. */
+static bool hostDMAStep(bool loopback)
+{
+	uint8_t frame[2048];
+	uint32_t len = 0, i = dmaTx, ctrl;
+	ENET_ENHRXDESC_T *pRx;
+
+	if (!(hostENET.DMA_OP_MODE & DMA_OM_ST) || !(txDescs[i].CTRLSTAT & TDES_OWN)) {
+		return false;
+	}
+	TEST_CHECK(txDescs[i].CTRLSTAT & TDES_ENH_FS);
+	for (;; ) {
+		ENET_ENHTXDESC_T *pTx = &txDescs[i];
+
+		TEST_CHECK(pTx->CTRLSTAT & TDES_OWN);
+		memcpy(frame + len, (void *) (uintptr_t) pTx->B1ADD, pTx->BSIZE & 0xFFF);
+		len += pTx->BSIZE & 0xFFF;
+		pTx->CTRLSTAT &= ~TDES_OWN;
+		ctrl = pTx->CTRLSTAT;
+		i = (ctrl & TDES_ENH_TER) ? 0 : i + 1;
+		if (ctrl & TDES_ENH_LS) {
+			if (ctrl & TDES_ENH_IC) {
+				hostStat |= DMA_ST_TI | DMA_ST_NIS;
+			}
+			break;
+		}
+	}
+	dmaTx = i;
+
+	if (!loopback || !(hostENET.MAC_CONFIG & MAC_CFG_RE)) {
+		return true;
+	}
+	pRx = &rxDescs[dmaRx];
+	if (!(pRx->STATUS & RDES_OWN)) {
+		numMissed++;
+		hostStat |= DMA_ST_RU | DMA_ST_AIE;
+		return true;
+	}
+	memcpy((void *) (uintptr_t) pRx->B1ADD, frame, len);
+	pRx->STATUS = RDES_FS | RDES_LS | ((len + 4) << 16);
+	dmaRx = (pRx->CTRL & RDES_ENH_RER) ? 0 : dmaRx + 1;
+	hostStat |= DMA_ST_RI | DMA_ST_NIS;
+	return true;
+}
+
+static void rxEvent(void)
+{
+	numEvents++;
+}
+
+static void txDone(void *cbData, Status status)
+{
+	if (status == SUCCESS) {
+		numSentOk++;
+	}
+	else {
+		numSentBad++;
+	}
+}
+
+static void resetModel(ENETRING_EVENT_T event)
+{
+	ENETRING_CFG_T cfg = {txDescs, NUM_TX, rxDescs, rxBuffers, NUM_RX, event};
+
+	memset(&hostENET, 0, sizeof(hostENET));
+	dmaTx = dmaRx = numMissed = hostStat = 0;
+	numEvents = numSentOk = numSentBad = 0;
+	TEST_CHECK(Chip_ENETRING_Init(&hostENET, &cfg) == SUCCESS);
+}
+
+/* Bursts of scatter-gather frames through the loopback, taken by a task
+   that polls while frames keep coming and holds and releases frames in
+   random order. Frames arrive intact and in order, ring overruns only lose
+   frames, and bursts take fewer receive interrupts than frames. */
+static void testLoopback(void)
+{
+	ENETRING_SEG_T segs[3];
+	ENETRING_RXFRAME_T held[NUM_RX], frame;
+	ENETRING_STATS_T *pStats;
+	uint32_t numSent = 0, numGot = 0, len, off, k, step, i, seq;
+	int n, numSegs, numHeld = 0, j;
+	int32_t lastSeq = -1;
+	bool polling = false;
+
+	resetModel(rxEvent);
+	segs[0].data = src[0];
+	segs[0].len = 60;
+	TEST_CHECK(Chip_ENETRING_Send(segs, 1, NULL, NULL) == ERROR);
+	Chip_ENETRING_SetLink(true, true, true);
+
+	srand(1);
+	for (step = 0; (step < 20000) && (numGot < 2000); step++) {
+		for (n = (step % 50) < 25 ? 3 : 0; (n > 0) && (numSent - numGot - numMissed < 40); n--) {
+			len = 60 + rand() % 1400;
+			k = numSent % 64;
+			numSegs = 1 + rand() % 3;
+			for (i = 0; i < len; i++) {
+				src[k][i] = (uint8_t) (numSent * 7 + i);
+			}
+			memcpy(src[k], &numSent, 4);
+			for (j = 0, off = 0; j < numSegs; j++) {
+				segs[j].data = src[k] + off;
+				segs[j].len = (j == numSegs - 1) ? len - off : len / numSegs;
+				off += segs[j].len;
+			}
+			srcLen[k] = len;
+			if (Chip_ENETRING_Send(segs, numSegs, txDone, NULL) == SUCCESS) {
+				numSent++;
+			}
+		}
+		for (n = rand() % 3; n >= 0; n--) {
+			hostDMAStep(true);
+			hostIRQ();
+		}
+
+		if (numEvents) {
+			numEvents = 0;
+			polling = true;
+		}
+		if (polling) {
+			for (n = 0; (n < 4) && Chip_ENETRING_Receive(&frame); n++) {
+				memcpy(&seq, frame.data, 4);
+				TEST_CHECK((int32_t) seq > lastSeq);
+				lastSeq = seq;
+				k = seq % 64;
+				TEST_CHECK(frame.len == srcLen[k] && memcmp(frame.data, src[k], frame.len) == 0);
+				numGot++;
+				held[numHeld++] = frame;
+				if ((numHeld >= 3) || (rand() % 2)) {
+					j = rand() % numHeld;
+					Chip_ENETRING_Release(&held[j]);
+					held[j] = held[--numHeld];
+				}
+			}
+			if ((n < 4) && Chip_ENETRING_EnableRXInt()) {
+				polling = false;
+			}
+			hostIRQ();
+		}
+		while (numHeld && ((rand() % 4) == 0)) {
+			Chip_ENETRING_Release(&held[--numHeld]);
+		}
+	}
+
+	pStats = Chip_ENETRING_GetStats();
+	TEST_CHECK(numGot >= 2000 && numMissed > 0);
+	TEST_CHECK(numGot + numMissed <= numSent && numSent - numGot - numMissed <= NUM_TX);
+	TEST_CHECK(numSentBad == 0 && pStats->rxErrors == 0);
+	TEST_CHECK(pStats->rxInts < pStats->rxFrames);
+	printf("test_enetring: %u frames received with %u receive interrupts, %u lost to overruns\n",
+		   (unsigned) pStats->rxFrames, (unsigned) pStats->rxInts, (unsigned) numMissed);
+}
+
+/* Frames still owned by the DMA when the link goes down fail, and sending
+   restarts where the next frame goes once it is back */
+static void testLinkDown(void)
+{
+	static uint8_t data[100];
+	ENETRING_SEG_T segs[2] = {{data, 60}, {data, 30}};
+	uint32_t k;
+
+	resetModel(NULL);
+	Chip_ENETRING_SetLink(true, true, true);
+	TEST_CHECK(Chip_ENETRING_Send(segs, 2, txDone, NULL) == SUCCESS);
+	TEST_CHECK(Chip_ENETRING_Send(segs, 1, txDone, NULL) == SUCCESS);
+	TEST_CHECK(Chip_ENETRING_Send(segs, 2, txDone, NULL) == SUCCESS);
+	TEST_CHECK(hostDMAStep(false));
+
+	Chip_ENETRING_SetLink(false, true, true);
+	TEST_CHECK(numSentOk == 1 && numSentBad == 2);
+	TEST_CHECK(Chip_ENETRING_TXFree() == NUM_TX && Chip_ENETRING_GetStats()->txAborted == 2);
+	TEST_CHECK(!(hostENET.DMA_OP_MODE & DMA_OM_ST));
+	TEST_CHECK(Chip_ENETRING_Send(segs, 1, txDone, NULL) == ERROR);
+
+	Chip_ENETRING_SetLink(true, true, true);
+	dmaTx = ((uintptr_t) hostENET.DMA_TRANS_DES_ADDR - (uintptr_t) txDescs) / sizeof(txDescs[0]);
+	for (k = 0; k < 20; k++) {
+		TEST_CHECK(Chip_ENETRING_Send(segs, (k & 1) + 1, txDone, NULL) == SUCCESS);
+		while (hostDMAStep(false)) {}
+		Chip_ENETRING_ReclaimTX();
+	}
+	TEST_CHECK(numSentOk == 21 && numSentBad == 2);
+	TEST_CHECK(Chip_ENETRING_TXFree() == NUM_TX);
+}
+
+int main(void)
+{
+	testLoopback();
+	testLinkDown();
+	printf("test_enetring: passed\n");
+	return 0;
+}
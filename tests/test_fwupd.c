@@ -0,0 +1,321 @@
+/*
+ * @brief Host test of the dual bank firmware updater
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+/* Both flash banks in host memory, below 4 GB like the rest of the image */
+static uint8_t hostBank[2][FWUPD_BANK_SIZE] __attribute__ ((aligned(16)));
+
+#undef FWUPD_BANK_A_BASE
+#undef FWUPD_BANK_B_BASE
+#define FWUPD_BANK_A_BASE   ((uint32_t) (uintptr_t) hostBank[IAP_FLASH_BANK_A])
+#define FWUPD_BANK_B_BASE   ((uint32_t) (uintptr_t) hostBank[IAP_FLASH_BANK_B])
+
+#include "../lpc_chip_43xx/src/fwupd_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Flash timing of the model */
+#define ERASE_US            100000
+#define PROGRAM_US          1000
+#define SET_BANK_US         5000
+#define STEP_US             50
+
+#define IMAGE_SIZE          (300 * 1024)
+
+static FWUPD_HANDLE_T hUpd;
+static uint8_t image[IMAGE_SIZE];
+
+/* Time taken by the IAP calls, the sector prepared for the next command,
+   bits programmed from 0 back to 1 and a sector made to fail its erase */
+static double iapUs;
+static int32_t preparedSector = -1;
+static uint32_t flashErrors;
+static int32_t failErase = -1;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+uint8_t Chip_IAP_Init(void)
+{
+	return IAP_CMD_SUCCESS;
+}
+
+uint8_t Chip_IAP_PreSectorForReadWrite(uint32_t strSector, uint32_t endSector, uint8_t bankNum)
+{
+	TEST_CHECK((strSector == endSector) && (bankNum == IAP_FLASH_BANK_B));
+	preparedSector = strSector;
+	iapUs += 5;
+	return IAP_CMD_SUCCESS;
+}
+
+uint8_t Chip_IAP_EraseSector(uint32_t strSector, uint32_t endSector, uint8_t bankNum)
+{
+	uint32_t offset, size;
+
+	if ((int32_t) strSector != preparedSector) {
+		return IAP_SECTOR_NOT_PREPARED;
+	}
+	preparedSector = -1;
+	if ((int32_t) strSector == failErase) {
+		return IAP_BUSY;
+	}
+
+	offset = (strSector < 8) ? strSector * 0x2000 : 0x10000 + (strSector - 8) * 0x10000;
+	size = (strSector < 8) ? 0x2000 : 0x10000;
+	memset(&hostBank[bankNum][offset], 0xFF, size);
+	iapUs += ERASE_US;
+	return IAP_CMD_SUCCESS;
+}
+
+uint8_t Chip_IAP_CopyRamToFlash(uint32_t dstAdd, uint32_t *srcAdd, uint32_t byteswrt)
+{
+	uint8_t *dst = (uint8_t *) (uintptr_t) dstAdd;
+	const uint8_t *src = (const uint8_t *) srcAdd;
+	uint32_t i;
+
+	if (preparedSector < 0) {
+		return IAP_SECTOR_NOT_PREPARED;
+	}
+	preparedSector = -1;
+
+	/* Programming only clears bits */
+	for (i = 0; i < byteswrt; i++) {
+		if (dst[i] != 0xFF) {
+			flashErrors++;
+		}
+		dst[i] &= src[i];
+	}
+	iapUs += PROGRAM_US;
+	return IAP_CMD_SUCCESS;
+}
+
+uint8_t Chip_IAP_Compare(uint32_t dstAdd, uint32_t srcAdd, uint32_t bytescmp)
+{
+	iapUs += bytescmp / 200.0;
+	return memcmp((void *) (uintptr_t) dstAdd, (void *) (uintptr_t) srcAdd, bytescmp) ? IAP_COMPARE_ERROR : IAP_CMD_SUCCESS;
+}
+
+uint8_t Chip_IAP_SetBootFlashBank(uint8_t bankNum)
+{
+	TEST_CHECK(bankNum == IAP_FLASH_BANK_B);
+	iapUs += SET_BANK_US;
+	return IAP_CMD_SUCCESS;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static uint32_t refCRC(const uint8_t *p, uint32_t len)
+{
+	uint32_t crc = 0xFFFFFFFF;
+	int k;
+
+	while (len--) {
+		crc ^= *p++;
+		for (k = 0; k < 8; k++) {
+			crc = (crc >> 1) ^ (0xEDB88320 & -(crc & 1));
+		}
+	}
+	return ~crc;
+}
+
+/* Random image whose first 8 vectors add up to 0, as the boot ROM wants */
+static void makeImage(uint32_t size)
+{
+	uint32_t *vectors = (uint32_t *) image;
+	uint32_t sum = 0, i;
+
+	for (i = 0; i < size; i++) {
+		image[i] = (uint8_t) rand();
+	}
+	for (i = 0; i < 7; i++) {
+		sum += vectors[i];
+	}
+	vectors[7] = -sum;
+}
+
+static void beginUpdate(uint32_t size, uint32_t crc)
+{
+	memset(hostBank[IAP_FLASH_BANK_B], 0x5A, FWUPD_BANK_SIZE);
+	flashErrors = 0;
+	iapUs = 0;
+	TEST_CHECK(Chip_FWUPD_Begin(&hUpd, size, crc) == SUCCESS);
+	TEST_CHECK(hUpd.base == FWUPD_BANK_B_BASE);
+}
+
+/* Stream the image over a link of the given rate in bytes per second.
+   Like RTOS_IO_FWUpdateWrite, the sender blocks when the page buffers are
+   full until the flash task finishes its next program or erase. With
+   eraseFirst, the whole image area is erased before the transfer starts,
+   the application being halted meanwhile. Returns the update time in
+   seconds. */
+static double streamImage(const char *link, double rate, bool eraseFirst)
+{
+	double t = 0, busyUntil = 0, busyUs = 0, stallUs = 0, sent = 0, want;
+	bool waiting = false, stepDone;
+	uint32_t n, got;
+
+	makeImage(IMAGE_SIZE);
+	beginUpdate(IMAGE_SIZE, refCRC(image, IMAGE_SIZE));
+	if (eraseFirst) {
+		while (hUpd.erased < IMAGE_SIZE) {
+			fwupdEraseNext(&hUpd);
+		}
+		t = busyUntil = busyUs = iapUs;
+	}
+
+	while ((Chip_FWUPD_GetState(&hUpd) == FWUPD_RECEIVING) && (t < 60e6)) {
+		/* Flash task, one IAP operation when the previous one is done */
+		stepDone = false;
+		if (t >= busyUntil) {
+			iapUs = 0;
+			if (Chip_FWUPD_Poll(&hUpd)) {
+				busyUntil = t + iapUs;
+				busyUs += iapUs;
+				stepDone = true;
+			}
+		}
+		if (waiting && stepDone) {
+			waiting = false;
+		}
+
+		/* Link, the bytes of this step arrive unless the sender waits */
+		if (waiting) {
+			stallUs += STEP_US;
+		}
+		else if (sent < IMAGE_SIZE) {
+			want = rate * STEP_US / 1e6;
+			n = (uint32_t) (sent + want) - (uint32_t) sent;
+			got = Chip_FWUPD_Write(&hUpd, &image[(uint32_t) sent], n);
+			if (got < n) {
+				waiting = true;
+				sent = (uint32_t) sent + got;
+			}
+			else {
+				sent += want;
+			}
+		}
+		t += STEP_US;
+	}
+
+	TEST_CHECK(Chip_FWUPD_GetState(&hUpd) == FWUPD_VERIFIED);
+	TEST_CHECK(memcmp(hostBank[IAP_FLASH_BANK_B], image, IMAGE_SIZE) == 0);
+	TEST_CHECK(flashErrors == 0);
+	TEST_CHECK(Chip_FWUPD_Activate(&hUpd) == SUCCESS);
+
+	printf("test_fwupd: %s, %s: %.2f s (transfer alone %.2f s), link stalled %.2f s, flash task busy %.0f%%\n",
+		   link, eraseFirst ? "erase all first" : "streaming", t / 1e6, IMAGE_SIZE / rate, stallUs / 1e6,
+		   100 * busyUs / t);
+	return t / 1e6;
+}
+
+/* Run the update to its end without timing, feeding data as it is taken */
+static FWUPD_STATE_T runUpdate(const uint8_t *data, uint32_t size)
+{
+	uint32_t sent = 0;
+
+	while (Chip_FWUPD_GetState(&hUpd) == FWUPD_RECEIVING) {
+		if (sent < size) {
+			sent += Chip_FWUPD_Write(&hUpd, &data[sent], size - sent);
+		}
+		if (!Chip_FWUPD_Poll(&hUpd) && (sent == size)) {
+			break;
+		}
+	}
+	return Chip_FWUPD_GetState(&hUpd);
+}
+
+/* Images that must not become the boot image */
+static void testRejects(void)
+{
+	uint32_t size = 20000 + 123;
+
+	/* Odd size, the last page is padded */
+	makeImage(size);
+	beginUpdate(size, refCRC(image, size));
+	TEST_CHECK(Chip_FWUPD_Begin(&hUpd, size, 0) == ERROR);
+	TEST_CHECK(runUpdate(image, size) == FWUPD_VERIFIED);
+	TEST_CHECK(memcmp(hostBank[IAP_FLASH_BANK_B], image, size) == 0);
+	TEST_CHECK(Chip_FWUPD_Write(&hUpd, image, 4) == 0);
+
+	/* A byte corrupted on the link */
+	beginUpdate(size, refCRC(image, size));
+	image[size / 2] ^= 0x10;
+	TEST_CHECK(runUpdate(image, size) == FWUPD_FAILED);
+	TEST_CHECK(Chip_FWUPD_Activate(&hUpd) == ERROR);
+
+	/* Correct CRC, but the boot ROM would not start the image */
+	image[size / 2] ^= 0x10;
+	image[0] ^= 1;
+	beginUpdate(size, refCRC(image, size));
+	TEST_CHECK(runUpdate(image, size) == FWUPD_FAILED);
+	TEST_CHECK(Chip_FWUPD_Activate(&hUpd) == ERROR);
+	image[0] ^= 1;
+
+	/* Failing erase */
+	failErase = 2;
+	beginUpdate(size, refCRC(image, size));
+	TEST_CHECK(runUpdate(image, size) == FWUPD_FAILED);
+	TEST_CHECK(hUpd.status == IAP_BUSY);
+	failErase = -1;
+
+	/* Too large or too small */
+	TEST_CHECK(Chip_FWUPD_Begin(&hUpd, FWUPD_BANK_SIZE + 4, 0) == ERROR);
+	TEST_CHECK(Chip_FWUPD_Begin(&hUpd, 16, 0) == ERROR);
+}
+
+int main(void)
+{
+	double uartFirst, uartStream, usbFirst, usbStream;
+
+	srand(11);
+	hostCREG.MXMEMMAP = FWUPD_BANK_A_BASE;
+
+	uartFirst = streamImage("UART 921600", 92160, true);
+	uartStream = streamImage("UART 921600", 92160, false);
+	usbFirst = streamImage("USB CDC", 1000000, true);
+	usbStream = streamImage("USB CDC", 1000000, false);
+
+	/* Erase-ahead hides most of the erases behind the slow link, the fast
+	   link is limited by the flash either way */
+	TEST_CHECK(uartStream < uartFirst - 0.5);
+	TEST_CHECK(uartStream < (IMAGE_SIZE / 92160.0) + 0.4);
+	TEST_CHECK((usbStream - usbFirst) < 0.05);
+
+	testRejects();
+	printf("test_fwupd: passed\n");
+	return 0;
+}
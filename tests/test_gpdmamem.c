@@ -0,0 +1,249 @@
+/*
+ * @brief Host test of the GPDMA memory copy/fill engine
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+
+#include "../lpc_chip_43xx/src/gpdma_18xx_43xx.c"
+#include "gpdma_model.h"
+#define Chip_GPDMA_ChannelCmd hostChannelCmd
+#include "../lpc_chip_43xx/src/gpdmamgr_18xx_43xx.c"
+#undef Chip_GPDMA_ChannelCmd
+
+/* The engine sees a channel manager that can be told to refuse requests,
+   and a PRIMASK the callbacks can check */
+static int hostRefuse;
+static uint32_t hostPrimask;
+
+static Status hostMgrSubmit(GPDMAMGR_REQ_T *pReq)
+{
+	if (hostRefuse > 0) {
+		hostRefuse--;
+		return ERROR;
+	}
+	return Chip_GPDMAMGR_Submit(pReq);
+}
+
+#undef __get_PRIMASK
+#undef __set_PRIMASK
+#undef __disable_irq
+#define __get_PRIMASK()     hostPrimask
+#define __set_PRIMASK(x)    (hostPrimask = (x))
+#define __disable_irq()     (hostPrimask = 1)
+#define Chip_GPDMAMGR_Submit hostMgrSubmit
+#include "../lpc_chip_43xx/src/gpdmamem_18xx_43xx.c"
+#undef Chip_GPDMAMGR_Submit
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Long enough for several segments of GPDMAMEM_MAX_DESC descriptors */
+#define BIG_LEN     (3 * GPDMAMEM_MAX_DESC * GPDMAMEM_MAX_XFER * 4 + 37)
+#define NUM_REQS    6
+
+static uint8_t srcBuf[BIG_LEN + 8], dstBuf[BIG_LEN + 8];
+static uint8_t smallSrc[NUM_REQS][300], smallDst[NUM_REQS][300];
+static GPDMAMEM_REQ_T reqs[NUM_REQS];
+
+static GPDMAMEM_REQ_T *pDoneLog[NUM_REQS * 2];
+static int numDone;
+static GPDMAMEM_REQ_T *pResubmit;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void doneCb(GPDMAMEM_REQ_T *pReq)
+{
+	TEST_CHECK(hostPrimask == 0);
+	TEST_CHECK(numDone < NUM_REQS * 2);
+	pDoneLog[numDone++] = pReq;
+	if (pResubmit) {
+		GPDMAMEM_REQ_T *pNext = pResubmit;
+
+		pResubmit = NULL;
+		TEST_CHECK(Chip_GPDMAMEM_Submit(pNext) == SUCCESS);
+	}
+}
+
+static void resetModel(void)
+{
+	memset(&hostGPDMA, 0, sizeof(hostGPDMA));
+	memset(reqs, 0, sizeof(reqs));
+	numDone = 0;
+	pResubmit = NULL;
+	hostFailMask = 0;
+	hostRefuse = 0;
+	Chip_GPDMAMGR_Init(&hostGPDMA, 0x01);
+	Chip_GPDMAMEM_Init();
+}
+
+static void fill(uint8_t *p, uint32_t len, uint32_t seed)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		p[i] = (uint8_t) (seed + i * 7 + (i >> 8));
+	}
+}
+
+/* Every alignment pairing and lengths across the CPU threshold */
+static void testCopyFill(void)
+{
+	uint32_t so, dof, len;
+	static const uint32_t lens[] = {0, 1, 63, 64, 65, 257, 4095 * 4 + 3, BIG_LEN};
+	int l;
+
+	resetModel();
+	fill(srcBuf, sizeof(srcBuf), 5);
+	for (l = 0; l < (int) (sizeof(lens) / sizeof(lens[0])); l++) {
+		for (so = 0; so < 4; so++) {
+			for (dof = 0; dof < 4; dof++) {
+				len = lens[l];
+				numDone = 0;
+				memset(dstBuf, 0xEE, sizeof(dstBuf));
+				Chip_GPDMAMEM_SetupCopy(&reqs[0], dstBuf + dof, srcBuf + so, len, doneCb, NULL);
+				TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[0]) == SUCCESS);
+				hostPumpAll();
+				TEST_CHECK(Chip_GPDMAMEM_IsDone(&reqs[0]) && reqs[0].status == SUCCESS);
+				TEST_CHECK(memcmp(dstBuf + dof, srcBuf + so, len) == 0);
+				TEST_CHECK(dstBuf[dof + len] == 0xEE && (dof == 0 || dstBuf[dof - 1] == 0xEE));
+
+				Chip_GPDMAMEM_SetupFill(&reqs[1], dstBuf + dof, (uint8_t) (len + so), len, doneCb, NULL);
+				TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[1]) == SUCCESS);
+				hostPumpAll();
+				TEST_CHECK(Chip_GPDMAMEM_IsDone(&reqs[1]) && reqs[1].status == SUCCESS);
+				TEST_CHECK(len == 0 || (dstBuf[dof] == (uint8_t) (len + so) &&
+										memcmp(dstBuf + dof, dstBuf + dof + 1, len - 1) == 0));
+				TEST_CHECK(dstBuf[dof + len] == 0xEE);
+			}
+		}
+	}
+	TEST_CHECK(memStats.errors == 0 && memStats.segments > memStats.dmaReqs);
+	TEST_CHECK(hostPrimask == 0);
+}
+
+/* Requests queue behind the running one and complete in order, also when
+   submitted from a completion callback */
+static void testQueue(void)
+{
+	int i;
+
+	resetModel();
+	for (i = 0; i < 3; i++) {
+		fill(smallSrc[i], sizeof(smallSrc[i]), i);
+		Chip_GPDMAMEM_SetupCopy(&reqs[i], smallDst[i], smallSrc[i], sizeof(smallSrc[i]), doneCb, NULL);
+	}
+	fill(smallSrc[3], sizeof(smallSrc[3]), 3);
+	Chip_GPDMAMEM_SetupCopy(&reqs[3], smallDst[3], smallSrc[3], sizeof(smallSrc[3]), doneCb, NULL);
+	pResubmit = &reqs[3];
+	for (i = 0; i < 3; i++) {
+		TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[i]) == SUCCESS);
+	}
+	TEST_CHECK(numDone == 0 && pMemHead == &reqs[0] && pMemTail == &reqs[2]);
+	hostPumpAll();
+	TEST_CHECK(numDone == 4);
+	for (i = 0; i < 4; i++) {
+		TEST_CHECK(pDoneLog[i] == &reqs[i] && reqs[i].status == SUCCESS);
+		TEST_CHECK(memcmp(smallDst[i], smallSrc[i], sizeof(smallSrc[i])) == 0);
+	}
+	TEST_CHECK(pMemHead == NULL && pMemTail == NULL);
+}
+
+/* A DMA error ends the request and the queue carries on */
+static void testDMAError(void)
+{
+	resetModel();
+	Chip_GPDMAMEM_SetupCopy(&reqs[0], smallDst[0], smallSrc[0], 200, doneCb, NULL);
+	Chip_GPDMAMEM_SetupCopy(&reqs[1], smallDst[1], smallSrc[1], 200, doneCb, NULL);
+	hostFailMask = 0x01;
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[0]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[1]) == SUCCESS);
+	hostPumpAll();
+	TEST_CHECK(numDone == 2 && reqs[0].status == ERROR && reqs[1].status == SUCCESS);
+	TEST_CHECK(memStats.errors == 1 && pMemHead == NULL);
+}
+
+/* The channel manager refuses the first segment, a continuation segment and
+   the next queued request: each fails with ERROR and nothing stalls */
+static void testRefused(void)
+{
+	resetModel();
+	memset(smallDst, 0, sizeof(smallDst));
+
+	/* First segment, completed from Submit */
+	Chip_GPDMAMEM_SetupCopy(&reqs[0], smallDst[0], smallSrc[0], 200, doneCb, NULL);
+	hostRefuse = 1;
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[0]) == SUCCESS);
+	TEST_CHECK(numDone == 1 && reqs[0].done && reqs[0].status == ERROR);
+	TEST_CHECK(pMemHead == NULL && pMemTail == NULL);
+
+	/* Continuation segment of a long request */
+	Chip_GPDMAMEM_SetupCopy(&reqs[1], dstBuf, srcBuf, BIG_LEN, doneCb, NULL);
+	Chip_GPDMAMEM_SetupCopy(&reqs[2], smallDst[2], smallSrc[2], 200, doneCb, NULL);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[1]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[2]) == SUCCESS);
+	hostRefuse = 1;
+	hostPumpAll();
+	TEST_CHECK(numDone == 3 && pDoneLog[1] == &reqs[1] && pDoneLog[2] == &reqs[2]);
+	TEST_CHECK(reqs[1].status == ERROR && reqs[2].status == SUCCESS);
+
+	/* Two queued requests refused in a row, the third still runs */
+	Chip_GPDMAMEM_SetupCopy(&reqs[3], smallDst[3], smallSrc[3], 200, doneCb, NULL);
+	Chip_GPDMAMEM_SetupCopy(&reqs[4], smallDst[4], smallSrc[4], 200, doneCb, NULL);
+	Chip_GPDMAMEM_SetupCopy(&reqs[5], smallDst[5], smallSrc[5], 200, doneCb, NULL);
+	fill(smallSrc[5], 200, 9);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[0]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[3]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[4]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMEM_Submit(&reqs[5]) == SUCCESS);
+	hostRefuse = 2;
+	hostPumpAll();
+	TEST_CHECK(numDone == 7);
+	TEST_CHECK(pDoneLog[3] == &reqs[0] && pDoneLog[4] == &reqs[3] && pDoneLog[5] == &reqs[4]);
+	TEST_CHECK(pDoneLog[6] == &reqs[5]);
+	TEST_CHECK(reqs[0].status == SUCCESS && reqs[3].status == ERROR && reqs[4].status == ERROR);
+	TEST_CHECK(reqs[5].status == SUCCESS && memcmp(smallDst[5], smallSrc[5], 200) == 0);
+	TEST_CHECK(pMemHead == NULL && pMemTail == NULL && memStats.errors == 4);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	testCopyFill();
+	testQueue();
+	testDMAError();
+	testRefused();
+	printf("test_gpdmamem: passed, %u interrupts\n", (unsigned) hostIRQs);
+	return 0;
+}
@@ -0,0 +1,314 @@
+/*
+ * @brief Host test of the GPDMA channel manager
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "../lpc_chip_43xx/src/gpdma_18xx_43xx.c"
+#include "gpdma_model.h"
+#define Chip_GPDMA_ChannelCmd hostChannelCmd
+#include "../lpc_chip_43xx/src/gpdmamgr_18xx_43xx.c"
+#undef Chip_GPDMA_ChannelCmd
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_REQS    8
+#define BUF_SIZE    1000
+
+typedef struct {
+	GPDMAMGR_REQ_T req;
+	DMA_TransferDescriptor_t desc[2];
+	uint8_t src[BUF_SIZE];
+	uint8_t dst[BUF_SIZE];
+} TEST_XFER_T;
+
+static TEST_XFER_T xfers[NUM_REQS];
+
+/* Completion order */
+static GPDMAMGR_REQ_T *pDoneLog[NUM_REQS * 2];
+static int numDone;
+
+/* Request expected to be running already when the next callback comes */
+static GPDMAMGR_REQ_T *pExpectRunning;
+static GPDMAMGR_REQ_T *pResubmit;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void doneCb(GPDMAMGR_REQ_T *pReq)
+{
+	TEST_CHECK(numDone < NUM_REQS * 2);
+	pDoneLog[numDone++] = pReq;
+
+	/* Queued work must be chained before anyone is told */
+	if (pExpectRunning) {
+		TEST_CHECK(Chip_GPDMAMGR_GetNextDesc(pExpectRunning) != NULL);
+		TEST_CHECK(hostEnabled() & (1 << pExpectRunning->channel));
+		pExpectRunning = NULL;
+	}
+	if (pResubmit) {
+		TEST_CHECK(Chip_GPDMAMGR_Submit(pResubmit) == SUCCESS);
+		pResubmit = NULL;
+	}
+}
+
+static void resetModel(uint8_t chanMask)
+{
+	memset(&hostGPDMA, 0, sizeof(hostGPDMA));
+	memset(xfers, 0, sizeof(xfers));
+	numDone = 0;
+	pExpectRunning = pResubmit = NULL;
+	hostFailMask = 0;
+	Chip_GPDMAMGR_Init(&hostGPDMA, chanMask);
+}
+
+/* Copy len bytes over two descriptors, on connection conn */
+static GPDMAMGR_REQ_T *setupXfer(int i, uint32_t len, uint8_t conn, uint8_t priority)
+{
+	TEST_XFER_T *pX = &xfers[i];
+	uint32_t ctrl, first = len / 2, k;
+
+	for (k = 0; k < len; k++) {
+		pX->src[k] = (uint8_t) (i * 37 + k * 11 + 1);
+	}
+	ctrl = GPDMA_DMACCxControl_SWidth(GPDMA_WIDTH_BYTE) | GPDMA_DMACCxControl_DWidth(GPDMA_WIDTH_BYTE)
+		   | GPDMA_DMACCxControl_SI | GPDMA_DMACCxControl_DI;
+	pX->desc[0].src = (uint32_t) (uintptr_t) pX->src;
+	pX->desc[0].dst = (uint32_t) (uintptr_t) pX->dst;
+	pX->desc[0].lli = (uint32_t) (uintptr_t) &pX->desc[1];
+	pX->desc[0].ctrl = ctrl | GPDMA_DMACCxControl_TransferSize(first);
+	pX->desc[1].src = pX->desc[0].src + first;
+	pX->desc[1].dst = pX->desc[0].dst + first;
+	pX->desc[1].lli = 0;
+	pX->desc[1].ctrl = ctrl | GPDMA_DMACCxControl_TransferSize((len - first)) | GPDMA_DMACCxControl_I;
+
+	/* The model moves memory whatever the connection, only queueing differs */
+	Chip_GPDMAMGR_SetupReq(&pX->req, pX->desc,
+						   (conn == GPDMA_CONN_MEMORY) ? GPDMA_TRANSFERTYPE_M2M_CONTROLLER_DMA :
+						   GPDMA_TRANSFERTYPE_M2P_CONTROLLER_DMA,
+						   GPDMA_CONN_MEMORY, conn, priority, doneCb, NULL);
+	return &pX->req;
+}
+
+static bool copied(int i, uint32_t len)
+{
+	return memcmp(xfers[i].src, xfers[i].dst, len) == 0;
+}
+
+static bool untouched(int i)
+{
+	static const uint8_t zero[BUF_SIZE];
+
+	return memcmp(xfers[i].dst, zero, BUF_SIZE) == 0;
+}
+
+/* Requests on one connection run one at a time, in order */
+static void testQueueing(void)
+{
+	GPDMAMGR_REQ_T *pReq[3];
+	int i;
+
+	resetModel(0x0F);
+	for (i = 0; i < 3; i++) {
+		pReq[i] = setupXfer(i, 100 + i * 300, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_LOW);
+		TEST_CHECK(Chip_GPDMAMGR_Submit(pReq[i]) == SUCCESS);
+	}
+	TEST_CHECK(hostEnabled() == 0x01);
+	TEST_CHECK(Chip_GPDMAMGR_GetQueueDepth(GPDMA_CONN_MEMORY) == 2);
+	TEST_CHECK(Chip_GPDMAMGR_GetMaxQueueDepth(GPDMA_CONN_MEMORY) == 2);
+
+	pExpectRunning = pReq[1];
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 1 && pExpectRunning == NULL);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 3);
+	for (i = 0; i < 3; i++) {
+		TEST_CHECK(pDoneLog[i] == pReq[i]);
+		TEST_CHECK(Chip_GPDMAMGR_IsDone(pReq[i]) && pReq[i]->status == SUCCESS);
+		TEST_CHECK(copied(i, 100 + i * 300));
+	}
+	TEST_CHECK(Chip_GPDMAMGR_GetQueueDepth(GPDMA_CONN_MEMORY) == 0);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->transfers == 3);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->busyTicks == 100 + 400 + 700);
+	TEST_CHECK(Chip_GPDMAMGR_GetUtilization(0) == 1000);
+
+	/* Different connections get their own channels */
+	resetModel(0x0F);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(setupXfer(0, 10, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_LOW)) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(setupXfer(1, 10, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_LOW)) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(setupXfer(2, 10, GPDMA_CONN_SSP0_Tx, GPDMAMGR_PRIO_LOW)) == SUCCESS);
+	TEST_CHECK(hostEnabled() == 0x07);
+	hostPumpAll();
+	TEST_CHECK(hostIRQs > 0 && numDone == 3);
+
+	/* Bad requests are refused */
+	setupXfer(3, 10, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_LOW)->pDesc = NULL;
+	TEST_CHECK(Chip_GPDMAMGR_Submit(&xfers[3].req) == ERROR);
+	setupXfer(3, 10, GPDMAMGR_NUM_CONN, GPDMAMGR_PRIO_LOW);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(&xfers[3].req) == ERROR);
+}
+
+/* A free channel goes to the highest priority, then the oldest request */
+static void testPriority(void)
+{
+	GPDMAMGR_REQ_T *pBlock, *pA, *pB, *pC, *pD, *pX, *pY;
+
+	resetModel(0x01);
+	pBlock = setupXfer(0, 50, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_LOW);
+	pA = setupXfer(1, 50, GPDMA_CONN_SSP0_Tx, GPDMAMGR_PRIO_NORMAL);
+	pB = setupXfer(2, 50, GPDMA_CONN_SSP1_Tx, GPDMAMGR_PRIO_HIGHEST);
+	pC = setupXfer(3, 50, GPDMA_CONN_UART1_Tx, GPDMAMGR_PRIO_NORMAL);
+	pD = setupXfer(4, 50, GPDMA_CONN_I2S_Tx_Channel_0, GPDMAMGR_PRIO_HIGH);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pBlock) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pA) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pB) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pC) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pD) == SUCCESS);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 5);
+	TEST_CHECK(pDoneLog[0] == pBlock && pDoneLog[1] == pB && pDoneLog[2] == pD);
+	TEST_CHECK(pDoneLog[3] == pA && pDoneLog[4] == pC);
+
+	/* Lower channel numbers, which win on the bus, go to higher priorities */
+	resetModel(0x06);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(setupXfer(0, 50, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_LOW)) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(setupXfer(1, 50, GPDMA_CONN_UART1_Tx, GPDMAMGR_PRIO_LOW)) == SUCCESS);
+	pY = setupXfer(2, 50, GPDMA_CONN_SSP0_Tx, GPDMAMGR_PRIO_LOW);
+	pX = setupXfer(3, 50, GPDMA_CONN_SSP1_Tx, GPDMAMGR_PRIO_HIGH);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pY) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pX) == SUCCESS);
+	TEST_CHECK(hostEnabled() == 0x06);
+	TEST_CHECK(hostPump());
+	TEST_CHECK(pX->channel == 1 && pY->channel == 2);
+	TEST_CHECK(hostGPDMA.CH[1].LLI == xfers[3].desc[0].lli);
+	TEST_CHECK(hostCREG.DMAMUX != 0);
+	hostPumpAll();
+	TEST_CHECK(copied(2, 50) && copied(3, 50));
+}
+
+/* Cancel queued requests at every queue position and a running one */
+static void testCancel(void)
+{
+	GPDMAMGR_REQ_T *pBlock, *pQ[5];
+	int i;
+
+	resetModel(0x01);
+	pBlock = setupXfer(0, 200, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_LOW);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pBlock) == SUCCESS);
+	for (i = 0; i < 4; i++) {
+		pQ[i] = setupXfer(i + 1, 100 + i, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_NORMAL);
+		TEST_CHECK(Chip_GPDMAMGR_Submit(pQ[i]) == SUCCESS);
+	}
+	TEST_CHECK(Chip_GPDMAMGR_GetQueueDepth(GPDMA_CONN_MEMORY) == 4);
+
+	/* Middle, tail and head of the queue, callbacks run before returning */
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pQ[1]) == SUCCESS);
+	TEST_CHECK(numDone == 1 && pDoneLog[0] == pQ[1] && pQ[1]->status == ERROR);
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pQ[3]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pQ[0]) == SUCCESS);
+	TEST_CHECK(numDone == 3 && Chip_GPDMAMGR_GetQueueDepth(GPDMA_CONN_MEMORY) == 1);
+
+	/* The tail moved back, a new request must land behind the survivor */
+	pQ[4] = setupXfer(5, 120, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_NORMAL);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pQ[4]) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_GetQueueDepth(GPDMA_CONN_MEMORY) == 2);
+
+	/* Cancel the running one, its channel is stopped and reused at once */
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pBlock) == SUCCESS);
+	TEST_CHECK(pBlock->status == ERROR && Chip_GPDMAMGR_IsDone(pBlock));
+	TEST_CHECK(pQ[2]->channel == 0 && Chip_GPDMAMGR_GetNextDesc(pQ[2]) != NULL);
+	TEST_CHECK(hostEnabled() == 0x01);
+	TEST_CHECK(Chip_GPDMAMGR_GetNextDesc(pBlock) == NULL);
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pBlock) == ERROR);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->errors == 1);
+
+	hostPumpAll();
+	TEST_CHECK(numDone == 6);
+	TEST_CHECK(pDoneLog[4] == pQ[2] && pDoneLog[5] == pQ[4]);
+	TEST_CHECK(copied(3, 102) && copied(5, 120));
+	TEST_CHECK(untouched(0) && untouched(1) && untouched(2) && untouched(4));
+	TEST_CHECK(Chip_GPDMAMGR_Cancel(pQ[4]) == ERROR);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->transfers == 2);
+}
+
+/* A bus error ends the request and the queue carries on */
+static void testError(void)
+{
+	GPDMAMGR_REQ_T *pE, *pN;
+
+	resetModel(0x03);
+	pE = setupXfer(0, 64, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_NORMAL);
+	pN = setupXfer(1, 64, GPDMA_CONN_MEMORY, GPDMAMGR_PRIO_NORMAL);
+	hostFailMask = 0x01;
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pE) == SUCCESS);
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pN) == SUCCESS);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 2 && pDoneLog[0] == pE && pDoneLog[1] == pN);
+	TEST_CHECK(pE->status == ERROR && pN->status == SUCCESS);
+	TEST_CHECK(untouched(0) && copied(1, 64));
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->errors == 1);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(0)->transfers == 1);
+	TEST_CHECK((hostGPDMA.CH[0].CONFIG & GPDMA_DMACCxConfig_E) == 0);
+}
+
+/* A completion callback can submit, the new request runs without a task */
+static void testResubmit(void)
+{
+	GPDMAMGR_REQ_T *pFirst, *pSecond;
+
+	resetModel(0x01);
+	pFirst = setupXfer(0, 30, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_NORMAL);
+	pSecond = setupXfer(1, 40, GPDMA_CONN_UART0_Tx, GPDMAMGR_PRIO_NORMAL);
+	pResubmit = pSecond;
+	TEST_CHECK(Chip_GPDMAMGR_Submit(pFirst) == SUCCESS);
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 1 && Chip_GPDMAMGR_GetNextDesc(pSecond) != NULL);
+	hostPumpAll();
+	TEST_CHECK(numDone == 2 && copied(0, 30) && copied(1, 40));
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	testQueueing();
+	testPriority();
+	testCancel();
+	testError();
+	testResubmit();
+	printf("test_gpdmamgr: passed, %u interrupts\n", (unsigned) hostIRQs);
+	return 0;
+}
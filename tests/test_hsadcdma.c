@@ -0,0 +1,195 @@
+/*
+ * @brief Host test of the HSADC streaming driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/hsadcdma_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define BLOCK_WORDS     64
+#define NUM_BLOCKS      6
+#define NUM_WORDS       400000
+
+static LPC_HSADC_T hostHSADC;
+static uint32_t buffers[NUM_BLOCKS * BLOCK_WORDS];
+
+/* Descriptor chain model: the request being run, a copy of the loaded
+   descriptor, and a counter source standing in for the FIFO */
+static GPDMAMGR_REQ_T *pRunning;
+static DMA_TransferDescriptor_t loaded;
+static uint32_t nextWord, wordsLeft, numEnded;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The HSADC and the channel manager are not under test */
+void Chip_HSADC_SetupFIFO(LPC_HSADC_T *pHSADC, uint8_t trip, bool packed)
+{}
+
+Status Chip_GPDMAMGR_Submit(GPDMAMGR_REQ_T *pReq)
+{
+	pRunning = pReq;
+	return SUCCESS;
+}
+
+Status Chip_GPDMAMGR_Cancel(GPDMAMGR_REQ_T *pReq)
+{
+	pRunning = NULL;
+	pReq->cb(pReq);
+	return SUCCESS;
+}
+
+const DMA_TransferDescriptor_t *Chip_GPDMAMGR_GetNextDesc(const GPDMAMGR_REQ_T *pReq)
+{
+	return (pReq == pRunning) ? (const DMA_TransferDescriptor_t *) (uintptr_t) loaded.lli : NULL;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void hostLoad(uint32_t addr)
+{
+	loaded = *(DMA_TransferDescriptor_t *) (uintptr_t) addr;
+	wordsLeft = loaded.ctrl & 0xFFF;
+}
+
+/* Move one word, true when the descriptor ended */
+static bool hostDMAWord(void)
+{
+	*(uint32_t *) (uintptr_t) loaded.dst = nextWord++;
+	if (loaded.ctrl & GPDMA_DMACCxControl_DI) {
+		loaded.dst += 4;
+	}
+	if (--wordsLeft == 0) {
+		numEnded++;
+		hostLoad(loaded.lli);
+		return true;
+	}
+	return false;
+}
+
+/* A block holds consecutive words, starting at its sequence number */
+static bool blockIntact(const uint32_t *pBlock, uint32_t seq)
+{
+	uint32_t i;
+
+	for (i = 0; i < BLOCK_WORDS; i++) {
+		if (pBlock[i] != (seq * BLOCK_WORDS) + i) {
+			return false;
+		}
+	}
+	return true;
+}
+
+/* Stream with the block interrupt held off up to maxDelay words after a
+   block end, pending ends merging into one interrupt, for the first half.
+   A consumer polls every 100 words and holds up to two blocks. Every block
+   handed out matches its sequence number while it is held, sequence numbers
+   only increase, and blocks plus dropped account for every ended block. */
+static void runStream(uint32_t maxDelay)
+{
+	uint32_t *held[NUM_BLOCKS], *pBlock;
+	uint32_t heldSeq[NUM_BLOCKS], seq, lastSeq = 0, numHeld = 0, numGot = 0, t, i;
+	uint32_t delay = 0;
+	bool pending = false;
+	HSADCDMA_STATS_T *pStats;
+
+	nextWord = numEnded = 0;
+	TEST_CHECK(Chip_HSADCDMA_Init(&hostHSADC, buffers, BLOCK_WORDS, NUM_BLOCKS, NULL) == SUCCESS);
+	TEST_CHECK(Chip_HSADCDMA_Start() == SUCCESS);
+	hostLoad((uint32_t) (uintptr_t) pRunning->pDesc);
+
+	for (t = 0; t < NUM_WORDS; t++) {
+		if (hostDMAWord() && !pending) {
+			pending = true;
+			delay = (t < NUM_WORDS / 2) ? rand() % (maxDelay + 1) : 0;
+		}
+		if (pending && (delay-- == 0)) {
+			pending = false;
+			pRunning->progressCb(pRunning);
+		}
+
+		if ((t % 100) == 0) {
+			while ((pBlock = Chip_HSADCDMA_GetBlock(&seq)) != NULL) {
+				TEST_CHECK(numGot == 0 || seq > lastSeq);
+				TEST_CHECK(blockIntact(pBlock, seq));
+				for (i = 0; i < numHeld; i++) {
+					TEST_CHECK(held[i] != pBlock);
+				}
+				lastSeq = seq;
+				numGot++;
+				held[numHeld] = pBlock;
+				heldSeq[numHeld++] = seq;
+			}
+			while (numHeld > (uint32_t) (rand() % 3)) {
+				TEST_CHECK(blockIntact(held[0], heldSeq[0]));
+				Chip_HSADCDMA_ReleaseBlock(held[0]);
+				numHeld--;
+				memmove(held, held + 1, numHeld * sizeof(held[0]));
+				memmove(heldSeq, heldSeq + 1, numHeld * sizeof(heldSeq[0]));
+			}
+		}
+	}
+	Chip_HSADCDMA_Stop();
+
+	pStats = Chip_HSADCDMA_GetStats();
+	TEST_CHECK(pStats->blocks + pStats->dropped <= numEnded);
+	TEST_CHECK(pStats->blocks + pStats->dropped + 1 >= numEnded);
+	TEST_CHECK(numGot + numHeld >= pStats->blocks - NUM_BLOCKS);
+	printf("test_hsadcdma: delay up to %3u words: %u blocks, %u dropped, %u late interrupts\n",
+		   (unsigned) maxDelay, (unsigned) pStats->blocks, (unsigned) pStats->dropped,
+		   (unsigned) pStats->lateIrqs);
+}
+
+int main(void)
+{
+	srand(5);
+
+	/* Served at once nothing is dropped, within one block no interrupt is late */
+	runStream(0);
+	TEST_CHECK(Chip_HSADCDMA_GetStats()->lateIrqs == 0 && Chip_HSADCDMA_GetStats()->dropped == 0);
+	runStream(BLOCK_WORDS - 1);
+	TEST_CHECK(Chip_HSADCDMA_GetStats()->lateIrqs == 0);
+
+	/* Late interrupts, up to the numBlocks - 2 block times allowed */
+	runStream(BLOCK_WORDS + BLOCK_WORDS / 2);
+	TEST_CHECK(Chip_HSADCDMA_GetStats()->lateIrqs > 0);
+	runStream((NUM_BLOCKS - 2) * BLOCK_WORDS - 1);
+	TEST_CHECK(Chip_HSADCDMA_GetStats()->lateIrqs > 0);
+
+	printf("test_hsadcdma: passed\n");
+	return 0;
+}
@@ -0,0 +1,289 @@
+/*
+ * @brief Host test of the I2S audio streaming driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/i2sdma_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define PERIOD_WORDS    32
+#define NUM_PERIODS     6
+#define FIFO_WORDS      8
+
+/* Model channels, transmit and receive */
+#define CH_TX           0
+#define CH_RX           1
+
+static LPC_I2S_T hostI2S;
+static uint32_t txBuffers[NUM_PERIODS * PERIOD_WORDS], rxBuffers[NUM_PERIODS * PERIOD_WORDS];
+
+/* Descriptor chain model per channel: the request, a copy of the loaded
+   descriptor, words left in it and ended descriptors not yet signalled */
+static GPDMAMGR_REQ_T *pChReq[2];
+static DMA_TransferDescriptor_t loaded[2];
+static uint32_t wordsLeft[2], numEnded[2];
+static bool endPending[2], dmaOn[2];
+
+/* I2S FIFOs, looped back one frame per tick */
+static uint32_t txFifo[FIFO_WORDS], rxFifo[FIFO_WORDS];
+static uint32_t txLevel, rxLevel, fifoUnderflows, fifoOverflows;
+
+static uint32_t nextTx, lastRx;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The channel manager and the I2S driver are not under test */
+static int hostChannel(const GPDMAMGR_REQ_T *pReq)
+{
+	return (pReq->type == GPDMA_TRANSFERTYPE_P2M_CONTROLLER_DMA) ? CH_RX : CH_TX;
+}
+
+static void hostLoad(int ch, uint32_t addr)
+{
+	loaded[ch] = *(DMA_TransferDescriptor_t *) (uintptr_t) addr;
+	wordsLeft[ch] = loaded[ch].ctrl & 0xFFF;
+}
+
+Status Chip_GPDMAMGR_Submit(GPDMAMGR_REQ_T *pReq)
+{
+	int ch = hostChannel(pReq);
+
+	pChReq[ch] = pReq;
+	hostLoad(ch, (uint32_t) (uintptr_t) pReq->pDesc);
+	return SUCCESS;
+}
+
+Status Chip_GPDMAMGR_Cancel(GPDMAMGR_REQ_T *pReq)
+{
+	pChReq[hostChannel(pReq)] = NULL;
+	pReq->cb(pReq);
+	return SUCCESS;
+}
+
+const DMA_TransferDescriptor_t *Chip_GPDMAMGR_GetNextDesc(const GPDMAMGR_REQ_T *pReq)
+{
+	int ch = hostChannel(pReq);
+
+	return (pChReq[ch] == pReq) ? (const DMA_TransferDescriptor_t *) (uintptr_t) loaded[ch].lli : NULL;
+}
+
+void Chip_I2S_DMA_TxCmd(LPC_I2S_T *pI2S, I2S_DMA_CHANNEL_T dmaNum, FunctionalState newState, uint8_t depth)
+{
+	dmaOn[CH_TX] = (newState == ENABLE);
+}
+
+void Chip_I2S_DMA_RxCmd(LPC_I2S_T *pI2S, I2S_DMA_CHANNEL_T dmaNum, FunctionalState newState, uint8_t depth)
+{
+	dmaOn[CH_RX] = (newState == ENABLE);
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Move FIFO_DEPTH word bursts while the FIFOs request them */
+static void hostDMAService(void)
+{
+	int ch, i;
+
+	for (ch = 0; ch < 2; ch++) {
+		if (!pChReq[ch] || !dmaOn[ch]) {
+			continue;
+		}
+		while ((ch == CH_TX) ? (txLevel <= FIFO_WORDS - I2SDMA_FIFO_DEPTH) : (rxLevel >= I2SDMA_FIFO_DEPTH)) {
+			for (i = 0; i < I2SDMA_FIFO_DEPTH; i++) {
+				if (ch == CH_TX) {
+					txFifo[txLevel++] = *(uint32_t *) (uintptr_t) loaded[ch].src;
+					if (loaded[ch].ctrl & GPDMA_DMACCxControl_SI) {
+						loaded[ch].src += 4;
+					}
+				}
+				else {
+					*(uint32_t *) (uintptr_t) loaded[ch].dst = rxFifo[0];
+					memmove(rxFifo, rxFifo + 1, --rxLevel * 4);
+					if (loaded[ch].ctrl & GPDMA_DMACCxControl_DI) {
+						loaded[ch].dst += 4;
+					}
+				}
+			}
+			wordsLeft[ch] -= I2SDMA_FIFO_DEPTH;
+			if (wordsLeft[ch] == 0) {
+				numEnded[ch]++;
+				endPending[ch] = true;
+				hostLoad(ch, loaded[ch].lli);
+			}
+		}
+	}
+}
+
+/* Count the periods each direction owns, all must be back after a stop */
+static void checkPools(void)
+{
+	uint32_t free, m;
+
+	TEST_CHECK(!i2sTx.running && !i2sRx.running);
+	for (free = 0, m = i2sTx.freeMask; m; m &= m - 1) {
+		free++;
+	}
+	TEST_CHECK(free + i2sTx.qCount == NUM_PERIODS);
+	for (free = 0, m = i2sRx.freeMask; m; m &= m - 1) {
+		free++;
+	}
+	TEST_CHECK(free + i2sRx.qCount == NUM_PERIODS);
+}
+
+/* One frame per tick from the transmit FIFO to the receive FIFO. The DMA
+   interrupt is served 1 to 4 ticks after a period end, or in the late phase
+   now and then 1.5 periods later. The application alternates fast and slow
+   phases, so both directions run out of buffers at times. */
+static void runStream(uint32_t ticks, bool late)
+{
+	uint32_t t, w, delay = 0, *p;
+	int ch, i;
+	bool slow;
+
+	for (t = 0; t < ticks; t++) {
+		w = 0;
+		if (txLevel) {
+			w = txFifo[0];
+			memmove(txFifo, txFifo + 1, --txLevel * 4);
+		}
+		else {
+			fifoUnderflows++;
+		}
+		if (rxLevel < FIFO_WORDS) {
+			rxFifo[rxLevel++] = w;
+		}
+		else {
+			fifoOverflows++;
+		}
+		hostDMAService();
+
+		if (endPending[CH_TX] || endPending[CH_RX]) {
+			if (delay == 0) {
+				delay = 1 + ((late && ((rand() % 50) == 0)) ? PERIOD_WORDS + PERIOD_WORDS / 2 : rand() % 4);
+			}
+			if (--delay == 0) {
+				for (ch = 0; ch < 2; ch++) {
+					if (endPending[ch]) {
+						endPending[ch] = false;
+						if (pChReq[ch]) {
+							pChReq[ch]->progressCb(pChReq[ch]);
+						}
+					}
+				}
+			}
+		}
+
+		slow = ((t / 5000) % 3) == 2;
+		if ((rand() % (slow ? 300 : 8)) == 0) {
+			while ((p = Chip_I2SDMA_GetRxPeriod()) != NULL) {
+				for (i = 0; i < PERIOD_WORDS; i++) {
+					/* Silence is played and received as zeros */
+					if (p[i] == 0) {
+						continue;
+					}
+					if (!late) {
+						TEST_CHECK(p[i] > lastRx);
+					}
+					lastRx = p[i];
+				}
+				Chip_I2SDMA_ReleaseRxPeriod(p);
+			}
+			while ((p = Chip_I2SDMA_GetTxPeriod()) != NULL) {
+				for (i = 0; i < PERIOD_WORDS; i++) {
+					p[i] = nextTx++;
+				}
+				Chip_I2SDMA_QueueTxPeriod(p);
+			}
+		}
+	}
+}
+
+int main(void)
+{
+	I2SDMA_CFG_T cfg = {txBuffers, rxBuffers, PERIOD_WORDS, NUM_PERIODS, NULL, NULL};
+	I2SDMA_STATS_T *pStats;
+	uint32_t *p;
+	int i, j;
+
+	srand(5);
+	cfg.numPeriods = 2;
+	TEST_CHECK(Chip_I2SDMA_Init(&hostI2S, &cfg) == ERROR);
+	cfg.numPeriods = NUM_PERIODS;
+	TEST_CHECK(Chip_I2SDMA_Init(&hostI2S, &cfg) == SUCCESS);
+
+	/* Two periods primed before the start */
+	nextTx = 1;
+	for (i = 0; i < 2; i++) {
+		p = Chip_I2SDMA_GetTxPeriod();
+		for (j = 0; j < PERIOD_WORDS; j++) {
+			p[j] = nextTx++;
+		}
+		Chip_I2SDMA_QueueTxPeriod(p);
+	}
+	TEST_CHECK(Chip_I2SDMA_Start() == SUCCESS && pChReq[CH_TX] && pChReq[CH_RX]);
+	TEST_CHECK(Chip_I2SDMA_Start() == ERROR);
+
+	/* Periods are played and received in order, every ended period is a
+	   played or silent one and a received or discarded one, and the DMA keeps
+	   the FIFOs going */
+	runStream(300000, false);
+	pStats = Chip_I2SDMA_GetStats();
+	TEST_CHECK(pStats->txPeriods + pStats->underruns == numEnded[CH_TX] ||
+			   pStats->txPeriods + pStats->underruns == numEnded[CH_TX] + 2);
+	TEST_CHECK(pStats->rxPeriods + pStats->overruns + 2 >= numEnded[CH_RX] &&
+			   pStats->rxPeriods + pStats->overruns <= numEnded[CH_RX] + 2);
+	TEST_CHECK(fifoUnderflows <= FIFO_WORDS && fifoOverflows == 0);
+	TEST_CHECK(pStats->underruns > 0 && pStats->overruns > 0 && pStats->lateIrqs == 0);
+	printf("test_i2sdma: %u periods played, %u received, %u underruns, %u overruns\n",
+		   (unsigned) pStats->txPeriods, (unsigned) pStats->rxPeriods,
+		   (unsigned) pStats->underruns, (unsigned) pStats->overruns);
+	Chip_I2SDMA_Stop();
+	checkPools();
+
+	/* Late interrupts are counted and no period is lost or handed out twice */
+	TEST_CHECK(Chip_I2SDMA_Start() == SUCCESS);
+	runStream(300000, true);
+	pStats = Chip_I2SDMA_GetStats();
+	TEST_CHECK(pStats->lateIrqs > 0);
+	printf("test_i2sdma: %u late interrupts\n", (unsigned) pStats->lateIrqs);
+	Chip_I2SDMA_Stop();
+	checkPools();
+
+	printf("test_i2sdma: passed\n");
+	return 0;
+}
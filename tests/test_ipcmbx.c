@@ -0,0 +1,244 @@
+/*
+ * @brief Host test of the M4/M0 mailbox
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <string.h>
+#include <time.h>
+
+/* The doorbell posts to the semaphore the other core sleeps on */
+static __thread int hostCore;
+static sem_t hostBell[2];
+
+#define __SEV() sem_post(&hostBell[1 - hostCore])
+
+/* The CREG helpers were compiled with the fixed register address */
+#define Chip_CREG_ClearM0AppEvent() (hostCREG.M0APPTXEVENT = 0)
+#define Chip_CREG_ClearM4Event()    (hostCREG.M4TXEVENT = 0)
+
+#include "../lpc_chip_43xx/src/ipcmbx_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_MSGS            500000UL
+
+/* Length of the n-th message of a stream */
+#define MSG_LEN(n)          (4 + ((n) % (IPCMBX_MSG_DATA - 3)))
+
+static IPCMBX_SHARED_T shared;
+static IPCMBX_HANDLE_T hCore[2];
+static unsigned long toSend[2];
+static unsigned long sleeps[2], lostWakeups[2];
+static bool yields;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+void Chip_Clock_Enable(CHIP_CCU_CLK_T clk)
+{}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Sleep until the doorbell, a wakeup that never comes times out */
+static void coreSleep(int c)
+{
+	struct timespec ts;
+
+	sleeps[c]++;
+	clock_gettime(CLOCK_REALTIME, &ts);
+	ts.tv_sec += 2;
+	if (sem_timedwait(&hostBell[c], &ts) != 0) {
+		lostWakeups[c]++;
+		return;
+	}
+	Chip_IPCMBX_IRQHandler(&hCore[c]);
+}
+
+/* One core, sends its stream and checks the stream of the other core.
+   When neither is possible it asks for a doorbell and sleeps unless the
+   rings changed meanwhile, as the RTOS glue does. */
+static void *coreThread(void *arg)
+{
+	int c = (int) (intptr_t) arg, i;
+	unsigned long sent = 0, rcvd = 0;
+	IPCMBX_MSG_T msg, rx;
+	uint32_t seq;
+	bool progress, sleep;
+
+	hostCore = c;
+	while ((sent < toSend[c]) || (rcvd < toSend[1 - c])) {
+		progress = false;
+		if (sent < toSend[c]) {
+			msg.id = c;
+			msg.len = MSG_LEN(sent);
+			memcpy(msg.data, &sent, 4);
+			memset(&msg.data[4], (uint8_t) sent, msg.len - 4);
+			if (Chip_IPCMBX_Send(&hCore[c], &msg) == SUCCESS) {
+				sent++;
+				progress = true;
+			}
+		}
+		if (yields && ((rand() & 63) == 0)) {
+			sched_yield();
+		}
+		if ((rcvd < toSend[1 - c]) && Chip_IPCMBX_Receive(&hCore[c], &rx)) {
+			memcpy(&seq, rx.data, 4);
+			TEST_CHECK((seq == (uint32_t) rcvd) && (rx.id == (1 - c)) && (rx.len == MSG_LEN(rcvd)));
+			for (i = 4; i < rx.len; i++) {
+				TEST_CHECK(rx.data[i] == (uint8_t) rcvd);
+			}
+			rcvd++;
+			progress = true;
+		}
+
+		if (!progress) {
+			sleep = true;
+			if ((rcvd < toSend[1 - c]) && !Chip_IPCMBX_WaitRx(&hCore[c])) {
+				sleep = false;
+			}
+			if ((sent < toSend[c]) && !Chip_IPCMBX_WaitTx(&hCore[c])) {
+				sleep = false;
+			}
+			if (sleep) {
+				coreSleep(c);
+			}
+		}
+	}
+	return NULL;
+}
+
+/* Run both cores on fresh rings */
+static void runCores(const char *name, unsigned long m4Msgs, unsigned long m0Msgs, bool yield)
+{
+	pthread_t thread[2];
+	int c;
+
+	toSend[0] = m4Msgs;
+	toSend[1] = m0Msgs;
+	yields = yield;
+	memset(sleeps, 0, sizeof(sleeps));
+	memset(lostWakeups, 0, sizeof(lostWakeups));
+	sem_init(&hostBell[0], 0, 0);
+	sem_init(&hostBell[1], 0, 0);
+
+	/* The M0 side is the same code with the rings swapped */
+	hostCore = 0;
+	TEST_CHECK(Chip_IPCMBX_Init(&hCore[0], &shared) == SUCCESS);
+	TEST_CHECK(shared.magic == IPCMBX_MAGIC);
+	memset(&hCore[1], 0, sizeof(hCore[1]));
+	hCore[1].pShared = &shared;
+	hCore[1].pTx = &shared.toM4;
+	hCore[1].pRx = &shared.toM0;
+
+	for (c = 0; c < 2; c++) {
+		TEST_CHECK(pthread_create(&thread[c], NULL, coreThread, (void *) (intptr_t) c) == 0);
+	}
+	for (c = 0; c < 2; c++) {
+		pthread_join(thread[c], NULL);
+	}
+
+	for (c = 0; c < 2; c++) {
+		TEST_CHECK((hCore[c].stats.sent == toSend[c]) && (hCore[c].stats.received == toSend[1 - c]));
+		TEST_CHECK(lostWakeups[c] == 0);
+		printf("test_ipcmbx: %s, core %d: sent %u, received %u, ring full %u, doorbells %u, sleeps %lu\n",
+			   name, c, (unsigned) hCore[c].stats.sent, (unsigned) hCore[c].stats.received,
+			   (unsigned) hCore[c].stats.txFull, (unsigned) hCore[c].stats.doorbells, sleeps[c]);
+	}
+	sem_destroy(&hostBell[0]);
+	sem_destroy(&hostBell[1]);
+}
+
+/* Single thread checks of the ring limits */
+static void testRing(void)
+{
+	IPCMBX_MSG_T msg, rx;
+	IPCMBX_HANDLE_T hM0;
+	int i;
+
+	TEST_CHECK(Chip_IPCMBX_Init(&hCore[0], &shared) == SUCCESS);
+	memset(&hM0, 0, sizeof(hM0));
+	hM0.pTx = &shared.toM4;
+	hM0.pRx = &shared.toM0;
+
+	memset(&msg, 0, sizeof(msg));
+	msg.len = IPCMBX_MSG_DATA + 1;
+	TEST_CHECK(Chip_IPCMBX_Send(&hCore[0], &msg) == ERROR);
+	msg.len = IPCMBX_MSG_DATA;
+	for (i = 0; i < IPCMBX_RING_MSGS; i++) {
+		TEST_CHECK(Chip_IPCMBX_Send(&hCore[0], &msg) == SUCCESS);
+	}
+	TEST_CHECK(Chip_IPCMBX_Send(&hCore[0], &msg) == ERROR);
+	TEST_CHECK(hCore[0].stats.txFull == 1);
+
+	/* Nobody waits, a streaming ring rings no doorbell */
+	TEST_CHECK(hCore[0].stats.doorbells == 0);
+
+	/* A sender waiting for space gets one doorbell, and the interrupt on
+	   its side reports the space */
+	TEST_CHECK(Chip_IPCMBX_WaitTx(&hCore[0]));
+	hostCore = 1;
+	TEST_CHECK(Chip_IPCMBX_Receive(&hM0, &rx) && (rx.len == IPCMBX_MSG_DATA));
+	TEST_CHECK(hM0.stats.doorbells == 1);
+	hostCore = 0;
+	TEST_CHECK(sem_trywait(&hostBell[0]) == 0);
+	TEST_CHECK(Chip_IPCMBX_IRQHandler(&hCore[0]) == IPCMBX_EVENT_TX);
+
+	/* Sending again withdraws the request */
+	TEST_CHECK(Chip_IPCMBX_Send(&hCore[0], &msg) == SUCCESS);
+	hostCore = 1;
+	TEST_CHECK(Chip_IPCMBX_Receive(&hM0, &rx) && (hM0.stats.doorbells == 1));
+	hostCore = 0;
+
+	/* Not started on a misaligned image */
+	TEST_CHECK(Chip_IPCMBX_StartM0(0x10080100) == ERROR);
+}
+
+int main(void)
+{
+	srand(3);
+	sem_init(&hostBell[0], 0, 0);
+	sem_init(&hostBell[1], 0, 0);
+	testRing();
+	sem_destroy(&hostBell[0]);
+	sem_destroy(&hostBell[1]);
+
+	runCores("both ways", NUM_MSGS, NUM_MSGS, false);
+	runCores("both ways, random yields", NUM_MSGS, NUM_MSGS, true);
+	runCores("M4 to M0 only", NUM_MSGS, 0, false);
+	printf("test_ipcmbx: passed\n");
+	return 0;
+}
@@ -0,0 +1,352 @@
+/*
+ * @brief Host test of the ST7565S LCD drawing functions
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include <time.h>
+#include "board.h"
+
+/* The command/data line is a GPIO, kept in host memory */
+static LPC_GPIO_T hostGPIO;
+#undef LPC_GPIO_PORT
+#define LPC_GPIO_PORT       (&hostGPIO)
+
+#include "../lpc_board_nxp_lpcxpresso_4337/src/lcd_st7565s.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_OPS         60000
+#define NUM_FRAMES      2000
+
+#ifdef LCD_ORIENT_PORTRAIT
+#define TEST_NAME       "test_lcddraw_portrait"
+#else
+#define TEST_NAME       "test_lcddraw"
+#endif
+
+uint32_t SystemCoreClock = 100;
+
+/* Drawing operations */
+typedef enum {
+	OP_FILL, OP_RECT, OP_LINE, OP_STRING, OP_SCROLL, OP_CLEAR, OP_NUM
+} OP_T;
+
+/* Fixed, proportional and 20 row fonts with random glyphs */
+static uint16_t fontTable[96 * 16], tallTable[96 * 20];
+static uint8_t widthTable[96];
+static FONT_T fixedFont = {13, 32, 127, fontTable, NULL};
+static FONT_T propFont = {13, 32, 127, fontTable, widthTable};
+static FONT_T tallFont = {20, 32, 127, tallTable, NULL};
+
+static uint8_t bufSaved[sizeof(fbuffer)], bufNew[sizeof(fbuffer)], bufRef[sizeof(fbuffer)];
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Nothing is sent, the test compares the frame buffer */
+void Board_LCD_WriteData(const uint8_t *data, uint16_t size)
+{}
+
+void Board_LCD_SetupXfer(SSPDMA_XFER_T *pXfer, bool cmd, const uint8_t *data, uint16_t size,
+						 SSPDMA_CALLBACK_T cb, void *cbData)
+{}
+
+Status Chip_SSPDMA_Submit(SSPDMA_HANDLE_T *pHandle, SSPDMA_XFER_T *pXfer)
+{
+	return SUCCESS;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Reference versions, the original per-pixel implementations */
+static void refFillRect(int left, int top, int right, int bottom, int col)
+{
+	int x, y;
+
+	for (y = top; y <= bottom; y++) {
+		for (x = left; x <= right; x++) {
+			LCD_SetPixel(x, y, col);
+		}
+	}
+}
+
+static void refDrawRect(int left, int top, int right, int bottom, int col)
+{
+	int i;
+
+	for (i = left; i <= right; i++) {
+		LCD_SetPixel(i, top, col);
+		LCD_SetPixel(i, bottom, col);
+	}
+	for (i = top + 1; i < bottom; i++) {
+		LCD_SetPixel(left, i, col);
+		LCD_SetPixel(right, i, col);
+	}
+}
+
+static void refDrawLine(int x0, int y0, int x1, int y1, int col)
+{
+	int dx = abs(x1 - x0), sx = (x0 < x1) ? 1 : -1;
+	int dy = abs(y1 - y0), sy = (y0 < y1) ? 1 : -1;
+	int err = ((dx > dy) ? dx : -dy) / 2, e2;
+
+	LCD_SetPixel(x0, y0, col);
+	while ((x0 != x1) || (y0 != y1)) {
+		e2 = err;
+		if (e2 > -dx) {
+			err -= dy;
+			x0 += sx;
+		}
+		if (e2 < dy) {
+			err += dx;
+			y0 += sy;
+		}
+		LCD_SetPixel(x0, y0, col);
+	}
+}
+
+static uint32_t refPutCharXY(int xPos, int yPos, int ch)
+{
+	int w, h, r, c;
+	uint16_t *fp, t;
+
+	if (!cf->font) {
+		return 0;
+	}
+	if ((ch < cf->font->first_char) || (ch > cf->font->last_char)) {
+		return xPos | (yPos << 16);
+	}
+	ch -= cf->font->first_char;
+	w = LCD_GetCharWidth(ch) + cf->spacing;
+	h = cf->font->font_height;
+	fp = cf->font->font_table + (ch * h);
+	for (r = 0; r < h; r++, fp++) {
+		for (c = 0, t = 0x8000; c < w; c++, t >>= 1) {
+			LCD_SetPixel(xPos + c, yPos + r, (*fp & t) ? cf->fcolor : cf->bgcolor);
+		}
+	}
+	return (xPos + w) | ((yPos + h) << 16);
+}
+
+static void refPutStrXY(int xPos, int yPos, const char *str)
+{
+	uint32_t xp = xPos;
+
+	while (*str) {
+		xp = refPutCharXY(xp & 0xFFFF, yPos, *str++);
+	}
+}
+
+static int refGetPixel(const uint8_t *pBuf, int x, int y)
+{
+#ifdef LCD_ORIENT_PORTRAIT
+	int t = x;
+
+	x = y;
+	y = LCD_X_RES - t - 1;
+#endif
+	return (pBuf[(y / 8) * LCD_COL_NUM + x] >> (y & 7)) & 1;
+}
+
+static void refScrollUp(int lines, int col)
+{
+	int x, y;
+
+	memcpy(bufRef, fbuffer, sizeof(bufRef));
+	for (y = 0; y < LCD_Y_RES; y++) {
+		for (x = 0; x < LCD_X_RES; x++) {
+			LCD_SetPixel(x, y, (y + lines < LCD_Y_RES) ? refGetPixel(bufRef, x, y + lines) : col);
+		}
+	}
+}
+
+static int randRange(int lo, int hi)
+{
+	return lo + rand() % (hi - lo + 1);
+}
+
+static void randFont(void)
+{
+	int k = rand() % 3;
+
+	LCD_SetFont((k == 0) ? &fixedFont : ((k == 1) ? &propFont : &tallFont));
+	LCD_SetFontWidth(randRange(3, 14));
+	LCD_SetFontCharSpace(randRange(0, 3));
+	LCD_SetFontColor(rand() & 1);
+	LCD_SetFontBgColor(rand() & 1);
+}
+
+static void runOp(bool ref, OP_T op, const int *a, const char *str)
+{
+	switch (op) {
+	case OP_FILL:
+		ref ? refFillRect(a[0], a[1], a[2], a[3], a[4]) : LCD_FillRect(a[0], a[1], a[2], a[3], a[4]);
+		break;
+
+	case OP_RECT:
+		ref ? refDrawRect(a[0], a[1], a[2], a[3], a[4]) : LCD_DrawRect(a[0], a[1], a[2], a[3], a[4]);
+		break;
+
+	case OP_LINE:
+		ref ? refDrawLine(a[0], a[1], a[2], a[3], a[4]) : LCD_DrawLine(a[0], a[1], a[2], a[3], a[4]);
+		break;
+
+	case OP_STRING:
+		ref ? refPutStrXY(a[0], a[1], str) : LCD_PutStrXY(a[0], a[1], str);
+		break;
+
+	case OP_SCROLL:
+		ref ? refScrollUp(a[0], a[4]) : LCD_ScrollUp(a[0], a[4]);
+		break;
+
+	default:
+		ref ? refFillRect(0, 0, LCD_X_RES - 1, LCD_Y_RES - 1, a[4]) : LCD_Clear(a[4]);
+		break;
+	}
+}
+
+/* A test frame, clear, four text lines, a box, a bar and nine lines */
+static void drawFrame(bool ref)
+{
+	char str[24];
+	int i;
+
+	runOp(ref, OP_CLEAR, (const int[]) {0, 0, 0, 0, 0}, NULL);
+	LCD_SetFont(&fixedFont);
+	LCD_SetFontWidth(6);
+	LCD_SetFontCharSpace(0);
+	LCD_SetFontColor(1);
+	LCD_SetFontBgColor(0);
+	for (i = 0; i < 4; i++) {
+		sprintf(str, "Line %d: value %5d", i, i * 1234);
+		runOp(ref, OP_STRING, (const int[]) {0, i * 13, 0, 0, 0}, str);
+	}
+	runOp(ref, OP_RECT, (const int[]) {2, 2, LCD_X_RES - 3, LCD_Y_RES - 3, 1}, NULL);
+	runOp(ref, OP_FILL, (const int[]) {10, LCD_Y_RES - 12, LCD_X_RES / 2, LCD_Y_RES - 5, 1}, NULL);
+	for (i = 0; i < 8; i++) {
+		runOp(ref, OP_LINE, (const int[]) {0, 0, LCD_X_RES - 1 - i * 7, LCD_Y_RES - 1, 1}, NULL);
+	}
+	runOp(ref, OP_LINE, (const int[]) {0, 30, LCD_X_RES - 1, 30, 1}, NULL);
+}
+
+/* Random clipped operations must give the same frame buffer as the
+   reference versions */
+static void testRandom(void)
+{
+	char str[8];
+	int n, k, a[5];
+	OP_T op;
+
+	for (n = 0; n < NUM_OPS; n++) {
+		op = (OP_T) (rand() % OP_NUM);
+		if (((op == OP_SCROLL) || (op == OP_CLEAR)) && (rand() % 8)) {
+			op = (OP_T) (rand() % OP_SCROLL);
+		}
+		a[0] = randRange(-20, LCD_X_RES + 20);
+		a[1] = randRange(-20, LCD_Y_RES + 20);
+		a[2] = randRange(-20, LCD_X_RES + 20);
+		a[3] = randRange(-20, LCD_Y_RES + 20);
+		a[4] = rand() & 1;
+		if ((rand() % 3) == 0) {
+			a[2] = a[0] + randRange(-3, 40);
+			a[3] = a[1] + randRange(-3, 30);
+		}
+		if ((rand() % 4) == 0) {
+			a[3] = a[1];
+		}
+		if ((rand() % 4) == 0) {
+			a[2] = a[0];
+		}
+		if (op == OP_SCROLL) {
+			a[0] = randRange(0, LCD_Y_RES + 2);
+		}
+		for (k = 0; k < 7; k++) {
+			str[k] = (char) randRange(20, 130);
+		}
+		str[7] = 0;
+		if (op == OP_STRING) {
+			randFont();
+		}
+
+		memcpy(bufSaved, fbuffer, sizeof(bufSaved));
+		runOp(false, op, a, str);
+		memcpy(bufNew, fbuffer, sizeof(bufNew));
+		memcpy(fbuffer, bufSaved, sizeof(bufSaved));
+		runOp(true, op, a, str);
+		TEST_CHECK(memcmp(bufNew, fbuffer, sizeof(bufNew)) == 0);
+	}
+}
+
+static double frameTime(bool ref)
+{
+	clock_t start = clock();
+	int i;
+
+	for (i = 0; i < NUM_FRAMES; i++) {
+		drawFrame(ref);
+	}
+	return (double) (clock() - start) / CLOCKS_PER_SEC / NUM_FRAMES * 1e6;
+}
+
+int main(void)
+{
+	double refTime, newTime;
+	int i;
+
+	for (i = 0; i < 96 * 16; i++) {
+		fontTable[i] = rand();
+	}
+	for (i = 0; i < 96 * 20; i++) {
+		tallTable[i] = rand();
+	}
+	for (i = 0; i < 96; i++) {
+		widthTable[i] = randRange(2, 12);
+	}
+	LCD_Init();
+	LCD_SetDeferred(true);
+
+	testRandom();
+	drawFrame(false);
+	memcpy(bufNew, fbuffer, sizeof(bufNew));
+	drawFrame(true);
+	TEST_CHECK(memcmp(bufNew, fbuffer, sizeof(bufNew)) == 0);
+
+	refTime = frameTime(true);
+	newTime = frameTime(false);
+	printf(TEST_NAME ": test frame %.1f us drawn per pixel, %.1f us on page bytes (%.1fx)\n",
+		   refTime, newTime, refTime / newTime);
+	printf(TEST_NAME ": passed\n");
+	return 0;
+}
@@ -0,0 +1,308 @@
+/*
+ * @brief Host test of the ST7565S LCD deferred refresh
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "board.h"
+
+/* The command/data line is a GPIO, kept in host memory */
+static LPC_GPIO_T hostGPIO;
+#undef LPC_GPIO_PORT
+#define LPC_GPIO_PORT       (&hostGPIO)
+
+/* Waits for a flush let the DMA model send a transfer */
+static bool hostIsDone(const SSPDMA_XFER_T *pXfer);
+
+#define Chip_SSPDMA_IsDone hostIsDone
+#include "../lpc_board_nxp_lpcxpresso_4337/src/lcd_st7565s.c"
+#undef Chip_SSPDMA_IsDone
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_UPDATES     600
+
+uint32_t SystemCoreClock = 100;
+
+/* Panel model fed from the SSP, page and column set by the commands */
+static uint8_t panel[LCD_PG_NUM][LCD_COL_NUM];
+static int panelPage, panelCol;
+static uint32_t wireBytes;
+
+static void hostPanelFeed(bool cmd, const uint8_t *data, uint32_t size);
+
+/* SSP DMA queue model */
+static SSPDMA_HANDLE_T hostSSP;
+static SSPDMA_XFER_T *pQueue[LCD_PG_NUM * LCD_FLUSH_SPANS * 2];
+static int queueHead, queueTail;
+static uint32_t numXfers, numFlushDone;
+
+static uint16_t fontTable[96 * 8];
+static FONT_T font = {8, 32, 127, fontTable, NULL};
+
+/* Moving box of the scene */
+static int boxX, boxY, boxDX, boxDY;
+static double phase;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Board LCD transfers */
+void Board_LCD_WriteData(const uint8_t *data, uint16_t size)
+{
+	bool cmd = hostGPIO.CLR[LCD_CMD_GPIO_PORT] != 0;
+
+	/* No blocking write while DMA transfers are queued */
+	TEST_CHECK(queueHead == queueTail);
+	hostGPIO.CLR[LCD_CMD_GPIO_PORT] = 0;
+	hostPanelFeed(cmd, data, size);
+}
+
+void Board_LCD_SetupXfer(SSPDMA_XFER_T *pXfer, bool cmd, const uint8_t *data, uint16_t size,
+						 SSPDMA_CALLBACK_T cb, void *cbData)
+{
+	Chip_SSPDMA_SetupXfer(pXfer, cmd ? LCD_XFER_CMD : LCD_XFER_DATA, data, NULL, size, cb, cbData);
+}
+
+/* The SSP DMA driver is not under test */
+Status Chip_SSPDMA_Submit(SSPDMA_HANDLE_T *pHandle, SSPDMA_XFER_T *pXfer)
+{
+	if (pXfer->len == 0) {
+		return ERROR;
+	}
+	pXfer->done = 0;
+	pQueue[queueTail++] = pXfer;
+	return SUCCESS;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void hostPanelFeed(bool cmd, const uint8_t *data, uint32_t size)
+{
+	uint32_t i;
+
+	wireBytes += size;
+	for (i = 0; i < size; i++) {
+		if (!cmd) {
+			if (panelCol < LCD_COL_NUM) {
+				panel[panelPage][panelCol] = data[i];
+			}
+			panelCol++;
+		}
+		else if ((data[i] & 0xF0) == 0xB0) {
+			panelPage = data[i] & 0x0F;
+		}
+		else if ((data[i] & 0xF0) == 0x10) {
+			panelCol = (panelCol & 0x0F) | ((data[i] & 0x0F) << 4);
+		}
+		else if ((data[i] & 0xF0) == 0x00) {
+			panelCol = (panelCol & 0xF0) | data[i];
+		}
+	}
+}
+
+/* Send the next queued transfer */
+static bool hostDMAStep(void)
+{
+	SSPDMA_XFER_T *pXfer;
+
+	if (queueHead == queueTail) {
+		return false;
+	}
+	pXfer = pQueue[queueHead++];
+	hostPanelFeed(pXfer->cs == LCD_XFER_CMD, pXfer->tx, pXfer->len);
+	pXfer->done = 1;
+	numXfers++;
+	if (queueHead == queueTail) {
+		queueHead = queueTail = 0;
+	}
+	if (pXfer->cb) {
+		pXfer->cb(pXfer);
+	}
+	return true;
+}
+
+static bool hostIsDone(const SSPDMA_XFER_T *pXfer)
+{
+	if (!pXfer->done) {
+		hostDMAStep();
+	}
+	return pXfer->done != 0;
+}
+
+static void flushDone(SSPDMA_XFER_T *pXfer)
+{
+	numFlushDone++;
+}
+
+static bool panelMatches(void)
+{
+	return memcmp(panel, fbuffer, sizeof(panel)) == 0;
+}
+
+/* A clock, a progress bar, a bouncing box and a scope trace */
+static void drawScene(int t)
+{
+	char str[16];
+	int i, y0, y1;
+
+	LCD_FillRect(boxX, boxY, boxX + 5, boxY + 5, 0);
+	boxX += boxDX;
+	boxY += boxDY;
+	if ((boxX <= 0) || (boxX >= LCD_X_RES - 6)) {
+		boxDX = -boxDX;
+	}
+	if ((boxY <= 0) || (boxY >= 30)) {
+		boxDY = -boxDY;
+	}
+	LCD_FillRect(boxX, boxY, boxX + 5, boxY + 5, 1);
+
+	sprintf(str, "%02d:%02d:%02d", 12, 34, (t / 60) % 60);
+	LCD_PutStrXY(0, 0, str);
+	LCD_DrawRect(0, 56, 127, 63, 1);
+	LCD_FillRect(1, 57, 1 + (t % 126), 62, 1);
+
+	if ((t & 3) == 0) {
+		LCD_FillRect(64, 36, 127, 54, 0);
+		phase += 0.3;
+		y0 = 45 + (int) (8 * sin(phase));
+		for (i = 65; i < 128; i++) {
+			y1 = 45 + (int) (8 * sin(phase + i * 0.2));
+			LCD_DrawLine(i - 1, y0, i, y1, 1);
+			y0 = y1;
+		}
+	}
+	if ((t % 100) == 0) {
+		LCD_FillRect(0, 8, 40, 30, (t / 100) & 1);
+	}
+}
+
+static void resetScene(void)
+{
+	boxX = boxY = 10;
+	boxDX = 2;
+	boxDY = 1;
+	phase = 0;
+}
+
+/* The same scene drawn immediately and with a flush every second update at
+   30 fps. The panel must match the frame buffer after every flush, and the
+   flushes must send fewer bytes. */
+static void testFlush(void)
+{
+	uint32_t start, immBytes, defBytes, n, peak = 0;
+	int t;
+
+	resetScene();
+	start = wireBytes;
+	for (t = 0; t < NUM_UPDATES; t++) {
+		drawScene(t);
+	}
+	immBytes = wireBytes - start;
+	TEST_CHECK(panelMatches());
+
+	resetScene();
+	LCD_FillRect(0, 0, LCD_X_RES - 1, LCD_Y_RES - 1, 0);
+	LCD_SetDeferred(true);
+	LCD_FlushAsync(&hostSSP, flushDone, NULL);
+	while (hostDMAStep()) {}
+	TEST_CHECK(panelMatches());
+
+	start = wireBytes;
+	numXfers = numFlushDone = 0;
+	for (t = 0; t < NUM_UPDATES; t++) {
+		drawScene(t);
+		if (t & 1) {
+			n = LCD_FlushAsync(&hostSSP, flushDone, NULL);
+
+			/* A flush is refused while the last one runs */
+			TEST_CHECK((n == 0) || (LCD_FlushAsync(&hostSSP, flushDone, NULL) == 0));
+			while (hostDMAStep()) {}
+			TEST_CHECK(panelMatches());
+			peak = MAX(peak, n);
+		}
+	}
+	defBytes = wireBytes - start;
+	TEST_CHECK(defBytes == LCD_GetFlushStats()->bytes);
+	TEST_CHECK((defBytes < immBytes) && (numFlushDone == LCD_GetFlushStats()->flushes));
+	printf("test_lcdflush: %u bytes per frame immediate, %u deferred (%u peak), %.1f transfers per frame\n",
+		   (unsigned) (immBytes / (NUM_UPDATES / 2)), (unsigned) (defBytes / (NUM_UPDATES / 2)),
+		   (unsigned) peak, numXfers / (NUM_UPDATES / 2.0));
+
+	/* An unchanged redraw sends nothing */
+	LCD_PutStrXY(0, 0, "12:34:09");
+	LCD_FlushAsync(&hostSSP, flushDone, NULL);
+	while (hostDMAStep()) {}
+	LCD_PutStrXY(0, 0, "12:34:09");
+	TEST_CHECK(LCD_FlushAsync(&hostSSP, flushDone, NULL) == 0);
+}
+
+/* Leaving deferred mode with a flush on the DMA and more regions dirty
+   waits for the flush before the blocking writes */
+static void testUndefer(void)
+{
+	LCD_FillRect(3, 3, 60, 20, 1);
+	TEST_CHECK(LCD_FlushAsync(&hostSSP, flushDone, NULL) > 0);
+	TEST_CHECK(queueHead != queueTail);
+	LCD_FillRect(10, 40, 90, 50, 1);
+	LCD_SetDeferred(false);
+	TEST_CHECK((queueHead == queueTail) && panelMatches());
+
+	/* Clipping of immediate drawing */
+	LCD_PutPixel(200, 5, 1);
+	LCD_PutPixel(-1, 5, 1);
+	LCD_Refresh(-5, -5, 300, 300);
+	TEST_CHECK(panelMatches());
+}
+
+int main(void)
+{
+	int i;
+
+	for (i = 0; i < 96 * 8; i++) {
+		fontTable[i] = rand() & 0xFC00;
+	}
+	LCD_SetFont(&font);
+	LCD_SetFontWidth(6);
+	LCD_SetFontColor(1);
+	LCD_SetFontBgColor(0);
+	LCD_Init();
+	TEST_CHECK(panelMatches());
+
+	testFlush();
+	testUndefer();
+	printf("test_lcdflush: passed\n");
+	return 0;
+}
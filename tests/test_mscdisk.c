@@ -0,0 +1,319 @@
+/*
+ * @brief Host test of the SD card export over USB mass storage
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../freertos_statechart/example/src/msc_disk.c"
+#include "../freertos_statechart/example/src/usb_desc.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define CARD_BLOCKS     65536
+#define MAX_REQS        8
+#define CLASS_MEM_SIZE  1024
+
+/* Card timing, overhead per command in us and bytes per us, and the USB
+   transfer rate in bytes per us */
+#define CARD_RD_OVH     100.0
+#define CARD_RD_RATE    20.0
+#define CARD_WR_OVH     500.0
+#define CARD_WR_RATE    12.0
+#define USB_RATE        40.0
+
+const USBD_API_T *g_pUsbApi;
+
+static USBD_MSC_API_T hostMsc;
+static USBD_API_T hostApi;
+static USBD_MSC_INIT_PARAM_T hostParam;
+
+/* Card model in simulated time, requests run one after another */
+static uint8_t *pCard;
+static double hostTime, cardFree;
+static SDBLK_REQ_T *pReqs[MAX_REQS];
+static double reqEnd[MAX_REQS];
+static int numReqs;
+static uint32_t numDone, numWaits;
+
+static uint8_t mscBuffers[2 * MSCDISK_RUN_SIZE];
+static uint8_t stackBuf[65536];
+static uint8_t dataA[4 << 20], dataB[4 << 20];
+
+static void hostAdvance(double t);
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The SD block driver is not under test */
+Status Chip_SDBLK_Submit(SDBLK_REQ_T *pReq)
+{
+	double start;
+
+	if ((pReq->count == 0) || (pReq->block + pReq->count > CARD_BLOCKS)) {
+		return ERROR;
+	}
+	TEST_CHECK(numReqs < MAX_REQS);
+	pReq->done = 0;
+	pReq->status = SUCCESS;
+	start = (hostTime > cardFree) ? hostTime : cardFree;
+	if (pReq->write) {
+		cardFree = start + CARD_WR_OVH + pReq->count * MMC_SECTOR_SIZE / CARD_WR_RATE;
+	}
+	else {
+		cardFree = start + CARD_RD_OVH + pReq->count * MMC_SECTOR_SIZE / CARD_RD_RATE;
+	}
+	pReqs[numReqs] = pReq;
+	reqEnd[numReqs++] = cardFree;
+	return SUCCESS;
+}
+
+/* Skip to the next request end */
+void Chip_SDBLK_Poll(void)
+{
+	if (numReqs > 0) {
+		hostAdvance(reqEnd[0]);
+	}
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Advance the simulated time, finishing the requests that end by then */
+static void hostAdvance(double t)
+{
+	SDBLK_REQ_T *pReq;
+
+	hostTime = t;
+	while ((numReqs > 0) && (reqEnd[0] <= hostTime)) {
+		pReq = pReqs[0];
+		if (pReq->write) {
+			memcpy(pCard + pReq->block * MMC_SECTOR_SIZE, pReq->buffer, pReq->count * MMC_SECTOR_SIZE);
+		}
+		else {
+			memcpy(pReq->buffer, pCard + pReq->block * MMC_SECTOR_SIZE, pReq->count * MMC_SECTOR_SIZE);
+		}
+		numReqs--;
+		memmove(pReqs, pReqs + 1, numReqs * sizeof(pReqs[0]));
+		memmove(reqEnd, reqEnd + 1, numReqs * sizeof(reqEnd[0]));
+		pReq->done = 1;
+		if (pReq->cb) {
+			pReq->cb(pReq);
+		}
+	}
+}
+
+static void hostCardIdle(void)
+{
+	while (numReqs > 0) {
+		Chip_SDBLK_Poll();
+	}
+}
+
+static void cardDone(void)
+{
+	numDone++;
+}
+
+/* Blocking wait of a task, the card finishes a request meanwhile */
+static void cardWait(void)
+{
+	numWaits++;
+	Chip_SDBLK_Poll();
+}
+
+static ErrorCode_t hostMscInit(USBD_HANDLE_T hUsb, USBD_MSC_INIT_PARAM_T *param)
+{
+	USB_INTERFACE_DESCRIPTOR *pIntf = (USB_INTERFACE_DESCRIPTOR *) param->intf_desc;
+
+	TEST_CHECK(pIntf && (pIntf->bInterfaceNumber == USB_MSC_IF_NUM));
+	hostParam = *param;
+	param->mem_base += CLASS_MEM_SIZE;
+	param->mem_size -= CLASS_MEM_SIZE;
+	return LPC_OK;
+}
+
+static void hostInit(bool blocking)
+{
+	USB_CORE_DESCS_T desc;
+	USBD_API_INIT_PARAM_T usbParam;
+	MSCDISK_CFG_T cfg;
+
+	desc.high_speed_desc = USB_HsMscConfigDescriptor;
+	usbParam.mem_base = 0x1000;
+	usbParam.mem_size = 0x1000;
+	cfg.buffers = mscBuffers;
+	cfg.blockCount = CARD_BLOCKS;
+	cfg.doneCb = blocking ? cardDone : NULL;
+	cfg.waitCb = blocking ? cardWait : NULL;
+	TEST_CHECK(mscDisk_init(NULL, &desc, &usbParam, &cfg) == LPC_OK);
+	TEST_CHECK(usbParam.mem_base == 0x1000 + CLASS_MEM_SIZE);
+	TEST_CHECK((hostParam.BlockCount == CARD_BLOCKS) && (strlen((char *) hostParam.InquiryStr) == 28));
+}
+
+/* Host READ, the class driver asks for the data in chunks and the USB
+   sends each chunk before the next is asked for */
+static void hostRead(uint64_t pos, uint8_t *pOut, uint32_t len, uint32_t chunk)
+{
+	uint8_t *p;
+	uint32_t n;
+
+	while (len > 0) {
+		n = MIN(len, chunk);
+		p = stackBuf;
+		hostParam.MSC_Read((uint32_t) pos, &p, n, (uint32_t) (pos >> 32));
+		memcpy(pOut, p, n);
+		hostAdvance(hostTime + n / USB_RATE);
+		pos += n;
+		pOut += n;
+		len -= n;
+	}
+}
+
+/* Host WRITE, each chunk is received where the class driver asks for it */
+static void hostWrite(uint64_t pos, const uint8_t *pIn, uint32_t len, uint32_t chunk)
+{
+	uint8_t *p;
+	uint32_t n;
+
+	while (len > 0) {
+		n = MIN(len, chunk);
+		p = stackBuf;
+		hostParam.MSC_GetWriteBuf((uint32_t) pos, &p, n, (uint32_t) (pos >> 32));
+		hostAdvance(hostTime + n / USB_RATE);
+		memcpy(p, pIn, n);
+		hostParam.MSC_Write((uint32_t) pos, &p, n, (uint32_t) (pos >> 32));
+		pos += n;
+		pIn += n;
+		len -= n;
+	}
+}
+
+/* Sequential reads and writes must beat serving each run in turn, where
+   the card and the USB never overlap */
+static void testStream(uint32_t chunk, uint32_t len)
+{
+	double t0, rdTime, wrTime, rdSerial, wrSerial;
+	uint32_t i, runs = len / MSCDISK_RUN_SIZE;
+
+	memset(&mscStats, 0, sizeof(mscStats));
+	t0 = hostTime;
+	hostRead(1000 * MMC_SECTOR_SIZE, dataA, len, chunk);
+	rdTime = hostTime - t0;
+	TEST_CHECK(memcmp(dataA, pCard + 1000 * MMC_SECTOR_SIZE, len) == 0);
+	TEST_CHECK(mscStats.readRuns <= runs + 1);
+
+	for (i = 0; i < len; i++) {
+		dataB[i] = (uint8_t) rand();
+	}
+	mscDisk_poll();
+	mscDisk_poll();
+	hostCardIdle();
+	memset(&mscStats, 0, sizeof(mscStats));
+	t0 = hostTime;
+	hostWrite(20000 * MMC_SECTOR_SIZE, dataB, len, chunk);
+	mscDisk_flush();
+	wrTime = hostTime - t0;
+	TEST_CHECK(memcmp(dataB, pCard + 20000 * MMC_SECTOR_SIZE, len) == 0);
+	TEST_CHECK((mscStats.writeRuns == runs) && (mscStats.errors == 0));
+
+	/* What was written is read back through the run buffers */
+	hostRead(20000 * MMC_SECTOR_SIZE, dataA, len, chunk);
+	TEST_CHECK(memcmp(dataA, dataB, len) == 0);
+
+	rdSerial = runs * (CARD_RD_OVH + MSCDISK_RUN_SIZE / CARD_RD_RATE) + len / USB_RATE;
+	wrSerial = runs * (CARD_WR_OVH + MSCDISK_RUN_SIZE / CARD_WR_RATE) + len / USB_RATE;
+	TEST_CHECK((rdTime < rdSerial) && (wrTime < wrSerial));
+	printf("test_mscdisk: %5u byte chunks, read %.2f MB/s (serial %.2f), write %.2f MB/s (serial %.2f)\n",
+		   (unsigned) chunk, len / rdTime, len / rdSerial, len / wrTime, len / wrSerial);
+}
+
+/* A partial run is written once the host goes idle, and reads and verifies
+   see the data written before them */
+static void testCoherence(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < 1536; i++) {
+		dataB[i] = (uint8_t) (i * 7);
+	}
+	hostWrite(300 * MMC_SECTOR_SIZE, dataB, 1536, 512);
+	mscDisk_poll();
+	mscDisk_poll();
+	hostCardIdle();
+	TEST_CHECK(memcmp(pCard + 300 * MMC_SECTOR_SIZE, dataB, 1536) == 0);
+
+	hostRead(296 * MMC_SECTOR_SIZE, dataA, 4096, 4096);
+	TEST_CHECK(memcmp(dataA + 2048, dataB, 1536) == 0);
+	hostWrite(297 * MMC_SECTOR_SIZE, dataB + 100, 512, 512);
+	hostRead(296 * MMC_SECTOR_SIZE, dataA, 4096, 512);
+	TEST_CHECK(memcmp(dataA + 512, dataB + 100, 512) == 0);
+	TEST_CHECK(hostParam.MSC_Verify(297 * MMC_SECTOR_SIZE, dataB + 100, 512, 0) == LPC_OK);
+	TEST_CHECK(hostParam.MSC_Verify(297 * MMC_SECTOR_SIZE, dataB, 512, 0) != LPC_OK);
+
+	/* The last run is cut at the end of the card */
+	hostRead((CARD_BLOCKS - 3) * (uint64_t) MMC_SECTOR_SIZE, dataA, 1536, 512);
+	TEST_CHECK(memcmp(dataA, pCard + (CARD_BLOCKS - 3) * MMC_SECTOR_SIZE, 1536) == 0);
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	hostMsc.init = hostMscInit;
+	hostApi.msc = &hostMsc;
+	g_pUsbApi = &hostApi;
+	pCard = malloc(CARD_BLOCKS * MMC_SECTOR_SIZE);
+	for (i = 0; i < CARD_BLOCKS * MMC_SECTOR_SIZE; i++) {
+		pCard[i] = (uint8_t) rand();
+	}
+
+	/* Stack run from the interrupt, the waits poll the card */
+	hostInit(false);
+	testStream(512, 4 << 20);
+	testStream(4096, 4 << 20);
+	testStream(16384, 4 << 20);
+	testStream(64, 256 << 10);
+	testCoherence();
+	TEST_CHECK((numDone == 0) && (numWaits == 0));
+
+	/* Stack run from a task, the waits block until a request is done */
+	hostInit(true);
+	testStream(4096, 4 << 20);
+	testCoherence();
+	TEST_CHECK((numWaits > 0) && (numDone > 0));
+	printf("test_mscdisk: %u blocking waits, %u requests signalled\n", (unsigned) numWaits, (unsigned) numDone);
+
+	printf("test_mscdisk: passed\n");
+	return 0;
+}
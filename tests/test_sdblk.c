@@ -0,0 +1,304 @@
+/*
+ * @brief Host test of the asynchronous SD/MMC block driver
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+/* The SDIF functions the driver calls are replaced by the card model below,
+   the interrupt status bits written as ones are cleared like on hardware */
+#define Chip_SDIF_ClrIntStatus hostClrIntStatus
+static void hostClrIntStatus(LPC_SDMMC_T *pSDMMC, uint32_t iVal)
+{
+	pSDMMC->RINTSTS &= ~iVal;
+}
+
+#include "../lpc_chip_43xx/src/sdblk_18xx_43xx.c"
+#undef Chip_SDIF_ClrIntStatus
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define CARD_BLOCKS     256
+
+/* Steps a write keeps the card busy after its data is sent */
+#define BUSY_STEPS      3
+
+/* SDIF registers and a RAM card. A data command runs on the next model step,
+   which raises its interrupts and, for writes, holds the card busy. */
+static LPC_SDMMC_T hostSD;
+static mci_card_struct hostCard;
+static uint8_t cardData[CARD_BLOCKS][MMC_SECTOR_SIZE];
+static int32_t hostCardState;
+static uint32_t dmaAddr, dmaSize;
+static uint32_t runCmd, runArg, busyLeft;
+static bool cmdRunning;
+static uint32_t numCmds, numStops;
+static uint32_t failInt;
+
+static uint8_t wbuf[4][4 * MMC_SECTOR_SIZE], rbuf[4][4 * MMC_SECTOR_SIZE];
+static SDBLK_REQ_T *pDoneLog[16];
+static int numDone;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int32_t Chip_SDMMC_GetState(LPC_SDMMC_T *pSDMMC)
+{
+	return hostCardState;
+}
+
+void Chip_SDIF_SetClearIntFifo(LPC_SDMMC_T *pSDMMC)
+{
+	pSDMMC->RINTSTS = 0;
+}
+
+void Chip_SDIF_DmaSetup(LPC_SDMMC_T *pSDMMC, sdif_device *psdif_dev, uint32_t addr, uint32_t size)
+{
+	dmaAddr = addr;
+	dmaSize = size;
+}
+
+int32_t Chip_SDIF_SendCmd(LPC_SDMMC_T *pSDMMC, uint32_t cmd, uint32_t arg)
+{
+	TEST_CHECK(pSDMMC == &hostSD);
+	numCmds++;
+	if (cmd & MCI_CMD_STOP) {
+		TEST_CHECK((cmd & 0x3F) == MMC_STOP_TRANSMISSION);
+		numStops++;
+		cmdRunning = false;
+		return 0;
+	}
+
+	/* The driver must wait for the busy line before the next command */
+	TEST_CHECK(!(pSDMMC->STATUS & MCI_STS_DATA_BUSY));
+	TEST_CHECK(!cmdRunning);
+	TEST_CHECK(cmd & MCI_CMD_PRV_DAT_WAIT);
+	runCmd = cmd;
+	runArg = arg;
+	cmdRunning = true;
+	return 0;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void hostSDIRQ(void)
+{
+	if (hostSD.RINTSTS & hostSD.INTMASK) {
+		Chip_SDBLK_IRQHandler();
+	}
+}
+
+/* Run the pending data command, release the busy line and poll the driver */
+static void hostSDStep(void)
+{
+	if (busyLeft && (--busyLeft == 0)) {
+		*(volatile uint32_t *) &hostSD.STATUS &= ~MCI_STS_DATA_BUSY;
+	}
+
+	if (cmdRunning) {
+		uint32_t idx = runCmd & 0x3F, count = dmaSize / MMC_SECTOR_SIZE;
+		uint32_t block = (hostCard.card_info.card_type & CARD_TYPE_HC) ? runArg : runArg >> 9;
+		void *pBuf = (void *) (uintptr_t) dmaAddr;
+
+		cmdRunning = false;
+		TEST_CHECK(hostSD.BYTCNT == dmaSize);
+		TEST_CHECK(block + count <= CARD_BLOCKS);
+		TEST_CHECK(((runCmd & MCI_CMD_SEND_STOP) != 0) == (count > 1));
+		if (runCmd & MCI_CMD_DAT_WR) {
+			TEST_CHECK(idx == (count > 1 ? MMC_WRITE_MULTIPLE_BLOCK : MMC_WRITE_BLOCK));
+		}
+		else {
+			TEST_CHECK(idx == (count > 1 ? MMC_READ_MULTIPLE_BLOCK : MMC_READ_SINGLE_BLOCK));
+		}
+
+		if (failInt) {
+			hostSD.RINTSTS |= failInt;
+			failInt = 0;
+		}
+		else {
+			if (runCmd & MCI_CMD_DAT_WR) {
+				memcpy(cardData[block], pBuf, dmaSize);
+				*(volatile uint32_t *) &hostSD.STATUS |= MCI_STS_DATA_BUSY;
+				busyLeft = BUSY_STEPS;
+			}
+			else {
+				memcpy(pBuf, cardData[block], dmaSize);
+			}
+			hostSD.RINTSTS |= MCI_INT_DATA_OVER | ((runCmd & MCI_CMD_SEND_STOP) ? MCI_INT_ACD : 0);
+		}
+	}
+
+	hostSDIRQ();
+	Chip_SDBLK_Poll();
+}
+
+static void hostSDRun(int steps)
+{
+	while (steps--) {
+		hostSDStep();
+	}
+}
+
+static void doneCb(SDBLK_REQ_T *pReq)
+{
+	TEST_CHECK(numDone < 16);
+	pDoneLog[numDone++] = pReq;
+}
+
+static void resetModel(uint32_t cardType)
+{
+	memset(&hostSD, 0, sizeof(hostSD));
+	cmdRunning = false;
+	busyLeft = 0;
+	numCmds = numStops = 0;
+	failInt = 0;
+	numDone = 0;
+	hostCard.card_info.blocknr = CARD_BLOCKS;
+	hostCard.card_info.card_type = cardType;
+	hostCardState = SDMMC_TRAN_ST;
+	TEST_CHECK(Chip_SDBLK_Init(&hostSD, &hostCard) == SUCCESS);
+}
+
+/* An SDIO interrupt before the card is attached, as during card acquire,
+   leaves the controller alone and requests are refused */
+static void testBeforeInit(void)
+{
+	SDBLK_REQ_T req;
+
+	hostSD.RINTSTS = MCI_INT_CMD_DONE | MCI_INT_DATA_OVER;
+	hostSD.INTMASK = MCI_INT_CMD_DONE;
+	Chip_SDBLK_IRQHandler();
+	TEST_CHECK(hostSD.RINTSTS == (MCI_INT_CMD_DONE | MCI_INT_DATA_OVER));
+	TEST_CHECK(hostSD.INTMASK == MCI_INT_CMD_DONE);
+
+	Chip_SDBLK_SetupReq(&req, rbuf[0], 0, 1, false, doneCb, NULL);
+	TEST_CHECK(Chip_SDBLK_Submit(&req) == ERROR);
+	Chip_SDBLK_Poll();
+	TEST_CHECK(numCmds == 0);
+
+	/* A card that is not selected is not attached either */
+	hostCardState = SDMMC_STBY_ST;
+	TEST_CHECK(Chip_SDBLK_Init(&hostSD, &hostCard) == ERROR);
+	Chip_SDBLK_IRQHandler();
+	TEST_CHECK(hostSD.RINTSTS == (MCI_INT_CMD_DONE | MCI_INT_DATA_OVER));
+}
+
+/* Queued writes and reads of 1 to 4 blocks complete in order, and writes
+   only once the card has released its busy line */
+static void testQueue(uint32_t cardType)
+{
+	SDBLK_REQ_T w[4], r[4];
+	int i, steps;
+
+	resetModel(cardType);
+	for (i = 0; i < 4; i++) {
+		memset(wbuf[i], 0x10 + i + cardType, sizeof(wbuf[i]));
+		Chip_SDBLK_SetupReq(&w[i], wbuf[i], 8 * i + 1, i + 1, true, doneCb, NULL);
+		TEST_CHECK(Chip_SDBLK_Submit(&w[i]) == SUCCESS);
+	}
+	for (i = 0; i < 4; i++) {
+		memset(rbuf[i], 0, sizeof(rbuf[i]));
+		Chip_SDBLK_SetupReq(&r[i], rbuf[i], 8 * i + 1, i + 1, false, doneCb, NULL);
+		TEST_CHECK(Chip_SDBLK_Submit(&r[i]) == SUCCESS);
+	}
+
+	/* The first write is not done while the card programs it */
+	hostSDStep();
+	for (steps = 0; steps < BUSY_STEPS - 1; steps++) {
+		TEST_CHECK(!Chip_SDBLK_IsDone(&w[0]));
+		hostSDStep();
+	}
+
+	hostSDRun(100);
+	TEST_CHECK(numDone == 8);
+	for (i = 0; i < 4; i++) {
+		TEST_CHECK(pDoneLog[i] == &w[i] && w[i].status == SUCCESS);
+		TEST_CHECK(pDoneLog[4 + i] == &r[i] && r[i].status == SUCCESS);
+		TEST_CHECK(memcmp(cardData[8 * i + 1], wbuf[i], (i + 1) * MMC_SECTOR_SIZE) == 0);
+		TEST_CHECK(memcmp(rbuf[i], wbuf[i], (i + 1) * MMC_SECTOR_SIZE) == 0);
+	}
+	TEST_CHECK(numCmds == 8 && numStops == 0);
+	TEST_CHECK(Chip_SDBLK_GetStats()->writes == 4 && Chip_SDBLK_GetStats()->reads == 4);
+	TEST_CHECK(Chip_SDBLK_GetStats()->blocks == 20 && Chip_SDBLK_GetStats()->errors == 0);
+	TEST_CHECK(Chip_SDBLK_GetStats()->busyPolls > 0);
+}
+
+static void testRange(void)
+{
+	SDBLK_REQ_T req;
+
+	resetModel(CARD_TYPE_HC);
+	Chip_SDBLK_SetupReq(&req, rbuf[0], 0, 0, false, NULL, NULL);
+	TEST_CHECK(Chip_SDBLK_Submit(&req) == ERROR);
+	Chip_SDBLK_SetupReq(&req, rbuf[0], 0, SDBLK_MAX_BLOCKS + 1, false, NULL, NULL);
+	TEST_CHECK(Chip_SDBLK_Submit(&req) == ERROR);
+	Chip_SDBLK_SetupReq(&req, rbuf[0], CARD_BLOCKS - 1, 2, false, NULL, NULL);
+	TEST_CHECK(Chip_SDBLK_Submit(&req) == ERROR);
+	Chip_SDBLK_SetupReq(&req, rbuf[0], CARD_BLOCKS - 1, 1, false, NULL, NULL);
+	TEST_CHECK(Chip_SDBLK_Submit(&req) == SUCCESS);
+	hostSDRun(2);
+	TEST_CHECK(Chip_SDBLK_IsDone(&req) && req.status == SUCCESS);
+}
+
+/* A data error fails its request, stops a multiple block transfer and
+   leaves the queue running */
+static void testError(void)
+{
+	SDBLK_REQ_T a, b;
+
+	resetModel(CARD_TYPE_HC);
+	memset(cardData[40], 0x5A, 2 * MMC_SECTOR_SIZE);
+	Chip_SDBLK_SetupReq(&a, rbuf[0], 40, 2, false, doneCb, NULL);
+	Chip_SDBLK_SetupReq(&b, rbuf[1], 40, 2, false, doneCb, NULL);
+	failInt = MCI_INT_DCRC;
+	TEST_CHECK(Chip_SDBLK_Submit(&a) == SUCCESS);
+	TEST_CHECK(Chip_SDBLK_Submit(&b) == SUCCESS);
+	hostSDRun(10);
+	TEST_CHECK(numDone == 2 && pDoneLog[0] == &a && pDoneLog[1] == &b);
+	TEST_CHECK(a.status == ERROR && b.status == SUCCESS);
+	TEST_CHECK(numStops == 1);
+	TEST_CHECK(rbuf[1][0] == 0x5A && rbuf[1][2 * MMC_SECTOR_SIZE - 1] == 0x5A);
+	TEST_CHECK(Chip_SDBLK_GetStats()->errors == 1 && Chip_SDBLK_GetStats()->reads == 1);
+}
+
+int main(void)
+{
+	testBeforeInit();
+	testQueue(CARD_TYPE_HC);
+	testQueue(CARD_TYPE_SD);
+	testRange();
+	testError();
+	printf("test_sdblk: passed, %u commands\n", (unsigned) numCmds);
+	return 0;
+}
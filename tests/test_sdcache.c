@@ -0,0 +1,242 @@
+/*
+ * @brief Host test of the SD/MMC block cache
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/sdcache_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define CARD_BLOCKS     4096
+#define NUM_LINES       32
+#define STAGE_BLOCKS    8
+
+/* RAM card behind the block I/O hook, with the expected card contents */
+static uint8_t cardData[CARD_BLOCKS][MMC_SECTOR_SIZE], refData[CARD_BLOCKS][MMC_SECTOR_SIZE];
+static uint32_t ioReads, ioWrites;
+
+static SDCACHE_LINE_T lines[NUM_LINES];
+static uint32_t lineData[NUM_LINES][MMC_SECTOR_SIZE / 4], stage[STAGE_BLOCKS][MMC_SECTOR_SIZE / 4];
+static uint32_t buf[300 * MMC_SECTOR_SIZE / 4 + 1];
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The default block I/O is not used, the tests pass their own */
+Status Chip_SDBLK_Submit(SDBLK_REQ_T *pReq)
+{
+	return ERROR;
+}
+
+void Chip_SDBLK_Poll(void)
+{}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Refuses what Chip_SDBLK_Submit() and the IDMAC would refuse */
+static Status hostIO(void *buffer, uint32_t block, uint32_t count, bool write)
+{
+	TEST_CHECK((count > 0) && (count <= SDBLK_MAX_BLOCKS));
+	TEST_CHECK(((uintptr_t) buffer & 3) == 0);
+	TEST_CHECK(block + count <= CARD_BLOCKS);
+	if (write) {
+		memcpy(cardData[block], buffer, count * MMC_SECTOR_SIZE);
+		ioWrites++;
+	}
+	else {
+		memcpy(buffer, cardData[block], count * MMC_SECTOR_SIZE);
+		ioReads++;
+	}
+	return SUCCESS;
+}
+
+static void resetModel(void)
+{
+	uint32_t i, j;
+
+	for (i = 0; i < CARD_BLOCKS; i++) {
+		for (j = 0; j < MMC_SECTOR_SIZE; j++) {
+			cardData[i][j] = (uint8_t) (i * 3 + j);
+		}
+	}
+	memcpy(refData, cardData, sizeof(cardData));
+	ioReads = ioWrites = 0;
+	Chip_SDCACHE_Init(lines, lineData, NUM_LINES, stage, STAGE_BLOCKS, CARD_BLOCKS, hostIO);
+}
+
+/* Write to the cache and to the expected contents */
+static void writeRef(const void *data, uint32_t block, uint32_t count)
+{
+	memcpy(refData[block], data, count * MMC_SECTOR_SIZE);
+	TEST_CHECK(Chip_SDCACHE_Write(data, block, count) == SUCCESS);
+}
+
+static void checkRead(uint32_t block, uint32_t count)
+{
+	TEST_CHECK(Chip_SDCACHE_Read(buf, block, count) == SUCCESS);
+	TEST_CHECK(memcmp(buf, refData[block], count * MMC_SECTOR_SIZE) == 0);
+}
+
+/* Adjacent dirty blocks are written back with one command */
+static void testMerge(void)
+{
+	uint32_t i;
+
+	resetModel();
+	for (i = 0; i < 4; i++) {
+		memset(buf, 0x40 + i, MMC_SECTOR_SIZE);
+		writeRef(buf, 103 - i, 1);
+	}
+	TEST_CHECK(ioWrites == 0);
+	TEST_CHECK(Chip_SDCACHE_Flush() == SUCCESS);
+	TEST_CHECK(ioWrites == 1 && Chip_SDCACHE_GetStats()->blocksWritten == 4);
+	TEST_CHECK(memcmp(cardData, refData, sizeof(cardData)) == 0);
+
+	/* Nothing is left dirty */
+	TEST_CHECK(Chip_SDCACHE_Flush() == SUCCESS);
+	TEST_CHECK(ioWrites == 1);
+}
+
+/* A read continuing the previous one loads the next blocks with it */
+static void testReadAhead(void)
+{
+	resetModel();
+	checkRead(2000, 2);
+	TEST_CHECK(ioReads == 1 && Chip_SDCACHE_GetStats()->readAhead == 0);
+	checkRead(2002, 2);
+	TEST_CHECK(ioReads == 2 && Chip_SDCACHE_GetStats()->readAhead > 0);
+	checkRead(2004, 2);
+	TEST_CHECK(ioReads == 2);
+	TEST_CHECK(Chip_SDCACHE_GetStats()->hits == 2);
+}
+
+/* Writes of a stage or more bypass the cache in commands the block driver
+   takes, from aligned and unaligned buffers */
+static void testLongWrite(void)
+{
+	uint8_t *p = (uint8_t *) buf;
+	uint32_t i;
+
+	resetModel();
+
+	/* A cached, dirty copy of a block in the range is replaced */
+	memset(buf, 0x11, MMC_SECTOR_SIZE);
+	writeRef(buf, 650, 1);
+
+	for (i = 0; i < 300 * MMC_SECTOR_SIZE; i++) {
+		p[i] = (uint8_t) (i * 7 + (i >> 9));
+	}
+	writeRef(buf, 500, 300);
+	TEST_CHECK(ioWrites == 3);
+	TEST_CHECK(memcmp(cardData, refData, sizeof(cardData)) == 0);
+	TEST_CHECK(Chip_SDCACHE_Flush() == SUCCESS);
+	TEST_CHECK(ioWrites == 3);
+	checkRead(650, 1);
+
+	for (i = 0; i < 20 * MMC_SECTOR_SIZE; i++) {
+		p[i + 1] = (uint8_t) (i * 5 + 3);
+	}
+	writeRef(p + 1, 1000, 20);
+	TEST_CHECK(ioWrites == 6);
+	TEST_CHECK(memcmp(cardData, refData, sizeof(cardData)) == 0);
+
+	TEST_CHECK(Chip_SDCACHE_Write(buf, CARD_BLOCKS - 10, 11) == ERROR);
+}
+
+/* Logging-style mix of tail rewrites, random reads and writes, sequential
+   reads and flushes. The card matches the expected contents after every flush. */
+static void testMixed(void)
+{
+	uint32_t tail = 100, seq = 2000, op, i, block, count;
+
+	resetModel();
+	srand(1);
+	for (op = 0; op < 20000; op++) {
+		int k = rand() % 10;
+
+		if (k < 6) {
+			memset(buf, op, MMC_SECTOR_SIZE);
+			writeRef(buf, tail, 1);
+			if ((op % 4) == 3) {
+				tail++;
+			}
+			if (tail >= CARD_BLOCKS - 20) {
+				tail = 100;
+			}
+		}
+		else if (k < 8) {
+			block = rand() % (CARD_BLOCKS - 16);
+			count = 1 + rand() % 16;
+			if (count >= STAGE_BLOCKS) {
+				for (i = 0; i < count * MMC_SECTOR_SIZE / 4; i++) {
+					buf[i] = rand();
+				}
+				writeRef(buf, block, count);
+			}
+			else {
+				checkRead(block, count);
+			}
+		}
+		else if (k < 9) {
+			checkRead(seq, 2);
+			seq += 2;
+			if (seq > 3000) {
+				seq = 2000;
+			}
+		}
+		else {
+			TEST_CHECK(Chip_SDCACHE_Flush() == SUCCESS);
+			TEST_CHECK(memcmp(cardData, refData, sizeof(cardData)) == 0);
+		}
+	}
+	TEST_CHECK(Chip_SDCACHE_Flush() == SUCCESS);
+	TEST_CHECK(memcmp(cardData, refData, sizeof(cardData)) == 0);
+}
+
+int main(void)
+{
+	SDCACHE_STATS_T *pStats;
+
+	testMerge();
+	testReadAhead();
+	testLongWrite();
+	testMixed();
+	pStats = Chip_SDCACHE_GetStats();
+	printf("test_sdcache: passed, %u hits, %u misses, %u read ahead, %u card reads, %u card writes\n",
+		   (unsigned) pStats->hits, (unsigned) pStats->misses, (unsigned) pStats->readAhead,
+		   (unsigned) ioReads, (unsigned) ioWrites);
+	return 0;
+}
@@ -0,0 +1,241 @@
+/*
+ * @brief Host test of the SD/MMC record log
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/sdlog_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define CARD_BLOCKS     300
+#define LOG_BASE        10
+#define LOG_BLOCKS      280
+
+/* Small log for the power loss test, two pages per segment */
+#define SMALL_BLOCKS    (4 + 2 * SDLOG_MAX_SEGMENTS)
+
+/* RAM card. A power loss can be set to tear one block write, which then
+   holds the new data up to the tear offset and the old data after it. */
+static uint8_t cardData[CARD_BLOCKS][MMC_SECTOR_SIZE];
+static uint32_t numWrites, tearAt, tearOffset;
+static bool powerLost;
+
+static SDLOG_T hLog;
+static uint32_t got[200000], numGot;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static Status hostIO(void *buffer, uint32_t block, uint32_t count, bool write)
+{
+	TEST_CHECK(block + count <= CARD_BLOCKS);
+	if (!write) {
+		memcpy(buffer, cardData[block], count * MMC_SECTOR_SIZE);
+		return SUCCESS;
+	}
+
+	if (powerLost) {
+		return ERROR;
+	}
+	if (++numWrites == tearAt) {
+		TEST_CHECK(count == 1);
+		memcpy(cardData[block], buffer, tearOffset);
+		powerLost = true;
+		return ERROR;
+	}
+	memcpy(cardData[block], buffer, count * MMC_SECTOR_SIZE);
+	return SUCCESS;
+}
+
+/* Records carry their time stamp times 7 and vary in length */
+static Status appendRec(uint32_t ts)
+{
+	uint8_t rec[32];
+	uint32_t v = ts * 7;
+
+	memset(rec, 0, sizeof(rec));
+	memcpy(rec, &v, 4);
+	return Chip_SDLOG_Append(&hLog, ts, rec, 4 + (ts % 20));
+}
+
+static void recordCb(uint32_t ts, const void *data, uint32_t len, void *arg)
+{
+	uint32_t v;
+
+	memcpy(&v, data, 4);
+	TEST_CHECK(v == ts * 7 && len == 4 + (ts % 20));
+	TEST_CHECK(numGot < 200000);
+	got[numGot++] = ts;
+}
+
+/* Read everything and check the records are consecutive */
+static void readAll(void)
+{
+	uint32_t i;
+
+	numGot = 0;
+	TEST_CHECK(Chip_SDLOG_ReadRange(&hLog, 0, 0xFFFFFFFF, recordCb, NULL) == SUCCESS);
+	for (i = 1; i < numGot; i++) {
+		TEST_CHECK(got[i] == got[i - 1] + 1);
+	}
+}
+
+static void resetCard(void)
+{
+	memset(cardData, 0, sizeof(cardData));
+	numWrites = 0;
+	tearAt = 0;
+	powerLost = false;
+}
+
+/* Bursts of appends with random syncs, each followed by a power loss between
+   writes and a remount. Every synced record is recovered in order, and
+   range reads return exactly their range. */
+static void testRemount(void)
+{
+	uint32_t ts = 1, synced = 0, round, i, n, a, b;
+
+	resetCard();
+	TEST_CHECK(Chip_SDLOG_Mount(&hLog, LOG_BASE, LOG_BLOCKS, hostIO) == ERROR);
+	TEST_CHECK(Chip_SDLOG_Format(&hLog, LOG_BASE, LOG_BLOCKS, hostIO) == SUCCESS);
+
+	srand(3);
+	for (round = 0; round < 40; round++) {
+		n = rand() % 2000;
+		for (i = 0; i < n; i++, ts++) {
+			TEST_CHECK(appendRec(ts) == SUCCESS);
+			if ((rand() % 50) == 0) {
+				TEST_CHECK(Chip_SDLOG_Sync(&hLog) == SUCCESS);
+				synced = ts;
+			}
+		}
+
+		TEST_CHECK(Chip_SDLOG_Mount(&hLog, LOG_BASE, LOG_BLOCKS, hostIO) == SUCCESS);
+		readAll();
+		TEST_CHECK(numGot > 0 && got[numGot - 1] >= synced);
+		ts = got[numGot - 1] + 1;
+		synced = got[numGot - 1];
+
+		if (numGot > 10) {
+			a = got[numGot / 3];
+			b = got[numGot / 2];
+			numGot = 0;
+			TEST_CHECK(Chip_SDLOG_ReadRange(&hLog, a, b, recordCb, NULL) == SUCCESS);
+			TEST_CHECK(numGot == b - a + 1 && got[0] == a);
+		}
+	}
+}
+
+/* Power lost in the middle of every write of a run that wraps the log
+   several times. No record synced before the torn write is lost. */
+static void testTornWrite(void)
+{
+	uint32_t tear, ts, synced, written, step, numTears = 0;
+
+	for (tear = 1; ; tear++) {
+		resetCard();
+		TEST_CHECK(Chip_SDLOG_Format(&hLog, LOG_BASE, SMALL_BLOCKS, hostIO) == SUCCESS);
+		tearAt = numWrites + tear;
+		tearOffset = (tear * 37) % MMC_SECTOR_SIZE;
+
+		srand(tear);
+		synced = 0;
+		for (ts = 1; ts < 3000; ts++) {
+			if (appendRec(ts) != SUCCESS) {
+				break;
+			}
+			step = rand() % 8;
+			if (step == 0) {
+				if (Chip_SDLOG_Sync(&hLog) != SUCCESS) {
+					break;
+				}
+				synced = ts;
+			}
+		}
+		if (!powerLost) {
+			break;
+		}
+		written = ts;
+		numTears++;
+
+		TEST_CHECK(Chip_SDLOG_Mount(&hLog, LOG_BASE, SMALL_BLOCKS, hostIO) == SUCCESS);
+		readAll();
+		if (synced) {
+			TEST_CHECK(numGot > 0 && got[numGot - 1] >= synced && got[numGot - 1] <= written);
+		}
+
+		/* The log carries on after the power loss */
+		powerLost = false;
+		tearAt = 0;
+		ts = numGot ? got[numGot - 1] + 1 : 1;
+		TEST_CHECK(appendRec(ts) == SUCCESS && Chip_SDLOG_Sync(&hLog) == SUCCESS);
+		TEST_CHECK(Chip_SDLOG_Mount(&hLog, LOG_BASE, SMALL_BLOCKS, hostIO) == SUCCESS);
+		readAll();
+		TEST_CHECK(numGot > 0 && got[numGot - 1] == ts);
+	}
+	printf("test_sdlog: %u torn writes recovered\n", (unsigned) numTears);
+	TEST_CHECK(numTears > 400);
+}
+
+/* Sync every 100 records of 16 bytes */
+static void testAmplification(void)
+{
+	SDLOG_STATS_T *pStats = Chip_SDLOG_GetStats(&hLog);
+	uint8_t rec[16];
+	uint32_t i;
+
+	resetCard();
+	TEST_CHECK(Chip_SDLOG_Format(&hLog, LOG_BASE, LOG_BLOCKS, hostIO) == SUCCESS);
+	memset(rec, 0, sizeof(rec));
+	for (i = 1; i <= 100000; i++) {
+		memcpy(rec, &i, 4);
+		TEST_CHECK(Chip_SDLOG_Append(&hLog, i, rec, sizeof(rec)) == SUCCESS);
+		if ((i % 100) == 0) {
+			TEST_CHECK(Chip_SDLOG_Sync(&hLog) == SUCCESS);
+		}
+	}
+	TEST_CHECK(pStats->records == 100000);
+	printf("test_sdlog: %u blocks written for %u payload bytes, write amplification %.2f\n",
+		   (unsigned) pStats->blocksWritten, (unsigned) pStats->recordBytes,
+		   pStats->blocksWritten * (double) MMC_SECTOR_SIZE / pStats->recordBytes);
+}
+
+int main(void)
+{
+	testRemount();
+	testTornWrite();
+	testAmplification();
+	printf("test_sdlog: passed\n");
+	return 0;
+}
@@ -0,0 +1,282 @@
+/*
+ * @brief Host test of the SSP DMA transaction queue
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include "../lpc_chip_43xx/src/gpdma_18xx_43xx.c"
+#include "gpdma_model.h"
+#define Chip_GPDMA_ChannelCmd hostChannelCmd
+#include "../lpc_chip_43xx/src/gpdmamgr_18xx_43xx.c"
+#undef Chip_GPDMA_ChannelCmd
+#include "../lpc_chip_43xx/src/sspdma_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Manager channels, the receive side of a transaction gets the lower one */
+#define CHAN_MASK   0x0C
+#define RX_CHAN     2
+#define TX_CHAN     3
+
+#define CR0_8BIT    SSP_CR0_DSS(7)
+#define CR0_16BIT   SSP_CR0_DSS(15)
+
+#define BIG_LEN     10000
+
+/* The SSP data register is looped back to itself through the model FIFO */
+static LPC_SSP_T hostSSP;
+static SSPDMA_HANDLE_T hSSP;
+
+static uint8_t txA[100], rxA[100], txB[50], rxC[BIG_LEN], txE[64], rxE[64];
+static uint16_t txH[300], rxH[300];
+
+/* Chip select and completion events */
+static int csAsserted, csEvents;
+static uint32_t csLastCR0;
+static SSPDMA_XFER_T *pDoneLog[8];
+static int numDone;
+static SSPDMA_XFER_T *pExpectNext, *pResubmit;
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* The SSP driver itself is not under test, this empties the model's FIFO
+   like the real function empties the receive FIFO */
+void Chip_SSP_Int_FlushData(LPC_SSP_T *pSSP)
+{
+	TEST_CHECK(pSSP == &hostSSP);
+	hostFifoFlush();
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+static void csCb(uint32_t cs, bool assert)
+{
+	TEST_CHECK(cs < 4);
+	if (assert) {
+		/* Only one device selected at a time, DMA not yet moving frames */
+		TEST_CHECK(csAsserted == 0);
+		TEST_CHECK((hostEnabled() & ((1 << RX_CHAN) | (1 << TX_CHAN))) == 0);
+		csLastCR0 = hostSSP.CR0;
+	}
+	else {
+		TEST_CHECK(csAsserted == 1);
+	}
+	csAsserted = assert;
+	csEvents++;
+}
+
+static void doneCb(SSPDMA_XFER_T *pXfer)
+{
+	TEST_CHECK(numDone < 8);
+	pDoneLog[numDone++] = pXfer;
+	TEST_CHECK(csAsserted == 0 || hSSP.pHead != NULL);
+
+	/* The next transaction is on the bus before this callback runs */
+	if (pExpectNext) {
+		TEST_CHECK(hSSP.pHead == pExpectNext);
+		TEST_CHECK(hostEnabled() == ((1 << RX_CHAN) | (1 << TX_CHAN)));
+		pExpectNext = NULL;
+	}
+	if (pResubmit) {
+		TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, pResubmit) == SUCCESS);
+		pResubmit = NULL;
+	}
+}
+
+static void resetModel(void)
+{
+	memset(&hostGPDMA, 0, sizeof(hostGPDMA));
+	memset(&hostSSP, 0, sizeof(hostSSP));
+	hostSSP.CR0 = CR0_8BIT;
+	hostAttachFifo(&hostSSP.DR);
+	hostFailMask = 0;
+	csAsserted = csEvents = numDone = 0;
+	pExpectNext = pResubmit = NULL;
+	Chip_GPDMAMGR_Init(&hostGPDMA, CHAN_MASK);
+	Chip_SSPDMA_Init(&hSSP, &hostSSP, GPDMAMGR_PRIO_NORMAL, csCb);
+}
+
+static void fill(uint8_t *p, uint32_t len, uint8_t seed)
+{
+	uint32_t i;
+
+	for (i = 0; i < len; i++) {
+		p[i] = (uint8_t) (seed + i * 7);
+	}
+}
+
+/* Back to back transactions, NULL buffers and multi descriptor lengths */
+static void testQueue(void)
+{
+	SSPDMA_XFER_T xA, xB, xC;
+	uint32_t i;
+
+	resetModel();
+	fill(txA, sizeof(txA), 1);
+	fill(txB, sizeof(txB), 2);
+	memset(rxA, 0, sizeof(rxA));
+	memset(rxC, 0, sizeof(rxC));
+	Chip_SSPDMA_SetupXfer(&xA, 0, txA, rxA, sizeof(txA), doneCb, NULL);
+	Chip_SSPDMA_SetupXfer(&xB, 1, txB, NULL, sizeof(txB), doneCb, NULL);
+	Chip_SSPDMA_SetupXfer(&xC, 2, NULL, rxC, BIG_LEN, doneCb, NULL);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xA) == SUCCESS);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xB) == SUCCESS);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xC) == SUCCESS);
+	TEST_CHECK(hostSSP.DMACR == SSP_DMA_BITMASK);
+	TEST_CHECK(hSSP.rxDesc[2].lli == 0 && hSSP.rxDesc[1].lli == 0);
+
+	/* Transmit finishes first, the transaction waits for its receive side */
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 0 && hSSP.pending == 1);
+	pExpectNext = &xB;
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 1 && pExpectNext == NULL);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 3 && pDoneLog[0] == &xA && pDoneLog[1] == &xB && pDoneLog[2] == &xC);
+	TEST_CHECK(xA.status == SUCCESS && xB.status == SUCCESS && xC.status == SUCCESS);
+	TEST_CHECK(memcmp(txA, rxA, sizeof(txA)) == 0);
+	for (i = 0; i < BIG_LEN; i++) {
+		TEST_CHECK(rxC[i] == 0xFF);
+	}
+	TEST_CHECK(csEvents == 6 && csAsserted == 0);
+	TEST_CHECK(Chip_SSPDMA_IsIdle(&hSSP) && hostSSP.DMACR == 0);
+	TEST_CHECK(hSSP.stats.xfers == 3 && hSSP.stats.frames == sizeof(txA) + sizeof(txB) + BIG_LEN);
+	TEST_CHECK(hSSP.stats.errors == 0 && hSSP.stats.busyTicks > 0);
+
+	/* Lengths the descriptors cannot hold are refused */
+	Chip_SSPDMA_SetupXfer(&xA, 0, txA, rxA, 0, doneCb, NULL);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xA) == ERROR);
+	Chip_SSPDMA_SetupXfer(&xA, 0, txA, rxA, SSPDMA_MAX_FRAMES + 1, doneCb, NULL);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xA) == ERROR);
+	TEST_CHECK(Chip_SSPDMA_IsIdle(&hSSP) && csEvents == 6);
+}
+
+/* A per transaction CR0 switches to halfword frames and is restored */
+static void testFormat(void)
+{
+	SSPDMA_XFER_T xH, xA;
+	uint32_t i;
+
+	resetModel();
+	for (i = 0; i < 300; i++) {
+		txH[i] = (uint16_t) (0x8000 + i * 257);
+	}
+	memset(rxH, 0, sizeof(rxH));
+	fill(txA, sizeof(txA), 3);
+	Chip_SSPDMA_SetupXfer(&xH, 3, txH, rxH, 300, doneCb, NULL);
+	xH.cr0 = CR0_16BIT;
+	Chip_SSPDMA_SetupXfer(&xA, 0, txA, rxA, sizeof(txA), doneCb, NULL);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xH) == SUCCESS);
+	TEST_CHECK(csLastCR0 == CR0_16BIT);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xA) == SUCCESS);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 2 && memcmp(txH, rxH, sizeof(txH)) == 0);
+	TEST_CHECK(memcmp(txA, rxA, sizeof(txA)) == 0);
+	TEST_CHECK(csLastCR0 == CR0_8BIT && hostSSP.CR0 == CR0_8BIT);
+}
+
+/* A failed transmit cancels the stalled receive and the queue carries on */
+static void testTxError(void)
+{
+	SSPDMA_XFER_T xE, xN;
+
+	resetModel();
+	fill(txE, sizeof(txE), 4);
+	fill(txA, sizeof(txA), 5);
+	memset(rxE, 0, sizeof(rxE));
+	Chip_SSPDMA_SetupXfer(&xE, 1, txE, rxE, sizeof(txE), doneCb, NULL);
+	Chip_SSPDMA_SetupXfer(&xN, 2, txA, rxA, sizeof(txA), doneCb, NULL);
+	xE.cr0 = CR0_16BIT;
+	hostFailMask = 1 << TX_CHAN;
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xE) == SUCCESS);
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xN) == SUCCESS);
+
+	/* One interrupt ends both directions and starts the next transaction */
+	pExpectNext = &xN;
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 1 && pDoneLog[0] == &xE && pExpectNext == NULL);
+	TEST_CHECK(xE.status == ERROR && Chip_SSPDMA_IsDone(&xE));
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(RX_CHAN)->errors == 1);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(TX_CHAN)->errors == 1);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 2 && xN.status == SUCCESS);
+	TEST_CHECK(memcmp(txA, rxA, sizeof(txA)) == 0);
+	TEST_CHECK(hostSSP.CR0 == CR0_8BIT && csEvents == 4 && csAsserted == 0);
+	TEST_CHECK(hSSP.stats.errors == 1 && hSSP.stats.xfers == 1 && hSSP.stats.frames == sizeof(txA));
+	TEST_CHECK(Chip_SSPDMA_IsIdle(&hSSP) && hostSSP.DMACR == 0);
+}
+
+/* A failed receive after a completed transmit leaves frames behind, the next
+   transaction must not see them */
+static void testRxError(void)
+{
+	SSPDMA_XFER_T xE, xN;
+
+	resetModel();
+	fill(txE, sizeof(txE), 6);
+	fill(txA, sizeof(txA), 7);
+	memset(rxE, 0, sizeof(rxE));
+	Chip_SSPDMA_SetupXfer(&xE, 1, txE, rxE, sizeof(txE), doneCb, NULL);
+	Chip_SSPDMA_SetupXfer(&xN, 2, txA, rxA, sizeof(txA), doneCb, NULL);
+	hostFailMask = 1 << RX_CHAN;
+	pResubmit = &xN;
+	TEST_CHECK(Chip_SSPDMA_Submit(&hSSP, &xE) == SUCCESS);
+	TEST_CHECK(hostPump());
+	TEST_CHECK(numDone == 1 && xE.status == ERROR);
+	TEST_CHECK(hSSP.pHead == &xN && hostFifoCount() == 0);
+	hostPumpAll();
+
+	TEST_CHECK(numDone == 2 && xN.status == SUCCESS);
+	TEST_CHECK(memcmp(txA, rxA, sizeof(txA)) == 0);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(RX_CHAN)->errors == 1);
+	TEST_CHECK(Chip_GPDMAMGR_GetChannelStats(TX_CHAN)->errors == 0);
+	TEST_CHECK(hSSP.stats.errors == 1 && hSSP.stats.xfers == 1);
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+int main(void)
+{
+	testQueue();
+	testFormat();
+	testTxError();
+	testRxError();
+	printf("test_sspdma: passed, %u interrupts\n", (unsigned) hostIRQs);
+	return 0;
+}
@@ -0,0 +1,240 @@
+/*
+ * @brief Host test of the framed binary telemetry
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+#include <time.h>
+
+#include "../lpc_chip_43xx/src/ring_buffer.c"
+#include "../lpc_chip_43xx/src/telem_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+#define NUM_RECORDS         200000
+#define QUEUE_SIZE          512
+
+/* A record sent and not yet decoded, with the records dropped before it */
+typedef struct {
+	uint8_t type;
+	uint8_t seq;
+	uint32_t dropsBefore;
+	uint32_t len;
+	uint8_t payload[TELEM_MAX_PAYLOAD];
+} HOST_RECORD_T;
+
+static HOST_RECORD_T queue[QUEUE_SIZE];
+static uint32_t queueHead, queueTail, dropsPending;
+
+/* Host side decoder */
+static uint8_t frame[512];
+static uint32_t frameLen, framesDecoded, lostReported;
+static int lastSeq = -1;
+
+static bool drainAll = true, decodeFrames = true;
+static RINGBUFF_T txRing;
+static uint8_t txRingBuf[1024];
+static LPC_USART_T hostUART;
+static TELEM_HANDLE_T hTelem;
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Decode a frame without its delimiter and check it against the oldest
+   record sent */
+static void hostDecodeFrame(void)
+{
+	uint8_t raw[512];
+	uint32_t i = 0, n = 0, code, k;
+	HOST_RECORD_T *pRec;
+	uint16_t crc;
+
+	while (i < frameLen) {
+		code = frame[i];
+		TEST_CHECK((code != 0) && ((i + code) <= frameLen));
+		for (k = 1; k < code; k++) {
+			raw[n++] = frame[i + k];
+		}
+		i += code;
+		if ((code != 0xFF) && (i < frameLen)) {
+			raw[n++] = 0;
+		}
+	}
+	TEST_CHECK(n >= 4);
+	crc = raw[n - 2] | (raw[n - 1] << 8);
+	TEST_CHECK(Chip_TELEM_CRC16(0xFFFF, raw, n - 2) == crc);
+
+	TEST_CHECK(queueTail != queueHead);
+	pRec = &queue[queueTail++ % QUEUE_SIZE];
+	TEST_CHECK((raw[0] == pRec->type) && (raw[1] == pRec->seq) && ((n - 4) == pRec->len));
+	TEST_CHECK(memcmp(&raw[2], pRec->payload, pRec->len) == 0);
+
+	/* The host sees a dropped record as a gap in the sequence numbers */
+	if (lastSeq >= 0) {
+		TEST_CHECK(((raw[1] - lastSeq - 1) & 0xFF) == (pRec->dropsBefore & 0xFF));
+		lostReported += (raw[1] - lastSeq - 1) & 0xFF;
+	}
+	lastSeq = raw[1];
+	framesDecoded++;
+}
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+/* Stands in for the UART, takes some or all of the ring and feeds the
+   bytes to the decoder */
+void Chip_UART_TXIntHandlerRB(LPC_USART_T *pUART, RINGBUFF_T *pRB)
+{
+	uint8_t bytes[1024];
+	int n = RingBuffer_GetCount(pRB), i;
+
+	if (!drainAll) {
+		n = ((rand() % 4) == 0) ? (rand() % (n + 1)) : 0;
+	}
+	n = RingBuffer_PopMult(pRB, bytes, n);
+	for (i = 0; decodeFrames && (i < n); i++) {
+		if (bytes[i] == 0) {
+			if (frameLen) {
+				hostDecodeFrame();
+			}
+			frameLen = 0;
+		}
+		else {
+			TEST_CHECK(frameLen < sizeof(frame));
+			frame[frameLen++] = bytes[i];
+		}
+	}
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Random records of 0 to 249 bytes, all zeros, all 0xFF or mixed, through
+   a 1 KiB ring drained at random. Every record sent must decode intact and
+   every drop must show as a sequence gap. */
+static void testFrames(void)
+{
+	HOST_RECORD_T *pRec;
+	uint32_t i, j, mode;
+
+	RingBuffer_Init(&txRing, txRingBuf, 1, sizeof(txRingBuf));
+	Chip_TELEM_Init(&hTelem, &hostUART, &txRing);
+	drainAll = false;
+
+	for (i = 0; i < NUM_RECORDS; i++) {
+		pRec = &queue[queueHead % QUEUE_SIZE];
+		pRec->type = (uint8_t) (i % 7);
+		pRec->seq = hTelem.seq;
+		pRec->len = rand() % (TELEM_MAX_PAYLOAD + 1);
+		mode = rand() % 3;
+		for (j = 0; j < pRec->len; j++) {
+			pRec->payload[j] = (mode == 0) ? 0 : (mode == 1) ? 0xFF : (((rand() % 4) != 0) ? rand() : 0);
+		}
+		pRec->dropsBefore = dropsPending;
+
+		/* Queued first, the send may drain the frame at once */
+		queueHead++;
+		TEST_CHECK((queueHead - queueTail) < QUEUE_SIZE);
+		if (Chip_TELEM_Send(&hTelem, pRec->type, pRec->payload, pRec->len) == SUCCESS) {
+			dropsPending = 0;
+		}
+		else {
+			queueHead--;
+			dropsPending++;
+		}
+		if ((i & 3) == 0) {
+			Chip_UART_TXIntHandlerRB(&hostUART, &txRing);
+		}
+	}
+	drainAll = true;
+	Chip_UART_TXIntHandlerRB(&hostUART, &txRing);
+
+	TEST_CHECK(queueTail == queueHead);
+	TEST_CHECK(framesDecoded == hTelem.stats.frames);
+	TEST_CHECK(lostReported + dropsPending == hTelem.stats.dropped);
+	printf("test_telem: %u records, %u frames decoded, %u dropped and reported as lost\n",
+		   NUM_RECORDS, (unsigned) framesDecoded, (unsigned) hTelem.stats.dropped);
+
+	TEST_CHECK(Chip_TELEM_Send(&hTelem, 1, txRingBuf, TELEM_MAX_PAYLOAD + 1) == ERROR);
+
+	/* CRC-16/CCITT-FALSE check value */
+	TEST_CHECK(Chip_TELEM_CRC16(0xFFFF, "123456789", 9) == 0x29B1);
+}
+
+/* Encoding a tick record against printing the same DEBUGOUT line */
+static void testCost(void)
+{
+	struct {
+		uint32_t count;
+		uint32_t ms;
+	} tick;
+	static char text[64];
+	uint32_t i, frameBytes = 0, bytes;
+	int textBytes = 0;
+	clock_t start;
+	double encodeNs, textNs;
+
+	decodeFrames = false;
+	start = clock();
+	for (i = 0; i < 1000000; i++) {
+		tick.count = i;
+		tick.ms = i * 1000;
+		bytes = hTelem.stats.bytes;
+		Chip_TELEM_Send(&hTelem, 1, &tick, sizeof(tick));
+		frameBytes = hTelem.stats.bytes - bytes;
+		RingBuffer_Flush(&txRing);
+	}
+	encodeNs = (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 1000000;
+
+	start = clock();
+	for (i = 0; i < 1000000; i++) {
+		textBytes = snprintf(text, sizeof(text), "Tick: %lu %lu ms\r\n", (unsigned long) i, (unsigned long) i * 1000);
+		RingBuffer_InsertMult(&txRing, text, textBytes);
+		RingBuffer_Flush(&txRing);
+	}
+	textNs = (double) (clock() - start) / CLOCKS_PER_SEC * 1e9 / 1000000;
+
+	TEST_CHECK(frameBytes == (sizeof(tick) + TELEM_FRAME_OVERHEAD));
+	printf("test_telem: tick record %u bytes in %.0f ns, as text %d bytes in %.0f ns\n",
+		   (unsigned) frameBytes, encodeNs, textBytes, textNs);
+}
+
+int main(void)
+{
+	srand(1);
+	testFrames();
+	testCost();
+	printf("test_telem: passed\n");
+	return 0;
+}
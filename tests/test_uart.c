@@ -0,0 +1,295 @@
+/*
+ * @brief Host test of the UART ring buffer interrupt paths
+ *
+ * @note
+ * Copyright(C) NXP Semiconductors, 2015
+ * All rights reserved.
+ *
+ * @par
+ * Software that is described herein is for illustrative purposes only
+ * which provides customers with programming information regarding the
+ * LPC products.  This software is supplied "AS IS" without any warranties of
+ * any kind, and NXP Semiconductors and its licensor disclaim any and
+ * all warranties, express or implied, including all implied warranties of
+ * merchantability, fitness for a particular purpose and non-infringement of
+ * intellectual property rights.  NXP Semiconductors assumes no responsibility
+ * or liability for the use of the software, conveys no license or rights under any
+ * patent, copyright, mask work right, or any other intellectual property rights in
+ * or to any products. NXP Semiconductors reserves the right to make changes
+ * in the software without notification. NXP Semiconductors also makes no
+ * representation or warranty that such application will be suitable for the
+ * specified use without further testing or modification.
+ *
+ * @par
+ * Permission to use, copy, modify, and distribute this software and its
+ * documentation is hereby granted, under NXP Semiconductors' and its
+ * licensor's relevant copyrights in the software, without fee, provided that it
+ * is used in conjunction with NXP Semiconductors microcontrollers.  This
+ * copyright, permission, and disclaimer notice must appear in all copies of
+ * this code.
+ */
+
+#include <string.h>
+
+#include "../lpc_chip_43xx/src/ring_buffer.c"
+
+/* UART model: 16 byte FIFOs, one character time per step. The register
+   helpers the driver uses are replaced by the model, which also counts
+   the APB accesses, ring buffer calls and bytes moved in the handler. */
+static uint8_t rxFifo[16], txFifo[16];
+static int rxCount, rxHead, txCount, txHead;
+static int rxTrig, threPending;
+static uint32_t ier;
+static long now, lastRx, overruns;
+static bool inIrq;
+static long apbAccesses, ringCalls, ringBytes, loopBytes;
+
+static uint32_t hostReadIIR(LPC_USART_T *pUART)
+{
+	if (inIrq) {
+		apbAccesses++;
+	}
+	if ((ier & UART_IER_RBRINT) && (rxCount >= rxTrig)) {
+		return UART_IIR_INTID_RDA;
+	}
+	if ((ier & UART_IER_RBRINT) && (rxCount > 0) && ((now - lastRx) >= 4)) {
+		return UART_IIR_INTID_CTI;
+	}
+	if ((ier & UART_IER_THREINT) && threPending) {
+		threPending = 0;
+		return UART_IIR_INTID_THRE;
+	}
+	return UART_IIR_INTSTAT_PEND;
+}
+
+static uint32_t hostReadLSR(LPC_USART_T *pUART)
+{
+	if (inIrq) {
+		apbAccesses++;
+	}
+	return (rxCount ? UART_LSR_RDR : 0) | ((txCount == 0) ? UART_LSR_THRE : 0);
+}
+
+static uint8_t hostReadRBR(LPC_USART_T *pUART)
+{
+	uint8_t c;
+
+	if (inIrq) {
+		apbAccesses++;
+		loopBytes++;
+	}
+	TEST_CHECK(rxCount > 0);
+	c = rxFifo[rxHead];
+	rxHead = (rxHead + 1) & 15;
+	rxCount--;
+	lastRx = now;
+	return c;
+}
+
+static void hostWriteTHR(LPC_USART_T *pUART, uint8_t c)
+{
+	if (inIrq) {
+		apbAccesses++;
+		loopBytes++;
+	}
+	TEST_CHECK(txCount < 16);
+	txFifo[(txHead + txCount) & 15] = c;
+	txCount++;
+	threPending = 0;
+}
+
+static void hostIntEnable(LPC_USART_T *pUART, uint32_t mask)
+{
+	if (inIrq) {
+		apbAccesses += 2;
+	}
+	/* Enabling THRE with an empty FIFO raises it at once */
+	if ((mask & UART_IER_THREINT) && !(ier & UART_IER_THREINT) && (txCount == 0)) {
+		threPending = 1;
+	}
+	ier |= mask;
+	pUART->IER = ier;
+}
+
+static void hostIntDisable(LPC_USART_T *pUART, uint32_t mask)
+{
+	if (inIrq) {
+		apbAccesses += 2;
+	}
+	ier &= ~mask;
+	pUART->IER = ier;
+}
+
+static uint32_t hostReadMSR(LPC_USART_T *pUART)
+{
+	apbAccesses++;
+	return 0;
+}
+
+#define Chip_UART_ReadIntIDReg(p)       hostReadIIR(p)
+#define Chip_UART_ReadLineStatus(p)     hostReadLSR(p)
+#define Chip_UART_ReadByte(p)           hostReadRBR(p)
+#define Chip_UART_SendByte(p, c)        hostWriteTHR(p, c)
+#define Chip_UART_IntEnable(p, m)       hostIntEnable(p, m)
+#define Chip_UART_IntDisable(p, m)      hostIntDisable(p, m)
+#define Chip_UART_ReadModemStatus(p)    hostReadMSR(p)
+
+#define RingBuffer_Insert(r, d) \
+	(inIrq ? (ringCalls++, ringBytes++) : 0, RingBuffer_Insert(r, d))
+#define RingBuffer_Pop(r, d) \
+	(inIrq ? (ringCalls++, ringBytes++) : 0, RingBuffer_Pop(r, d))
+#define RingBuffer_InsertMult(r, d, n) \
+	(inIrq ? (ringCalls++, ringBytes += (n)) : 0, RingBuffer_InsertMult(r, d, n))
+#define RingBuffer_PopMult(r, d, n) \
+	(inIrq ? (ringCalls++, ringBytes += (n)) : 0, RingBuffer_PopMult(r, d, n))
+
+#include "../lpc_chip_43xx/src/uart_18xx_43xx.c"
+
+/*****************************************************************************
+ * Private types/enumerations/variables
+ ****************************************************************************/
+
+/* Cycle costs at 204 MHz, assumed and not measured: exception entry, exit
+   and dispatch, UART APB access, ring buffer call and per byte, handler
+   loop per byte */
+#define CYC_IRQ             36
+#define CYC_APB             6
+#define CYC_RING            25
+#define CYC_RING_BYTE       2
+#define CYC_BYTE            3
+
+#define DATA_SIZE           65536
+
+static LPC_USART_T hostUART;
+static RINGBUFF_T rxRing, txRing;
+static uint8_t rxRingBuf[1024], txRingBuf[1024];
+static uint8_t src[DATA_SIZE + 8], rxGot[DATA_SIZE], txOut[DATA_SIZE];
+
+/*****************************************************************************
+ * Public functions
+ ****************************************************************************/
+
+uint32_t Chip_Clock_GetRate(CHIP_CCU_CLK_T clk)
+{
+	return 204000000;
+}
+
+/*****************************************************************************
+ * Private functions
+ ****************************************************************************/
+
+/* Move rxBytes in and txBytes out at 921600 baud. Received data comes in
+   1000 byte packets with 20 idle character times between them, the task
+   drains the receive ring and tops up the transmit ring in 256 byte
+   writes. Returns the interrupts per KB. */
+static double runUART(const char *name, uint32_t fifoTrig, bool fifoHandler, long rxBytes, long txBytes)
+{
+	static const int trigLevels[] = {1, 4, 8, 14};
+	long rxSent = 0, rxDone = 0, txQueued = 0, txDone = 0, irqs = 0, idle = 0, n;
+	double kb = (rxBytes + txBytes) / 1024.0, cycles, secs;
+	bool pending;
+
+	rxCount = rxHead = txCount = txHead = threPending = 0;
+	ier = 0;
+	now = lastRx = overruns = 0;
+	apbAccesses = ringCalls = ringBytes = loopBytes = 0;
+	RingBuffer_Init(&rxRing, rxRingBuf, 1, sizeof(rxRingBuf));
+	RingBuffer_Init(&txRing, txRingBuf, 1, sizeof(txRingBuf));
+	rxTrig = trigLevels[fifoTrig >> 6];
+	hostIntEnable(&hostUART, UART_IER_RBRINT | UART_IER_RLSINT);
+
+	while ((rxDone < rxBytes) || (txDone < txBytes) || txCount) {
+		now++;
+
+		/* Receiver */
+		if (rxSent < rxBytes) {
+			if (idle) {
+				idle--;
+			}
+			else {
+				if (rxCount == 16) {
+					overruns++;
+				}
+				else {
+					rxFifo[(rxHead + rxCount) & 15] = src[rxSent];
+					rxCount++;
+				}
+				rxSent++;
+				lastRx = now;
+				if ((rxSent % 1000) == 0) {
+					idle = 20;
+				}
+			}
+		}
+
+		/* Transmitter */
+		if (txCount) {
+			txOut[txDone++] = txFifo[txHead];
+			txHead = (txHead + 1) & 15;
+			if (--txCount == 0) {
+				threPending = 1;
+			}
+		}
+
+		/* Interrupt line */
+		for (;;) {
+			pending = ((ier & UART_IER_RBRINT) && (rxCount >= rxTrig)) ||
+					  ((ier & UART_IER_RBRINT) && (rxCount > 0) && ((now - lastRx) >= 4)) ||
+					  ((ier & UART_IER_THREINT) && threPending);
+			if (!pending) {
+				break;
+			}
+			inIrq = true;
+			irqs++;
+			if (fifoHandler) {
+				Chip_UART_IRQRBFIFOHandler(&hostUART, &rxRing, &txRing, fifoTrig);
+			}
+			else {
+				Chip_UART_IRQRBHandler(&hostUART, &rxRing, &txRing);
+			}
+			inIrq = false;
+			TEST_CHECK(irqs < (10 * (rxBytes + txBytes) + 100));
+		}
+
+		/* Task */
+		rxDone += Chip_UART_ReadRB(&hostUART, &rxRing, &rxGot[rxDone], 1024);
+		if ((txQueued < txBytes) && (RingBuffer_GetFree(&txRing) >= 256)) {
+			n = ((txBytes - txQueued) > 256) ? 256 : (txBytes - txQueued);
+			txQueued += Chip_UART_SendRB(&hostUART, &txRing, &src[7 + txQueued], n);
+		}
+		TEST_CHECK(now < (100 * (rxBytes + txBytes) + 1000));
+	}
+
+	TEST_CHECK(memcmp(rxGot, src, rxBytes) == 0);
+	TEST_CHECK(memcmp(txOut, &src[7], txBytes) == 0);
+	TEST_CHECK(overruns == 0);
+
+	cycles = irqs * CYC_IRQ + apbAccesses * CYC_APB + ringCalls * CYC_RING +
+			 ringBytes * CYC_RING_BYTE + loopBytes * CYC_BYTE;
+	secs = now * 10.0 / 921600.0;
+	printf("test_uart: %-26s irq/KB %7.1f, APB/byte %5.2f, CPU %5.2f%%\n",
+		   name, irqs / kb, (double) apbAccesses / (rxBytes + txBytes), 100.0 * cycles / (secs * 204e6));
+	return irqs / kb;
+}
+
+int main(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < sizeof(src); i++) {
+		src[i] = (uint8_t) (i * 131 + (i >> 8));
+	}
+
+	/* Each THRE refills the whole FIFO */
+	TEST_CHECK(runUART("IRQRBHandler, tx only", UART_FCR_TRG_LEV0, false, 0, DATA_SIZE) <= 64.0);
+	TEST_CHECK(runUART("IRQRBHandler, duplex", UART_FCR_TRG_LEV0, false, DATA_SIZE, DATA_SIZE) > 0);
+
+	/* RDA takes the whole trigger level, CTI the rest of a packet */
+	TEST_CHECK(runUART("FIFOHandler LEV3, rx only", UART_FCR_TRG_LEV3, true, DATA_SIZE, 0) < 80.0);
+	TEST_CHECK(runUART("FIFOHandler LEV3, tx only", UART_FCR_TRG_LEV3, true, 0, DATA_SIZE) <= 64.0);
+	TEST_CHECK(runUART("FIFOHandler LEV3, duplex", UART_FCR_TRG_LEV3, true, DATA_SIZE, DATA_SIZE) < 80.0);
+	TEST_CHECK(runUART("FIFOHandler LEV2, duplex", UART_FCR_TRG_LEV2, true, DATA_SIZE, DATA_SIZE) < 100.0);
+
+	printf("test_uart: passed\n");
+	return 0;
+}